@@ -42,6 +42,7 @@ bool EditorSystem::initialize(const JSON::json& systemData)
 
 	m_Scene.reset(new SceneDock());
 	m_Output.reset(new OutputDock());
+	m_LuaProfiler.reset(new LuaProfilerDock());
 	m_Toolbar.reset(new ToolbarDock());
 	m_Viewport.reset(new ViewportDock(systemData["viewport"]));
 	m_Inspector.reset(new InspectorDock());
@@ -186,6 +187,7 @@ void EditorSystem::update(float deltaMilliseconds)
 	m_Inspector->draw(deltaMilliseconds);
 	m_FileViewer->draw(deltaMilliseconds);
 	m_Output->draw(deltaMilliseconds);
+	m_LuaProfiler->draw(deltaMilliseconds);
 
 	popFont();
 
@@ -427,6 +429,7 @@ void EditorSystem::drawDefaultUI(float deltaMilliseconds)
 					ImGui::Checkbox("Scene", &m_Scene->getSettings().m_IsActive);
 					ImGui::Checkbox("Viewport", &m_Viewport->getSettings().m_IsActive);
 					ImGui::Checkbox("Inspector", &m_Inspector->getSettings().m_IsActive);
+					ImGui::Checkbox("Lua Profiler", &m_LuaProfiler->getSettings().m_IsActive);
 					ImGui::EndMenu();
 				}
 				ImGui::EndMenu();
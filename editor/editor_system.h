@@ -7,6 +7,7 @@
 
 #include "gui/scene_dock.h"
 #include "gui/output_dock.h"
+#include "gui/lua_profiler_dock.h"
 #include "gui/toolbar_dock.h"
 #include "gui/viewport_dock.h"
 #include "gui/inspector_dock.h"
@@ -49,6 +50,7 @@ class EditorSystem : public System
 
 	Ptr<SceneDock> m_Scene;
 	Ptr<OutputDock> m_Output;
+	Ptr<LuaProfilerDock> m_LuaProfiler;
 	Ptr<ToolbarDock> m_Toolbar;
 	Ptr<ViewportDock> m_Viewport;
 	Ptr<InspectorDock> m_Inspector;
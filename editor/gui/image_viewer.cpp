@@ -2,6 +2,7 @@
 
 #include "editor/editor_system.h"
 #include "core/resource_files/image_resource_file.h"
+#include "core/renderer/texture_streamer.h"
 
 #include "imgui.h"
 
@@ -20,7 +21,9 @@ void ImageViewer::draw(float deltaMilliseconds)
 	ImGui::Separator();
 	ImGui::SetNextItemWidth(ImGui::GetContentRegionAvailWidth());
 	ImGui::SliderFloat("##Zoom", &m_Zoom, m_MinZoom, m_MaxZoom, "Zoom %.3fx");
-	ImGui::Image(m_ImageResourceFile->getTexture()->getTextureResourceView(), { m_Zoom * (float)m_ImageResourceFile->getTexture()->getWidth(), m_Zoom * (float)m_ImageResourceFile->getTexture()->getHeight() }, { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f });
+	const Ref<Texture> texture = m_ImageResourceFile->getTexture();
+	TextureStreamer::GetSingleton()->request(texture.get(), m_Zoom * std::max(texture->getWidth(), texture->getHeight()));
+	ImGui::Image(texture->getTextureResourceView(), { m_Zoom * (float)texture->getWidth(), m_Zoom * (float)texture->getHeight() }, { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f });
 }
 
 void ImageViewer::drawFileInfo()
@@ -0,0 +1,83 @@
+#include "lua_profiler_dock.h"
+
+#include "vendor/ImGUI/imgui.h"
+#include "vendor/ImGUI/imgui_impl_dx11.h"
+#include "vendor/ImGUI/imgui_impl_win32.h"
+
+#include "Tracy/Tracy.hpp"
+
+void LuaProfilerDock::drawEntries(const char* label, const HashMap<String, LuaProfiler::Entry>& entries)
+{
+	if (!ImGui::TreeNodeEx(label, ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		return;
+	}
+
+	Vector<Pair<String, LuaProfiler::Entry>> sorted(entries.begin(), entries.end());
+	std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second.milliseconds > b.second.milliseconds; });
+
+	const float total = std::max(LuaProfiler::GetSingleton()->getTotalMilliseconds(), 0.001f);
+	ImGui::Columns(3);
+	ImGui::Text("Name");
+	ImGui::NextColumn();
+	ImGui::Text("Milliseconds");
+	ImGui::NextColumn();
+	ImGui::Text("Share");
+	ImGui::NextColumn();
+	for (auto& [name, entry] : sorted)
+	{
+		ImGui::TextUnformatted(name.c_str());
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", entry.milliseconds);
+		ImGui::NextColumn();
+		ImGui::ProgressBar(entry.milliseconds / total);
+		ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+	ImGui::TreePop();
+}
+
+void LuaProfilerDock::draw(float deltaMilliseconds)
+{
+	ZoneScoped;
+	if (m_LuaProfilerDockSettings.m_IsActive)
+	{
+		if (ImGui::Begin("Lua Profiler", &m_LuaProfilerDockSettings.m_IsActive))
+		{
+			LuaProfiler* profiler = LuaProfiler::GetSingleton();
+			if (profiler->isRunning())
+			{
+				if (ImGui::Button("Stop"))
+				{
+					profiler->stop();
+				}
+			}
+			else if (ImGui::Button("Start"))
+			{
+				profiler->start();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Reset"))
+			{
+				profiler->reset();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Save Flame Graph"))
+			{
+				if (Optional<String> result = OS::SaveSelectFile("Folded Stacks(*.folded)\0*.folded\0", "game/"))
+				{
+					if (!profiler->saveFoldedStacks(*result))
+					{
+						WARN("Could not save Lua profile: " + *result);
+					}
+				}
+			}
+			ImGui::Text("%u samples, %.2f ms", profiler->getTotalSamples(), profiler->getTotalMilliseconds());
+
+			drawEntries("Entities", profiler->getEntities());
+			drawEntries("Files", profiler->getFiles());
+			drawEntries("Functions", profiler->getFunctions());
+		}
+		ImGui::End();
+	}
+}
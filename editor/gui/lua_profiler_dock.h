@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common/common.h"
+#include "script/lua_profiler.h"
+
+class LuaProfilerDock
+{
+public:
+	struct LuaProfilerDockSettings
+	{
+		bool m_IsActive = false;
+	};
+
+private:
+	LuaProfilerDockSettings m_LuaProfilerDockSettings;
+
+	void drawEntries(const char* label, const HashMap<String, LuaProfiler::Entry>& entries);
+
+public:
+	LuaProfilerDock() = default;
+	LuaProfilerDock(LuaProfilerDock&) = delete;
+	~LuaProfilerDock() = default;
+
+	void draw(float deltaMilliseconds);
+
+	LuaProfilerDockSettings& getSettings() { return m_LuaProfilerDockSettings; }
+	void setActive(bool enabled) { m_LuaProfilerDockSettings.m_IsActive = enabled; }
+};
@@ -8,46 +8,43 @@
 
 #include "imgui_stdlib.h"
 
-Variant OutputDock::catchOutput(const Event* event)
-{
-	VariantVector data = Extract<VariantVector>(event->getData());
-	String msg = Extract<String>(data.front());
-	String type = Extract<String>(data.back());
-	m_CaughtOutputs.push_back({ type, msg });
-	m_IsOutputJustCaught = true;
-	return true;
-}
-
-OutputDock::OutputDock()
-{
-	BIND_EVENT_MEMBER_FUNCTION(RootexEvents::OSPrint, catchOutput);
-}
-
 void OutputDock::draw(float deltaMilliseconds)
 {
 	ZoneScoped;
+
+	// Everything the logger wrote since the last frame arrives at once
+	const size_t caughtCount = m_CaughtOutputs.size();
+	Logger::GetSingleton()->takeBatch(m_CaughtOutputs);
+	m_IsOutputJustCaught |= m_CaughtOutputs.size() != caughtCount;
+
 	if (m_OutputDockSettings.m_IsActive)
 	{
 		if (ImGui::Begin("Output"))
 		{
-			for (auto&& outputString : m_CaughtOutputs)
+			ImGuiListClipper clipper;
+			clipper.Begin(m_CaughtOutputs.size());
+			while (clipper.Step())
 			{
-				if (outputString.first == "Error")
-				{
-					ImGui::PushStyleColor(ImGuiCol_Text, (const ImVec4&)EditorSystem::GetSingleton()->getFatalColor());
-				}
-				else if (outputString.first == "Warning")
+				for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
 				{
-					ImGui::PushStyleColor(ImGuiCol_Text, (const ImVec4&)EditorSystem::GetSingleton()->getWarningColor());
-				}
-				else
-				{
-					ImGui::PushStyleColor(ImGuiCol_Text, (const ImVec4&)EditorSystem::GetSingleton()->getNormalColor());
-				}
+					const LogEntry& output = m_CaughtOutputs[i];
+					switch (output.level)
+					{
+					case LogLevel::Error:
+						ImGui::PushStyleColor(ImGuiCol_Text, (const ImVec4&)EditorSystem::GetSingleton()->getFatalColor());
+						break;
+					case LogLevel::Warning:
+						ImGui::PushStyleColor(ImGuiCol_Text, (const ImVec4&)EditorSystem::GetSingleton()->getWarningColor());
+						break;
+					default:
+						ImGui::PushStyleColor(ImGuiCol_Text, (const ImVec4&)EditorSystem::GetSingleton()->getNormalColor());
+						break;
+					}
 
-				ImGui::TextUnformatted(outputString.second.c_str());
+					ImGui::TextUnformatted(output.message.c_str());
 
-				ImGui::PopStyleColor(1);
+					ImGui::PopStyleColor(1);
+				}
 			}
 		}
 
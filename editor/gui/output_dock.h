@@ -16,12 +16,11 @@ public:
 
 private:
 	OutputDockSettings m_OutputDockSettings;
-	Vector<Pair<String, String>> m_CaughtOutputs;
+	Vector<LogEntry> m_CaughtOutputs;
 	bool m_IsOutputJustCaught = false;
-	Variant catchOutput(const Event* event);
 
 public:
-	OutputDock();
+	OutputDock() = default;
 	OutputDock(OutputDock&) = delete;
 	~OutputDock() = default;
 
@@ -10,13 +10,18 @@ end
 function Follow:begin(entity)
     local following = RTX.Scene.FindSceneByID(self.exports.following)
     self.followingTransform = following:getEntity():getTransform()
+    self.transform = entity:getTransform()
+    -- Reused every frame so following does not allocate
+    self.target = RTX.Vector3.new()
+    self.position = RTX.Vector3.new()
 end
 
 function Follow:update(entity, delta)
-    entity:getTransform():setAbsolutePosition(
-        self.exports.tightness * self.followingTransform:getAbsolutePosition() + 
-        (1.0 - self.exports.tightness) * entity:getTransform():getAbsolutePosition())
-    entity:getTransform():setRotation(0, 0, 0)
+    self.followingTransform:getAbsolutePositionInto(self.target)
+    self.transform:getAbsolutePositionInto(self.position)
+    self.position:lerpInPlace(self.target, self.exports.tightness)
+    self.transform:setAbsolutePosition(self.position)
+    self.transform:setRotation(0, 0, 0)
 end
 
 function Follow:destroy(entity)
@@ -0,0 +1,60 @@
+MathBenchmark = class("MathBenchmark")
+
+-- Compares Lua allocations made by math operators against the in place methods.
+-- Attach to any entity and read the averages printed to the output.
+function MathBenchmark:initialize(entity)
+    self.exports = {
+        iterations = 1000,
+        reportFrames = 120
+    }
+end
+
+function MathBenchmark:begin(entity)
+    self.a = RTX.Vector3.new(1, 2, 3)
+    self.b = RTX.Vector3.new(4, 5, 6)
+    self.result = RTX.Vector3.new()
+    self.transform = entity:getTransform()
+    self.frames = 0
+    self.operatorAllocations = 0
+    self.inPlaceAllocations = 0
+end
+
+function MathBenchmark:update(entity, delta)
+    local a = self.a
+    local b = self.b
+    local result = self.result
+    local transform = self.transform
+
+    local start = RTX.GetLuaAllocationCount()
+    for i = 1, self.exports.iterations do
+        result = 0.5 * (a + b) - transform:getAbsolutePosition()
+    end
+    local middle = RTX.GetLuaAllocationCount()
+    result = self.result
+    for i = 1, self.exports.iterations do
+        transform:getAbsolutePositionInto(result)
+        result:scaleInPlace(-1)
+        result:addInPlace(a)
+        result:addInPlace(b)
+        result:scaleInPlace(0.5)
+    end
+    local finish = RTX.GetLuaAllocationCount()
+
+    self.operatorAllocations = self.operatorAllocations + (middle - start)
+    self.inPlaceAllocations = self.inPlaceAllocations + (finish - middle)
+    self.frames = self.frames + 1
+
+    if self.frames == self.exports.reportFrames then
+        print("Math allocations per frame over " .. self.frames .. " frames: operators "
+            .. (self.operatorAllocations / self.frames) .. ", in place "
+            .. (self.inPlaceAllocations / self.frames))
+        self.frames = 0
+        self.operatorAllocations = 0
+        self.inPlaceAllocations = 0
+    end
+end
+
+function MathBenchmark:destroy(entity)
+end
+
+return MathBenchmark
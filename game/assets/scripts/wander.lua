@@ -0,0 +1,41 @@
+Wander = class("Wander")
+
+-- Meant to run as a parallel script. It only touches its own entity through the view
+-- it is given, and tells others where it is through an event applied on the main thread.
+function Wander:initialize(entity)
+    self.exports = {
+        speed = 2.0,
+        radius = 10.0,
+        turnRate = 0.5
+    }
+end
+
+function Wander:begin(entity)
+    self.origin = entity:getPosition()
+    self.position = RTX.Vector3.new()
+    self.heading = math.random() * math.pi * 2
+end
+
+function Wander:update(entity, delta)
+    local seconds = delta / 1000.0
+    self.heading = self.heading + (math.random() - 0.5) * self.exports.turnRate * seconds * 60
+
+    entity:getPositionInto(self.position)
+    self.position.x = self.position.x + math.cos(self.heading) * self.exports.speed * seconds
+    self.position.z = self.position.z + math.sin(self.heading) * self.exports.speed * seconds
+
+    local offsetX = self.position.x - self.origin.x
+    local offsetZ = self.position.z - self.origin.z
+    if offsetX * offsetX + offsetZ * offsetZ > self.exports.radius * self.exports.radius then
+        self.heading = math.atan(-offsetZ, -offsetX)
+    end
+
+    entity:setPosition(self.position)
+    entity:setRotation(-self.heading, 0, 0)
+end
+
+function Wander:destroy(entity)
+    RTX.CallEvent("WandererRemoved", entity:getID())
+end
+
+return Wander
@@ -7,6 +7,8 @@
 #include "core/input/input_manager.h"
 #include "core/renderer/shader_library.h"
 #include "core/renderer/material_library.h"
+#include "core/renderer/geometry_heap.h"
+#include "core/renderer/texture_streamer.h"
 #include "script/interpreter.h"
 
 #include "systems/audio_system.h"
@@ -20,6 +22,7 @@
 #include "systems/script_system.h"
 #include "systems/transform_animation_system.h"
 #include "systems/trigger_system.h"
+#include "systems/spatial_system.h"
 
 #include "Tracy/Tracy.hpp"
 
@@ -48,6 +51,24 @@ Application::Application(const String& settingsFile)
 
 	m_ApplicationSettings.reset(new ApplicationSettings(ResourceLoader::CreateTextResourceFile(settingsFile)));
 
+	auto&& logLevel = m_ApplicationSettings->find("logLevel");
+	if (logLevel != m_ApplicationSettings->end())
+	{
+		Logger::SetMinimumLevel(Logger::GetLevelFromName(*logLevel));
+	}
+
+	auto&& packVertices = m_ApplicationSettings->find("packVertices");
+	if (packVertices != m_ApplicationSettings->end())
+	{
+		GeometryHeap::GetSingleton()->setPackingVertices(*packVertices);
+	}
+
+	auto&& textureBudget = m_ApplicationSettings->find("textureBudgetMB");
+	if (textureBudget != m_ApplicationSettings->end())
+	{
+		TextureStreamer::GetSingleton()->setBudget((size_t)*textureBudget * 1024 * 1024);
+	}
+
 	const JSON::json& splashSettings = m_ApplicationSettings->getJSON()["splash"];
 	m_SplashWindow.reset(new SplashWindow(
 	    splashSettings["title"],
@@ -89,6 +110,7 @@ Application::Application(const String& settingsFile)
 	UISystem::GetSingleton()->initialize(uiSystemSettings);
 
 	RenderUISystem::GetSingleton();
+	SpatialSystem::GetSingleton();
 	RenderSystem::GetSingleton();
 	ParticleSystem::GetSingleton()->initialize(systemsSettings["ParticleSystem"]);
 	PostProcessSystem::GetSingleton();
@@ -116,13 +138,27 @@ Application::Application(const String& settingsFile)
 		}
 	}
 
+	auto&& luaGCBudget = m_ApplicationSettings->find("luaGCBudget");
+	if (luaGCBudget != m_ApplicationSettings->end())
+	{
+		LuaInterpreter::GetSingleton()->setGCBudget(*luaGCBudget);
+	}
+
+	auto&& hotReload = m_ApplicationSettings->find("hotReload");
+	if (hotReload != m_ApplicationSettings->end() && (bool)*hotReload)
+	{
+		ResourceLoader::StartWatching({ "game/assets", "rootex/assets" });
+	}
+
 	m_Window->show();
 }
 
 Application::~Application()
 {
+	ResourceLoader::StopWatching();
 	SceneLoader::GetSingleton()->destroyAllScenes();
 	AudioSystem::GetSingleton()->shutDown();
+	TextureStreamer::GetSingleton()->shutDown();
 	UISystem::GetSingleton()->shutDown();
 	ShaderLibrary::DestroyShaders();
 	EventManager::GetSingleton()->releaseAllEventListeners();
@@ -148,6 +184,8 @@ void Application::run()
 		process(m_FrameTimer.getLastFrameTime());
 
 		EventManager::GetSingleton()->dispatchDeferred();
+		LuaInterpreter::GetSingleton()->stepGarbageCollector();
+		ResourceLoader::ReloadChangedResources();
 
 		m_Window->swapBuffers();
 		FrameMark;
@@ -2,25 +2,43 @@
 
 #include "common/types.h"
 #include "os/os.h"
+#include "os/logger.h"
 #include "script/interpreter.h"
 
+/// Logs function, message in white color if trace logging is enabled
+#define TRACE(m_Msg)                                                                             \
+	{                                                                                            \
+		if (::Logger::IsEnabled(LogLevel::Trace))                                                \
+		{                                                                                        \
+			::Logger::GetSingleton()->log(LogLevel::Trace, String(__FUNCTION__) + ": " + m_Msg); \
+		}                                                                                        \
+	}
 /// Logs function, message in white color
-#define PRINT(m_Msg)                                      \
-	{                                                     \
-		String msg = String(__FUNCTION__) + ": " + m_Msg; \
-		::OS::Print(msg);                                 \
+#define PRINT(m_Msg)                                          \
+	{                                                         \
+		if (::Logger::IsEnabled(LogLevel::Print))             \
+		{                                                     \
+			String msg = String(__FUNCTION__) + ": " + m_Msg; \
+			::OS::Print(msg);                                 \
+		}                                                     \
 	}
 /// Logs file, line, function, message in yellow color
-#define WARN(m_Msg)                                                                                                 \
-	{                                                                                                               \
-		String msg = String(__FILE__) + ":" + std::to_string(__LINE__) + ":" + String(__FUNCTION__) + ": " + m_Msg; \
-		::OS::PrintWarning(msg);                                                                                    \
+#define WARN(m_Msg)                                                                                                     \
+	{                                                                                                                   \
+		if (::Logger::IsEnabled(LogLevel::Warning))                                                                     \
+		{                                                                                                               \
+			String msg = String(__FILE__) + ":" + std::to_string(__LINE__) + ":" + String(__FUNCTION__) + ": " + m_Msg; \
+			::OS::PrintWarning(msg);                                                                                    \
+		}                                                                                                               \
 	}
 /// Logs file, line, function, message in red color
-#define ERR(m_Msg)                                                                                                  \
-	{                                                                                                               \
-		String msg = String(__FILE__) + ":" + std::to_string(__LINE__) + ":" + String(__FUNCTION__) + ": " + m_Msg; \
-		::OS::PrintError(msg);                                                                                      \
+#define ERR(m_Msg)                                                                                                      \
+	{                                                                                                                   \
+		if (::Logger::IsEnabled(LogLevel::Error))                                                                       \
+		{                                                                                                               \
+			String msg = String(__FILE__) + ":" + std::to_string(__LINE__) + ":" + String(__FUNCTION__) + ": " + m_Msg; \
+			::OS::PrintError(msg);                                                                                      \
+		}                                                                                                               \
 	}
 /// Logs file, line, function, message in yellow color in condition is true
 #define PANIC(m_IfTtrue, m_Msg) \
@@ -23,6 +23,9 @@
 #include <future>
 template <class T>
 using Future = std::future<T>;
+/// Future that several threads can wait on
+template <class T>
+using SharedFuture = std::shared_future<T>;
 
 /// Promise data types for sharing futures
 #include <future>
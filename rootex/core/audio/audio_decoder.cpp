@@ -0,0 +1,249 @@
+#include "audio_decoder.h"
+
+#include "common/common.h"
+
+#include <cstring>
+
+static const int IMAStepTable[89] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+	253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+	1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+	3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+	12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int IMAIndexTable[16] = {
+	-1, -1, -1, -1, 2, 4, 6, 8,
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+template <class T>
+static T ReadLittleEndian(const char* data)
+{
+	T value;
+	memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+void AudioDecoder::setFormat(int channels, int bitDepth)
+{
+	m_Channels = channels;
+	m_BitDepth = bitDepth;
+	if (channels == 1)
+	{
+		m_Format = bitDepth == 8 ? AL_FORMAT_MONO8 : AL_FORMAT_MONO16;
+	}
+	else
+	{
+		m_Format = bitDepth == 8 ? AL_FORMAT_STEREO8 : AL_FORMAT_STEREO16;
+	}
+}
+
+Ptr<AudioDecoder> AudioDecoder::Open(const String& path)
+{
+	Ptr<MappedFile> file = MappedFile::Open(path);
+	if (!file)
+	{
+		WARN("Could not open audio file: " + path);
+		return nullptr;
+	}
+
+	Ptr<AudioDecoder> decoder = WAVDecoder::Open(std::move(file));
+	if (!decoder)
+	{
+		WARN("Unsupported audio file: " + path);
+	}
+	return decoder;
+}
+
+Ptr<WAVDecoder> WAVDecoder::Open(Ptr<MappedFile> file)
+{
+	const char* data = file->getData();
+	const size_t size = file->getSize();
+	if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+	{
+		return nullptr;
+	}
+
+	Ptr<WAVDecoder> decoder(new WAVDecoder());
+	bool isFormatFound = false;
+	size_t offset = 12;
+	while (offset + 8 <= size)
+	{
+		const char* chunk = data + offset;
+		const size_t chunkSize = std::min<size_t>(ReadLittleEndian<unsigned int>(chunk + 4), size - offset - 8);
+		const char* chunkData = chunk + 8;
+
+		if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16)
+		{
+			decoder->m_Encoding = (Encoding)ReadLittleEndian<unsigned short>(chunkData);
+			const int channels = ReadLittleEndian<unsigned short>(chunkData + 2);
+			decoder->m_Frequency = ReadLittleEndian<unsigned int>(chunkData + 4);
+			decoder->m_BlockAlign = ReadLittleEndian<unsigned short>(chunkData + 12);
+			const int bitDepth = ReadLittleEndian<unsigned short>(chunkData + 14);
+
+			if (channels < 1 || channels > 2 || decoder->m_BlockAlign == 0)
+			{
+				return nullptr;
+			}
+			if (decoder->m_Encoding == Encoding::PCM && (bitDepth == 8 || bitDepth == 16))
+			{
+				decoder->setFormat(channels, bitDepth);
+			}
+			else if (decoder->m_Encoding == Encoding::IMAADPCM && bitDepth == 4 && decoder->m_BlockAlign > 4 * channels)
+			{
+				decoder->setFormat(channels, 16);
+				decoder->m_FramesPerBlock = (decoder->m_BlockAlign - 4 * channels) * 8 / (4 * channels) + 1;
+			}
+			else
+			{
+				return nullptr;
+			}
+			isFormatFound = true;
+		}
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			decoder->m_Data = chunkData;
+			decoder->m_DataSize = chunkSize;
+		}
+
+		// Chunks are padded to an even size
+		offset += 8 + chunkSize + (chunkSize & 1);
+	}
+
+	if (!isFormatFound || !decoder->m_Data)
+	{
+		return nullptr;
+	}
+
+	if (decoder->m_Encoding == Encoding::PCM)
+	{
+		decoder->m_DataSize -= decoder->m_DataSize % decoder->getFrameSize();
+		decoder->m_FrameCount = decoder->m_DataSize / decoder->getFrameSize();
+	}
+	else
+	{
+		decoder->m_DataSize -= decoder->m_DataSize % decoder->m_BlockAlign;
+		decoder->m_FrameCount = decoder->m_DataSize / decoder->m_BlockAlign * decoder->m_FramesPerBlock;
+		decoder->m_Block.reserve(decoder->m_FramesPerBlock * decoder->m_Channels);
+	}
+	decoder->m_File = std::move(file);
+	return decoder;
+}
+
+bool WAVDecoder::decodeBlock()
+{
+	m_Block.clear();
+	m_BlockCursor = 0;
+	if (m_Cursor + m_BlockAlign > m_DataSize)
+	{
+		return false;
+	}
+
+	const unsigned char* block = (const unsigned char*)m_Data + m_Cursor;
+	m_Cursor += m_BlockAlign;
+	m_Block.resize(m_FramesPerBlock * m_Channels);
+
+	int predictor[2];
+	int stepIndex[2];
+	for (int channel = 0; channel < m_Channels; channel++)
+	{
+		predictor[channel] = ReadLittleEndian<short>((const char*)block + channel * 4);
+		stepIndex[channel] = std::clamp((int)block[channel * 4 + 2], 0, 88);
+		m_Block[channel] = predictor[channel];
+	}
+
+	// Each channel stores 8 samples in every 4 bytes, interleaved 4 bytes at a time
+	const unsigned char* nibbles = block + 4 * m_Channels;
+	const int groups = (m_FramesPerBlock - 1) / 8;
+	for (int group = 0; group < groups; group++)
+	{
+		for (int channel = 0; channel < m_Channels; channel++)
+		{
+			const unsigned char* bytes = nibbles + (group * m_Channels + channel) * 4;
+			for (int i = 0; i < 8; i++)
+			{
+				const int nibble = (bytes[i / 2] >> ((i & 1) * 4)) & 0xF;
+				const int step = IMAStepTable[stepIndex[channel]];
+
+				int difference = step >> 3;
+				if (nibble & 1)
+				{
+					difference += step >> 2;
+				}
+				if (nibble & 2)
+				{
+					difference += step >> 1;
+				}
+				if (nibble & 4)
+				{
+					difference += step;
+				}
+				if (nibble & 8)
+				{
+					difference = -difference;
+				}
+
+				predictor[channel] = std::clamp(predictor[channel] + difference, -32768, 32767);
+				stepIndex[channel] = std::clamp(stepIndex[channel] + IMAIndexTable[nibble], 0, 88);
+
+				const int frame = 1 + group * 8 + i;
+				m_Block[frame * m_Channels + channel] = (short)predictor[channel];
+			}
+		}
+	}
+	return true;
+}
+
+unsigned int WAVDecoder::decode(char* output, unsigned int size)
+{
+	size -= size % getFrameSize();
+
+	if (m_Encoding == Encoding::PCM)
+	{
+		const unsigned int count = std::min<size_t>(size, m_DataSize - m_Cursor);
+		memcpy(output, m_Data + m_Cursor, count);
+		m_Cursor += count;
+		return count;
+	}
+
+	unsigned int written = 0;
+	while (written < size)
+	{
+		if (m_BlockCursor == m_Block.size() && !decodeBlock())
+		{
+			break;
+		}
+		const unsigned int count = std::min<size_t>(size - written, (m_Block.size() - m_BlockCursor) * sizeof(short));
+		memcpy(output + written, m_Block.data() + m_BlockCursor, count);
+		m_BlockCursor += count / sizeof(short);
+		written += count;
+	}
+	return written;
+}
+
+void WAVDecoder::rewind()
+{
+	m_Cursor = 0;
+	m_Block.clear();
+	m_BlockCursor = 0;
+}
+
+void WAVDecoder::seek(size_t frame)
+{
+	frame = std::min(frame, m_FrameCount);
+	if (m_Encoding == Encoding::PCM)
+	{
+		m_Cursor = frame * getFrameSize();
+		return;
+	}
+
+	m_Cursor = frame / m_FramesPerBlock * m_BlockAlign;
+	m_Block.clear();
+	m_BlockCursor = 0;
+	if (decodeBlock())
+	{
+		m_BlockCursor = frame % m_FramesPerBlock * m_Channels;
+	}
+}
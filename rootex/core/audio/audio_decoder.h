@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/types.h"
+#include "os/mapped_file.h"
+
+#include "al.h"
+
+/// Decodes an audio file to PCM a chunk at a time, so only what is about to be played is ever decoded.
+class AudioDecoder
+{
+protected:
+	ALenum m_Format = 0;
+	int m_Frequency = 0;
+	int m_Channels = 0;
+	int m_BitDepth = 0;
+	/// Number of sample frames in the whole file
+	size_t m_FrameCount = 0;
+
+	void setFormat(int channels, int bitDepth);
+
+public:
+	/// Open a decoder for a file relative to Rootex root. Returns nullptr if the file is not supported.
+	static Ptr<AudioDecoder> Open(const String& path);
+
+	virtual ~AudioDecoder() = default;
+
+	/// Decode up to size bytes of PCM into output. Returns the number of bytes written, 0 at the end of the file.
+	virtual unsigned int decode(char* output, unsigned int size) = 0;
+	/// Restart decoding from the beginning of the file.
+	virtual void rewind() = 0;
+	/// Continue decoding from a sample frame. Frames past the end are clamped to it.
+	virtual void seek(size_t frame) = 0;
+
+	/// Returns the same enum value that OpenAL uses.
+	ALenum getFormat() const { return m_Format; }
+	int getFrequency() const { return m_Frequency; }
+	int getChannels() const { return m_Channels; }
+	int getBitDepth() const { return m_BitDepth; }
+	/// Size of a sample frame in the decoded PCM
+	int getFrameSize() const { return m_Channels * m_BitDepth / 8; }
+	/// Size of the whole file once decoded
+	size_t getDecodedSize() const { return m_FrameCount * getFrameSize(); }
+	/// Duration of the audio in seconds
+	float getDuration() const { return (float)m_FrameCount / m_Frequency; }
+};
+
+/// Decoder for RIFF WAV files holding either PCM or IMA ADPCM data.
+/// IMA ADPCM stores 4 bits per sample and is decoded to 16 bit PCM.
+class WAVDecoder : public AudioDecoder
+{
+	enum class Encoding
+	{
+		PCM = 1,
+		IMAADPCM = 0x11
+	};
+
+	Ptr<MappedFile> m_File;
+	Encoding m_Encoding;
+	const char* m_Data = nullptr;
+	size_t m_DataSize = 0;
+	size_t m_Cursor = 0;
+
+	/// IMA ADPCM blocks are decoded whole, then handed out in pieces
+	int m_BlockAlign = 0;
+	int m_FramesPerBlock = 0;
+	Vector<short> m_Block;
+	size_t m_BlockCursor = 0;
+
+	bool decodeBlock();
+
+public:
+	/// Returns nullptr if the file is not a WAV file this decoder understands.
+	static Ptr<WAVDecoder> Open(Ptr<MappedFile> file);
+
+	WAVDecoder() = default;
+	WAVDecoder(const WAVDecoder&) = delete;
+	~WAVDecoder() = default;
+
+	unsigned int decode(char* output, unsigned int size) override;
+	void rewind() override;
+	void seek(size_t frame) override;
+};
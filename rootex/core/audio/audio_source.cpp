@@ -7,17 +7,138 @@
 AudioSource::AudioSource(bool isStreaming)
     : m_IsStreaming(isStreaming)
 {
-	AL_CHECK(alGenSources(1, &m_SourceID));
 }
 
 AudioSource::~AudioSource()
 {
-	AL_CHECK(alDeleteSources(1, &m_SourceID));
 }
 
-void AudioSource::setLooping(bool enabled)
+bool AudioSource::hasVoiceEnded() const
+{
+	ALenum state;
+	AL_CHECK(alGetSourcei(m_SourceID, AL_SOURCE_STATE, &state));
+	return state == AL_STOPPED;
+}
+
+void AudioSource::applyParameters()
+{
+	AL_CHECK(alSourcef(m_SourceID, AL_GAIN, m_Volume));
+	AL_CHECK(alSourcei(m_SourceID, AL_SOURCE_RELATIVE, !m_IsAttenuated));
+	if (m_IsAttenuated)
+	{
+		AL_CHECK(alSource3f(m_SourceID, AL_POSITION, m_Position.x, m_Position.y, m_Position.z));
+		AL_CHECK(alDistanceModel((ALenum)m_Model));
+		AL_CHECK(alSourcef(m_SourceID, AL_ROLLOFF_FACTOR, m_RolloffFactor));
+		AL_CHECK(alSourcef(m_SourceID, AL_REFERENCE_DISTANCE, m_ReferenceDistance));
+		AL_CHECK(alSourcef(m_SourceID, AL_MAX_DISTANCE, m_MaxDistance));
+	}
+	else
+	{
+		AL_CHECK(alSource3f(m_SourceID, AL_POSITION, 0.0f, 0.0f, 0.0f));
+	}
+}
+
+void AudioSource::bindVoice(ALuint voice)
 {
-	AL_CHECK(alSourcei(m_SourceID, AL_LOOPING, enabled));
+	m_SourceID = voice;
+	applyParameters();
+	attach(m_ElapsedSeconds);
+	if (m_State == State::Playing)
+	{
+		AL_CHECK(alSourcePlay(m_SourceID));
+	}
+}
+
+ALuint AudioSource::releaseVoice()
+{
+	if (m_State != State::Stopped)
+	{
+		m_ElapsedSeconds = getVoiceOffset();
+	}
+	AL_CHECK(alSourceStop(m_SourceID));
+	detach();
+	AL_CHECK(alSourcei(m_SourceID, AL_BUFFER, 0));
+	AL_CHECK(alSourcei(m_SourceID, AL_LOOPING, AL_FALSE));
+
+	ALuint voice = m_SourceID;
+	m_SourceID = 0;
+	return voice;
+}
+
+void AudioSource::updatePlayback(float deltaSeconds)
+{
+	if (m_State != State::Playing)
+	{
+		return;
+	}
+
+	if (m_SourceID)
+	{
+		if (hasVoiceEnded())
+		{
+			m_State = State::Stopped;
+			m_ElapsedSeconds = 0.0f;
+		}
+		m_PublishedSeconds = m_State == State::Playing ? getVoiceOffset() : 0.0f;
+		return;
+	}
+
+	m_ElapsedSeconds += deltaSeconds;
+	const float duration = getDuration();
+	if (m_ElapsedSeconds >= duration)
+	{
+		if (m_IsLooping && duration > 0.0f)
+		{
+			m_ElapsedSeconds = std::fmod(m_ElapsedSeconds, duration);
+		}
+		else
+		{
+			m_State = State::Stopped;
+			m_ElapsedSeconds = 0.0f;
+		}
+	}
+	m_PublishedSeconds = m_ElapsedSeconds;
+}
+
+float AudioSource::getAudibility(const Vector3& listenerPosition) const
+{
+	if (!m_IsAttenuated)
+	{
+		return m_Volume;
+	}
+
+	// Same curves OpenAL applies, see the OpenAL 1.1 specification
+	float distance = Vector3::Distance(m_Position, listenerPosition);
+	float attenuation = 1.0f;
+	switch (m_Model)
+	{
+	case AttenuationModel::InverseClamped:
+		distance = std::clamp(distance, m_ReferenceDistance, std::max(m_ReferenceDistance, m_MaxDistance));
+	case AttenuationModel::Inverse:
+		attenuation = m_ReferenceDistance / std::max(m_ReferenceDistance + m_RolloffFactor * (distance - m_ReferenceDistance), FLT_EPSILON);
+		break;
+	case AttenuationModel::LinearClamped:
+		distance = std::clamp(distance, m_ReferenceDistance, std::max(m_ReferenceDistance, m_MaxDistance));
+	case AttenuationModel::Linear:
+		distance = std::min(distance, m_MaxDistance);
+		attenuation = 1.0f - m_RolloffFactor * (distance - m_ReferenceDistance) / std::max(m_MaxDistance - m_ReferenceDistance, FLT_EPSILON);
+		break;
+	case AttenuationModel::ExponentialClamped:
+		distance = std::clamp(distance, m_ReferenceDistance, std::max(m_ReferenceDistance, m_MaxDistance));
+	case AttenuationModel::Exponential:
+		attenuation = std::pow(std::max(distance, FLT_EPSILON) / std::max(m_ReferenceDistance, FLT_EPSILON), -m_RolloffFactor);
+		break;
+	}
+	return m_Volume * std::clamp(attenuation, 0.0f, 1.0f);
+}
+
+void AudioSource::applyLooping(bool enabled)
+{
+	m_IsLooping = enabled;
+	if (m_SourceID)
+	{
+		AL_CHECK(alSourcei(m_SourceID, AL_LOOPING, enabled));
+	}
 }
 
 void AudioSource::queueNewBuffers()
@@ -25,47 +146,144 @@ void AudioSource::queueNewBuffers()
 	// Empty
 }
 
-void AudioSource::play()
+void AudioSource::applyPlay()
 {
+	const bool isRestart = m_State == State::Stopped;
+	m_State = State::Playing;
+	if (isRestart)
+	{
+		m_ElapsedSeconds = 0.0f;
+	}
+
+	if (!m_SourceID)
+	{
+		// Starts right away if a voice is free, otherwise the next voice update decides
+		AudioSystem::GetSingleton()->requestVoice(this);
+		return;
+	}
+	if (isRestart)
+	{
+		AL_CHECK(alSourceRewind(m_SourceID));
+		detach();
+		AL_CHECK(alSourcei(m_SourceID, AL_BUFFER, 0));
+		attach(0.0f);
+	}
 	AL_CHECK(alSourcePlay(m_SourceID));
 }
 
-void AudioSource::pause()
+void AudioSource::applyPause()
 {
-	AL_CHECK(alSourcePause(m_SourceID));
+	if (m_State != State::Playing)
+	{
+		return;
+	}
+	m_State = State::Paused;
+	if (m_SourceID)
+	{
+		AL_CHECK(alSourcePause(m_SourceID));
+	}
 }
 
-void AudioSource::stop()
+void AudioSource::applyStop()
 {
-	AL_CHECK(alSourceStop(m_SourceID));
+	m_State = State::Stopped;
+	m_ElapsedSeconds = 0.0f;
+	m_PublishedSeconds = 0.0f;
+	if (m_SourceID)
+	{
+		AL_CHECK(alSourceStop(m_SourceID));
+	}
 }
 
-bool AudioSource::isPlaying() const
+void AudioSource::post(AudioCommand::Type type, const Vector3& vector, float value)
 {
-	ALenum state;
-	AL_CHECK(alGetSourcei(m_SourceID, AL_SOURCE_STATE, &state));
-	return state == AL_PLAYING;
+	AudioSystem::GetSingleton()->postCommand({ type, this, vector, value });
 }
 
-bool AudioSource::isPaused() const
+void AudioSource::execute(const AudioCommand& command)
 {
-	ALenum state;
-	AL_CHECK(alGetSourcei(m_SourceID, AL_SOURCE_STATE, &state));
-	return state == AL_PAUSED;
+	switch (command.type)
+	{
+	case AudioCommand::Type::Play:
+		applyPlay();
+		break;
+	case AudioCommand::Type::Pause:
+		applyPause();
+		break;
+	case AudioCommand::Type::Stop:
+		applyStop();
+		break;
+	case AudioCommand::Type::SetLooping:
+		applyLooping(command.value != 0.0f);
+		break;
+	case AudioCommand::Type::SetPosition:
+		m_Position = command.vector;
+		if (m_SourceID && m_IsAttenuated)
+		{
+			AL_CHECK(alSource3f(m_SourceID, AL_POSITION, m_Position.x, m_Position.y, m_Position.z));
+		}
+		break;
+	case AudioCommand::Type::SetAttenuated:
+		m_IsAttenuated = command.value != 0.0f;
+		if (m_SourceID)
+		{
+			applyParameters();
+		}
+		break;
+	case AudioCommand::Type::SetModel:
+		m_Model = (AttenuationModel)(int)command.value;
+		AL_CHECK(alDistanceModel((ALenum)m_Model));
+		break;
+	case AudioCommand::Type::SetRolloffFactor:
+		m_RolloffFactor = command.value;
+		if (m_SourceID)
+		{
+			AL_CHECK(alSourcef(m_SourceID, AL_ROLLOFF_FACTOR, m_RolloffFactor));
+		}
+		break;
+	case AudioCommand::Type::SetReferenceDistance:
+		m_ReferenceDistance = command.value;
+		if (m_SourceID)
+		{
+			AL_CHECK(alSourcef(m_SourceID, AL_REFERENCE_DISTANCE, m_ReferenceDistance));
+		}
+		break;
+	case AudioCommand::Type::SetMaxDistance:
+		m_MaxDistance = command.value;
+		if (m_SourceID)
+		{
+			AL_CHECK(alSourcef(m_SourceID, AL_MAX_DISTANCE, m_MaxDistance));
+		}
+		break;
+	case AudioCommand::Type::SetVolume:
+		m_Volume = command.value;
+		if (m_SourceID)
+		{
+			AL_CHECK(alSourcef(m_SourceID, AL_GAIN, m_Volume));
+		}
+		break;
+	case AudioCommand::Type::SetPriority:
+		m_Priority = command.value;
+		break;
+	default:
+		WARN("AudioSource: Unhandled audio command " + std::to_string((int)command.type));
+		break;
+	}
 }
 
-bool AudioSource::isStopped() const
+void AudioSource::play()
 {
-	ALenum state;
-	AL_CHECK(alGetSourcei(m_SourceID, AL_SOURCE_STATE, &state));
-	return state == AL_STOPPED;
+	post(AudioCommand::Type::Play);
 }
 
-bool AudioSource::isLooping() const
+void AudioSource::pause()
 {
-	ALenum state;
-	AL_CHECK(alGetSourcei(m_SourceID, AL_SOURCE_STATE, &state));
-	return (state == AL_LOOPING);
+	post(AudioCommand::Type::Pause);
+}
+
+void AudioSource::stop()
+{
+	post(AudioCommand::Type::Stop);
 }
 
 ALuint AudioSource::getSourceID() const
@@ -73,59 +291,80 @@ ALuint AudioSource::getSourceID() const
 	return m_SourceID;
 }
 
-void AudioSource::setPosition(Vector3& position)
+void AudioSource::setLooping(bool enabled)
+{
+	post(AudioCommand::Type::SetLooping, Vector3::Zero, enabled);
+}
+
+void AudioSource::setPosition(const Vector3& position)
 {
-	AL_CHECK(alSource3f(m_SourceID, AL_POSITION, position.x, position.y, position.z));
+	post(AudioCommand::Type::SetPosition, position);
+}
+
+void AudioSource::setAttenuated(bool enabled)
+{
+	post(AudioCommand::Type::SetAttenuated, Vector3::Zero, enabled);
 }
 
 void AudioSource::setRollOffFactor(ALfloat rolloffFactor)
 {
-	AL_CHECK(alSourcef(m_SourceID, AL_ROLLOFF_FACTOR, rolloffFactor));
+	post(AudioCommand::Type::SetRolloffFactor, Vector3::Zero, rolloffFactor);
 }
 
 void AudioSource::setReferenceDistance(ALfloat referenceDistance)
 {
-	AL_CHECK(alSourcef(m_SourceID, AL_REFERENCE_DISTANCE, referenceDistance));
+	post(AudioCommand::Type::SetReferenceDistance, Vector3::Zero, referenceDistance);
 }
 
 void AudioSource::setMaxDistance(ALfloat maxDistance)
 {
-	AL_CHECK(alSourcef(m_SourceID, AL_MAX_DISTANCE, maxDistance));
+	post(AudioCommand::Type::SetMaxDistance, Vector3::Zero, maxDistance);
+}
+
+void AudioSource::setVolume(float volume)
+{
+	post(AudioCommand::Type::SetVolume, Vector3::Zero, volume);
+}
+
+void AudioSource::setPriority(float priority)
+{
+	post(AudioCommand::Type::SetPriority, Vector3::Zero, priority);
 }
 
 void AudioSource::setModel(AudioSource::AttenuationModel distanceModel)
 {
-	AL_CHECK(alDistanceModel((ALenum)distanceModel));
+	post(AudioCommand::Type::SetModel, Vector3::Zero, (float)(int)distanceModel);
 }
 
 StaticAudioSource::StaticAudioSource(Ref<StaticAudioBuffer> audio)
     : AudioSource(false)
     , m_StaticAudio(audio)
 {
-	AL_CHECK(alSourcei(m_SourceID, AL_BUFFER, audio->getBuffer()));
+	post(AudioCommand::Type::AddSource);
 }
 
 StaticAudioSource::~StaticAudioSource()
 {
-	if (isPlaying())
-	{
-		stop();
-		unqueueBuffers();
-	}
+	AudioSystem::GetSingleton()->removeSource(this);
 }
 
-float StaticAudioSource::getElapsedTimeS()
+void StaticAudioSource::attach(float offsetSeconds)
 {
-	float pos = 0;
-	AL_CHECK(alGetSourcef(m_SourceID, AL_SEC_OFFSET, &pos));
-	return pos;
+	AL_CHECK(alSourcei(m_SourceID, AL_BUFFER, m_StaticAudio->getBuffer()));
+	AL_CHECK(alSourcei(m_SourceID, AL_LOOPING, m_IsLooping));
+	AL_CHECK(alSourcef(m_SourceID, AL_SEC_OFFSET, offsetSeconds));
+}
+
+void StaticAudioSource::detach()
+{
+	AL_CHECK(alSourcei(m_SourceID, AL_BUFFER, 0));
 }
 
-void StaticAudioSource::unqueueBuffers()
+float StaticAudioSource::getVoiceOffset() const
 {
-	ALint processed;
-	AL_CHECK(alGetSourcei(m_SourceID, AL_BUFFERS_PROCESSED, &processed));
-	AL_CHECK(alSourceUnqueueBuffers(m_SourceID, processed, &m_StaticAudio->getBuffer()));
+	float pos = 0;
+	AL_CHECK(alGetSourcef(m_SourceID, AL_SEC_OFFSET, &pos));
+	return pos;
 }
 
 float StaticAudioSource::getDuration() const
@@ -136,57 +375,89 @@ float StaticAudioSource::getDuration() const
 StreamingAudioSource::StreamingAudioSource(Ref<StreamingAudioBuffer> audio)
     : AudioSource(true)
     , m_StreamingAudio(audio)
-    , m_IsLooping(false)
 {
-	AL_CHECK(alSourceQueueBuffers(m_SourceID, m_StreamingAudio->getBufferQueueLength(), m_StreamingAudio->getBuffers()));
+	post(AudioCommand::Type::AddSource);
 }
 
 StreamingAudioSource::~StreamingAudioSource()
 {
-	if (isPlaying())
-	{
-		stop();
-		unqueueBuffers();
-	}
+	AudioSystem::GetSingleton()->removeSource(this);
+}
+
+void StreamingAudioSource::attach(float offsetSeconds)
+{
+	m_StreamingAudio->seek(offsetSeconds);
+	m_QueueStartSeconds = offsetSeconds;
+	int filled = m_StreamingAudio->fillBuffers(m_StreamingAudio->getBuffers(), MAX_BUFFER_QUEUE_LENGTH, isLooping());
+	AL_CHECK(alSourceQueueBuffers(m_SourceID, filled, m_StreamingAudio->getBuffers()));
+}
+
+void StreamingAudioSource::detach()
+{
+	// Detaching the buffer of a stopped source unqueues everything
+	AL_CHECK(alSourcei(m_SourceID, AL_BUFFER, 0));
+}
+
+float StreamingAudioSource::getVoiceOffset() const
+{
+	float pos = 0;
+	AL_CHECK(alGetSourcef(m_SourceID, AL_SEC_OFFSET, &pos));
+	const float duration = getDuration();
+	return duration > 0.0f ? std::fmod(m_QueueStartSeconds + pos, duration) : 0.0f;
 }
 
-bool StreamingAudioSource::isLooping() const
+bool StreamingAudioSource::hasVoiceEnded() const
 {
-	return m_IsLooping;
+	// A stopped source that still has buffers ran dry and is restarted by queueNewBuffers
+	int queued;
+	AL_CHECK(alGetSourcei(m_SourceID, AL_BUFFERS_QUEUED, &queued));
+	return queued == 0 && AudioSource::hasVoiceEnded();
 }
 
-void StreamingAudioSource::setLooping(bool enabled)
+void StreamingAudioSource::applyLooping(bool enabled)
 {
 	m_IsLooping = enabled;
 }
 
 void StreamingAudioSource::queueNewBuffers()
 {
+	if (!m_SourceID || m_State != State::Playing)
+	{
+		return;
+	}
+
 	int numUsedUp;
 	AL_CHECK(alGetSourcei(m_SourceID, AL_BUFFERS_PROCESSED, &numUsedUp));
 
 	if (numUsedUp > 0)
 	{
-		AL_CHECK(alSourceUnqueueBuffers(m_SourceID, numUsedUp, m_StreamingAudio->getBuffers()));
-		m_StreamingAudio->loadNewBuffers(numUsedUp, isLooping());
-		AL_CHECK(alSourceQueueBuffers(m_SourceID, numUsedUp, m_StreamingAudio->getBuffers()));
+		ALuint buffers[MAX_BUFFER_QUEUE_LENGTH];
+		AL_CHECK(alSourceUnqueueBuffers(m_SourceID, numUsedUp, buffers));
+		for (int i = 0; i < numUsedUp; i++)
+		{
+			m_QueueStartSeconds += m_StreamingAudio->getBufferDuration(buffers[i]);
+		}
+		int filled = m_StreamingAudio->fillBuffers(buffers, numUsedUp, isLooping());
+		if (filled > 0)
+		{
+			AL_CHECK(alSourceQueueBuffers(m_SourceID, filled, buffers));
+		}
+	}
 
-		static ALint val;
-		AL_CHECK(alGetSourcei(m_SourceID, AL_SOURCE_STATE, &val));
-		if (val != AL_PLAYING)
+	// A source that ran out of buffers before they were refilled stops by itself
+	ALenum state;
+	AL_CHECK(alGetSourcei(m_SourceID, AL_SOURCE_STATE, &state));
+	if (state != AL_PLAYING)
+	{
+		int queued;
+		AL_CHECK(alGetSourcei(m_SourceID, AL_BUFFERS_QUEUED, &queued));
+		if (queued > 0)
 		{
 			AL_CHECK(alSourcePlay(m_SourceID));
 		}
 	}
 }
 
-void StreamingAudioSource::unqueueBuffers()
-{
-	int numUsedUp;
-	AL_CHECK(alGetSourcei(m_SourceID, AL_BUFFERS_PROCESSED, &numUsedUp));
-	AL_CHECK(alSourceUnqueueBuffers(m_SourceID, numUsedUp, m_StreamingAudio->getBuffers()));
-}
-
 float StreamingAudioSource::getDuration() const
 {
 	return m_StreamingAudio->getAudioFile()->getDuration();
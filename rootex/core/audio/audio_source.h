@@ -1,7 +1,11 @@
 #pragma once
 
+#include "common/types.h"
+
 #include "al.h"
 
+#include <cfloat>
+
 class StreamingAudioBuffer;
 class StaticAudioBuffer;
 
@@ -11,17 +15,41 @@ typedef float ALfloat;
 /// Convert minutes to seconds
 #define MIN_TO_S 60.0f
 
-/// An interface for an audio source in the game world.
-class AudioSource
+class AudioSource;
+
+/// A change made by gameplay, applied later on the audio thread
+struct AudioCommand
 {
-protected:
-	ALuint m_SourceID;
+	enum class Type
+	{
+		AddSource,
+		Play,
+		Pause,
+		Stop,
+		SetLooping,
+		SetPosition,
+		SetAttenuated,
+		SetModel,
+		SetRolloffFactor,
+		SetReferenceDistance,
+		SetMaxDistance,
+		SetVolume,
+		SetPriority,
+		SetListenerPosition
+	};
 
-	/// RTTI for storing if the audio buffer is being streamed
-	bool m_IsStreaming;
-	AudioSource(bool isStreaming);
-	virtual ~AudioSource();
+	Type type;
+	AudioSource* source = nullptr;
+	Vector3 vector;
+	float value = 0.0f;
+};
 
+/// An interface for an audio source in the game world.
+/// A source only holds an OpenAL source (a voice) while the AudioSystem thinks it is worth hearing.
+/// Without one it is virtual: its playback position keeps advancing so it resumes in the right place when it gets a voice back.
+/// Everything except the public setters and getters runs on the audio thread. Setters post commands to it.
+class AudioSource
+{
 public:
 	/// Defines all attenuation models provided by OpenAL
 	enum class AttenuationModel
@@ -34,7 +62,71 @@ public:
 		ExponentialClamped = AL_EXPONENT_DISTANCE_CLAMPED
 	};
 
-	virtual void setLooping(bool enabled);
+protected:
+	enum class State
+	{
+		Stopped,
+		Playing,
+		Paused
+	};
+
+	/// Voice held by this source, 0 while it is virtual
+	ALuint m_SourceID = 0;
+
+	/// RTTI for storing if the audio buffer is being streamed
+	bool m_IsStreaming;
+
+	/// Playback state kept outside OpenAL so it survives losing the voice. Written only by the audio thread.
+	Atomic<State> m_State = State::Stopped;
+	float m_ElapsedSeconds = 0.0f;
+	/// Playback position last seen by the audio thread, for gameplay to read
+	Atomic<float> m_PublishedSeconds = 0.0f;
+	/// Written by the audio thread, atomic so gameplay and Lua can read them
+	Atomic<bool> m_IsLooping = false;
+	float m_Volume = 1.0f;
+	Atomic<float> m_Priority = 1.0f;
+
+	bool m_IsAttenuated = false;
+	Vector3 m_Position;
+	AttenuationModel m_Model = AttenuationModel::InverseClamped;
+	ALfloat m_RolloffFactor = 1.0f;
+	ALfloat m_ReferenceDistance = 1.0f;
+	ALfloat m_MaxDistance = FLT_MAX;
+
+	AudioSource(bool isStreaming);
+	virtual ~AudioSource();
+
+	/// Attach audio to the voice, positioned at a playback time
+	virtual void attach(float offsetSeconds) = 0;
+	/// Detach all audio from the stopped voice
+	virtual void detach() = 0;
+	/// Playback position of the voice
+	virtual float getVoiceOffset() const = 0;
+	/// True once the voice has played to the end of audio that does not loop
+	virtual bool hasVoiceEnded() const;
+
+	void applyParameters();
+	virtual void applyLooping(bool enabled);
+	void applyPlay();
+	void applyPause();
+	void applyStop();
+	void post(AudioCommand::Type type, const Vector3& vector = Vector3::Zero, float value = 0.0f);
+
+public:
+	/// Apply a command posted for this source. Called on the audio thread.
+	void execute(const AudioCommand& command);
+
+	/// Start using a voice, continuing from the current playback position
+	void bindVoice(ALuint voice);
+	/// Give up the voice and become virtual. Returns the voice.
+	ALuint releaseVoice();
+	bool hasVoice() const { return m_SourceID != 0; }
+
+	/// Detect the end of playback and advance the position of virtual sources
+	void updatePlayback(float deltaSeconds);
+	/// Loudness at the listener from volume and distance attenuation
+	float getAudibility(const Vector3& listenerPosition) const;
+
 	/// Queue new buffers to the audio card if possible.
 	virtual void queueNewBuffers();
 
@@ -42,21 +134,30 @@ public:
 	void pause();
 	void stop();
 
-	bool isPlaying() const;
-	bool isPaused() const;
-	bool isStopped() const;
-	virtual bool isLooping() const;
+	/// Play state as of the last audio thread update, so it trails play() and stop() by a few milliseconds
+	bool isPlaying() const { return m_State == State::Playing; }
+	bool isPaused() const { return m_State == State::Paused; }
+	bool isStopped() const { return m_State == State::Stopped; }
+	bool isLooping() const { return m_IsLooping; }
 	ALuint getSourceID() const;
 	/// Get audio duration in seconds.
 	virtual float getDuration() const = 0;
+	/// Get playback position in seconds as of the last audio thread update.
+	float getElapsedTimeS() const { return m_PublishedSeconds; }
 
-	void setPosition(Vector3& position);
+	void setLooping(bool enabled);
+	void setPosition(const Vector3& position);
+	void setAttenuated(bool enabled);
 	void setModel(AttenuationModel distanceModel);
 	/// Roll Off Factor: The rate of change of attenuation
 	void setRollOffFactor(ALfloat rolloffFactor);
 	/// Reference Distance: Distance until which clamping occurs
 	void setReferenceDistance(ALfloat referenceDistance);
 	void setMaxDistance(ALfloat maxDistance);
+	void setVolume(float volume);
+	/// Priority: Weight on audibility when sources compete for voices
+	void setPriority(float priority);
+	float getPriority() const { return m_Priority; }
 };
 
 /// An audio source that uses StaticAudioBuffer.
@@ -64,31 +165,38 @@ class StaticAudioSource : public AudioSource
 {
 	Ref<StaticAudioBuffer> m_StaticAudio;
 
+	void attach(float offsetSeconds) override;
+	void detach() override;
+	float getVoiceOffset() const override;
+
 public:
 	StaticAudioSource(Ref<StaticAudioBuffer> audio);
 	~StaticAudioSource();
 
-	void unqueueBuffers();
-
 	float getDuration() const override;
-	float getElapsedTimeS();
 };
 
 /// An audio source that uses StreamingAudioBuffer.
+/// Buffers are requeued by the audio thread at its own pace, independent of the frame rate.
 class StreamingAudioSource : public AudioSource
 {
 	Ref<StreamingAudioBuffer> m_StreamingAudio;
+	/// Playback position at the start of the first queued buffer
+	float m_QueueStartSeconds = 0.0f;
 
-	bool m_IsLooping;
+	void attach(float offsetSeconds) override;
+	void detach() override;
+	float getVoiceOffset() const override;
+	bool hasVoiceEnded() const override;
+	/// Looping is done by the decoder instead of OpenAL
+	void applyLooping(bool enabled) override;
 
 public:
 	StreamingAudioSource(Ref<StreamingAudioBuffer> audio);
 	~StreamingAudioSource();
 
-	bool isLooping() const override;
-	void setLooping(bool enabled) override;
+	/// Refill and requeue buffers that have finished playing. Called on the audio thread.
 	void queueNewBuffers() override;
-	void unqueueBuffers();
 
 	virtual float getDuration() const override;
 };
@@ -6,12 +6,15 @@ void StaticAudioBuffer::initializeBuffers()
 {
 	PANIC(m_AudioFile->getType() != ResourceFile::Type::Audio, "AudioSystem: Trying to load a non-WAV file in a sound buffer");
 
+	// OpenAL keeps its own copy, the decoded data is only needed until it is uploaded
+	Vector<char> audioData = m_AudioFile->decodeAll();
+
 	AL_CHECK(alGenBuffers(1, &m_BufferID));
 	AL_CHECK(alBufferData(
 	    m_BufferID,
 	    m_AudioFile->getFormat(),
-	    m_AudioFile->getAudioData(),
-	    m_AudioFile->getAudioDataSize(),
+	    audioData.data(),
+	    audioData.size(),
 	    m_AudioFile->getFrequency()));
 }
 
@@ -5,77 +5,70 @@
 
 void StreamingAudioBuffer::initializeBuffers()
 {
-	PANIC(m_AudioFile->getType() != ResourceFile::Type::Audio, "AudioSystem: Trying to load a non-WAV file in a sound buffer");
+	PANIC(m_AudioFile->getType() != ResourceFile::Type::Audio, "AudioSystem: Trying to load a non-audio file in a sound buffer");
 
-	AL_CHECK(alGenBuffers(BUFFER_COUNT, m_Buffers));
+	AL_CHECK(alGenBuffers(MAX_BUFFER_QUEUE_LENGTH, m_Buffers));
 
-	ALsizei blockAlign = m_AudioFile->getChannels() * (m_AudioFile->getBitDepth() / 8.0);
-
-	m_BufferSize = m_AudioFile->getAudioDataSize() / BUFFER_COUNT;
-	m_BufferSize -= (m_BufferSize % blockAlign);
-	m_BufferCursor = m_AudioFile->getAudioData();
-	m_BufferEnd = m_BufferCursor + m_AudioFile->getAudioDataSize();
-
-	int i = 0;
-	while (i < MAX_BUFFER_QUEUE_LENGTH)
-	{
-		if (m_BufferCursor > m_AudioFile->getAudioData() + m_AudioFile->getAudioDataSize())
-		{
-			break;
-		}
-		AL_CHECK(alBufferData(
-		    m_Buffers[i],
-		    m_AudioFile->getFormat(),
-		    (const ALvoid*)m_BufferCursor,
-		    (ALsizei)m_BufferSize,
-		    m_AudioFile->getFrequency()));
-
-		m_BufferCursor += m_BufferSize;
-		i++;
-	}
-
-	m_BufferQueueLength = i;
+	m_Decoder = m_AudioFile->createDecoder();
+	m_DecodeBuffer.resize(STREAMING_BUFFER_SIZE);
 }
 
 void StreamingAudioBuffer::destroyBuffers()
 {
-	AL_CHECK(alDeleteBuffers(BUFFER_COUNT, m_Buffers));
+	AL_CHECK(alDeleteBuffers(MAX_BUFFER_QUEUE_LENGTH, m_Buffers));
 }
 
-void StreamingAudioBuffer::loadNewBuffers(int count, bool isLooping)
+int StreamingAudioBuffer::fillBuffers(ALuint* buffers, int count, bool isLooping)
 {
-	for (int i = 0; i < count; i++)
+	if (!m_Decoder)
 	{
-		m_BufferEnd = m_BufferCursor + m_BufferSize;
+		return 0;
+	}
 
-		if (m_BufferCursor == m_AudioFile->getAudioData() + m_AudioFile->getAudioDataSize()) // Data has exhausted
+	int filled = 0;
+	while (filled < count)
+	{
+		unsigned int size = m_Decoder->decode(m_DecodeBuffer.data(), m_DecodeBuffer.size());
+		if (size < m_DecodeBuffer.size() && isLooping) // Wrap around to fill the rest of the buffer
 		{
-			if (isLooping) // Re-queue if looping
-			{
-				m_BufferCursor = m_AudioFile->getAudioData();
-			}
-			else
-			{
-				break;
-			}
+			m_Decoder->rewind();
+			size += m_Decoder->decode(m_DecodeBuffer.data() + size, m_DecodeBuffer.size() - size);
 		}
-
-		if (m_BufferEnd >= m_AudioFile->getAudioData() + m_AudioFile->getAudioDataSize()) // Data not left enough to entirely fill the next buffer
+		if (size == 0) // Data has exhausted
 		{
-			m_BufferEnd = m_AudioFile->getAudioData() + m_AudioFile->getAudioDataSize(); // Only take what you can
+			break;
 		}
 
 		AL_CHECK(alBufferData(
-		    m_Buffers[i],
-		    m_AudioFile->getFormat(),
-		    m_BufferCursor,
-		    m_BufferEnd - m_BufferCursor,
-		    m_AudioFile->getFrequency()));
+		    buffers[filled],
+		    m_Decoder->getFormat(),
+		    m_DecodeBuffer.data(),
+		    size,
+		    m_Decoder->getFrequency()));
+		filled++;
+	}
+	return filled;
+}
 
-		m_BufferCursor = m_BufferEnd;
+void StreamingAudioBuffer::seek(float seconds)
+{
+	if (m_Decoder)
+	{
+		m_Decoder->seek((size_t)(seconds * m_Decoder->getFrequency()));
 	}
 }
 
+float StreamingAudioBuffer::getBufferDuration(ALuint buffer) const
+{
+	if (!m_Decoder)
+	{
+		return 0.0f;
+	}
+	ALint size = 0;
+	AL_CHECK(alGetBufferi(buffer, AL_SIZE, &size));
+	return (float)size / (m_Decoder->getFrameSize() * m_Decoder->getFrequency());
+}
+
 StreamingAudioBuffer::StreamingAudioBuffer(Ref<AudioResourceFile> audioFile)
     : AudioBuffer(audioFile)
 {
@@ -91,8 +84,3 @@ ALuint* StreamingAudioBuffer::getBuffers()
 {
 	return m_Buffers;
 }
-
-int StreamingAudioBuffer::getBufferQueueLength()
-{
-	return m_BufferQueueLength;
-}
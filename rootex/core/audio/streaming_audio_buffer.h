@@ -1,22 +1,22 @@
 #pragma once
 
-/// Number of equal slices that an audio buffer is cut down into.
-#define BUFFER_COUNT 50
-/// Maximum number of buffers queued at once.
-#define MAX_BUFFER_QUEUE_LENGTH BUFFER_COUNT / 25
+/// Number of OpenAL buffers a stream cycles through.
+#define MAX_BUFFER_QUEUE_LENGTH 4
+/// Bytes of PCM decoded into each streaming buffer.
+#define STREAMING_BUFFER_SIZE 65536
 
 #include "audio_buffer.h"
+#include "audio_decoder.h"
 #include "framework/systems/audio_system.h"
 
-/// An audio buffer that is streamed to the audio card instead of sent entirely at once. Allows faster startup for large audio files.
+/// An audio buffer that is decoded a few buffers ahead of playback instead of being held in memory whole.
+/// Buffers are filled when a source gets a voice and refilled by the audio thread as they finish playing.
 class StreamingAudioBuffer : public AudioBuffer
 {
-	ALuint m_Buffers[BUFFER_COUNT];
-	ALsizei m_BufferSize;
+	ALuint m_Buffers[MAX_BUFFER_QUEUE_LENGTH];
 
-	const char* m_BufferCursor;
-	int m_BufferQueueLength;
-	const char* m_BufferEnd;
+	Ptr<AudioDecoder> m_Decoder;
+	Vector<char> m_DecodeBuffer;
 
 	void initializeBuffers() override;
 	void destroyBuffers() override;
@@ -25,8 +25,12 @@ public:
 	StreamingAudioBuffer(Ref<AudioResourceFile> audioFile);
 	~StreamingAudioBuffer();
 
-	void loadNewBuffers(int count, bool isLooping);
+	/// Decode the next part of the audio into buffers. Returns how many were filled, fewer than count once a stream that does not loop has ended.
+	int fillBuffers(ALuint* buffers, int count, bool isLooping);
+	/// Continue decoding from a playback position.
+	void seek(float seconds);
+	/// Playback time covered by an OpenAL buffer filled by this stream
+	float getBufferDuration(ALuint buffer) const;
 
 	ALuint* getBuffers();
-	int getBufferQueueLength();
 };
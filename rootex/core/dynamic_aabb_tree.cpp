@@ -0,0 +1,558 @@
+#include "dynamic_aabb_tree.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace
+{
+float SurfaceArea(const Vector3& min, const Vector3& max)
+{
+	const Vector3 d = max - min;
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+bool Overlaps(const Vector3& minA, const Vector3& maxA, const Vector3& minB, const Vector3& maxB)
+{
+	return minA.x <= maxB.x && maxA.x >= minB.x && minA.y <= maxB.y && maxA.y >= minB.y && minA.z <= maxB.z && maxA.z >= minB.z;
+}
+
+bool Contains(const Vector3& outerMin, const Vector3& outerMax, const Vector3& min, const Vector3& max)
+{
+	return outerMin.x <= min.x && outerMin.y <= min.y && outerMin.z <= min.z && max.x <= outerMax.x && max.y <= outerMax.y && max.z <= outerMax.z;
+}
+
+float DistanceSquared(const Vector3& point, const Vector3& min, const Vector3& max)
+{
+	const Vector3 closest = Vector3::Min(Vector3::Max(point, min), max);
+	return Vector3::DistanceSquared(point, closest);
+}
+
+/// Entry and exit distances of a ray through a box. The box is missed if entry > exit.
+void RayBox(const Vector3& origin, const Vector3& inverseDirection, const Vector3& min, const Vector3& max, float& entry, float& exit)
+{
+	const float x1 = (min.x - origin.x) * inverseDirection.x;
+	const float x2 = (max.x - origin.x) * inverseDirection.x;
+	const float y1 = (min.y - origin.y) * inverseDirection.y;
+	const float y2 = (max.y - origin.y) * inverseDirection.y;
+	const float z1 = (min.z - origin.z) * inverseDirection.z;
+	const float z2 = (max.z - origin.z) * inverseDirection.z;
+	entry = std::max({ std::min(x1, x2), std::min(y1, y2), std::min(z1, z2) });
+	exit = std::min({ std::max(x1, x2), std::max(y1, y2), std::max(z1, z2) });
+}
+
+enum class PlaneSide
+{
+	Outside,
+	Intersecting,
+	Inside
+};
+
+PlaneSide ClassifyBox(const Vector4 planes[6], const Vector3& min, const Vector3& max)
+{
+	const Vector3 center = (min + max) * 0.5f;
+	const Vector3 extents = (max - min) * 0.5f;
+	PlaneSide side = PlaneSide::Inside;
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4& plane = planes[i];
+		const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		const float radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+		if (distance < -radius)
+		{
+			return PlaneSide::Outside;
+		}
+		if (distance < radius)
+		{
+			side = PlaneSide::Intersecting;
+		}
+	}
+	return side;
+}
+}
+
+int DynamicAABBTree::allocateNode()
+{
+	if (m_FreeList == AABB_TREE_NULL_NODE)
+	{
+		m_Nodes.push_back({});
+		m_Nodes.back().height = 0;
+		return m_Nodes.size() - 1;
+	}
+
+	const int node = m_FreeList;
+	m_FreeList = m_Nodes[node].parent;
+	m_Nodes[node] = {};
+	m_Nodes[node].height = 0;
+	return node;
+}
+
+void DynamicAABBTree::freeNode(int node)
+{
+	m_Nodes[node].parent = m_FreeList;
+	m_Nodes[node].height = -1;
+	m_Nodes[node].userData = nullptr;
+	m_FreeList = node;
+}
+
+int DynamicAABBTree::createProxy(const Vector3& min, const Vector3& max, void* userData, TypeMask types)
+{
+	const int proxy = allocateNode();
+	Node& node = m_Nodes[proxy];
+	const Vector3 margin = { AABB_TREE_FAT_MARGIN, AABB_TREE_FAT_MARGIN, AABB_TREE_FAT_MARGIN };
+	node.tightMin = min;
+	node.tightMax = max;
+	node.min = min - margin;
+	node.max = max + margin;
+	node.userData = userData;
+	node.types = types;
+	insertLeaf(proxy);
+	m_ProxyCount++;
+	return proxy;
+}
+
+void DynamicAABBTree::destroyProxy(int proxy)
+{
+	removeLeaf(proxy);
+	freeNode(proxy);
+	m_ProxyCount--;
+}
+
+bool DynamicAABBTree::moveProxy(int proxy, const Vector3& min, const Vector3& max)
+{
+	Node& node = m_Nodes[proxy];
+	const Vector3 displacement = (min + max - node.tightMin - node.tightMax) * 0.5f;
+	node.tightMin = min;
+	node.tightMax = max;
+	if (Contains(node.min, node.max, min, max))
+	{
+		return false;
+	}
+
+	// Grow the fat box towards the direction of the move, since the proxy is likely to keep moving that way
+	const Vector3 margin = { AABB_TREE_FAT_MARGIN, AABB_TREE_FAT_MARGIN, AABB_TREE_FAT_MARGIN };
+	removeLeaf(proxy);
+	Node& moved = m_Nodes[proxy];
+	moved.min = min - margin + Vector3::Min(displacement, Vector3::Zero);
+	moved.max = max + margin + Vector3::Max(displacement, Vector3::Zero);
+	insertLeaf(proxy);
+	return true;
+}
+
+void DynamicAABBTree::setTypes(int proxy, TypeMask types)
+{
+	m_Nodes[proxy].types = types;
+	refitFrom(m_Nodes[proxy].parent);
+}
+
+void DynamicAABBTree::clear()
+{
+	m_Nodes.clear();
+	m_Root = AABB_TREE_NULL_NODE;
+	m_FreeList = AABB_TREE_NULL_NODE;
+	m_ProxyCount = 0;
+}
+
+void DynamicAABBTree::getBounds(int proxy, Vector3& min, Vector3& max) const
+{
+	min = m_Nodes[proxy].tightMin;
+	max = m_Nodes[proxy].tightMax;
+}
+
+void DynamicAABBTree::insertLeaf(int leaf)
+{
+	if (m_Root == AABB_TREE_NULL_NODE)
+	{
+		m_Root = leaf;
+		m_Nodes[leaf].parent = AABB_TREE_NULL_NODE;
+		return;
+	}
+
+	// Walk down to the sibling that grows the total surface area the least
+	const Vector3 leafMin = m_Nodes[leaf].min;
+	const Vector3 leafMax = m_Nodes[leaf].max;
+	int index = m_Root;
+	while (!m_Nodes[index].isLeaf())
+	{
+		const Node& node = m_Nodes[index];
+		const float area = SurfaceArea(node.min, node.max);
+		const float combinedArea = SurfaceArea(Vector3::Min(node.min, leafMin), Vector3::Max(node.max, leafMax));
+		// Cost of making a new parent for this node and the leaf
+		const float cost = 2.0f * combinedArea;
+		// Minimum cost of pushing the leaf further down
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [this, &leafMin, &leafMax, inheritanceCost](int child) {
+			const Node& childNode = m_Nodes[child];
+			const float newArea = SurfaceArea(Vector3::Min(childNode.min, leafMin), Vector3::Max(childNode.max, leafMax));
+			if (childNode.isLeaf())
+			{
+				return newArea + inheritanceCost;
+			}
+			return newArea - SurfaceArea(childNode.min, childNode.max) + inheritanceCost;
+		};
+		const float leftCost = descendCost(node.left);
+		const float rightCost = descendCost(node.right);
+
+		if (cost < leftCost && cost < rightCost)
+		{
+			break;
+		}
+		index = leftCost < rightCost ? node.left : node.right;
+	}
+
+	const int sibling = index;
+	const int oldParent = m_Nodes[sibling].parent;
+	const int newParent = allocateNode();
+	m_Nodes[newParent].parent = oldParent;
+	m_Nodes[newParent].left = sibling;
+	m_Nodes[newParent].right = leaf;
+	m_Nodes[sibling].parent = newParent;
+	m_Nodes[leaf].parent = newParent;
+
+	if (oldParent == AABB_TREE_NULL_NODE)
+	{
+		m_Root = newParent;
+	}
+	else if (m_Nodes[oldParent].left == sibling)
+	{
+		m_Nodes[oldParent].left = newParent;
+	}
+	else
+	{
+		m_Nodes[oldParent].right = newParent;
+	}
+
+	refitFrom(newParent);
+}
+
+void DynamicAABBTree::removeLeaf(int leaf)
+{
+	if (leaf == m_Root)
+	{
+		m_Root = AABB_TREE_NULL_NODE;
+		return;
+	}
+
+	const int parent = m_Nodes[leaf].parent;
+	const int grandParent = m_Nodes[parent].parent;
+	const int sibling = m_Nodes[parent].left == leaf ? m_Nodes[parent].right : m_Nodes[parent].left;
+
+	if (grandParent == AABB_TREE_NULL_NODE)
+	{
+		m_Root = sibling;
+		m_Nodes[sibling].parent = AABB_TREE_NULL_NODE;
+	}
+	else
+	{
+		if (m_Nodes[grandParent].left == parent)
+		{
+			m_Nodes[grandParent].left = sibling;
+		}
+		else
+		{
+			m_Nodes[grandParent].right = sibling;
+		}
+		m_Nodes[sibling].parent = grandParent;
+		refitFrom(grandParent);
+	}
+	freeNode(parent);
+	m_Nodes[leaf].parent = AABB_TREE_NULL_NODE;
+}
+
+void DynamicAABBTree::refitFrom(int node)
+{
+	while (node != AABB_TREE_NULL_NODE)
+	{
+		node = balance(node);
+		Node& current = m_Nodes[node];
+		const Node& left = m_Nodes[current.left];
+		const Node& right = m_Nodes[current.right];
+		current.min = Vector3::Min(left.min, right.min);
+		current.max = Vector3::Max(left.max, right.max);
+		current.types = left.types | right.types;
+		current.height = 1 + std::max(left.height, right.height);
+		node = current.parent;
+	}
+}
+
+int DynamicAABBTree::balance(int a)
+{
+	Node& nodeA = m_Nodes[a];
+	if (nodeA.isLeaf() || nodeA.height < 2)
+	{
+		return a;
+	}
+
+	const int b = nodeA.left;
+	const int c = nodeA.right;
+	const int difference = m_Nodes[c].height - m_Nodes[b].height;
+	if (difference >= -1 && difference <= 1)
+	{
+		return a;
+	}
+
+	// Lift the taller child up to replace a, and hang a under it in place of its shorter child
+	const int up = difference > 1 ? c : b;
+	Node& nodeUp = m_Nodes[up];
+	const int upLeft = nodeUp.left;
+	const int upRight = nodeUp.right;
+
+	nodeUp.left = a;
+	nodeUp.parent = nodeA.parent;
+	nodeA.parent = up;
+	if (nodeUp.parent == AABB_TREE_NULL_NODE)
+	{
+		m_Root = up;
+	}
+	else if (m_Nodes[nodeUp.parent].left == a)
+	{
+		m_Nodes[nodeUp.parent].left = up;
+	}
+	else
+	{
+		m_Nodes[nodeUp.parent].right = up;
+	}
+
+	// The taller grandchild stays under the lifted node, the shorter one takes its place under a
+	const bool isLeftTaller = m_Nodes[upLeft].height > m_Nodes[upRight].height;
+	const int keep = isLeftTaller ? upLeft : upRight;
+	const int give = isLeftTaller ? upRight : upLeft;
+	nodeUp.right = keep;
+	if (difference > 1)
+	{
+		nodeA.right = give;
+	}
+	else
+	{
+		nodeA.left = give;
+	}
+	m_Nodes[give].parent = a;
+	m_Nodes[keep].parent = up;
+
+	const Node& aLeft = m_Nodes[nodeA.left];
+	const Node& aRight = m_Nodes[nodeA.right];
+	nodeA.min = Vector3::Min(aLeft.min, aRight.min);
+	nodeA.max = Vector3::Max(aLeft.max, aRight.max);
+	nodeA.types = aLeft.types | aRight.types;
+	nodeA.height = 1 + std::max(aLeft.height, aRight.height);
+	return up;
+}
+
+void DynamicAABBTree::collectLeaves(int node, TypeMask types, Vector<int>& result) const
+{
+	const size_t base = m_Stack.size();
+	m_Stack.push_back(node);
+	while (m_Stack.size() > base)
+	{
+		const int index = m_Stack.back();
+		m_Stack.pop_back();
+		const Node& current = m_Nodes[index];
+		if (!(current.types & types))
+		{
+			continue;
+		}
+		if (current.isLeaf())
+		{
+			result.push_back(index);
+			continue;
+		}
+		m_Stack.push_back(current.left);
+		m_Stack.push_back(current.right);
+	}
+}
+
+void DynamicAABBTree::queryBox(const Vector3& min, const Vector3& max, TypeMask types, Vector<int>& result) const
+{
+	result.clear();
+	if (m_Root == AABB_TREE_NULL_NODE)
+	{
+		return;
+	}
+
+	m_Stack.clear();
+	m_Stack.push_back(m_Root);
+	while (!m_Stack.empty())
+	{
+		const Node& node = m_Nodes[m_Stack.back()];
+		const int index = m_Stack.back();
+		m_Stack.pop_back();
+		if (!(node.types & types) || !Overlaps(node.min, node.max, min, max))
+		{
+			continue;
+		}
+		if (node.isLeaf())
+		{
+			if (Overlaps(node.tightMin, node.tightMax, min, max))
+			{
+				result.push_back(index);
+			}
+			continue;
+		}
+		m_Stack.push_back(node.left);
+		m_Stack.push_back(node.right);
+	}
+}
+
+void DynamicAABBTree::querySphere(const Vector3& center, float radius, TypeMask types, Vector<int>& result) const
+{
+	result.clear();
+	if (m_Root == AABB_TREE_NULL_NODE)
+	{
+		return;
+	}
+
+	const float radiusSquared = radius * radius;
+	m_Stack.clear();
+	m_Stack.push_back(m_Root);
+	while (!m_Stack.empty())
+	{
+		const int index = m_Stack.back();
+		const Node& node = m_Nodes[index];
+		m_Stack.pop_back();
+		if (!(node.types & types) || DistanceSquared(center, node.min, node.max) > radiusSquared)
+		{
+			continue;
+		}
+		if (node.isLeaf())
+		{
+			if (DistanceSquared(center, node.tightMin, node.tightMax) <= radiusSquared)
+			{
+				result.push_back(index);
+			}
+			continue;
+		}
+		m_Stack.push_back(node.left);
+		m_Stack.push_back(node.right);
+	}
+}
+
+void DynamicAABBTree::queryFrustum(const Vector4 planes[6], TypeMask types, Vector<int>& result) const
+{
+	result.clear();
+	if (m_Root == AABB_TREE_NULL_NODE)
+	{
+		return;
+	}
+
+	m_Stack.clear();
+	m_Stack.push_back(m_Root);
+	while (!m_Stack.empty())
+	{
+		const int index = m_Stack.back();
+		const Node& node = m_Nodes[index];
+		m_Stack.pop_back();
+		if (!(node.types & types))
+		{
+			continue;
+		}
+		if (node.isLeaf())
+		{
+			if (ClassifyBox(planes, node.tightMin, node.tightMax) != PlaneSide::Outside)
+			{
+				result.push_back(index);
+			}
+			continue;
+		}
+
+		const PlaneSide side = ClassifyBox(planes, node.min, node.max);
+		if (side == PlaneSide::Outside)
+		{
+			continue;
+		}
+		if (side == PlaneSide::Inside)
+		{
+			// Everything below is inside as well, so the remaining planes need not be tested
+			collectLeaves(index, types, result);
+			continue;
+		}
+		m_Stack.push_back(node.left);
+		m_Stack.push_back(node.right);
+	}
+}
+
+int DynamicAABBTree::raycast(const Vector3& origin, const Vector3& direction, float maxDistance, TypeMask types, float& hitDistance) const
+{
+	int hit = AABB_TREE_NULL_NODE;
+	hitDistance = maxDistance;
+	if (m_Root == AABB_TREE_NULL_NODE)
+	{
+		return hit;
+	}
+
+	// Division by a zero component gives an infinity, which the slab test handles
+	const Vector3 inverseDirection = { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+	m_Stack.clear();
+	m_Stack.push_back(m_Root);
+	while (!m_Stack.empty())
+	{
+		const int index = m_Stack.back();
+		const Node& node = m_Nodes[index];
+		m_Stack.pop_back();
+		if (!(node.types & types))
+		{
+			continue;
+		}
+
+		float entry;
+		float exit;
+		if (node.isLeaf())
+		{
+			RayBox(origin, inverseDirection, node.tightMin, node.tightMax, entry, exit);
+			entry = std::max(entry, 0.0f);
+			if (entry <= exit && entry <= hitDistance)
+			{
+				hit = index;
+				hitDistance = entry;
+			}
+			continue;
+		}
+
+		RayBox(origin, inverseDirection, node.min, node.max, entry, exit);
+		if (entry <= exit && exit >= 0.0f && entry <= hitDistance)
+		{
+			m_Stack.push_back(node.left);
+			m_Stack.push_back(node.right);
+		}
+	}
+	return hit;
+}
+
+void DynamicAABBTree::queryNearest(const Vector3& point, unsigned int count, TypeMask types, Vector<int>& result) const
+{
+	result.clear();
+	if (m_Root == AABB_TREE_NULL_NODE || count == 0)
+	{
+		return;
+	}
+
+	// Best first search. A parent box is never farther than anything below it, so leaves come out in order of distance.
+	auto distance = [this, &point](int index) {
+		const Node& node = m_Nodes[index];
+		return node.isLeaf() ? DistanceSquared(point, node.tightMin, node.tightMax) : DistanceSquared(point, node.min, node.max);
+	};
+	typedef Pair<float, int> Entry;
+	std::priority_queue<Entry, Vector<Entry>, std::greater<Entry>> open;
+	if (m_Nodes[m_Root].types & types)
+	{
+		open.push({ distance(m_Root), m_Root });
+	}
+	while (!open.empty() && result.size() < count)
+	{
+		const int index = open.top().second;
+		open.pop();
+		const Node& node = m_Nodes[index];
+		if (node.isLeaf())
+		{
+			result.push_back(index);
+			continue;
+		}
+		if (m_Nodes[node.left].types & types)
+		{
+			open.push({ distance(node.left), node.left });
+		}
+		if (m_Nodes[node.right].types & types)
+		{
+			open.push({ distance(node.right), node.right });
+		}
+	}
+}
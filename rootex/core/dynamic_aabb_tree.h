@@ -0,0 +1,88 @@
+#pragma once
+
+#include "common/types.h"
+
+#define AABB_TREE_NULL_NODE -1
+/// Leaf boxes are grown by this much on every side so small movements do not need a reinsert
+#define AABB_TREE_FAT_MARGIN 0.1f
+
+/// Balanced binary tree of axis aligned boxes that supports inserting, moving and removing boxes at any time.
+/// Leaves carry a type mask and parents carry the union of their children's masks, so queries can skip whole subtrees of unwanted types.
+/// Queries fill a list of proxy IDs instead of calling back, so callers can act on the results after the traversal.
+class DynamicAABBTree
+{
+public:
+	typedef unsigned long long TypeMask;
+
+private:
+	struct Node
+	{
+		/// Fat box for leaves, union of the children for parents
+		Vector3 min;
+		Vector3 max;
+		/// Box given by the user, only set for leaves
+		Vector3 tightMin;
+		Vector3 tightMax;
+		void* userData = nullptr;
+		TypeMask types = 0;
+		/// Next free node while the node is in the free list
+		int parent = AABB_TREE_NULL_NODE;
+		int left = AABB_TREE_NULL_NODE;
+		int right = AABB_TREE_NULL_NODE;
+		/// Leaves have height 0, free nodes have height -1
+		int height = -1;
+
+		bool isLeaf() const { return left == AABB_TREE_NULL_NODE; }
+	};
+
+	Vector<Node> m_Nodes;
+	int m_Root = AABB_TREE_NULL_NODE;
+	int m_FreeList = AABB_TREE_NULL_NODE;
+	unsigned int m_ProxyCount = 0;
+	/// Reused by queries to avoid allocating, so queries must not run on several threads at once
+	mutable Vector<int> m_Stack;
+
+	int allocateNode();
+	void freeNode(int node);
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	/// Rotate the subtree under node if it is out of balance and return the new subtree root
+	int balance(int node);
+	/// Recompute boxes, masks and heights of node and all its ancestors
+	void refitFrom(int node);
+	void collectLeaves(int node, TypeMask types, Vector<int>& result) const;
+
+public:
+	DynamicAABBTree() = default;
+	DynamicAABBTree(DynamicAABBTree&) = delete;
+	~DynamicAABBTree() = default;
+
+	/// Returns the ID of the new proxy
+	int createProxy(const Vector3& min, const Vector3& max, void* userData, TypeMask types);
+	void destroyProxy(int proxy);
+	/// Update the box of a proxy. Returns true if it had to be reinserted because it left its fat box.
+	bool moveProxy(int proxy, const Vector3& min, const Vector3& max);
+	void setTypes(int proxy, TypeMask types);
+	void clear();
+
+	void* getUserData(int proxy) const { return m_Nodes[proxy].userData; }
+	TypeMask getTypes(int proxy) const { return m_Nodes[proxy].types; }
+	void getBounds(int proxy, Vector3& min, Vector3& max) const;
+
+	/// Proxies of any of the types whose boxes overlap the box
+	void queryBox(const Vector3& min, const Vector3& max, TypeMask types, Vector<int>& result) const;
+	/// Proxies of any of the types whose boxes overlap the sphere
+	void querySphere(const Vector3& center, float radius, TypeMask types, Vector<int>& result) const;
+	/// Proxies of any of the types whose boxes are at least partly on the inner side of all planes.
+	/// A plane (a, b, c, d) keeps points where a * x + b * y + c * z + d >= 0.
+	void queryFrustum(const Vector4 planes[6], TypeMask types, Vector<int>& result) const;
+	/// Closest proxy of any of the types whose box is hit by the ray within maxDistance, or AABB_TREE_NULL_NODE.
+	/// direction does not need to be normalized, hitDistance is measured in multiples of it.
+	int raycast(const Vector3& origin, const Vector3& direction, float maxDistance, TypeMask types, float& hitDistance) const;
+	/// Up to count proxies of any of the types whose boxes are closest to the point, closest first
+	void queryNearest(const Vector3& point, unsigned int count, TypeMask types, Vector<int>& result) const;
+
+	unsigned int getProxyCount() const { return m_ProxyCount; }
+	unsigned int getNodeCount() const { return m_Nodes.size(); }
+	int getHeight() const { return m_Root == AABB_TREE_NULL_NODE ? 0 : m_Nodes[m_Root].height; }
+};
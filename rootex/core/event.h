@@ -37,8 +37,8 @@ struct RootexEvents
 	/// SceneLoader opened a new Scene
 	DEFINE_EVENT(OpenedScene);
 
-	/// A string was printed to output
-	DEFINE_EVENT(OSPrint, String);
+	/// Files were changed on disk and the resources depending on them were hot reloaded
+	DEFINE_EVENT(FilesChanged, Vector<String>);
 
 	/// UISystem debugger on/off
 	DEFINE_EVENT(UISystemEnableDebugger);
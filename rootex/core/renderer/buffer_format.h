@@ -16,6 +16,9 @@ struct VertexBufferElement
 		ByteByteByteByte = DXGI_FORMAT_R8G8B8A8_UNORM,
 		UInt = DXGI_FORMAT_R32_UINT,
 		IntIntIntInt = DXGI_FORMAT_R32G32B32A32_SINT,
+		HalfHalfHalfHalf = DXGI_FORMAT_R16G16B16A16_FLOAT,
+		HalfHalf = DXGI_FORMAT_R16G16_FLOAT,
+		UByteUByteUByteUByte = DXGI_FORMAT_R8G8B8A8_UINT,
 	};
 
 	/// What type of objects are present in buffer
@@ -48,6 +51,12 @@ struct VertexBufferElement
 			return sizeof(int) * 4;
 		case UInt:
 			return sizeof(unsigned int);
+		case HalfHalfHalfHalf:
+			return sizeof(unsigned short) * 4;
+		case HalfHalf:
+			return sizeof(unsigned short) * 2;
+		case UByteUByteUByteUByte:
+			return sizeof(unsigned char) * 4;
 		default:
 			ERR("Unknown size found");
 			return 0;
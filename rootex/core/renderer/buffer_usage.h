@@ -0,0 +1,12 @@
+#pragma once
+
+/// How a GPU buffer is written after it is created, which decides where the driver keeps it
+enum class BufferUsage
+{
+	/// Filled once at creation and never written again, like level geometry
+	Immutable,
+	/// Written now and then through updates
+	Default,
+	/// Rewritten by the CPU about every frame through mapping
+	Dynamic
+};
@@ -101,17 +101,21 @@ struct StaticPointLightsInfo
 	PointLightInfo pointLightInfos[MAX_STATIC_POINT_LIGHTS];
 };
 
+/// Dynamic point and spot lights are read from structured buffers through the light clusters
 struct LightsInfo
 {
 	Vector3 cameraPos;
-	int pointLightCount = 0;
-	PointLightInfo pointLightInfos[MAX_DYNAMIC_POINT_LIGHTS];
 	int directionalLightPresent = 0;
-	float pad2[3];
 	DirectionalLightInfo directionalLightInfo;
-	int spotLightCount = 0;
-	float pad3[3];
-	SpotLightInfo spotLightInfos[MAX_DYNAMIC_SPOT_LIGHTS];
+	/// View basis and depth slicing the light clusters were built with
+	Vector3 cameraForward;
+	float clusterDepthScale = 0.0f;
+	Vector3 cameraRight;
+	float clusterDepthBias = 0.0f;
+	Vector3 cameraUp;
+	float clusterNear = 0.0f;
+	Vector2 clusterTanHalfFov;
+	float pad[2];
 };
 
 /// Constant buffer uploaded once per frame in the PS
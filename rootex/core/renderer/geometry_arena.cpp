@@ -0,0 +1,114 @@
+#include "geometry_arena.h"
+
+GeometryArena::GeometryArena(unsigned int pageCapacity)
+    : m_PageCapacity(pageCapacity)
+{
+}
+
+bool GeometryArena::allocateFromPage(int page, unsigned int count, GeometryRange& range)
+{
+	Page& current = m_Pages[page];
+	for (auto freeIt = current.freeRanges.begin(); freeIt != current.freeRanges.end(); freeIt++)
+	{
+		auto [offset, freeCount] = *freeIt;
+		if (freeCount < count)
+		{
+			continue;
+		}
+
+		current.freeRanges.erase(freeIt);
+		if (freeCount > count)
+		{
+			current.freeRanges[offset + count] = freeCount - count;
+		}
+		current.used += count;
+		m_UsedCount += count;
+		range = { page, offset, count };
+		return true;
+	}
+	return false;
+}
+
+GeometryRange GeometryArena::allocate(unsigned int count, bool& isNewPage)
+{
+	isNewPage = false;
+	GeometryRange range;
+	if (count == 0)
+	{
+		return range;
+	}
+
+	if (count <= m_PageCapacity)
+	{
+		for (int page = 0; page < m_Pages.size(); page++)
+		{
+			const Page& current = m_Pages[page];
+			if (current.capacity - current.used >= count && allocateFromPage(page, count, range))
+			{
+				return range;
+			}
+		}
+	}
+
+	int page = 0;
+	while (page < m_Pages.size() && m_Pages[page].capacity != 0)
+	{
+		page++;
+	}
+	if (page == m_Pages.size())
+	{
+		m_Pages.emplace_back();
+	}
+
+	Page& newPage = m_Pages[page];
+	newPage.capacity = std::max(count, m_PageCapacity);
+	newPage.used = 0;
+	newPage.freeRanges = { { 0u, newPage.capacity } };
+	m_PageCount++;
+	m_CapacityCount += newPage.capacity;
+	isNewPage = true;
+
+	allocateFromPage(page, count, range);
+	return range;
+}
+
+bool GeometryArena::free(const GeometryRange& range)
+{
+	if (range.page < 0 || range.count == 0)
+	{
+		return false;
+	}
+
+	Page& page = m_Pages[range.page];
+	page.used -= range.count;
+	m_UsedCount -= range.count;
+	if (page.used == 0)
+	{
+		m_PageCount--;
+		m_CapacityCount -= page.capacity;
+		page.capacity = 0;
+		page.freeRanges.clear();
+		return true;
+	}
+
+	unsigned int offset = range.offset;
+	unsigned int count = range.count;
+	auto nextIt = page.freeRanges.lower_bound(offset);
+	if (nextIt != page.freeRanges.end() && nextIt->first == offset + count)
+	{
+		count += nextIt->second;
+		nextIt = page.freeRanges.erase(nextIt);
+	}
+	if (nextIt != page.freeRanges.begin())
+	{
+		auto previousIt = std::prev(nextIt);
+		if (previousIt->first + previousIt->second == offset)
+		{
+			offset = previousIt->first;
+			count += previousIt->second;
+			page.freeRanges.erase(previousIt);
+		}
+	}
+	page.freeRanges[offset] = count;
+	return false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "common/types.h"
+
+/// Elements handed out from one page of a GeometryArena
+struct GeometryRange
+{
+	int page = -1;
+	unsigned int offset = 0;
+	unsigned int count = 0;
+};
+
+/// Sub-allocates ranges of elements from pages of a fixed capacity, first fit, merging neighbouring free ranges on free.
+/// Ranges bigger than a page get a page of their own. Only does the bookkeeping, so the policy can be exercised without a GPU.
+class GeometryArena
+{
+	struct Page
+	{
+		/// 0 for slots of released pages, which are reused by later pages
+		unsigned int capacity = 0;
+		unsigned int used = 0;
+		/// Free ranges by offset
+		Map<unsigned int, unsigned int> freeRanges;
+	};
+
+	unsigned int m_PageCapacity;
+	Vector<Page> m_Pages;
+	unsigned int m_PageCount = 0;
+	unsigned int m_UsedCount = 0;
+	unsigned int m_CapacityCount = 0;
+
+	bool allocateFromPage(int page, unsigned int count, GeometryRange& range);
+
+public:
+	GeometryArena(unsigned int pageCapacity);
+	GeometryArena(const GeometryArena&) = delete;
+	~GeometryArena() = default;
+
+	/// Sets isNewPage if a page was added for the range, which then needs storage for getPageCapacity(range.page) elements.
+	/// Empty ranges are not backed by any page.
+	GeometryRange allocate(unsigned int count, bool& isNewPage);
+	/// Returns true if this emptied the page and released it
+	bool free(const GeometryRange& range);
+
+	unsigned int getPageCapacity(int page) const { return m_Pages[page].capacity; }
+	/// Pages in use, not counting released slots
+	unsigned int getPageCount() const { return m_PageCount; }
+	unsigned int getUsedCount() const { return m_UsedCount; }
+	unsigned int getCapacityCount() const { return m_CapacityCount; }
+};
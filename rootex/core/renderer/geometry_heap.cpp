@@ -0,0 +1,198 @@
+#include "geometry_heap.h"
+
+#include "rendering_device.h"
+#include "vertex_buffer.h"
+#include "index_buffer.h"
+
+#include "meshoptimizer.h"
+#include "Tracy/Tracy.hpp"
+
+static void PackVertex(const VertexData& vertex, PackedVertexData& packed)
+{
+	packed.m_Position = vertex.m_Position;
+	packed.m_Normal[0] = meshopt_quantizeHalf(vertex.m_Normal.x);
+	packed.m_Normal[1] = meshopt_quantizeHalf(vertex.m_Normal.y);
+	packed.m_Normal[2] = meshopt_quantizeHalf(vertex.m_Normal.z);
+	packed.m_Normal[3] = meshopt_quantizeHalf(1.0f);
+	packed.m_TextureCoord[0] = meshopt_quantizeHalf(vertex.m_TextureCoord.x);
+	packed.m_TextureCoord[1] = meshopt_quantizeHalf(vertex.m_TextureCoord.y);
+	packed.m_Tangent[0] = meshopt_quantizeHalf(vertex.m_Tangent.x);
+	packed.m_Tangent[1] = meshopt_quantizeHalf(vertex.m_Tangent.y);
+	packed.m_Tangent[2] = meshopt_quantizeHalf(vertex.m_Tangent.z);
+	packed.m_Tangent[3] = 0;
+}
+
+GeometryPool::GeometryPool(unsigned int elementSize, unsigned int pageBytes, UINT bindFlags)
+    : m_Arena(pageBytes / elementSize)
+    , m_ElementSize(elementSize)
+    , m_BindFlags(bindFlags)
+{
+}
+
+Microsoft::WRL::ComPtr<ID3D11Buffer> GeometryPool::allocate(const void* elements, unsigned int count, GeometryRange& range)
+{
+	std::lock_guard<Mutex> lock(m_Mutex);
+
+	bool isNewPage = false;
+	range = m_Arena.allocate(count, isNewPage);
+	if (range.page < 0)
+	{
+		return nullptr;
+	}
+
+	if (isNewPage)
+	{
+		if (range.page >= m_Pages.size())
+		{
+			m_Pages.resize(range.page + 1);
+		}
+		m_Pages[range.page] = RenderingDevice::GetSingleton()->createBuffer(nullptr, m_Arena.getPageCapacity(range.page) * m_ElementSize, m_BindFlags, BufferUsage::Default);
+	}
+
+	Upload& upload = m_Uploads.emplace_back();
+	upload.page = m_Pages[range.page];
+	upload.byteOffset = range.offset * m_ElementSize;
+	upload.data.assign((const char*)elements, (const char*)elements + count * m_ElementSize);
+
+	return m_Pages[range.page];
+}
+
+void GeometryPool::free(const GeometryRange& range)
+{
+	std::lock_guard<Mutex> lock(m_Mutex);
+
+	// Buffers still using an emptied page hold their own reference, so it is only destroyed once all of them are
+	if (m_Arena.free(range))
+	{
+		m_Pages[range.page].Reset();
+	}
+}
+
+void GeometryPool::upload()
+{
+	Vector<Upload> uploads;
+	{
+		std::lock_guard<Mutex> lock(m_Mutex);
+		uploads.swap(m_Uploads);
+	}
+
+	for (auto& upload : uploads)
+	{
+		RenderingDevice::GetSingleton()->updateBuffer(upload.page.Get(), upload.byteOffset, upload.data.data(), upload.data.size());
+	}
+}
+
+unsigned int GeometryPool::getPageCount()
+{
+	std::lock_guard<Mutex> lock(m_Mutex);
+	return m_Arena.getPageCount();
+}
+
+unsigned int GeometryPool::getUsedCount()
+{
+	std::lock_guard<Mutex> lock(m_Mutex);
+	return m_Arena.getUsedCount();
+}
+
+unsigned int GeometryPool::getCapacityCount()
+{
+	std::lock_guard<Mutex> lock(m_Mutex);
+	return m_Arena.getCapacityCount();
+}
+
+GeometryHeap::GeometryHeap()
+    : m_VertexPool(std::make_shared<GeometryPool>(sizeof(VertexData), GEOMETRY_VERTEX_PAGE_BYTES, D3D11_BIND_VERTEX_BUFFER))
+    , m_AnimatedVertexPool(std::make_shared<GeometryPool>(sizeof(AnimatedVertexData), GEOMETRY_VERTEX_PAGE_BYTES, D3D11_BIND_VERTEX_BUFFER))
+    , m_PackedVertexPool(std::make_shared<GeometryPool>(sizeof(PackedVertexData), GEOMETRY_VERTEX_PAGE_BYTES, D3D11_BIND_VERTEX_BUFFER))
+    , m_PackedAnimatedVertexPool(std::make_shared<GeometryPool>(sizeof(PackedAnimatedVertexData), GEOMETRY_VERTEX_PAGE_BYTES, D3D11_BIND_VERTEX_BUFFER))
+    , m_ShortIndexPool(std::make_shared<GeometryPool>(sizeof(unsigned short), GEOMETRY_INDEX_PAGE_BYTES, D3D11_BIND_INDEX_BUFFER))
+    , m_IndexPool(std::make_shared<GeometryPool>(sizeof(unsigned int), GEOMETRY_INDEX_PAGE_BYTES, D3D11_BIND_INDEX_BUFFER))
+{
+}
+
+GeometryHeap* GeometryHeap::GetSingleton()
+{
+	static GeometryHeap singleton;
+	return &singleton;
+}
+
+Ref<VertexBuffer> GeometryHeap::createVertexBuffer(const Vector<VertexData>& vertices)
+{
+	if (!m_IsPackingVertices)
+	{
+		return std::make_shared<VertexBuffer>(m_VertexPool, vertices.data(), vertices.size(), sizeof(VertexData));
+	}
+
+	Vector<PackedVertexData> packedVertices(vertices.size());
+	for (int i = 0; i < vertices.size(); i++)
+	{
+		PackVertex(vertices[i], packedVertices[i]);
+	}
+	return std::make_shared<VertexBuffer>(m_PackedVertexPool, packedVertices.data(), packedVertices.size(), sizeof(PackedVertexData), true);
+}
+
+Ref<VertexBuffer> GeometryHeap::createVertexBuffer(const Vector<AnimatedVertexData>& vertices)
+{
+	bool isPackable = m_IsPackingVertices;
+	for (int i = 0; i < vertices.size() && isPackable; i++)
+	{
+		for (int bone : vertices[i].m_BoneIndices)
+		{
+			isPackable &= bone >= 0 && bone <= UCHAR_MAX;
+		}
+	}
+	if (!isPackable)
+	{
+		return std::make_shared<VertexBuffer>(m_AnimatedVertexPool, vertices.data(), vertices.size(), sizeof(AnimatedVertexData));
+	}
+
+	Vector<PackedAnimatedVertexData> packedVertices(vertices.size());
+	for (int i = 0; i < vertices.size(); i++)
+	{
+		const AnimatedVertexData& vertex = vertices[i];
+		PackedAnimatedVertexData& packed = packedVertices[i];
+		PackVertex(vertex, packed);
+		const float weights[4] = { vertex.m_BoneWeights.x, vertex.m_BoneWeights.y, vertex.m_BoneWeights.z, vertex.m_BoneWeights.w };
+		for (int j = 0; j < 4; j++)
+		{
+			packed.m_BoneIndices[j] = (unsigned char)vertex.m_BoneIndices[j];
+			packed.m_BoneWeights[j] = (unsigned char)meshopt_quantizeUnorm(weights[j], 8);
+		}
+	}
+	return std::make_shared<VertexBuffer>(m_PackedAnimatedVertexPool, packedVertices.data(), packedVertices.size(), sizeof(PackedAnimatedVertexData), true);
+}
+
+Ref<IndexBuffer> GeometryHeap::createIndexBuffer(const Vector<unsigned int>& indices)
+{
+	Vector<unsigned short> shortIndices;
+	if (IndexBuffer::Narrow(indices, shortIndices))
+	{
+		return std::make_shared<IndexBuffer>(m_ShortIndexPool, shortIndices.data(), shortIndices.size(), DXGI_FORMAT_R16_UINT);
+	}
+	return std::make_shared<IndexBuffer>(m_IndexPool, indices.data(), indices.size(), DXGI_FORMAT_R32_UINT);
+}
+
+void GeometryHeap::upload()
+{
+	ZoneScoped;
+	m_VertexPool->upload();
+	m_AnimatedVertexPool->upload();
+	m_PackedVertexPool->upload();
+	m_PackedAnimatedVertexPool->upload();
+	m_ShortIndexPool->upload();
+	m_IndexPool->upload();
+}
+
+void GeometryHeap::draw()
+{
+	auto drawPool = [](const char* name, GeometryPool* pool) {
+		const unsigned int elementSize = pool->getElementSize();
+		ImGui::Text("%s: %u pages, %.2f / %.2f MB", name, pool->getPageCount(), pool->getUsedCount() * elementSize / 1048576.0f, pool->getCapacityCount() * elementSize / 1048576.0f);
+	};
+	drawPool("Vertices", m_VertexPool.get());
+	drawPool("Animated Vertices", m_AnimatedVertexPool.get());
+	drawPool("Packed Vertices", m_PackedVertexPool.get());
+	drawPool("Packed Animated Vertices", m_PackedAnimatedVertexPool.get());
+	drawPool("16 bit Indices", m_ShortIndexPool.get());
+	drawPool("32 bit Indices", m_IndexPool.get());
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include "common/common.h"
+#include "renderer/geometry_arena.h"
+#include "renderer/vertex_data.h"
+
+/// Size of the pages shared by mesh vertices and indices. Bigger meshes get a page of their own.
+#define GEOMETRY_VERTEX_PAGE_BYTES (8 * 1024 * 1024)
+#define GEOMETRY_INDEX_PAGE_BYTES (4 * 1024 * 1024)
+
+class VertexBuffer;
+class IndexBuffer;
+
+/// GPU pages holding one kind of element, either vertices of one layout or indices of one format.
+/// Kept alive by the buffers using its ranges, so those can be destroyed in any order.
+class GeometryPool
+{
+	struct Upload
+	{
+		Microsoft::WRL::ComPtr<ID3D11Buffer> page;
+		unsigned int byteOffset;
+		Vector<char> data;
+	};
+
+	Mutex m_Mutex;
+	GeometryArena m_Arena;
+	unsigned int m_ElementSize;
+	UINT m_BindFlags;
+	Vector<Microsoft::WRL::ComPtr<ID3D11Buffer>> m_Pages;
+	/// Ranges waiting to be written by the render thread
+	Vector<Upload> m_Uploads;
+
+public:
+	GeometryPool(unsigned int elementSize, unsigned int pageBytes, UINT bindFlags);
+	GeometryPool(const GeometryPool&) = delete;
+	~GeometryPool() = default;
+
+	/// Copy elements into a new range, which reaches the GPU at the next upload. Safe to call from any thread.
+	/// Returns the page holding the range.
+	Microsoft::WRL::ComPtr<ID3D11Buffer> allocate(const void* elements, unsigned int count, GeometryRange& range);
+	void free(const GeometryRange& range);
+	/// Write the queued ranges to their pages. Must be called on the thread that renders.
+	void upload();
+
+	unsigned int getElementSize() const { return m_ElementSize; }
+	unsigned int getPageCount();
+	unsigned int getUsedCount();
+	unsigned int getCapacityCount();
+};
+
+/// Shares a few large GPU buffers between the vertices and indices of all loaded meshes and their LODs,
+/// so consecutive meshes draw without rebinding buffers and the driver tracks a handful of objects instead of one per mesh.
+class GeometryHeap
+{
+	Ref<GeometryPool> m_VertexPool;
+	Ref<GeometryPool> m_AnimatedVertexPool;
+	Ref<GeometryPool> m_PackedVertexPool;
+	Ref<GeometryPool> m_PackedAnimatedVertexPool;
+	Ref<GeometryPool> m_ShortIndexPool;
+	Ref<GeometryPool> m_IndexPool;
+	bool m_IsPackingVertices = true;
+
+	GeometryHeap();
+	GeometryHeap(GeometryHeap&) = delete;
+	~GeometryHeap() = default;
+
+public:
+	static GeometryHeap* GetSingleton();
+
+	/// Quantize mesh vertices to PackedVertexData and PackedAnimatedVertexData. Only affects meshes created afterwards.
+	void setPackingVertices(bool enabled) { m_IsPackingVertices = enabled; }
+	bool isPackingVertices() const { return m_IsPackingVertices; }
+
+	Ref<VertexBuffer> createVertexBuffer(const Vector<VertexData>& vertices);
+	Ref<VertexBuffer> createVertexBuffer(const Vector<AnimatedVertexData>& vertices);
+	/// Indices are stored in 16 bits if every one of them fits
+	Ref<IndexBuffer> createIndexBuffer(const Vector<unsigned int>& indices);
+
+	/// Write geometry added since the last call to the GPU. Call on the render thread before drawing.
+	void upload();
+
+	void draw();
+};
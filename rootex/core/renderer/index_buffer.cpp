@@ -1,41 +1,59 @@
 #include "index_buffer.h"
 
 #include "rendering_device.h"
+#include "geometry_heap.h"
 
 #include "Tracy/Tracy.hpp"
 
-IndexBuffer::IndexBuffer(const Vector<unsigned short>& indices)
-    : m_Count(indices.size())
+bool IndexBuffer::Narrow(const Vector<unsigned int>& indices, Vector<unsigned short>& shortIndices)
 {
-	D3D11_BUFFER_DESC ibd = { 0 };
-	ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	ibd.Usage = D3D11_USAGE_DYNAMIC;
-	ibd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	ibd.MiscFlags = 0u;
-	ibd.ByteWidth = indices.size() * sizeof(unsigned short);
-	ibd.StructureByteStride = 0;
-	D3D11_SUBRESOURCE_DATA isd = { 0 };
-	isd.pSysMem = indices.data();
+	for (unsigned int index : indices)
+	{
+		if (index > USHRT_MAX)
+		{
+			return false;
+		}
+	}
+	shortIndices.assign(indices.begin(), indices.end());
+	return true;
+}
 
-	m_Format = DXGI_FORMAT_R16_UINT;
-	m_IndexBuffer = RenderingDevice::GetSingleton()->createBuffer(&ibd, &isd);
+IndexBuffer::IndexBuffer(const Vector<unsigned short>& indices, BufferUsage usage)
+    : m_Count(indices.size())
+    , m_Format(DXGI_FORMAT_R16_UINT)
+{
+	m_IndexBuffer = RenderingDevice::GetSingleton()->createBuffer(indices.data(), indices.size() * sizeof(unsigned short), D3D11_BIND_INDEX_BUFFER, usage);
 }
 
-IndexBuffer::IndexBuffer(const Vector<unsigned int>& indices)
+IndexBuffer::IndexBuffer(const Vector<unsigned int>& indices, BufferUsage usage)
     : m_Count(indices.size())
 {
-	D3D11_BUFFER_DESC ibd = { 0 };
-	ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	ibd.Usage = D3D11_USAGE_DYNAMIC;
-	ibd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	ibd.MiscFlags = 0u;
-	ibd.ByteWidth = indices.size() * sizeof(int);
-	ibd.StructureByteStride = 0;
-	D3D11_SUBRESOURCE_DATA isd = { 0 };
-	isd.pSysMem = indices.data();
+	Vector<unsigned short> shortIndices;
+	if (usage != BufferUsage::Dynamic && Narrow(indices, shortIndices))
+	{
+		m_Format = DXGI_FORMAT_R16_UINT;
+		m_IndexBuffer = RenderingDevice::GetSingleton()->createBuffer(shortIndices.data(), shortIndices.size() * sizeof(unsigned short), D3D11_BIND_INDEX_BUFFER, usage);
+		return;
+	}
 
 	m_Format = DXGI_FORMAT_R32_UINT;
-	m_IndexBuffer = RenderingDevice::GetSingleton()->createBuffer(&ibd, &isd);
+	m_IndexBuffer = RenderingDevice::GetSingleton()->createBuffer(indices.data(), indices.size() * sizeof(unsigned int), D3D11_BIND_INDEX_BUFFER, usage);
+}
+
+IndexBuffer::IndexBuffer(Ref<GeometryPool> pool, const void* indices, unsigned int count, DXGI_FORMAT format)
+    : m_Count(count)
+    , m_Format(format)
+    , m_Pool(pool)
+{
+	m_IndexBuffer = m_Pool->allocate(indices, count, m_Range);
+}
+
+IndexBuffer::~IndexBuffer()
+{
+	if (m_Pool)
+	{
+		m_Pool->free(m_Range);
+	}
 }
 
 void IndexBuffer::setData(const Vector<unsigned short>& indices)
@@ -3,6 +3,10 @@
 #include <d3d11.h>
 
 #include "common/common.h"
+#include "renderer/buffer_usage.h"
+#include "renderer/geometry_arena.h"
+
+class GeometryPool;
 
 /// Encapsulates Index Buffer data, to be supplied to the Input Assembler
 class IndexBuffer
@@ -11,16 +15,30 @@ protected:
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_IndexBuffer;
 	unsigned int m_Count;
 	DXGI_FORMAT m_Format;
+	/// Set when the indices are a range of a page shared with other meshes
+	Ref<GeometryPool> m_Pool;
+	GeometryRange m_Range;
 
 public:
-	IndexBuffer(const Vector<unsigned short>& indices);
-	IndexBuffer(const Vector<unsigned int>& indices);
-	~IndexBuffer() = default;
+	/// Copy the indices to 16 bits if every one of them fits. Returns false if they do not.
+	static bool Narrow(const Vector<unsigned int>& indices, Vector<unsigned short>& shortIndices);
+
+	IndexBuffer(const Vector<unsigned short>& indices, BufferUsage usage = BufferUsage::Immutable);
+	/// Indices that fit are stored in 16 bits, unless the buffer is dynamic and may be rewritten with bigger ones
+	IndexBuffer(const Vector<unsigned int>& indices, BufferUsage usage = BufferUsage::Immutable);
+	/// Indices in a range of a shared page. Use GeometryHeap to create these.
+	IndexBuffer(Ref<GeometryPool> pool, const void* indices, unsigned int count, DXGI_FORMAT format);
+	IndexBuffer(const IndexBuffer&) = delete;
+	~IndexBuffer();
 
+	/// Only for dynamic buffers
 	void setData(const Vector<unsigned short>& indices);
 	void setData(const Vector<unsigned int>& indices);
 
 	void bind() const;
 	unsigned int getCount() const;
-	ID3D11Buffer* getBuffer() { return m_IndexBuffer.Get(); }
+	/// Offset of the first index in the buffer
+	unsigned int getStartIndex() const { return m_Range.offset; }
+	DXGI_FORMAT getFormat() const { return m_Format; }
+	ID3D11Buffer* getBuffer() const { return m_IndexBuffer.Get(); }
 };
@@ -0,0 +1,176 @@
+#include "light_clusters.h"
+
+#include <cmath>
+
+LightClusterGrid::LightClusterGrid()
+    : m_ClusterLights(CLUSTER_COUNT)
+    , m_ClusterPointLightCounts(CLUSTER_COUNT, 0)
+    , m_Clusters(CLUSTER_COUNT)
+{
+}
+
+void LightClusterGrid::build(const ClusterView& view, const Vector<ClusterLightBounds>& pointLights, const Vector<ClusterLightBounds>& spotLights)
+{
+	begin(view, pointLights, spotLights);
+	binSlices(0, CLUSTER_COUNT_Z - 1);
+	finish();
+}
+
+LightClusterGrid::ViewLight LightClusterGrid::toView(const ClusterLightBounds& bounds) const
+{
+	const Vector3 relative = bounds.center - m_View.position;
+	ViewLight light;
+	light.center = { relative.Dot(m_View.right), relative.Dot(m_View.up), relative.Dot(m_View.forward) };
+	light.radius = bounds.radius;
+
+	const float nearest = light.center.z - light.radius;
+	const float farthest = light.center.z + light.radius;
+	if (farthest < m_View.nearPlane || nearest > m_View.farPlane)
+	{
+		light.firstSlice = 0;
+		light.lastSlice = -1;
+		return light;
+	}
+	light.firstSlice = getSlice(nearest);
+	light.lastSlice = getSlice(farthest);
+	return light;
+}
+
+void LightClusterGrid::begin(const ClusterView& view, const Vector<ClusterLightBounds>& pointLights, const Vector<ClusterLightBounds>& spotLights)
+{
+	m_View = view;
+	m_View.nearPlane = std::max(view.nearPlane, 1e-4f);
+	m_View.farPlane = std::max(view.farPlane, m_View.nearPlane * 1.001f);
+
+	const float logDepthRange = std::log(m_View.farPlane / m_View.nearPlane);
+	m_DepthScale = CLUSTER_COUNT_Z / logDepthRange;
+	m_DepthBias = -CLUSTER_COUNT_Z * std::log(m_View.nearPlane) / logDepthRange;
+	for (int i = 0; i <= CLUSTER_COUNT_Z; i++)
+	{
+		m_SliceDepths[i] = m_View.nearPlane * std::pow(m_View.farPlane / m_View.nearPlane, (float)i / CLUSTER_COUNT_Z);
+	}
+
+	m_ViewLights.clear();
+	m_PointLightCount = pointLights.size();
+	for (auto& light : pointLights)
+	{
+		m_ViewLights.push_back(toView(light));
+	}
+	for (auto& light : spotLights)
+	{
+		m_ViewLights.push_back(toView(light));
+	}
+
+	for (int i = 0; i < CLUSTER_COUNT; i++)
+	{
+		m_ClusterLights[i].clear();
+		m_ClusterPointLightCounts[i] = 0;
+	}
+}
+
+void LightClusterGrid::binLight(const ViewLight& light, unsigned int index, bool isPointLight, int slice)
+{
+	// Depths of the part of the slice the light reaches
+	const float nearest = std::max({ m_SliceDepths[slice], light.center.z - light.radius, m_View.nearPlane });
+	const float farthest = std::min(m_SliceDepths[slice + 1], light.center.z + light.radius);
+	if (nearest > farthest)
+	{
+		return;
+	}
+
+	// A side of the sphere projects furthest out at whichever end of the depth range is closer to the camera
+	auto project = [nearest, farthest](float side, float tanHalfFov, bool isMinimum) {
+		const float depth = (side >= 0.0f) == isMinimum ? farthest : nearest;
+		return side / (depth * tanHalfFov);
+	};
+	const float minX = project(light.center.x - light.radius, m_View.tanHalfFov.x, true);
+	const float maxX = project(light.center.x + light.radius, m_View.tanHalfFov.x, false);
+	const float minY = project(light.center.y - light.radius, m_View.tanHalfFov.y, true);
+	const float maxY = project(light.center.y + light.radius, m_View.tanHalfFov.y, false);
+	if (minX > 1.0f || maxX < -1.0f || minY > 1.0f || maxY < -1.0f)
+	{
+		return;
+	}
+
+	auto toTile = [](float ndc, int count) {
+		return std::clamp((int)std::floor((ndc * 0.5f + 0.5f) * count), 0, count - 1);
+	};
+	const int firstX = toTile(minX, CLUSTER_COUNT_X);
+	const int lastX = toTile(maxX, CLUSTER_COUNT_X);
+	const int firstY = toTile(minY, CLUSTER_COUNT_Y);
+	const int lastY = toTile(maxY, CLUSTER_COUNT_Y);
+
+	for (int y = firstY; y <= lastY; y++)
+	{
+		for (int x = firstX; x <= lastX; x++)
+		{
+			const int cluster = GetClusterIndex(x, y, slice);
+			m_ClusterLights[cluster].push_back(index);
+			if (isPointLight)
+			{
+				m_ClusterPointLightCounts[cluster]++;
+			}
+		}
+	}
+}
+
+void LightClusterGrid::binSlices(int first, int last)
+{
+	first = std::max(first, 0);
+	last = std::min(last, CLUSTER_COUNT_Z - 1);
+	for (int slice = first; slice <= last; slice++)
+	{
+		// Point lights are binned first so they come first in every cluster list
+		for (unsigned int i = 0; i < m_ViewLights.size(); i++)
+		{
+			const ViewLight& light = m_ViewLights[i];
+			if (slice < light.firstSlice || slice > light.lastSlice)
+			{
+				continue;
+			}
+			const bool isPointLight = i < m_PointLightCount;
+			binLight(light, isPointLight ? i : i - m_PointLightCount, isPointLight, slice);
+		}
+	}
+}
+
+void LightClusterGrid::finish()
+{
+	m_LightIndices.clear();
+	for (int i = 0; i < CLUSTER_COUNT; i++)
+	{
+		const Vector<unsigned int>& lights = m_ClusterLights[i];
+		m_Clusters[i].offset = m_LightIndices.size();
+		m_Clusters[i].pointLightCount = m_ClusterPointLightCounts[i];
+		m_Clusters[i].spotLightCount = lights.size() - m_ClusterPointLightCounts[i];
+		m_Clusters[i].pad = 0;
+		m_LightIndices.insert(m_LightIndices.end(), lights.begin(), lights.end());
+	}
+}
+
+int LightClusterGrid::getSlice(float depth) const
+{
+	const float slice = std::log(std::max(depth, m_View.nearPlane)) * m_DepthScale + m_DepthBias;
+	return std::clamp((int)slice, 0, CLUSTER_COUNT_Z - 1);
+}
+
+int LightClusterGrid::getClusterIndex(const Vector3& worldPosition) const
+{
+	const Vector3 relative = worldPosition - m_View.position;
+	const float depth = relative.Dot(m_View.forward);
+	if (depth < m_View.nearPlane || depth > m_View.farPlane)
+	{
+		return -1;
+	}
+
+	const float ndcX = relative.Dot(m_View.right) / (depth * m_View.tanHalfFov.x);
+	const float ndcY = relative.Dot(m_View.up) / (depth * m_View.tanHalfFov.y);
+	if (std::abs(ndcX) > 1.0f || std::abs(ndcY) > 1.0f)
+	{
+		return -1;
+	}
+
+	const int x = std::clamp((int)((ndcX * 0.5f + 0.5f) * CLUSTER_COUNT_X), 0, CLUSTER_COUNT_X - 1);
+	const int y = std::clamp((int)((ndcY * 0.5f + 0.5f) * CLUSTER_COUNT_Y), 0, CLUSTER_COUNT_Y - 1);
+	return GetClusterIndex(x, y, getSlice(depth));
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/renderer/shaders/register_locations_pixel_shader.h"
+
+/// Total number of clusters in the view frustum
+#define CLUSTER_COUNT (CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z)
+
+/// Camera the light clusters are built for
+struct ClusterView
+{
+	Vector3 position;
+	Vector3 forward;
+	Vector3 right;
+	Vector3 up;
+	/// Tangents of half the horizontal and vertical fields of view
+	Vector2 tanHalfFov;
+	float nearPlane;
+	float farPlane;
+};
+
+/// Sphere bounding the volume a light can affect, in world space
+struct ClusterLightBounds
+{
+	Vector3 center;
+	float radius;
+};
+
+/// Range of the light index list used by one cluster. Point lights come first, then spot lights.
+/// Uploaded to the GPU as is, so the layout matches LightCluster in light.hlsli.
+struct LightCluster
+{
+	unsigned int offset;
+	unsigned int pointLightCount;
+	unsigned int spotLightCount;
+	unsigned int pad;
+};
+
+/// Bins lights into a grid of view space clusters. Clusters are screen tiles split into slices that get exponentially deeper.
+/// Only depends on plain data, so it can be built and checked without a renderer.
+/// Binning can be split across threads by slices: call begin, then binSlices on disjoint slice ranges, then finish.
+class LightClusterGrid
+{
+	/// Light bounds in view space, with the slices they cover
+	struct ViewLight
+	{
+		Vector3 center;
+		float radius;
+		int firstSlice;
+		int lastSlice;
+	};
+
+	ClusterView m_View;
+	/// slice = log(depth) * m_DepthScale + m_DepthBias
+	float m_DepthScale = 0.0f;
+	float m_DepthBias = 0.0f;
+	float m_SliceDepths[CLUSTER_COUNT_Z + 1];
+
+	Vector<ViewLight> m_ViewLights;
+	unsigned int m_PointLightCount = 0;
+
+	/// Light indices per cluster, point lights then spot lights. Kept between frames to reuse their memory.
+	Vector<Vector<unsigned int>> m_ClusterLights;
+	Vector<unsigned int> m_ClusterPointLightCounts;
+
+	Vector<LightCluster> m_Clusters;
+	Vector<unsigned int> m_LightIndices;
+
+	ViewLight toView(const ClusterLightBounds& bounds) const;
+	void binLight(const ViewLight& light, unsigned int index, bool isPointLight, int slice);
+
+public:
+	LightClusterGrid();
+	LightClusterGrid(LightClusterGrid&) = delete;
+	~LightClusterGrid() = default;
+
+	static int GetClusterIndex(int x, int y, int z) { return x + CLUSTER_COUNT_X * (y + CLUSTER_COUNT_Y * z); }
+
+	/// Bin all lights on the calling thread
+	void build(const ClusterView& view, const Vector<ClusterLightBounds>& pointLights, const Vector<ClusterLightBounds>& spotLights);
+
+	/// Transform the lights to view space and clear the clusters
+	void begin(const ClusterView& view, const Vector<ClusterLightBounds>& pointLights, const Vector<ClusterLightBounds>& spotLights);
+	/// Bin lights into the clusters of slices first to last, inclusive. Different slice ranges may be binned at the same time.
+	void binSlices(int first, int last);
+	/// Pack the cluster lists into one light index list
+	void finish();
+
+	/// Slice a view space depth falls in, the same way the pixel shader finds it
+	int getSlice(float depth) const;
+	/// Cluster a world space point falls in, the same way the pixel shader finds it. Returns -1 outside the view.
+	int getClusterIndex(const Vector3& worldPosition) const;
+
+	float getDepthScale() const { return m_DepthScale; }
+	float getDepthBias() const { return m_DepthBias; }
+	const ClusterView& getView() const { return m_View; }
+	const Vector<LightCluster>& getClusters() const { return m_Clusters; }
+	const Vector<unsigned int>& getLightIndices() const { return m_LightIndices; }
+};
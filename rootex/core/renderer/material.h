@@ -27,6 +27,8 @@ public:
 	virtual void bind() = 0;
 
 	virtual ID3D11ShaderResourceView* getPreview() = 0;
+	/// Ask the TextureStreamer for the mips needed to draw the textures across screenPixels pixels
+	virtual void requestTextures(float screenPixels) {}
 
 	bool isAlpha() { return m_IsAlpha; }
 	String getFileName() { return m_FileName; };
@@ -4,6 +4,7 @@
 #include "core/resource_files/text_resource_file.h"
 
 MaterialLibrary::MaterialMap MaterialLibrary::s_Materials;
+RecursiveMutex MaterialLibrary::s_MaterialsMutex;
 const String MaterialLibrary::s_DefaultMaterialPath = "rootex/assets/materials/default.rmat";
 const String MaterialLibrary::s_DefaultParticlesMaterialPath = "rootex/assets/materials/default_particles.rmat";
 const String MaterialLibrary::s_AnimatedDefaultMaterialPath = "rootex/assets/materials/animated_default.rmat";
@@ -23,6 +24,7 @@ bool MaterialLibrary::IsDefault(const String& materialPath)
 
 Ref<Material> MaterialLibrary::GetMaterial(const String& materialPath)
 {
+	std::lock_guard<RecursiveMutex> lock(s_MaterialsMutex);
 	if (s_Materials.find(materialPath) == s_Materials.end())
 	{
 		Ref<TextResourceFile> materialResourceFile = ResourceLoader::CreateTextResourceFile(materialPath);
@@ -58,6 +60,7 @@ Ref<Material> MaterialLibrary::GetMaterial(const String& materialPath)
 
 Ref<Material> MaterialLibrary::GetDefaultMaterial()
 {
+	std::lock_guard<RecursiveMutex> lock(s_MaterialsMutex);
 	if (Ref<Material> lockedMaterial = s_Materials[s_DefaultMaterialPath].second.lock())
 	{
 		return lockedMaterial;
@@ -73,6 +76,7 @@ Ref<Material> MaterialLibrary::GetDefaultMaterial()
 
 Ref<Material> MaterialLibrary::GetDefaultParticlesMaterial()
 {
+	std::lock_guard<RecursiveMutex> lock(s_MaterialsMutex);
 	if (Ref<Material> lockedMaterial = s_Materials[s_DefaultParticlesMaterialPath].second.lock())
 	{
 		return lockedMaterial;
@@ -88,6 +92,7 @@ Ref<Material> MaterialLibrary::GetDefaultParticlesMaterial()
 
 Ref<Material> MaterialLibrary::GetDefaultAnimatedMaterial()
 {
+	std::lock_guard<RecursiveMutex> lock(s_MaterialsMutex);
 	if (Ref<Material> lockedMaterial = s_Materials[s_AnimatedDefaultMaterialPath].second.lock())
 	{
 		return lockedMaterial;
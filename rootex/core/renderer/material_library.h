@@ -19,6 +19,8 @@ private:
 
 	static MaterialMap s_Materials;
 	static MaterialDatabase s_MaterialDatabase;
+	/// Guards material creation, which can happen on worker threads while scenes are instantiated.
+	static RecursiveMutex s_MaterialsMutex;
 
 	static bool IsDefault(const String& materialPath);
 
@@ -59,6 +59,7 @@ public:
 	static Material* Create(const JSON::json& materialData);
 
 	virtual ID3D11ShaderResourceView* getPreview() override;
+	void requestTextures(float screenPixels) override;
 
 	virtual void bind() override;
 	JSON::json getJSON() const override;
@@ -7,6 +7,7 @@
 #include "framework/systems/render_system.h"
 #include "renderer/shader_library.h"
 #include "renderer/texture.h"
+#include "renderer/texture_streamer.h"
 
 #include "renderer/shaders/register_locations_pixel_shader.h"
 #include "renderer/shaders/register_locations_vertex_shader.h"
@@ -116,6 +117,16 @@ ID3D11ShaderResourceView* ParticlesMaterial::getPreview()
 	return m_DiffuseImageFile->getTexture()->getTextureResourceView();
 }
 
+void ParticlesMaterial::requestTextures(float screenPixels)
+{
+	TextureStreamer::GetSingleton()->request(m_DiffuseImageFile->getTexture().get(), screenPixels);
+	if (m_IsNormal)
+	{
+		TextureStreamer::GetSingleton()->request(m_NormalImageFile->getTexture().get(), screenPixels);
+	}
+	TextureStreamer::GetSingleton()->request(m_SpecularImageFile->getTexture().get(), screenPixels);
+}
+
 void ParticlesMaterial::bind()
 {
 	m_ParticlesShader->set(m_DiffuseImageFile->getTexture().get(), DIFFUSE_PS_CPP);
@@ -52,6 +52,7 @@ public:
 	static Material* Create(const JSON::json& materialData);
 
 	virtual ID3D11ShaderResourceView* getPreview() override;
+	void requestTextures(float screenPixels) override;
 
 	void bind() override;
 	JSON::json getJSON() const override;
@@ -3,24 +3,67 @@
 #include "index_buffer.h"
 #include "vertex_buffer.h"
 
-void Mesh::addLOD(Ref<IndexBuffer> ib, float lodLevel)
+#include "meshoptimizer.h"
+
+Vector<Pair<Vector<unsigned int>, float>> Mesh::SimplifyLODs(const Vector<unsigned int>& indices, const float* positions, size_t vertexCount, size_t vertexStride)
 {
-	m_LODs.push_back({ ib, lodLevel });
+	// Relative to the largest side of the mesh bounds, which is what meshoptimizer measures error against
+	const float lodErrors[MAX_LOD_COUNT - 1] = { 0.002f, 0.008f, 0.03f, 0.1f };
+
+	Vector3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+	Vector3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		const Vector3& position = *(const Vector3*)((const char*)positions + v * vertexStride);
+		min = Vector3::Min(min, position);
+		max = Vector3::Max(max, position);
+	}
+	const Vector3 size = max - min;
+	const float extent = std::max({ size.x, size.y, size.z });
+
+	Vector<Pair<Vector<unsigned int>, float>> lods;
+	size_t previousIndexCount = indices.size();
+	for (int i = 0; i < MAX_LOD_COUNT - 1; i++)
+	{
+		// No target count, so simplification runs until the error bound and the bound is close to the error reached
+		Vector<unsigned int> lod(indices.size());
+		lod.resize(meshopt_simplify(lod.data(), indices.data(), indices.size(), positions, vertexCount, vertexStride, 0, lodErrors[i]));
 
-	// LODs are to be kept in descending order
+		if (lod.empty())
+		{
+			break;
+		}
+		if (lod.size() > previousIndexCount * 0.8f)
+		{
+			continue;
+		}
+		meshopt_optimizeVertexCache(lod.data(), lod.data(), lod.size(), vertexCount);
+		previousIndexCount = lod.size();
+		lods.push_back({ lod, lodErrors[i] * extent });
+	}
+	return lods;
+}
+
+void Mesh::addLOD(Ref<IndexBuffer> ib, float error)
+{
+	m_LODs.push_back({ ib, error });
+
+	// LODs are to be kept from the most detailed to the coarsest
 	std::sort(m_LODs.begin(), m_LODs.end(), [](const Pair<Ref<IndexBuffer>, float>& a, const Pair<Ref<IndexBuffer>, float>& b) -> bool {
-		return a.second > b.second;
+		return a.second < b.second;
 	});
 }
 
-Ref<IndexBuffer> Mesh::getLOD(float lodLevel) const
+int Mesh::selectLOD(float errorScale, float errorBudget, int currentLOD) const
 {
-	for (auto& [meshLOD, meshLODLevel] : m_LODs)
+	int lod = std::clamp(currentLOD, 0, (int)m_LODs.size() - 1);
+	while (lod > 0 && m_LODs[lod].second * errorScale > errorBudget)
 	{
-		if (lodLevel >= meshLODLevel)
-		{
-			return meshLOD;
-		}
+		lod--;
+	}
+	while (lod + 1 < m_LODs.size() && m_LODs[lod + 1].second * errorScale <= errorBudget * (1.0f - LOD_HYSTERESIS))
+	{
+		lod++;
 	}
-	return m_LODs.back().first;
+	return lod;
 }
@@ -3,6 +3,8 @@
 #include "common/types.h"
 
 #define MAX_LOD_COUNT 5
+/// A coarser LOD is only switched to once its projected error is this fraction below the budget, so LODs do not flicker at the boundary
+#define LOD_HYSTERESIS 0.2f
 
 class VertexBuffer;
 class IndexBuffer;
@@ -12,14 +14,21 @@ struct Mesh
 	Ref<VertexBuffer> m_VertexBuffer;
 	BoundingBox m_BoundingBox;
 
+	/// Index buffers with the geometric error of each in model space units, from the full detail one with no error to the coarsest
 	Vector<Pair<Ref<IndexBuffer>, float>> m_LODs;
 
 	Mesh() = default;
 	Mesh(const Mesh&) = default;
 	~Mesh() = default;
 
-	void addLOD(Ref<IndexBuffer> ib, float lodLevel);
+	/// Simplify a mesh into at most MAX_LOD_COUNT - 1 coarser index lists, each paired with the error it is simplified to in model space units.
+	/// Levels that barely reduce the triangle count are left out.
+	static Vector<Pair<Vector<unsigned int>, float>> SimplifyLODs(const Vector<unsigned int>& indices, const float* positions, size_t vertexCount, size_t vertexStride);
 
-	/// LOD level can range from 0.0f to 1.0f, returns the appropriate LOD
-	Ref<IndexBuffer> getLOD(float lodLevel) const;
+	void addLOD(Ref<IndexBuffer> ib, float error);
+
+	/// Pick the coarsest LOD whose error, scaled to pixels by errorScale, stays within errorBudget pixels.
+	/// Starts from the LOD picked last time for hysteresis, which is usually kept without scanning.
+	int selectLOD(float errorScale, float errorBudget, int currentLOD) const;
+	Ref<IndexBuffer> getLOD(int lod) const { return m_LODs[lod].first; }
 };
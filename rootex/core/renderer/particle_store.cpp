@@ -0,0 +1,180 @@
+#include "particle_store.h"
+
+void ParticleStore::resize(size_t size)
+{
+	const size_t capacity = (size + PARTICLE_LANES - 1) / PARTICLE_LANES * PARTICLE_LANES;
+	Vector<float> data(capacity * StreamCount, 0.0f);
+	const size_t kept = std::min(m_Size, size);
+	for (int stream = 0; stream < StreamCount; stream++)
+	{
+		std::copy_n(m_Data.begin() + stream * m_Capacity, kept, data.begin() + stream * capacity);
+	}
+
+	m_Data = std::move(data);
+	m_Size = size;
+	m_Capacity = capacity;
+}
+
+void ParticleStore::spawn(size_t index, const ParticleSpawn& particle)
+{
+	m_Data[PositionX * m_Capacity + index] = particle.position.x;
+	m_Data[PositionY * m_Capacity + index] = particle.position.y;
+	m_Data[PositionZ * m_Capacity + index] = particle.position.z;
+	m_Data[VelocityX * m_Capacity + index] = particle.velocity.x;
+	m_Data[VelocityY * m_Capacity + index] = particle.velocity.y;
+	m_Data[VelocityZ * m_Capacity + index] = particle.velocity.z;
+	m_Data[RotationX * m_Capacity + index] = particle.rotation.x;
+	m_Data[RotationY * m_Capacity + index] = particle.rotation.y;
+	m_Data[RotationZ * m_Capacity + index] = particle.rotation.z;
+	m_Data[RotationW * m_Capacity + index] = particle.rotation.w;
+	m_Data[AngularVelocityX * m_Capacity + index] = particle.angularVelocity.x;
+	m_Data[AngularVelocityY * m_Capacity + index] = particle.angularVelocity.y;
+	m_Data[AngularVelocityZ * m_Capacity + index] = particle.angularVelocity.z;
+	m_Data[SizeBegin * m_Capacity + index] = particle.sizeBegin;
+	m_Data[SizeEnd * m_Capacity + index] = particle.sizeEnd;
+	m_Data[InverseLifeTime * m_Capacity + index] = particle.lifeTime > 0.0f ? 1.0f / particle.lifeTime : 0.0f;
+	m_Data[LifeRemaining * m_Capacity + index] = particle.lifeTime;
+	m_Data[ColorBeginR * m_Capacity + index] = particle.colorBegin.x;
+	m_Data[ColorBeginG * m_Capacity + index] = particle.colorBegin.y;
+	m_Data[ColorBeginB * m_Capacity + index] = particle.colorBegin.z;
+	m_Data[ColorBeginA * m_Capacity + index] = particle.colorBegin.w;
+	m_Data[ColorEndR * m_Capacity + index] = particle.colorEnd.x;
+	m_Data[ColorEndG * m_Capacity + index] = particle.colorEnd.y;
+	m_Data[ColorEndB * m_Capacity + index] = particle.colorEnd.z;
+	m_Data[ColorEndA * m_Capacity + index] = particle.colorEnd.w;
+}
+
+void ParticleStore::clear()
+{
+	std::fill_n(getStream(LifeRemaining), m_Capacity, 0.0f);
+}
+
+size_t ParticleStore::simulate(size_t first, size_t last, float delta, InstanceData* output)
+{
+	using namespace DirectX;
+
+	float* streams[StreamCount];
+	for (int stream = 0; stream < StreamCount; stream++)
+	{
+		streams[stream] = getStream((Stream)stream);
+	}
+	auto load = [&streams](Stream stream, size_t i) {
+		return XMLoadFloat4((const XMFLOAT4*)(streams[stream] + i));
+	};
+	auto store = [&streams](Stream stream, size_t i, FXMVECTOR value) {
+		XMStoreFloat4((XMFLOAT4*)(streams[stream] + i), value);
+	};
+
+	const XMVECTOR zero = XMVectorZero();
+	const XMVECTOR one = XMVectorSplatOne();
+	const XMVECTOR two = XMVectorReplicate(2.0f);
+	const XMVECTOR tinySize = XMVectorReplicate(1e-6f);
+	const XMVECTOR deltaLanes = XMVectorReplicate(delta);
+	const XMVECTOR halfDelta = XMVectorReplicate(delta * 0.5f);
+	const XMVECTOR inverseTransposeRowW = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+
+	size_t count = 0;
+	for (size_t i = first; i < last; i += PARTICLE_LANES)
+	{
+		const XMVECTOR lifeRemaining = XMVectorSubtract(load(LifeRemaining, i), deltaLanes);
+		store(LifeRemaining, i, lifeRemaining);
+		const XMVECTOR isAlive = XMVectorGreater(lifeRemaining, zero);
+		if (XMVector4EqualInt(isAlive, XMVectorFalseInt()))
+		{
+			continue;
+		}
+
+		const XMVECTOR life = XMVectorMultiply(lifeRemaining, load(InverseLifeTime, i));
+		const XMVECTOR sizeEnd = load(SizeEnd, i);
+		const XMVECTOR size = XMVectorMultiplyAdd(XMVectorSubtract(load(SizeBegin, i), sizeEnd), life, sizeEnd);
+
+		const XMVECTOR px = XMVectorMultiplyAdd(load(VelocityX, i), deltaLanes, load(PositionX, i));
+		const XMVECTOR py = XMVectorMultiplyAdd(load(VelocityY, i), deltaLanes, load(PositionY, i));
+		const XMVECTOR pz = XMVectorMultiplyAdd(load(VelocityZ, i), deltaLanes, load(PositionZ, i));
+		store(PositionX, i, px);
+		store(PositionY, i, py);
+		store(PositionZ, i, pz);
+
+		// Rotation for this frame, the same as Quaternion::CreateFromYawPitchRoll on the angular velocity
+		XMVECTOR sinYaw, cosYaw, sinPitch, cosPitch, sinRoll, cosRoll;
+		XMVectorSinCos(&sinYaw, &cosYaw, XMVectorMultiply(load(AngularVelocityX, i), halfDelta));
+		XMVectorSinCos(&sinPitch, &cosPitch, XMVectorMultiply(load(AngularVelocityY, i), halfDelta));
+		XMVectorSinCos(&sinRoll, &cosRoll, XMVectorMultiply(load(AngularVelocityZ, i), halfDelta));
+		const XMVECTOR cosPitchCosYaw = XMVectorMultiply(cosPitch, cosYaw);
+		const XMVECTOR sinPitchSinYaw = XMVectorMultiply(sinPitch, sinYaw);
+		const XMVECTOR sinPitchCosYaw = XMVectorMultiply(sinPitch, cosYaw);
+		const XMVECTOR cosPitchSinYaw = XMVectorMultiply(cosPitch, sinYaw);
+		const XMVECTOR dx = XMVectorMultiplyAdd(cosRoll, sinPitchCosYaw, XMVectorMultiply(sinRoll, cosPitchSinYaw));
+		const XMVECTOR dy = XMVectorNegativeMultiplySubtract(sinRoll, sinPitchCosYaw, XMVectorMultiply(cosRoll, cosPitchSinYaw));
+		const XMVECTOR dz = XMVectorNegativeMultiplySubtract(cosRoll, sinPitchSinYaw, XMVectorMultiply(sinRoll, cosPitchCosYaw));
+		const XMVECTOR dw = XMVectorMultiplyAdd(cosRoll, cosPitchCosYaw, XMVectorMultiply(sinRoll, sinPitchSinYaw));
+
+		// Concatenate it after the current rotation, the same as Quaternion::Concatenate
+		const XMVECTOR ax = load(RotationX, i);
+		const XMVECTOR ay = load(RotationY, i);
+		const XMVECTOR az = load(RotationZ, i);
+		const XMVECTOR aw = load(RotationW, i);
+		const XMVECTOR qx = XMVectorNegativeMultiplySubtract(az, dy, XMVectorMultiplyAdd(ay, dz, XMVectorMultiplyAdd(dw, ax, XMVectorMultiply(aw, dx))));
+		const XMVECTOR qy = XMVectorNegativeMultiplySubtract(ax, dz, XMVectorMultiplyAdd(az, dx, XMVectorMultiplyAdd(dw, ay, XMVectorMultiply(aw, dy))));
+		const XMVECTOR qz = XMVectorNegativeMultiplySubtract(ay, dx, XMVectorMultiplyAdd(ax, dy, XMVectorMultiplyAdd(dw, az, XMVectorMultiply(aw, dz))));
+		const XMVECTOR qw = XMVectorNegativeMultiplySubtract(az, dz, XMVectorNegativeMultiplySubtract(ay, dy, XMVectorNegativeMultiplySubtract(ax, dx, XMVectorMultiply(aw, dw))));
+		store(RotationX, i, qx);
+		store(RotationY, i, qy);
+		store(RotationZ, i, qz);
+		store(RotationW, i, qw);
+
+		// Rotation matrix rows, the same as Matrix::CreateFromQuaternion
+		const XMVECTOR xx = XMVectorMultiply(qx, qx);
+		const XMVECTOR yy = XMVectorMultiply(qy, qy);
+		const XMVECTOR zz = XMVectorMultiply(qz, qz);
+		const XMVECTOR xy = XMVectorMultiply(qx, qy);
+		const XMVECTOR xz = XMVectorMultiply(qx, qz);
+		const XMVECTOR yz = XMVectorMultiply(qy, qz);
+		const XMVECTOR xw = XMVectorMultiply(qx, qw);
+		const XMVECTOR yw = XMVectorMultiply(qy, qw);
+		const XMVECTOR zw = XMVectorMultiply(qz, qw);
+		const XMVECTOR r00 = XMVectorNegativeMultiplySubtract(two, XMVectorAdd(yy, zz), one);
+		const XMVECTOR r01 = XMVectorMultiply(two, XMVectorAdd(xy, zw));
+		const XMVECTOR r02 = XMVectorMultiply(two, XMVectorSubtract(xz, yw));
+		const XMVECTOR r10 = XMVectorMultiply(two, XMVectorSubtract(xy, zw));
+		const XMVECTOR r11 = XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, zz), one);
+		const XMVECTOR r12 = XMVectorMultiply(two, XMVectorAdd(yz, xw));
+		const XMVECTOR r20 = XMVectorMultiply(two, XMVectorAdd(xz, yw));
+		const XMVECTOR r21 = XMVectorMultiply(two, XMVectorSubtract(yz, xw));
+		const XMVECTOR r22 = XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, yy), one);
+
+		// Scale * rotation * translation has the inverse transpose rotation / scale with -dot(position, row) / scale in the last column.
+		// Vanishing particles would divide by zero, and their normals only need the rotation.
+		const XMVECTOR inverseSize = XMVectorReciprocal(XMVectorSelect(size, one, XMVectorLess(XMVectorAbs(size), tinySize)));
+		const XMVECTOR d0 = XMVectorMultiplyAdd(pz, r02, XMVectorMultiplyAdd(py, r01, XMVectorMultiply(px, r00)));
+		const XMVECTOR d1 = XMVectorMultiplyAdd(pz, r12, XMVectorMultiplyAdd(py, r11, XMVectorMultiply(px, r10)));
+		const XMVECTOR d2 = XMVectorMultiplyAdd(pz, r22, XMVectorMultiplyAdd(py, r21, XMVectorMultiply(px, r20)));
+
+		// Turn the lanes of each row into one row per particle
+		const XMMATRIX transformRowX = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(r00, size), XMVectorMultiply(r01, size), XMVectorMultiply(r02, size), zero));
+		const XMMATRIX transformRowY = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(r10, size), XMVectorMultiply(r11, size), XMVectorMultiply(r12, size), zero));
+		const XMMATRIX transformRowZ = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(r20, size), XMVectorMultiply(r21, size), XMVectorMultiply(r22, size), zero));
+		const XMMATRIX transformRowW = XMMatrixTranspose(XMMATRIX(px, py, pz, one));
+		const XMMATRIX inverseTransposeRowX = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(r00, inverseSize), XMVectorMultiply(r01, inverseSize), XMVectorMultiply(r02, inverseSize), XMVectorNegate(XMVectorMultiply(d0, inverseSize))));
+		const XMMATRIX inverseTransposeRowY = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(r10, inverseSize), XMVectorMultiply(r11, inverseSize), XMVectorMultiply(r12, inverseSize), XMVectorNegate(XMVectorMultiply(d1, inverseSize))));
+		const XMMATRIX inverseTransposeRowZ = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(r20, inverseSize), XMVectorMultiply(r21, inverseSize), XMVectorMultiply(r22, inverseSize), XMVectorNegate(XMVectorMultiply(d2, inverseSize))));
+		const XMMATRIX color = XMMatrixTranspose(XMMATRIX(
+		    XMVectorLerpV(load(ColorEndR, i), load(ColorBeginR, i), life),
+		    XMVectorLerpV(load(ColorEndG, i), load(ColorBeginG, i), life),
+		    XMVectorLerpV(load(ColorEndB, i), load(ColorBeginB, i), life),
+		    XMVectorLerpV(load(ColorEndA, i), load(ColorBeginA, i), life)));
+
+		// Every lane is written to the next free instance, which only moves past live ones
+		uint32_t isLaneAlive[PARTICLE_LANES];
+		XMStoreInt4(isLaneAlive, isAlive);
+		for (int lane = 0; lane < PARTICLE_LANES; lane++)
+		{
+			InstanceData& instance = output[count];
+			XMStoreFloat4x4(&instance.transform, XMMATRIX(transformRowX.r[lane], transformRowY.r[lane], transformRowZ.r[lane], transformRowW.r[lane]));
+			XMStoreFloat4x4(&instance.inverseTransposeTransform, XMMATRIX(inverseTransposeRowX.r[lane], inverseTransposeRowY.r[lane], inverseTransposeRowZ.r[lane], inverseTransposeRowW));
+			XMStoreFloat4(&instance.color, color.r[lane]);
+			count += isLaneAlive[lane] & 1;
+		}
+	}
+	return count;
+}
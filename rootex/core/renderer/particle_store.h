@@ -0,0 +1,86 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/renderer/vertex_data.h"
+
+/// Number of particles simulated together in one SIMD register
+#define PARTICLE_LANES 4
+
+/// State a particle starts its life with
+struct ParticleSpawn
+{
+	Vector3 position;
+	Quaternion rotation;
+	Vector3 velocity;
+	/// Yaw, pitch and roll rates in radians per second
+	Vector3 angularVelocity;
+	Color colorBegin;
+	Color colorEnd;
+	float sizeBegin;
+	float sizeEnd;
+	float lifeTime;
+};
+
+/// Particle pool stored as one array per attribute, so particles are simulated PARTICLE_LANES at a time with SIMD.
+/// Only depends on plain data, so it can be simulated and measured without a renderer.
+/// Simulation can be split across threads by calling simulate on disjoint blocks, each writing to its own part of the output.
+class ParticleStore
+{
+	enum Stream
+	{
+		PositionX,
+		PositionY,
+		PositionZ,
+		VelocityX,
+		VelocityY,
+		VelocityZ,
+		RotationX,
+		RotationY,
+		RotationZ,
+		RotationW,
+		AngularVelocityX,
+		AngularVelocityY,
+		AngularVelocityZ,
+		SizeBegin,
+		SizeEnd,
+		InverseLifeTime,
+		LifeRemaining,
+		ColorBeginR,
+		ColorBeginG,
+		ColorBeginB,
+		ColorBeginA,
+		ColorEndR,
+		ColorEndG,
+		ColorEndB,
+		ColorEndA,
+		StreamCount
+	};
+
+	size_t m_Size = 0;
+	/// Size rounded up to a whole number of lanes. Padding particles are never alive.
+	size_t m_Capacity = 0;
+	/// All streams back to back, m_Capacity floats each
+	Vector<float> m_Data;
+
+	float* getStream(Stream stream) { return m_Data.data() + stream * m_Capacity; }
+
+public:
+	ParticleStore() = default;
+	ParticleStore(ParticleStore&) = delete;
+	~ParticleStore() = default;
+
+	/// Change the number of particles, keeping the ones that still fit. New particles start dead.
+	void resize(size_t size);
+	/// Overwrite the particle at index with a new one
+	void spawn(size_t index, const ParticleSpawn& particle);
+	/// Kill every particle
+	void clear();
+
+	/// Advance particles first to last, which must be multiples of PARTICLE_LANES, by delta seconds.
+	/// Instances of the particles left alive are packed from the start of output, which needs room for last - first instances.
+	/// Returns the number of instances written.
+	size_t simulate(size_t first, size_t last, float delta, InstanceData* output);
+
+	size_t getSize() const { return m_Size; }
+	size_t getCapacity() const { return m_Capacity; }
+};
@@ -8,6 +8,7 @@
 #include <iostream>
 
 #include "shader_library.h"
+#include "rhi/d3d11_render_backend.h"
 
 #include "Tracy/Tracy.hpp"
 
@@ -25,6 +26,7 @@ void Renderer::setViewport(Viewport& viewport)
 void Renderer::resetCurrentShader()
 {
 	m_CurrentShader = nullptr;
+	m_IsPackedLayoutBound = false;
 }
 
 void Renderer::bind(Material* material)
@@ -35,23 +37,57 @@ void Renderer::bind(Material* material)
 		ZoneNamedN(materialBind, "Shader Bind", true);
 		m_CurrentShader = material->getShader();
 		m_CurrentShader->bind();
+		m_IsPackedLayoutBound = false;
 	}
 	material->bind();
 }
 
-void Renderer::draw(const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer) const
+void Renderer::resetCurrentGeometry()
 {
-	vertexBuffer->bind();
-	indexBuffer->bind();
-	RenderingDevice::GetSingleton()->drawIndexed(indexBuffer->getCount());
+	m_Commands.reset();
 }
 
-void Renderer::drawInstanced(const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer, const VertexBuffer* instanceBuffer, unsigned int instances) const
+void Renderer::bindInputLayout(const VertexBuffer* vertexBuffer)
 {
-	ID3D11Buffer* buffers[2] = { vertexBuffer->getBuffer(), instanceBuffer->getBuffer() };
+	if (m_CurrentShader && vertexBuffer->isPacked() != m_IsPackedLayoutBound)
+	{
+		m_CurrentShader->bindInputLayout(vertexBuffer->isPacked());
+		m_IsPackedLayoutBound = vertexBuffer->isPacked();
+	}
+}
+
+void Renderer::flush()
+{
+	m_Commands.replay(*D3D11RenderBackend::GetSingleton());
+	m_Commands.clear();
+}
+
+void Renderer::draw(const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer)
+{
+	bindInputLayout(vertexBuffer);
+	m_Commands.bindVertexBuffer(ToRHI(vertexBuffer->getBuffer()), vertexBuffer->getStride());
+	m_Commands.bindIndexBuffer(ToRHI(indexBuffer->getBuffer()), ToRHIIndexFormat(indexBuffer->getFormat()));
+	m_Commands.drawIndexed(indexBuffer->getCount(), indexBuffer->getStartIndex(), vertexBuffer->getBaseVertex());
+	flush();
+}
+
+void Renderer::drawInstanced(const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer, const VertexBuffer* instanceBuffer, unsigned int instances)
+{
+	bindInputLayout(vertexBuffer);
+	RHIBuffer* buffers[2] = { ToRHI(vertexBuffer->getBuffer()), ToRHI(instanceBuffer->getBuffer()) };
 	unsigned int strides[2] = { vertexBuffer->getStride(), instanceBuffer->getStride() };
 	unsigned int offsets[2] = { 0, 0 };
-	RenderingDevice::GetSingleton()->bind(buffers, 2, strides, offsets);
-	indexBuffer->bind();
-	RenderingDevice::GetSingleton()->drawIndexedInstanced(indexBuffer->getCount(), instances, 0);
+	m_Commands.bindVertexBuffers(2, buffers, strides, offsets);
+	m_Commands.bindIndexBuffer(ToRHI(indexBuffer->getBuffer()), ToRHIIndexFormat(indexBuffer->getFormat()));
+	m_Commands.drawIndexedInstanced(indexBuffer->getCount(), instances, indexBuffer->getStartIndex(), vertexBuffer->getBaseVertex(), 0);
+	flush();
+}
+
+void Renderer::submit(const CommandBuffer& commands)
+{
+	ZoneScoped;
+	commands.replay(*D3D11RenderBackend::GetSingleton());
+	// The shaders and buffers bound by the commands are unknown here
+	resetCurrentShader();
+	resetCurrentGeometry();
 }
@@ -5,11 +5,20 @@
 #include "material.h"
 #include "rendering_device.h"
 #include "viewport.h"
+#include "rhi/command_buffer.h"
 
 /// Makes the rendering draw call and set viewport, instrumental in seperating Game and HUD rendering
 class Renderer
 {
 	Shader* m_CurrentShader;
+	/// If the current shader reads packed vertices
+	bool m_IsPackedLayoutBound = false;
+	/// Geometry binds and draws, replayed as soon as they are recorded since materials still bind through RenderingDevice.
+	/// Keeps the geometry buffers left bound by the last draw, so meshes sharing geometry pages draw without rebinding.
+	CommandBuffer m_Commands;
+
+	void bindInputLayout(const VertexBuffer* vertexBuffer);
+	void flush();
 
 public:
 	Renderer();
@@ -20,7 +29,11 @@ public:
 	void setViewport(Viewport& viewport);
 
 	void resetCurrentShader();
+	/// Forget the bound geometry buffers. Call when something else may have bound buffers or freed the bound ones.
+	void resetCurrentGeometry();
 	void bind(Material* material);
-	void draw(const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer) const;
-	void drawInstanced(const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer, const VertexBuffer* instanceBuffer, unsigned int instances) const;
+	void draw(const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer);
+	void drawInstanced(const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer, const VertexBuffer* instanceBuffer, unsigned int instances);
+	/// Replay commands recorded elsewhere, possibly on other threads
+	void submit(const CommandBuffer& commands);
 };
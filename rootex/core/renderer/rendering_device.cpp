@@ -445,6 +445,43 @@ Microsoft::WRL::ComPtr<ID3D11Buffer> RenderingDevice::createBuffer(D3D11_BUFFER_
 	return buffer;
 }
 
+Microsoft::WRL::ComPtr<ID3D11Buffer> RenderingDevice::createBuffer(const void* data, unsigned int bytes, UINT bindFlags, BufferUsage usage)
+{
+	D3D11_BUFFER_DESC bd = { 0 };
+	bd.BindFlags = bindFlags;
+	bd.ByteWidth = bytes;
+	switch (usage)
+	{
+	case BufferUsage::Immutable:
+		bd.Usage = D3D11_USAGE_IMMUTABLE;
+		break;
+	case BufferUsage::Default:
+		bd.Usage = D3D11_USAGE_DEFAULT;
+		break;
+	case BufferUsage::Dynamic:
+		bd.Usage = D3D11_USAGE_DYNAMIC;
+		bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		break;
+	}
+	D3D11_SUBRESOURCE_DATA sd = { 0 };
+	sd.pSysMem = data;
+
+	return createBuffer(&bd, data ? &sd : nullptr);
+}
+
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> RenderingDevice::createBufferSRV(ID3D11Buffer* buffer, unsigned int count)
+{
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	srvDesc.Buffer.FirstElement = 0;
+	srvDesc.Buffer.NumElements = count;
+
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv = nullptr;
+	GFX_ERR_CHECK(m_Device->CreateShaderResourceView(buffer, &srvDesc, &srv));
+	return srv;
+}
+
 Microsoft::WRL::ComPtr<ID3D11Buffer> RenderingDevice::createVSCB(D3D11_BUFFER_DESC* cbd, D3D11_SUBRESOURCE_DATA* csd)
 {
 	Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer = nullptr;
@@ -487,12 +524,12 @@ Microsoft::WRL::ComPtr<ID3D11InputLayout> RenderingDevice::createVL(ID3DBlob* ve
 	return inputLayout;
 }
 
-Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> RenderingDevice::createDDSTexture(const char* imageDDSFileData, size_t size)
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> RenderingDevice::createDDSTexture(const char* imageDDSFileData, size_t size, bool isCubeMap)
 {
 	Microsoft::WRL::ComPtr<ID3D11Resource> textureResource;
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> textureView;
 
-	if (FAILED(DirectX::CreateDDSTextureFromMemoryEx(m_Device.Get(), (const uint8_t*)imageDDSFileData, size, 0, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, D3D11_RESOURCE_MISC_TEXTURECUBE, false, &textureResource, &textureView)))
+	if (FAILED(DirectX::CreateDDSTextureFromMemoryEx(m_Device.Get(), (const uint8_t*)imageDDSFileData, size, 0, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, isCubeMap ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0, false, &textureResource, &textureView)))
 	{
 		ERR("Could not load DDS texture from file data");
 	}
@@ -550,6 +587,47 @@ Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> RenderingDevice::createTextureF
 	return textureSRV;
 }
 
+Microsoft::WRL::ComPtr<ID3D11Texture2D> RenderingDevice::createTexture2D(DXGI_FORMAT format, unsigned int width, unsigned int height, unsigned int mipLevels, const D3D11_SUBRESOURCE_DATA* levels)
+{
+	D3D11_TEXTURE2D_DESC textureDesc = {};
+	textureDesc.Width = width;
+	textureDesc.Height = height;
+	textureDesc.MipLevels = mipLevels;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = format;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> texture2D;
+	if (FAILED(m_Device->CreateTexture2D(&textureDesc, levels, &texture2D)))
+	{
+		ERR("Could not create texture 2D with " + std::to_string(mipLevels) + " mips");
+	}
+	return texture2D;
+}
+
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> RenderingDevice::createTextureSRV(ID3D11Texture2D* texture)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	texture->GetDesc(&textureDesc);
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Format = textureDesc.Format;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	srvDesc.Texture2D.MipLevels = textureDesc.MipLevels;
+
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> textureSRV;
+	if (FAILED(m_Device->CreateShaderResourceView(texture, &srvDesc, &textureSRV)))
+	{
+		ERR("Could not create texture view");
+	}
+	return textureSRV;
+}
+
 void RenderingDevice::bind(ID3D11Buffer* const* vertexBuffer, int count, const unsigned int* stride, const unsigned int* offset)
 {
 	m_Context->IASetVertexBuffers(0u, count, vertexBuffer, stride, offset);
@@ -576,9 +654,9 @@ void RenderingDevice::bind(ID3D11InputLayout* inputLayout)
 }
 
 //Assuming subresource offset = 0
-void RenderingDevice::mapBuffer(ID3D11Buffer* buffer, D3D11_MAPPED_SUBRESOURCE& subresource)
+void RenderingDevice::mapBuffer(ID3D11Buffer* buffer, D3D11_MAPPED_SUBRESOURCE& subresource, D3D11_MAP mapType)
 {
-	if (FAILED(m_Context->Map(buffer, 0u, D3D11_MAP_WRITE_DISCARD, 0u, &subresource)))
+	if (FAILED(m_Context->Map(buffer, 0u, mapType, 0u, &subresource)))
 	{
 		ERR("Could not map to buffer");
 	}
@@ -590,6 +668,23 @@ void RenderingDevice::unmapBuffer(ID3D11Buffer* buffer)
 	m_Context->Unmap(buffer, 0);
 }
 
+void RenderingDevice::updateBuffer(ID3D11Buffer* buffer, unsigned int byteOffset, const void* data, unsigned int bytes)
+{
+	D3D11_BOX box = { byteOffset, 0u, 0u, byteOffset + bytes, 1u, 1u };
+	m_Context->UpdateSubresource(buffer, 0u, &box, data, 0u, 0u);
+}
+
+void RenderingDevice::updateTexture(ID3D11Texture2D* texture, unsigned int mip, const void* data, unsigned int rowPitch)
+{
+	// Textures without array slices number their subresources by mip
+	m_Context->UpdateSubresource(texture, mip, nullptr, data, rowPitch, 0u);
+}
+
+void RenderingDevice::copyTexture(ID3D11Texture2D* destination, unsigned int destinationMip, ID3D11Texture2D* source, unsigned int sourceMip)
+{
+	m_Context->CopySubresourceRegion(destination, destinationMip, 0u, 0u, 0u, source, sourceMip, nullptr);
+}
+
 void RenderingDevice::setInPixelShader(unsigned int slot, unsigned int number, ID3D11ShaderResourceView* texture)
 {
 	m_Context->PSSetShaderResources(slot, number, &texture);
@@ -827,12 +922,24 @@ void RenderingDevice::drawIndexed(UINT number)
 	m_Context->DrawIndexed(number, 0u, 0u);
 }
 
+void RenderingDevice::drawIndexed(UINT indices, UINT startIndex, INT baseVertex)
+{
+	ZoneNamedN(drawCall, "Draw Call", true);
+	m_Context->DrawIndexed(indices, startIndex, baseVertex);
+}
+
 void RenderingDevice::drawIndexedInstanced(UINT indices, UINT instances, UINT startInstance)
 {
 	ZoneNamedN(drawCall, "Draw Instances Call", true);
 	m_Context->DrawIndexedInstanced(indices, instances, 0u, 0u, startInstance);
 }
 
+void RenderingDevice::drawIndexedInstanced(UINT indices, UINT instances, UINT startIndex, INT baseVertex, UINT startInstance)
+{
+	ZoneNamedN(drawCall, "Draw Instances Call", true);
+	m_Context->DrawIndexedInstanced(indices, instances, startIndex, baseVertex, startInstance);
+}
+
 void RenderingDevice::beginDrawUI()
 {
 	m_FontBatch->Begin();
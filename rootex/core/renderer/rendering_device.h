@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/common.h"
+#include "core/renderer/buffer_usage.h"
 
 #include <d3d11.h>
 #include <d3dcompiler.h>
@@ -85,6 +86,10 @@ public:
 
 	void createRTVAndSRV(Microsoft::WRL::ComPtr<ID3D11RenderTargetView>& rtv, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& srv);
 	Microsoft::WRL::ComPtr<ID3D11Buffer> createBuffer(D3D11_BUFFER_DESC* bd, D3D11_SUBRESOURCE_DATA* sd);
+	/// Buffer with bind flags and usage chosen by how it is written. Immutable buffers need their data at creation.
+	Microsoft::WRL::ComPtr<ID3D11Buffer> createBuffer(const void* data, unsigned int bytes, UINT bindFlags, BufferUsage usage);
+	/// View of a structured buffer for reading in shaders
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> createBufferSRV(ID3D11Buffer* buffer, unsigned int count);
 	Microsoft::WRL::ComPtr<ID3D11Buffer> createVSCB(D3D11_BUFFER_DESC* cbd, D3D11_SUBRESOURCE_DATA* csd);
 	Microsoft::WRL::ComPtr<ID3D11Buffer> createPSCB(D3D11_BUFFER_DESC* cbd, D3D11_SUBRESOURCE_DATA* csd);
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> createPS(ID3DBlob* blob);
@@ -94,9 +99,13 @@ public:
 	Ref<DirectX::SpriteFont> createFont(const String& fontFilePath);
 	/// To hold shader blobs loaded from the compiled shader files
 	Microsoft::WRL::ComPtr<ID3DBlob> createBlob(LPCWSTR path);
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> createDDSTexture(const char* imageDDSFileData, size_t size);
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> createDDSTexture(const char* imageDDSFileData, size_t size, bool isCubeMap);
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> createTexture(const char* imageFileData, size_t size);
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> createTextureFromPixels(const char* imageRawData, unsigned int width, unsigned int height);
+	/// Default usage texture with a mip chain. Either every mip gets data from levels or none does, to be filled with updateTexture and copyTexture.
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> createTexture2D(DXGI_FORMAT format, unsigned int width, unsigned int height, unsigned int mipLevels, const D3D11_SUBRESOURCE_DATA* levels);
+	/// View of every mip of a texture
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> createTextureSRV(ID3D11Texture2D* texture);
 	Microsoft::WRL::ComPtr<ID3D11SamplerState> createSS();
 	Microsoft::WRL::ComPtr<ID3D11SamplerState> createSSAnisotropic();
 
@@ -106,8 +115,15 @@ public:
 	void bind(ID3D11PixelShader* pixelShader);
 	void bind(ID3D11InputLayout* inputLayout);
 
-	void mapBuffer(ID3D11Buffer* buffer, D3D11_MAPPED_SUBRESOURCE& subresource);
+	/// Maps a dynamic buffer for writing. WRITE_NO_OVERWRITE lets ring buffers append without stalling on in-flight draws
+	void mapBuffer(ID3D11Buffer* buffer, D3D11_MAPPED_SUBRESOURCE& subresource, D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD);
 	void unmapBuffer(ID3D11Buffer* buffer);
+	/// Overwrite part of a default usage buffer
+	void updateBuffer(ID3D11Buffer* buffer, unsigned int byteOffset, const void* data, unsigned int bytes);
+	/// Overwrite a whole mip of a default usage texture. Rows of block compressed formats are rows of 4x4 blocks.
+	void updateTexture(ID3D11Texture2D* texture, unsigned int mip, const void* data, unsigned int rowPitch);
+	/// Copy a mip between textures of the same format, on the GPU
+	void copyTexture(ID3D11Texture2D* destination, unsigned int destinationMip, ID3D11Texture2D* source, unsigned int sourceMip);
 
 	/// Binds textures used in Pixel Shader
 	void setInPixelShader(unsigned int slot, unsigned int number, ID3D11ShaderResourceView* texture);
@@ -153,7 +169,9 @@ public:
 
 	/// The last boss, draws Triangles
 	void drawIndexed(UINT indices);
+	void drawIndexed(UINT indices, UINT startIndex, INT baseVertex);
 	void drawIndexedInstanced(UINT indices, UINT instances, UINT startInstance);
+	void drawIndexedInstanced(UINT indices, UINT instances, UINT startIndex, INT baseVertex, UINT startInstance);
 
 	void beginDrawUI();
 	void endDrawUI();
@@ -0,0 +1,192 @@
+#include "command_buffer.h"
+
+#include <cassert>
+#include <cstring>
+
+/// Constant buffers are read in 16 byte registers
+#define RHI_CONSTANT_ALIGNMENT 16
+
+CommandBuffer::Command& CommandBuffer::push(Type type)
+{
+	Command& command = m_Commands.emplace_back();
+	command.type = type;
+	return command;
+}
+
+void CommandBuffer::bindShaders(RHIVertexShader* vertexShader, RHIPixelShader* pixelShader, RHIInputLayout* inputLayout)
+{
+	vertexShader = vertexShader == m_VertexShader ? nullptr : vertexShader;
+	pixelShader = pixelShader == m_PixelShader ? nullptr : pixelShader;
+	inputLayout = inputLayout == m_InputLayout ? nullptr : inputLayout;
+	if (!vertexShader && !pixelShader && !inputLayout)
+	{
+		return;
+	}
+
+	Command& command = push(Type::BindShaders);
+	command.shaders.vertexShader = vertexShader;
+	command.shaders.pixelShader = pixelShader;
+	command.shaders.inputLayout = inputLayout;
+	m_VertexShader = vertexShader ? vertexShader : m_VertexShader;
+	m_PixelShader = pixelShader ? pixelShader : m_PixelShader;
+	m_InputLayout = inputLayout ? inputLayout : m_InputLayout;
+}
+
+void CommandBuffer::bindVertexBuffers(unsigned int count, RHIBuffer* const* buffers, const unsigned int* strides, const unsigned int* offsets)
+{
+	assert(count <= RHI_MAX_VERTEX_STREAMS);
+	if (count == m_VertexBufferCount
+	    && std::memcmp(buffers, m_VertexBuffers, count * sizeof(RHIBuffer*)) == 0
+	    && std::memcmp(strides, m_VertexStrides, count * sizeof(unsigned int)) == 0
+	    && std::memcmp(offsets, m_VertexOffsets, count * sizeof(unsigned int)) == 0)
+	{
+		return;
+	}
+
+	Command& command = push(Type::BindVertexBuffers);
+	command.vertexBuffers.count = count;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		command.vertexBuffers.buffers[i] = m_VertexBuffers[i] = buffers[i];
+		command.vertexBuffers.strides[i] = m_VertexStrides[i] = strides[i];
+		command.vertexBuffers.offsets[i] = m_VertexOffsets[i] = offsets[i];
+	}
+	m_VertexBufferCount = count;
+}
+
+void CommandBuffer::bindVertexBuffer(RHIBuffer* buffer, unsigned int stride)
+{
+	const unsigned int offset = 0;
+	bindVertexBuffers(1, &buffer, &stride, &offset);
+}
+
+void CommandBuffer::bindIndexBuffer(RHIBuffer* buffer, RHIIndexFormat format)
+{
+	// A buffer only ever holds indices of one format
+	if (buffer == m_IndexBuffer)
+	{
+		return;
+	}
+
+	Command& command = push(Type::BindIndexBuffer);
+	command.indexBuffer.buffer = buffer;
+	command.indexBuffer.format = format;
+	m_IndexBuffer = buffer;
+}
+
+void CommandBuffer::setConstants(RHIShaderStage stage, unsigned int slot, RHIBuffer* buffer, const void* data, unsigned int bytes)
+{
+	const size_t offset = (m_ConstantData.size() + RHI_CONSTANT_ALIGNMENT - 1) & ~(size_t)(RHI_CONSTANT_ALIGNMENT - 1);
+	m_ConstantData.resize(offset + bytes);
+	std::memcpy(m_ConstantData.data() + offset, data, bytes);
+
+	Command& command = push(Type::SetConstants);
+	command.constants.stage = stage;
+	command.constants.slot = slot;
+	command.constants.buffer = buffer;
+	command.constants.offset = (unsigned int)offset;
+	command.constants.bytes = bytes;
+}
+
+void CommandBuffer::bindTexture(unsigned int slot, RHITexture* texture)
+{
+	if (slot < RHI_TRACKED_TEXTURE_SLOTS)
+	{
+		if (texture && texture == m_Textures[slot])
+		{
+			return;
+		}
+		m_Textures[slot] = texture;
+	}
+
+	Command& command = push(Type::BindTexture);
+	command.texture.slot = slot;
+	command.texture.texture = texture;
+}
+
+void CommandBuffer::bindSampler(RHISampler* sampler)
+{
+	if (sampler == m_Sampler)
+	{
+		return;
+	}
+
+	Command& command = push(Type::BindSampler);
+	command.sampler = sampler;
+	m_Sampler = sampler;
+}
+
+void CommandBuffer::drawIndexed(unsigned int indices, unsigned int startIndex, int baseVertex)
+{
+	Command& command = push(Type::DrawIndexed);
+	command.draw.indices = indices;
+	command.draw.instances = 1;
+	command.draw.startIndex = startIndex;
+	command.draw.baseVertex = baseVertex;
+	command.draw.startInstance = 0;
+	m_DrawCount++;
+}
+
+void CommandBuffer::drawIndexedInstanced(unsigned int indices, unsigned int instances, unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	Command& command = push(Type::DrawIndexedInstanced);
+	command.draw.indices = indices;
+	command.draw.instances = instances;
+	command.draw.startIndex = startIndex;
+	command.draw.baseVertex = baseVertex;
+	command.draw.startInstance = startInstance;
+	m_DrawCount++;
+}
+
+void CommandBuffer::replay(RenderBackend& backend) const
+{
+	for (const Command& command : m_Commands)
+	{
+		switch (command.type)
+		{
+		case Type::BindShaders:
+			backend.bindShaders(command.shaders.vertexShader, command.shaders.pixelShader, command.shaders.inputLayout);
+			break;
+		case Type::BindVertexBuffers:
+			backend.bindVertexBuffers(command.vertexBuffers.count, command.vertexBuffers.buffers, command.vertexBuffers.strides, command.vertexBuffers.offsets);
+			break;
+		case Type::BindIndexBuffer:
+			backend.bindIndexBuffer(command.indexBuffer.buffer, command.indexBuffer.format);
+			break;
+		case Type::SetConstants:
+			backend.setConstants(command.constants.stage, command.constants.slot, command.constants.buffer, m_ConstantData.data() + command.constants.offset, command.constants.bytes);
+			break;
+		case Type::BindTexture:
+			backend.bindTexture(command.texture.slot, command.texture.texture);
+			break;
+		case Type::BindSampler:
+			backend.bindSampler(command.sampler);
+			break;
+		case Type::DrawIndexed:
+			backend.drawIndexed(command.draw.indices, command.draw.startIndex, command.draw.baseVertex);
+			break;
+		case Type::DrawIndexedInstanced:
+			backend.drawIndexedInstanced(command.draw.indices, command.draw.instances, command.draw.startIndex, command.draw.baseVertex, command.draw.startInstance);
+			break;
+		}
+	}
+}
+
+void CommandBuffer::clear()
+{
+	m_Commands.clear();
+	m_ConstantData.clear();
+	m_DrawCount = 0;
+}
+
+void CommandBuffer::reset()
+{
+	clear();
+	m_VertexShader = nullptr;
+	m_PixelShader = nullptr;
+	m_InputLayout = nullptr;
+	m_VertexBufferCount = 0;
+	m_IndexBuffer = nullptr;
+	std::memset(m_Textures, 0, sizeof(m_Textures));
+	m_Sampler = nullptr;
+}
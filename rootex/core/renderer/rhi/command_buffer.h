@@ -0,0 +1,149 @@
+#pragma once
+
+#include "renderer/rhi/render_backend.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Pixel shader texture slots whose bindings are tracked to drop redundant binds
+#define RHI_TRACKED_TEXTURE_SLOTS 8
+
+/// Records binds, constant updates and draws to be replayed on a RenderBackend later.
+/// Recording touches nothing but the command buffer, so separate threads can each record their own buffers in parallel
+/// and the render thread submits them in order. Binds that repeat the state already recorded in the same buffer are dropped.
+/// Uses nothing but the standard library, like RenderBackend.
+class CommandBuffer
+{
+	enum class Type : uint8_t
+	{
+		BindShaders,
+		BindVertexBuffers,
+		BindIndexBuffer,
+		SetConstants,
+		BindTexture,
+		BindSampler,
+		DrawIndexed,
+		DrawIndexedInstanced
+	};
+
+	struct BindShadersCommand
+	{
+		RHIVertexShader* vertexShader;
+		RHIPixelShader* pixelShader;
+		RHIInputLayout* inputLayout;
+	};
+
+	struct BindVertexBuffersCommand
+	{
+		unsigned int count;
+		RHIBuffer* buffers[RHI_MAX_VERTEX_STREAMS];
+		unsigned int strides[RHI_MAX_VERTEX_STREAMS];
+		unsigned int offsets[RHI_MAX_VERTEX_STREAMS];
+	};
+
+	struct BindIndexBufferCommand
+	{
+		RHIBuffer* buffer;
+		RHIIndexFormat format;
+	};
+
+	struct SetConstantsCommand
+	{
+		RHIShaderStage stage;
+		unsigned int slot;
+		RHIBuffer* buffer;
+		/// Range of m_ConstantData
+		unsigned int offset;
+		unsigned int bytes;
+	};
+
+	struct BindTextureCommand
+	{
+		unsigned int slot;
+		RHITexture* texture;
+	};
+
+	struct DrawCommand
+	{
+		unsigned int indices;
+		unsigned int instances;
+		unsigned int startIndex;
+		int baseVertex;
+		unsigned int startInstance;
+	};
+
+	struct Command
+	{
+		Type type;
+		union
+		{
+			BindShadersCommand shaders;
+			BindVertexBuffersCommand vertexBuffers;
+			BindIndexBufferCommand indexBuffer;
+			SetConstantsCommand constants;
+			BindTextureCommand texture;
+			RHISampler* sampler;
+			DrawCommand draw;
+		};
+	};
+
+	std::vector<Command> m_Commands;
+	/// Constants are copied here when recorded, so callers may reuse their memory right away
+	std::vector<char> m_ConstantData;
+	unsigned int m_DrawCount = 0;
+
+	/// State recorded so far. Null when not bound in this buffer yet, so the first bind of each is always recorded.
+	RHIVertexShader* m_VertexShader = nullptr;
+	RHIPixelShader* m_PixelShader = nullptr;
+	RHIInputLayout* m_InputLayout = nullptr;
+	unsigned int m_VertexBufferCount = 0;
+	RHIBuffer* m_VertexBuffers[RHI_MAX_VERTEX_STREAMS] = {};
+	unsigned int m_VertexStrides[RHI_MAX_VERTEX_STREAMS] = {};
+	unsigned int m_VertexOffsets[RHI_MAX_VERTEX_STREAMS] = {};
+	RHIBuffer* m_IndexBuffer = nullptr;
+	RHITexture* m_Textures[RHI_TRACKED_TEXTURE_SLOTS] = {};
+	RHISampler* m_Sampler = nullptr;
+
+	Command& push(Type type);
+
+public:
+	CommandBuffer() = default;
+	CommandBuffer(const CommandBuffer&) = delete;
+	CommandBuffer(CommandBuffer&&) = default;
+	CommandBuffer& operator=(CommandBuffer&&) = default;
+	~CommandBuffer() = default;
+
+	/// Null shaders or layouts are left as they were
+	void bindShaders(RHIVertexShader* vertexShader, RHIPixelShader* pixelShader, RHIInputLayout* inputLayout);
+	void bindVertexBuffers(unsigned int count, RHIBuffer* const* buffers, const unsigned int* strides, const unsigned int* offsets);
+	void bindVertexBuffer(RHIBuffer* buffer, unsigned int stride);
+	void bindIndexBuffer(RHIBuffer* buffer, RHIIndexFormat format);
+	/// Copies the data, which is written to the dynamic constant buffer when replayed
+	void setConstants(RHIShaderStage stage, unsigned int slot, RHIBuffer* buffer, const void* data, unsigned int bytes);
+	template <class T>
+	void setConstants(RHIShaderStage stage, unsigned int slot, RHIBuffer* buffer, const T& constants);
+	void bindTexture(unsigned int slot, RHITexture* texture);
+	void bindSampler(RHISampler* sampler);
+
+	void drawIndexed(unsigned int indices, unsigned int startIndex, int baseVertex);
+	void drawIndexedInstanced(unsigned int indices, unsigned int instances, unsigned int startIndex, int baseVertex, unsigned int startInstance);
+
+	/// Run the commands in the order they were recorded. A buffer can be replayed any number of times.
+	void replay(RenderBackend& backend) const;
+	/// Drop the commands and the state recorded, keeping the memory for the next recording
+	void reset();
+	/// Drop the commands but keep the state recorded, for buffers replayed right after recording on a backend left in that state
+	void clear();
+
+	size_t getCommandCount() const { return m_Commands.size(); }
+	unsigned int getDrawCount() const { return m_DrawCount; }
+	size_t getConstantBytes() const { return m_ConstantData.size(); }
+	bool isEmpty() const { return m_Commands.empty(); }
+};
+
+template <class T>
+void CommandBuffer::setConstants(RHIShaderStage stage, unsigned int slot, RHIBuffer* buffer, const T& constants)
+{
+	setConstants(stage, slot, buffer, &constants, sizeof(T));
+}
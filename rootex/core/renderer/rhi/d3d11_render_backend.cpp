@@ -0,0 +1,74 @@
+#include "d3d11_render_backend.h"
+
+#include "renderer/rendering_device.h"
+
+D3D11RenderBackend* D3D11RenderBackend::GetSingleton()
+{
+	static D3D11RenderBackend singleton;
+	return &singleton;
+}
+
+void D3D11RenderBackend::bindShaders(RHIVertexShader* vertexShader, RHIPixelShader* pixelShader, RHIInputLayout* inputLayout)
+{
+	if (vertexShader)
+	{
+		RenderingDevice::GetSingleton()->bind((ID3D11VertexShader*)vertexShader);
+	}
+	if (pixelShader)
+	{
+		RenderingDevice::GetSingleton()->bind((ID3D11PixelShader*)pixelShader);
+	}
+	if (inputLayout)
+	{
+		RenderingDevice::GetSingleton()->bind((ID3D11InputLayout*)inputLayout);
+	}
+}
+
+void D3D11RenderBackend::bindVertexBuffers(unsigned int count, RHIBuffer* const* buffers, const unsigned int* strides, const unsigned int* offsets)
+{
+	RenderingDevice::GetSingleton()->bind((ID3D11Buffer* const*)buffers, count, strides, offsets);
+}
+
+void D3D11RenderBackend::bindIndexBuffer(RHIBuffer* buffer, RHIIndexFormat format)
+{
+	RenderingDevice::GetSingleton()->bind((ID3D11Buffer*)buffer, format == RHIIndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT);
+}
+
+void D3D11RenderBackend::setConstants(RHIShaderStage stage, unsigned int slot, RHIBuffer* buffer, const void* data, unsigned int bytes)
+{
+	ID3D11Buffer* constantBuffer = (ID3D11Buffer*)buffer;
+	D3D11_MAPPED_SUBRESOURCE subresource;
+	RenderingDevice::GetSingleton()->mapBuffer(constantBuffer, subresource);
+	memcpy(subresource.pData, data, bytes);
+	RenderingDevice::GetSingleton()->unmapBuffer(constantBuffer);
+
+	switch (stage)
+	{
+	case RHIShaderStage::Vertex:
+		RenderingDevice::GetSingleton()->setVSCB(constantBuffer, slot);
+		break;
+	case RHIShaderStage::Pixel:
+		RenderingDevice::GetSingleton()->setPSCB(constantBuffer, slot);
+		break;
+	}
+}
+
+void D3D11RenderBackend::bindTexture(unsigned int slot, RHITexture* texture)
+{
+	RenderingDevice::GetSingleton()->setInPixelShader(slot, 1, (ID3D11ShaderResourceView*)texture);
+}
+
+void D3D11RenderBackend::bindSampler(RHISampler* sampler)
+{
+	RenderingDevice::GetSingleton()->setInPixelShader((ID3D11SamplerState*)sampler);
+}
+
+void D3D11RenderBackend::drawIndexed(unsigned int indices, unsigned int startIndex, int baseVertex)
+{
+	RenderingDevice::GetSingleton()->drawIndexed(indices, startIndex, baseVertex);
+}
+
+void D3D11RenderBackend::drawIndexedInstanced(unsigned int indices, unsigned int instances, unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	RenderingDevice::GetSingleton()->drawIndexedInstanced(indices, instances, startIndex, baseVertex, startInstance);
+}
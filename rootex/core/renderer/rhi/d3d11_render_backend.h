@@ -0,0 +1,36 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include "common/common.h"
+#include "renderer/rhi/command_buffer.h"
+
+/// Handles of the D3D11 backend are the D3D11 objects themselves
+inline RHIBuffer* ToRHI(ID3D11Buffer* buffer) { return (RHIBuffer*)buffer; }
+inline RHIVertexShader* ToRHI(ID3D11VertexShader* vertexShader) { return (RHIVertexShader*)vertexShader; }
+inline RHIPixelShader* ToRHI(ID3D11PixelShader* pixelShader) { return (RHIPixelShader*)pixelShader; }
+inline RHIInputLayout* ToRHI(ID3D11InputLayout* inputLayout) { return (RHIInputLayout*)inputLayout; }
+inline RHITexture* ToRHI(ID3D11ShaderResourceView* texture) { return (RHITexture*)texture; }
+inline RHISampler* ToRHI(ID3D11SamplerState* sampler) { return (RHISampler*)sampler; }
+inline RHIIndexFormat ToRHIIndexFormat(DXGI_FORMAT format) { return format == DXGI_FORMAT_R16_UINT ? RHIIndexFormat::UInt16 : RHIIndexFormat::UInt32; }
+
+/// Replays command buffers through RenderingDevice
+class D3D11RenderBackend : public RenderBackend
+{
+	D3D11RenderBackend() = default;
+	D3D11RenderBackend(D3D11RenderBackend&) = delete;
+	~D3D11RenderBackend() = default;
+
+public:
+	static D3D11RenderBackend* GetSingleton();
+
+	void bindShaders(RHIVertexShader* vertexShader, RHIPixelShader* pixelShader, RHIInputLayout* inputLayout) override;
+	void bindVertexBuffers(unsigned int count, RHIBuffer* const* buffers, const unsigned int* strides, const unsigned int* offsets) override;
+	void bindIndexBuffer(RHIBuffer* buffer, RHIIndexFormat format) override;
+	void setConstants(RHIShaderStage stage, unsigned int slot, RHIBuffer* buffer, const void* data, unsigned int bytes) override;
+	void bindTexture(unsigned int slot, RHITexture* texture) override;
+	void bindSampler(RHISampler* sampler) override;
+
+	void drawIndexed(unsigned int indices, unsigned int startIndex, int baseVertex) override;
+	void drawIndexedInstanced(unsigned int indices, unsigned int instances, unsigned int startIndex, int baseVertex, unsigned int startInstance) override;
+};
@@ -0,0 +1,94 @@
+#include "null_render_backend.h"
+
+#include <algorithm>
+#include <iterator>
+
+template <class T>
+void NullRenderBackend::countBind(T*& current, T* bound)
+{
+	if (bound == current)
+	{
+		m_Stats.redundantBinds++;
+		return;
+	}
+	current = bound;
+	m_Stats.stateChanges++;
+}
+
+void NullRenderBackend::bindShaders(RHIVertexShader* vertexShader, RHIPixelShader* pixelShader, RHIInputLayout* inputLayout)
+{
+	if (vertexShader)
+	{
+		countBind(m_VertexShader, vertexShader);
+	}
+	if (pixelShader)
+	{
+		countBind(m_PixelShader, pixelShader);
+	}
+	if (inputLayout)
+	{
+		countBind(m_InputLayout, inputLayout);
+	}
+}
+
+void NullRenderBackend::bindVertexBuffers(unsigned int count, RHIBuffer* const* buffers, const unsigned int* /*strides*/, const unsigned int* /*offsets*/)
+{
+	for (unsigned int i = 0; i < count; i++)
+	{
+		countBind(m_VertexBuffers[i], buffers[i]);
+	}
+}
+
+void NullRenderBackend::bindIndexBuffer(RHIBuffer* buffer, RHIIndexFormat /*format*/)
+{
+	countBind(m_IndexBuffer, buffer);
+}
+
+void NullRenderBackend::setConstants(RHIShaderStage /*stage*/, unsigned int /*slot*/, RHIBuffer* /*buffer*/, const void* /*data*/, unsigned int bytes)
+{
+	m_Stats.constantUpdates++;
+	m_Stats.constantBytes += bytes;
+}
+
+void NullRenderBackend::bindTexture(unsigned int slot, RHITexture* texture)
+{
+	if (slot < RHI_TRACKED_TEXTURE_SLOTS)
+	{
+		countBind(m_Textures[slot], texture);
+	}
+	else
+	{
+		m_Stats.stateChanges++;
+	}
+}
+
+void NullRenderBackend::bindSampler(RHISampler* sampler)
+{
+	countBind(m_Sampler, sampler);
+}
+
+void NullRenderBackend::drawIndexed(unsigned int indices, unsigned int /*startIndex*/, int /*baseVertex*/)
+{
+	m_Stats.draws++;
+	m_Stats.instances++;
+	m_Stats.triangles += indices / 3;
+}
+
+void NullRenderBackend::drawIndexedInstanced(unsigned int indices, unsigned int instances, unsigned int /*startIndex*/, int /*baseVertex*/, unsigned int /*startInstance*/)
+{
+	m_Stats.draws++;
+	m_Stats.instances += instances;
+	m_Stats.triangles += (size_t)(indices / 3) * instances;
+}
+
+void NullRenderBackend::reset()
+{
+	m_Stats = Stats();
+	m_VertexShader = nullptr;
+	m_PixelShader = nullptr;
+	m_InputLayout = nullptr;
+	std::fill(std::begin(m_VertexBuffers), std::end(m_VertexBuffers), nullptr);
+	m_IndexBuffer = nullptr;
+	std::fill(std::begin(m_Textures), std::end(m_Textures), nullptr);
+	m_Sampler = nullptr;
+}
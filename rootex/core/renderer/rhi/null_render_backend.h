@@ -0,0 +1,54 @@
+#pragma once
+
+#include "renderer/rhi/command_buffer.h"
+
+/// Backend that draws nothing and only counts what it is asked to do, for running and measuring rendering code without a GPU
+class NullRenderBackend : public RenderBackend
+{
+public:
+	struct Stats
+	{
+		/// Binds of a shader, layout, buffer, texture or sampler that was not bound already
+		unsigned int stateChanges = 0;
+		/// Binds of what was bound already, which recording should have dropped
+		unsigned int redundantBinds = 0;
+		unsigned int constantUpdates = 0;
+		size_t constantBytes = 0;
+		unsigned int draws = 0;
+		unsigned int instances = 0;
+		size_t triangles = 0;
+	};
+
+private:
+	Stats m_Stats;
+
+	RHIVertexShader* m_VertexShader = nullptr;
+	RHIPixelShader* m_PixelShader = nullptr;
+	RHIInputLayout* m_InputLayout = nullptr;
+	RHIBuffer* m_VertexBuffers[RHI_MAX_VERTEX_STREAMS] = {};
+	RHIBuffer* m_IndexBuffer = nullptr;
+	RHITexture* m_Textures[RHI_TRACKED_TEXTURE_SLOTS] = {};
+	RHISampler* m_Sampler = nullptr;
+
+	template <class T>
+	void countBind(T*& current, T* bound);
+
+public:
+	NullRenderBackend() = default;
+	NullRenderBackend(const NullRenderBackend&) = delete;
+	~NullRenderBackend() = default;
+
+	void bindShaders(RHIVertexShader* vertexShader, RHIPixelShader* pixelShader, RHIInputLayout* inputLayout) override;
+	void bindVertexBuffers(unsigned int count, RHIBuffer* const* buffers, const unsigned int* strides, const unsigned int* offsets) override;
+	void bindIndexBuffer(RHIBuffer* buffer, RHIIndexFormat format) override;
+	void setConstants(RHIShaderStage stage, unsigned int slot, RHIBuffer* buffer, const void* data, unsigned int bytes) override;
+	void bindTexture(unsigned int slot, RHITexture* texture) override;
+	void bindSampler(RHISampler* sampler) override;
+
+	void drawIndexed(unsigned int indices, unsigned int startIndex, int baseVertex) override;
+	void drawIndexedInstanced(unsigned int indices, unsigned int instances, unsigned int startIndex, int baseVertex, unsigned int startInstance) override;
+
+	/// Forget the counts and the state bound, as if starting a new frame on a new device
+	void reset();
+	const Stats& getStats() const { return m_Stats; }
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+/// Backend objects are passed around as opaque handles. They are only ever dereferenced by the backend that created them,
+/// the D3D11 backend takes them to be the D3D11 objects themselves.
+struct RHIBuffer;
+struct RHIVertexShader;
+struct RHIPixelShader;
+struct RHIInputLayout;
+struct RHITexture;
+struct RHISampler;
+
+/// Vertex buffers bound at once, one for the vertices and one for per instance data
+#define RHI_MAX_VERTEX_STREAMS 2
+
+enum class RHIShaderStage
+{
+	Vertex,
+	Pixel
+};
+
+enum class RHIIndexFormat
+{
+	UInt16,
+	UInt32
+};
+
+/// Executes the commands recorded in command buffers. Only called from the thread that submits the command buffers.
+/// Uses nothing but the standard library so rendering code can run against the null backend on any platform.
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() = default;
+
+	/// Null shaders or layouts are left as they were
+	virtual void bindShaders(RHIVertexShader* vertexShader, RHIPixelShader* pixelShader, RHIInputLayout* inputLayout) = 0;
+	/// Binds from the first input slot on
+	virtual void bindVertexBuffers(unsigned int count, RHIBuffer* const* buffers, const unsigned int* strides, const unsigned int* offsets) = 0;
+	virtual void bindIndexBuffer(RHIBuffer* buffer, RHIIndexFormat format) = 0;
+	/// Overwrite a dynamic constant buffer and bind it
+	virtual void setConstants(RHIShaderStage stage, unsigned int slot, RHIBuffer* buffer, const void* data, unsigned int bytes) = 0;
+	/// Textures and samplers are only bound for pixel shaders
+	virtual void bindTexture(unsigned int slot, RHITexture* texture) = 0;
+	virtual void bindSampler(RHISampler* sampler) = 0;
+
+	virtual void drawIndexed(unsigned int indices, unsigned int startIndex, int baseVertex) = 0;
+	virtual void drawIndexedInstanced(unsigned int indices, unsigned int instances, unsigned int startIndex, int baseVertex, unsigned int startInstance) = 0;
+};
@@ -22,6 +22,11 @@ Shader::Shader(const LPCWSTR& vertexPath, const LPCWSTR& pixelPath, const Buffer
 	}
 	m_PixelShader = RenderingDevice::GetSingleton()->createPS(pixelShaderBlob.Get());
 
+	m_InputLayout = CreateInputLayout(vertexShaderBlob.Get(), vertexBufferFormat);
+}
+
+Microsoft::WRL::ComPtr<ID3D11InputLayout> Shader::CreateInputLayout(ID3DBlob* vertexShaderBlob, const BufferFormat& vertexBufferFormat)
+{
 	const Vector<VertexBufferElement>& elements = vertexBufferFormat.getElements();
 
 	Vector<D3D11_INPUT_ELEMENT_DESC> vertexDescArray;
@@ -46,12 +51,23 @@ Shader::Shader(const LPCWSTR& vertexPath, const LPCWSTR& pixelPath, const Buffer
 		vertexDescArray.push_back(desc);
 	}
 
-	m_InputLayout = RenderingDevice::GetSingleton()->createVL(
-	    vertexShaderBlob.Get(),
+	return RenderingDevice::GetSingleton()->createVL(
+	    vertexShaderBlob,
 	    vertexDescArray.data(),
 	    vertexDescArray.size());
 }
 
+void Shader::setPackedFormat(const BufferFormat& packedVertexBufferFormat)
+{
+	Microsoft::WRL::ComPtr<ID3DBlob> vertexShaderBlob = RenderingDevice::GetSingleton()->createBlob(m_VertexPath);
+	if (!vertexShaderBlob)
+	{
+		ERR("Vertex Shader not found");
+		return;
+	}
+	m_PackedInputLayout = CreateInputLayout(vertexShaderBlob.Get(), packedVertexBufferFormat);
+}
+
 Shader::~Shader()
 {
 }
@@ -63,6 +79,18 @@ void Shader::bind() const
 	RenderingDevice::GetSingleton()->bind(m_InputLayout.Get());
 }
 
+void Shader::bindInputLayout(bool isPacked) const
+{
+	if (isPacked && m_PackedInputLayout)
+	{
+		RenderingDevice::GetSingleton()->bind(m_PackedInputLayout.Get());
+	}
+	else
+	{
+		RenderingDevice::GetSingleton()->bind(m_InputLayout.Get());
+	}
+}
+
 ColorShader::ColorShader(const LPCWSTR& vertexPath, const LPCWSTR& pixelPath, const BufferFormat& vertexBufferFormat)
     : Shader(vertexPath, pixelPath, vertexBufferFormat)
 {
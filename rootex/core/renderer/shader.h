@@ -22,15 +22,22 @@ protected:
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> m_VertexShader;
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> m_PixelShader;
 	Microsoft::WRL::ComPtr<ID3D11InputLayout> m_InputLayout;
+	/// Reads PackedVertexData into the same shader inputs. Null for shaders that never see packed vertices.
+	Microsoft::WRL::ComPtr<ID3D11InputLayout> m_PackedInputLayout;
 
 	Shader(const LPCWSTR& vertexPath, const LPCWSTR& pixelPath, const BufferFormat& vertexBufferFormat);
 
+	static Microsoft::WRL::ComPtr<ID3D11InputLayout> CreateInputLayout(ID3DBlob* vertexShaderBlob, const BufferFormat& vertexBufferFormat);
+	void setPackedFormat(const BufferFormat& packedVertexBufferFormat);
+
 	friend class ShaderLibrary;
 
 public:
 	virtual ~Shader();
 
 	virtual void bind() const;
+	/// Switch between the layouts for full and packed vertices. Shaders without a packed layout keep the full one.
+	void bindInputLayout(bool isPacked) const;
 };
 
 class ColorShader : public Shader
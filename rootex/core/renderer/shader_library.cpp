@@ -55,7 +55,14 @@ void ShaderLibrary::MakeShaders()
 		basicBufferFormat.push(VertexBufferElement::Type::FloatFloatFloat, "NORMAL", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
 		basicBufferFormat.push(VertexBufferElement::Type::FloatFloat, "TEXCOORD", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
 		basicBufferFormat.push(VertexBufferElement::Type::FloatFloatFloat, "TANGENT", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
-		MakeShader(ShaderType::Basic, L"rootex/assets/shaders/basic_vertex_shader.cso", L"rootex/assets/shaders/basic_pixel_shader.cso", basicBufferFormat);
+		Shader* basicShader = MakeShader(ShaderType::Basic, L"rootex/assets/shaders/basic_vertex_shader.cso", L"rootex/assets/shaders/basic_pixel_shader.cso", basicBufferFormat);
+
+		BufferFormat packedBasicBufferFormat;
+		packedBasicBufferFormat.push(VertexBufferElement::Type::FloatFloatFloat, "POSITION", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedBasicBufferFormat.push(VertexBufferElement::Type::HalfHalfHalfHalf, "NORMAL", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedBasicBufferFormat.push(VertexBufferElement::Type::HalfHalf, "TEXCOORD", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedBasicBufferFormat.push(VertexBufferElement::Type::HalfHalfHalfHalf, "TANGENT", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		basicShader->setPackedFormat(packedBasicBufferFormat);
 	}
 	{
 		BufferFormat particlesBufferFormat;
@@ -72,7 +79,23 @@ void ShaderLibrary::MakeShaders()
 		particlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_INVERSE_TRANSPOSE_ROWZ", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
 		particlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_INVERSE_TRANSPOSE_ROWW", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
 		particlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_COLOR", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
-		MakeShader(ShaderType::Particles, L"rootex/assets/shaders/particles_vertex_shader.cso", L"rootex/assets/shaders/particles_pixel_shader.cso", particlesBufferFormat);
+		Shader* particlesShader = MakeShader(ShaderType::Particles, L"rootex/assets/shaders/particles_vertex_shader.cso", L"rootex/assets/shaders/particles_pixel_shader.cso", particlesBufferFormat);
+
+		BufferFormat packedParticlesBufferFormat;
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloat, "POSITION", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::HalfHalfHalfHalf, "NORMAL", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::HalfHalf, "TEXCOORD", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::HalfHalfHalfHalf, "TANGENT", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_ROWX", D3D11_INPUT_PER_INSTANCE_DATA, 1, true, 1);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_ROWY", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_ROWZ", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_ROWW", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_INVERSE_TRANSPOSE_ROWX", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_INVERSE_TRANSPOSE_ROWY", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_INVERSE_TRANSPOSE_ROWZ", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_INVERSE_TRANSPOSE_ROWW", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
+		packedParticlesBufferFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_COLOR", D3D11_INPUT_PER_INSTANCE_DATA, 1, false, 1);
+		particlesShader->setPackedFormat(packedParticlesBufferFormat);
 	}
 	{
 		BufferFormat skyFormat;
@@ -87,7 +110,16 @@ void ShaderLibrary::MakeShaders()
 		animationFormat.push(VertexBufferElement::Type::FloatFloatFloat, "TANGENT", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
 		animationFormat.push(VertexBufferElement::Type::IntIntIntInt, "BONEINDICES", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
 		animationFormat.push(VertexBufferElement::Type::FloatFloatFloatFloat, "BONEWEIGHTS", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
-		MakeShader(ShaderType::Animation, L"rootex/assets/shaders/animation_vertex_shader.cso", L"rootex/assets/shaders/basic_pixel_shader.cso", animationFormat);
+		Shader* animationShader = MakeShader(ShaderType::Animation, L"rootex/assets/shaders/animation_vertex_shader.cso", L"rootex/assets/shaders/basic_pixel_shader.cso", animationFormat);
+
+		BufferFormat packedAnimationFormat;
+		packedAnimationFormat.push(VertexBufferElement::Type::FloatFloatFloat, "POSITION", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedAnimationFormat.push(VertexBufferElement::Type::HalfHalfHalfHalf, "NORMAL", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedAnimationFormat.push(VertexBufferElement::Type::HalfHalf, "TEXCOORD", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedAnimationFormat.push(VertexBufferElement::Type::HalfHalfHalfHalf, "TANGENT", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedAnimationFormat.push(VertexBufferElement::Type::UByteUByteUByteUByte, "BONEINDICES", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		packedAnimationFormat.push(VertexBufferElement::Type::ByteByteByteByte, "BONEWEIGHTS", D3D11_INPUT_PER_VERTEX_DATA, 0, false, 0);
+		animationShader->setPackedFormat(packedAnimationFormat);
 	}
 	{
 		BufferFormat fxaaFormat;
@@ -44,8 +44,11 @@ float4 main(PixelInputType input) : SV_TARGET
     finalColor.rgb = lerp(finalColor.rgb, float3(0.0f, 0.0f, 0.0f), material.isLit);
     input.normal = normalize(input.normal);
 
-    float3 normalMapSample = NormalTexture.Sample(SampleType, input.tex).rgb;
-    float3 uncompressedNormal = 2.0f * normalMapSample - 1.0f;
+    // Blue is rebuilt from red and green so that two channel BC5 normal maps work too
+    float2 normalMapSample = NormalTexture.Sample(SampleType, input.tex).rg;
+    float3 uncompressedNormal;
+    uncompressedNormal.xy = 2.0f * normalMapSample - 1.0f;
+    uncompressedNormal.z = sqrt(saturate(1.0f - dot(uncompressedNormal.xy, uncompressedNormal.xy)));
     float3 N = input.normal;
     float3 T = normalize(input.tangent - dot(input.tangent, N) * N);
     float3 B = cross(N, T);
@@ -55,21 +58,22 @@ float4 main(PixelInputType input) : SV_TARGET
     input.normal = lerp(input.normal, mul(uncompressedNormal, TBN), material.hasNormalMap);
 
     float3 specularColor = SpecularTexture.Sample(SampleType, input.tex).rgb;
-    for (int i = 0; i < pointLightCount; i++)
+    LightCluster cluster = GetLightCluster(input.worldPosition.xyz);
+    for (uint pointLight = 0; pointLight < cluster.pointLightCount; pointLight++)
     {
-        finalColor += saturate(GetColorFromPointLight(pointLightInfos[i], toEye, input.normal, input.worldPosition, materialColor, specularColor, material.specPow, material.specularIntensity, material.isLit));
+        finalColor += saturate(GetColorFromPointLight(PointLights[LightIndices[cluster.offset + pointLight]], toEye, input.normal, input.worldPosition, materialColor, specularColor, material.specPow, material.specularIntensity, material.isLit));
     }
     
-    for (i = 0; i < staticPointLightAffectingCount; i++)
+    for (int i = 0; i < staticPointLightAffectingCount; i++)
     {
         finalColor += saturate(GetColorFromPointLight(staticPointLightInfos[staticPointsLightsAffecting[i]], toEye, input.normal, input.worldPosition, materialColor, specularColor, material.specPow, material.specularIntensity, material.isLit));
     }
 
     finalColor += saturate(GetColorFromDirectionalLight(directionalLightInfo, toEye, input.normal, materialColor, specularColor, material.specPow, material.specularIntensity, material.isLit));
     
-    for (i = 0; i < spotLightCount; i++)
+    for (uint spotLight = 0; spotLight < cluster.spotLightCount; spotLight++)
     {
-        finalColor += saturate(GetColorFromSpotLight(spotLightInfos[i], toEye, input.normal, input.worldPosition, materialColor, specularColor, material.specPow, material.specularIntensity, material.isLit));
+        finalColor += saturate(GetColorFromSpotLight(SpotLights[LightIndices[cluster.offset + cluster.pointLightCount + spotLight]], toEye, input.normal, input.worldPosition, materialColor, specularColor, material.specPow, material.specularIntensity, material.isLit));
     }
     
     finalColor.rgb = GetReflectionFromSky(finalColor, toEye, input.normal, SkyTexture, SampleType, material.reflectivity, material.affectedBySky);
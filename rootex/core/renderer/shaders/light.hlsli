@@ -36,6 +36,15 @@ struct SpotLightInfo
     float3 direction;
     float spot;
     float angleRange;
+    float3 pad;
+};
+
+struct LightCluster
+{
+    uint offset;
+    uint pointLightCount;
+    uint spotLightCount;
+    uint pad;
 };
 
 cbuffer StaticPointLights : register(PER_SCENE_PS_HLSL)
@@ -46,15 +55,34 @@ cbuffer StaticPointLights : register(PER_SCENE_PS_HLSL)
 cbuffer Lights : register(PER_FRAME_PS_HLSL)
 {
     float3 cameraPos;
-    int pointLightCount;
-    PointLightInfo pointLightInfos[MAX_DYNAMIC_POINT_LIGHTS];
     int directionLightPresent;
     DirectionalLightInfo directionalLightInfo;
-    int spotLightCount;
-    SpotLightInfo spotLightInfos[MAX_DYNAMIC_SPOT_LIGHTS];
+    float3 cameraForward;
+    float clusterDepthScale;
+    float3 cameraRight;
+    float clusterDepthBias;
+    float3 cameraUp;
+    float clusterNear;
+    float2 clusterTanHalfFov;
     float4 fogColor;
 }
 
+StructuredBuffer<PointLightInfo> PointLights : register(POINT_LIGHTS_PS_HLSL);
+StructuredBuffer<SpotLightInfo> SpotLights : register(SPOT_LIGHTS_PS_HLSL);
+StructuredBuffer<LightCluster> LightClusters : register(LIGHT_CLUSTERS_PS_HLSL);
+StructuredBuffer<uint> LightIndices : register(LIGHT_INDICES_PS_HLSL);
+
+/// Find the cluster a point falls in, the same way LightClusterGrid does on the CPU
+LightCluster GetLightCluster(float3 worldPosition)
+{
+    float3 relative = worldPosition - cameraPos;
+    float depth = max(dot(relative, cameraForward), clusterNear);
+    float2 ndc = float2(dot(relative, cameraRight), dot(relative, cameraUp)) / (depth * clusterTanHalfFov);
+    uint2 tile = (uint2) clamp((ndc * 0.5f + 0.5f) * float2(CLUSTER_COUNT_X, CLUSTER_COUNT_Y), 0.0f, float2(CLUSTER_COUNT_X - 1, CLUSTER_COUNT_Y - 1));
+    uint slice = (uint) clamp(log(depth) * clusterDepthScale + clusterDepthBias, 0.0f, CLUSTER_COUNT_Z - 1);
+    return LightClusters[tile.x + CLUSTER_COUNT_X * (tile.y + CLUSTER_COUNT_Y * slice)];
+}
+
 float4 GetColorFromPointLight(PointLightInfo pointLight, float3 toEye, float3 normal, float4 worldPosition, float4 materialColor, float3 specularColor, float specPow, float specularIntensity, float isLit)
 {
     float dist = distance(pointLight.lightPos, worldPosition.xyz);
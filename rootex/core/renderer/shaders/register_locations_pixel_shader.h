@@ -22,10 +22,21 @@
 #define LIGHTMAP_PS_HLSL CONCAT(t, LIGHTMAP_PS_CPP)
 #define SKY_PS_CPP 5
 #define SKY_PS_HLSL CONCAT(t, SKY_PS_CPP)
+#define POINT_LIGHTS_PS_CPP 6
+#define POINT_LIGHTS_PS_HLSL CONCAT(t, POINT_LIGHTS_PS_CPP)
+#define SPOT_LIGHTS_PS_CPP 7
+#define SPOT_LIGHTS_PS_HLSL CONCAT(t, SPOT_LIGHTS_PS_CPP)
+#define LIGHT_CLUSTERS_PS_CPP 8
+#define LIGHT_CLUSTERS_PS_HLSL CONCAT(t, LIGHT_CLUSTERS_PS_CPP)
+#define LIGHT_INDICES_PS_CPP 9
+#define LIGHT_INDICES_PS_HLSL CONCAT(t, LIGHT_INDICES_PS_CPP)
 
 #define MAX_STATIC_POINT_LIGHTS 1000
 #define MAX_STATIC_POINT_LIGHTS_AFFECTING_1_OBJECT 10
-#define MAX_DYNAMIC_POINT_LIGHTS 4
-#define MAX_DYNAMIC_SPOT_LIGHTS 4
+
+/// Dynamic lights are binned into screen tiles split into depth slices
+#define CLUSTER_COUNT_X 16
+#define CLUSTER_COUNT_Y 9
+#define CLUSTER_COUNT_Z 24
 
 #endif
@@ -0,0 +1,137 @@
+#include "static_light_bvh.h"
+
+#include <algorithm>
+
+float StaticLightBVH::GetStrength(const StaticLightBounds& light, float distance)
+{
+	if (distance >= light.radius)
+	{
+		return 0.0f;
+	}
+	const float attenuation = light.attConst + light.attLin * distance + light.attQuad * distance * distance;
+	return attenuation > 0.0f ? light.intensity / attenuation : light.intensity;
+}
+
+void StaticLightBVH::build(const Vector<StaticLightBounds>& lights)
+{
+	m_Lights = lights;
+	m_Order.resize(m_Lights.size());
+	for (unsigned int i = 0; i < m_Order.size(); i++)
+	{
+		m_Order[i] = i;
+	}
+
+	m_Nodes.clear();
+	if (m_Lights.empty())
+	{
+		return;
+	}
+	m_Nodes.reserve(2 * m_Lights.size() / STATIC_LIGHT_BVH_LEAF_SIZE + 1);
+	m_Nodes.push_back({});
+	buildNode(0, 0, m_Lights.size());
+}
+
+void StaticLightBVH::buildNode(unsigned int nodeIndex, unsigned int first, unsigned int count)
+{
+	Vector3 min = m_Lights[m_Order[first]].center;
+	Vector3 max = min;
+	Vector3 centerMin = min;
+	Vector3 centerMax = min;
+	for (unsigned int i = first; i < first + count; i++)
+	{
+		const StaticLightBounds& light = m_Lights[m_Order[i]];
+		const Vector3 extent = { light.radius, light.radius, light.radius };
+		min = Vector3::Min(min, light.center - extent);
+		max = Vector3::Max(max, light.center + extent);
+		centerMin = Vector3::Min(centerMin, light.center);
+		centerMax = Vector3::Max(centerMax, light.center);
+	}
+
+	// Nodes may move while children are added, so only write through the index
+	m_Nodes[nodeIndex].min = min;
+	m_Nodes[nodeIndex].max = max;
+	if (count <= STATIC_LIGHT_BVH_LEAF_SIZE)
+	{
+		m_Nodes[nodeIndex].first = first;
+		m_Nodes[nodeIndex].count = count;
+		m_Nodes[nodeIndex].left = 0;
+		return;
+	}
+
+	// Split at the median light center along the axis the centers spread furthest on
+	const Vector3 spread = centerMax - centerMin;
+	int axis = 0;
+	if (spread.y > spread.x && spread.y >= spread.z)
+	{
+		axis = 1;
+	}
+	else if (spread.z > spread.x && spread.z > spread.y)
+	{
+		axis = 2;
+	}
+	auto coordinate = [this, axis](unsigned int light) {
+		const Vector3& center = m_Lights[light].center;
+		return axis == 0 ? center.x : (axis == 1 ? center.y : center.z);
+	};
+	const unsigned int half = count / 2;
+	std::nth_element(m_Order.begin() + first, m_Order.begin() + first + half, m_Order.begin() + first + count, [&coordinate](unsigned int a, unsigned int b) {
+		return coordinate(a) < coordinate(b);
+	});
+
+	const unsigned int left = m_Nodes.size();
+	m_Nodes[nodeIndex].first = 0;
+	m_Nodes[nodeIndex].count = 0;
+	m_Nodes[nodeIndex].left = left;
+	m_Nodes.push_back({});
+	m_Nodes.push_back({});
+	buildNode(left, first, half);
+	buildNode(left + 1, first + half, count - half);
+}
+
+void StaticLightBVH::query(const Vector3& boxMin, const Vector3& boxMax, unsigned int maxCount, Vector<int>& result) const
+{
+	result.clear();
+	if (m_Nodes.empty() || maxCount == 0)
+	{
+		return;
+	}
+
+	m_Candidates.clear();
+	m_Stack.clear();
+	m_Stack.push_back(0);
+	while (!m_Stack.empty())
+	{
+		const Node& node = m_Nodes[m_Stack.back()];
+		m_Stack.pop_back();
+		if (node.min.x > boxMax.x || node.max.x < boxMin.x || node.min.y > boxMax.y || node.max.y < boxMin.y || node.min.z > boxMax.z || node.max.z < boxMin.z)
+		{
+			continue;
+		}
+		if (node.count == 0)
+		{
+			m_Stack.push_back(node.left);
+			m_Stack.push_back(node.left + 1);
+			continue;
+		}
+
+		for (unsigned int i = node.first; i < node.first + node.count; i++)
+		{
+			const StaticLightBounds& light = m_Lights[m_Order[i]];
+			const Vector3 closest = Vector3::Min(Vector3::Max(light.center, boxMin), boxMax);
+			const float strength = GetStrength(light, Vector3::Distance(light.center, closest));
+			if (strength > 0.0f)
+			{
+				m_Candidates.push_back({ (int)m_Order[i], strength });
+			}
+		}
+	}
+
+	const unsigned int kept = std::min<unsigned int>(maxCount, m_Candidates.size());
+	std::partial_sort(m_Candidates.begin(), m_Candidates.begin() + kept, m_Candidates.end(), [](const Candidate& a, const Candidate& b) {
+		return a.strength > b.strength || (a.strength == b.strength && a.light < b.light);
+	});
+	for (unsigned int i = 0; i < kept; i++)
+	{
+		result.push_back(m_Candidates[i].light);
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common/types.h"
+
+/// Leaves of the static light BVH are split until they hold at most this many lights
+#define STATIC_LIGHT_BVH_LEAF_SIZE 4
+
+/// Sphere a static point light can affect, with what is needed to tell how strongly it lights a point
+struct StaticLightBounds
+{
+	Vector3 center;
+	float radius;
+	float attConst;
+	float attLin;
+	float attQuad;
+	float intensity;
+};
+
+/// Bounding volume hierarchy over the influence spheres of static point lights.
+/// Built once when the static lights change and queried for the strongest lights reaching a box.
+/// Only depends on plain data, so it can be built and checked without a renderer.
+class StaticLightBVH
+{
+	/// Leaves hold lights first to first + count in m_Order. Inner nodes have count 0 and children at left and left + 1.
+	struct Node
+	{
+		Vector3 min;
+		Vector3 max;
+		unsigned int first;
+		unsigned int count;
+		unsigned int left;
+	};
+
+	struct Candidate
+	{
+		int light;
+		float strength;
+	};
+
+	Vector<StaticLightBounds> m_Lights;
+	Vector<unsigned int> m_Order;
+	Vector<Node> m_Nodes;
+	/// Reused by queries to avoid allocating, so queries must not run on several threads at once
+	mutable Vector<unsigned int> m_Stack;
+	mutable Vector<Candidate> m_Candidates;
+
+	void buildNode(unsigned int nodeIndex, unsigned int first, unsigned int count);
+
+public:
+	StaticLightBVH() = default;
+	StaticLightBVH(StaticLightBVH&) = delete;
+	~StaticLightBVH() = default;
+
+	/// Lighting strength of a light at a given distance, following the attenuation in light.hlsli. 0 outside its range.
+	static float GetStrength(const StaticLightBounds& light, float distance);
+
+	void build(const Vector<StaticLightBounds>& lights);
+	/// Fill result with the indices of up to maxCount lights whose spheres overlap the box, strongest first.
+	/// A light is rated by its strength at the point of the box closest to it.
+	void query(const Vector3& boxMin, const Vector3& boxMax, unsigned int maxCount, Vector<int>& result) const;
+
+	unsigned int getLightCount() const { return m_Lights.size(); }
+	unsigned int getNodeCount() const { return m_Nodes.size(); }
+};
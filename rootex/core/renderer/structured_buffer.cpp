@@ -0,0 +1,53 @@
+#include "structured_buffer.h"
+
+#include "rendering_device.h"
+
+#include "Tracy/Tracy.hpp"
+
+/// Capacity of a new buffer, doubled whenever more is needed
+#define STRUCTURED_BUFFER_MIN_CAPACITY 64
+
+StructuredBuffer::StructuredBuffer(unsigned int stride)
+    : m_Stride(stride)
+{
+	reserve(STRUCTURED_BUFFER_MIN_CAPACITY);
+}
+
+void StructuredBuffer::reserve(unsigned int count)
+{
+	unsigned int capacity = std::max(m_Capacity, (unsigned int)STRUCTURED_BUFFER_MIN_CAPACITY);
+	while (capacity < count)
+	{
+		capacity *= 2;
+	}
+
+	D3D11_BUFFER_DESC sbd = { 0 };
+	sbd.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	sbd.Usage = D3D11_USAGE_DYNAMIC;
+	sbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	sbd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	sbd.ByteWidth = capacity * m_Stride;
+	sbd.StructureByteStride = m_Stride;
+
+	m_Buffer = RenderingDevice::GetSingleton()->createBuffer(&sbd, nullptr);
+	m_SRV = RenderingDevice::GetSingleton()->createBufferSRV(m_Buffer.Get(), capacity);
+	m_Capacity = capacity;
+}
+
+void StructuredBuffer::setData(const void* data, unsigned int count)
+{
+	ZoneNamedN(structuredBufferUpload, "Structured Buffer Upload", true);
+	if (count > m_Capacity)
+	{
+		reserve(count);
+	}
+
+	if (count)
+	{
+		D3D11_MAPPED_SUBRESOURCE subresource = { 0 };
+		RenderingDevice::GetSingleton()->mapBuffer(m_Buffer.Get(), subresource);
+		memcpy(subresource.pData, data, count * m_Stride);
+		RenderingDevice::GetSingleton()->unmapBuffer(m_Buffer.Get());
+	}
+	m_Count = count;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include "common/common.h"
+
+/// Encapsulates a dynamic structured buffer read by shaders through a shader resource view.
+/// Grows to fit whatever is uploaded, so the number of elements is not capped.
+class StructuredBuffer
+{
+	Microsoft::WRL::ComPtr<ID3D11Buffer> m_Buffer;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_SRV;
+	unsigned int m_Stride;
+	unsigned int m_Capacity = 0;
+	unsigned int m_Count = 0;
+
+	void reserve(unsigned int count);
+
+public:
+	StructuredBuffer(unsigned int stride);
+	StructuredBuffer(StructuredBuffer&) = delete;
+	~StructuredBuffer() = default;
+
+	/// Replace the contents with count elements of the buffer's stride
+	void setData(const void* data, unsigned int count);
+	template <class T>
+	void setData(const Vector<T>& data);
+
+	unsigned int getCount() const { return m_Count; }
+	ID3D11ShaderResourceView* getSRV() const { return m_SRV.Get(); }
+};
+
+template <class T>
+inline void StructuredBuffer::setData(const Vector<T>& data)
+{
+	static_assert(sizeof(T) % 4 == 0, "Structured buffer elements must be a multiple of 4 bytes");
+	setData(data.data(), data.size());
+}
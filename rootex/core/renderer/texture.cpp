@@ -3,6 +3,8 @@
 #include "rendering_device.h"
 #include "resource_loader.h"
 
+#include <cstring>
+
 Texture::Texture(const char* pixelData, int width, int height)
 {
 	m_TextureView = RenderingDevice::GetSingleton()->createTextureFromPixels(pixelData, width, height);
@@ -21,7 +23,14 @@ Texture::Texture(const char* pixelData, int width, int height)
 
 Texture::Texture(const char* imageFileData, size_t size)
 {
-	m_TextureView = RenderingDevice::GetSingleton()->createTexture(imageFileData, size);
+	if (size >= 4 && std::memcmp(imageFileData, "DDS ", 4) == 0)
+	{
+		m_TextureView = RenderingDevice::GetSingleton()->createDDSTexture(imageFileData, size, false);
+	}
+	else
+	{
+		m_TextureView = RenderingDevice::GetSingleton()->createTexture(imageFileData, size);
+	}
 
 	Microsoft::WRL::ComPtr<ID3D11Resource> res;
 	m_TextureView->GetResource(&res);
@@ -35,7 +44,22 @@ Texture::Texture(const char* imageFileData, size_t size)
 	m_MipLevels = textureDesc.MipLevels;
 }
 
+Texture::Texture(Microsoft::WRL::ComPtr<ID3D11Texture2D> texture, unsigned int width, unsigned int height, unsigned int mipLevels, unsigned int residentMip)
+    : m_Width(width)
+    , m_Height(height)
+    , m_MipLevels(mipLevels)
+{
+	setResidentMips(texture, residentMip);
+}
+
+void Texture::setResidentMips(Microsoft::WRL::ComPtr<ID3D11Texture2D> texture, unsigned int residentMip)
+{
+	m_Texture = texture;
+	m_TextureView = RenderingDevice::GetSingleton()->createTextureSRV(texture.Get());
+	m_ResidentMip = residentMip;
+}
+
 TextureCube::TextureCube(const char* imageDDSFileData, size_t size)
 {
-	m_TextureView = RenderingDevice::GetSingleton()->createDDSTexture(imageDDSFileData, size);
+	m_TextureView = RenderingDevice::GetSingleton()->createDDSTexture(imageDDSFileData, size, true);
 }
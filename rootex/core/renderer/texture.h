@@ -12,10 +12,22 @@ class Texture
 	unsigned int m_Width;
 	unsigned int m_Height;
 	unsigned int m_MipLevels;
+	/// Finest mip in m_Texture, which holds the mips from here on
+	unsigned int m_ResidentMip = 0;
+	/// Slot in the TextureStreamer, -1 if the texture is not streamed
+	int m_StreamingSlot = -1;
+
+	/// Swap in a texture holding the mips from residentMip on, for TextureStreamer
+	void setResidentMips(Microsoft::WRL::ComPtr<ID3D11Texture2D> texture, unsigned int residentMip);
+
+	friend class TextureStreamer;
 
 public:
 	Texture(const char* pixelData, int width, int height);
+	/// Loads DDS files, mips and block compression included, and any other image format WIC can decode
 	Texture(const char* imageFileData, size_t size);
+	/// Texture with only the coarser mips resident. Width, height and mip levels describe the whole texture.
+	Texture(Microsoft::WRL::ComPtr<ID3D11Texture2D> texture, unsigned int width, unsigned int height, unsigned int mipLevels, unsigned int residentMip);
 	Texture(const Texture&) = default;
 	Texture& operator=(const Texture&) = default;
 	~Texture() = default;
@@ -25,6 +37,8 @@ public:
 	unsigned int getWidth() const { return m_Width; }
 	unsigned int getHeight() const { return m_Height; }
 	unsigned int getMipLevels() const { return m_MipLevels; }
+	unsigned int getResidentMip() const { return m_ResidentMip; }
+	int getStreamingSlot() const { return m_StreamingSlot; }
 };
 
 /// Cube texture in 3D
@@ -0,0 +1,858 @@
+#include "texture_cooker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+/// "RTXC", marks DDS files written by the cooker in the reserved part of the header
+#define COOKED_TEXTURE_TAG 0x43585452
+#define COOKED_TEXTURE_VERSION 1
+
+#define DDS_MAGIC 0x20534444
+#define DDS_FOURCC_DX10 0x30315844
+
+#define DDSD_CAPS 0x1
+#define DDSD_HEIGHT 0x2
+#define DDSD_WIDTH 0x4
+#define DDSD_PITCH 0x8
+#define DDSD_PIXELFORMAT 0x1000
+#define DDSD_MIPMAPCOUNT 0x20000
+#define DDSD_LINEARSIZE 0x80000
+#define DDPF_FOURCC 0x4
+#define DDSCAPS_COMPLEX 0x8
+#define DDSCAPS_TEXTURE 0x1000
+#define DDSCAPS_MIPMAP 0x400000
+
+/// Values of DXGI_FORMAT and D3D10_RESOURCE_DIMENSION, spelled out to stay off the Windows headers
+#define DXGI_FORMAT_VALUE_RGBA8 28
+#define DXGI_FORMAT_VALUE_BC1 71
+#define DXGI_FORMAT_VALUE_BC3 77
+#define DXGI_FORMAT_VALUE_BC5 83
+#define DXGI_FORMAT_VALUE_BC7 98
+#define DDS_DIMENSION_TEXTURE2D 3
+
+struct DDSPixelFormat
+{
+	uint32_t size;
+	uint32_t flags;
+	uint32_t fourCC;
+	uint32_t rgbBitCount;
+	uint32_t rBitMask;
+	uint32_t gBitMask;
+	uint32_t bBitMask;
+	uint32_t aBitMask;
+};
+
+struct DDSHeader
+{
+	uint32_t size;
+	uint32_t flags;
+	uint32_t height;
+	uint32_t width;
+	uint32_t pitchOrLinearSize;
+	uint32_t depth;
+	uint32_t mipMapCount;
+	/// [6] holds the cook settings, [7] COOKED_TEXTURE_TAG, [8] the cooker version and [9], [10] the source hash
+	uint32_t reserved1[11];
+	DDSPixelFormat pixelFormat;
+	uint32_t caps;
+	uint32_t caps2;
+	uint32_t caps3;
+	uint32_t caps4;
+	uint32_t reserved2;
+};
+
+struct DDSHeaderDX10
+{
+	uint32_t dxgiFormat;
+	uint32_t resourceDimension;
+	uint32_t miscFlag;
+	uint32_t arraySize;
+	uint32_t miscFlags2;
+};
+
+/// Fraction of the second endpoint in each palette entry of the block formats
+static const float BC1_OPAQUE_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+static const float BC1_PUNCH_THROUGH_WEIGHTS[3] = { 0.0f, 1.0f, 0.5f };
+static const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+template <class T>
+static void Append(std::vector<char>& buffer, const T& value)
+{
+	const char* bytes = (const char*)&value;
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+static float SRGBToLinear(float value)
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSRGB(float value)
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static unsigned char ToByte(float value)
+{
+	return (unsigned char)std::clamp((int)(value * 255.0f + 0.5f), 0, 255);
+}
+
+/// Halves a level of RGBA texels in [0, 1], weighting colours by alpha for sRGB images so that transparent texels do not bleed into the mips
+static void Downsample(const std::vector<float>& texels, unsigned int width, unsigned int height, bool isSRGB, std::vector<float>& result)
+{
+	const unsigned int resultWidth = std::max(1u, width / 2);
+	const unsigned int resultHeight = std::max(1u, height / 2);
+	result.resize(resultWidth * resultHeight * 4);
+
+	for (unsigned int y = 0; y < resultHeight; y++)
+	{
+		for (unsigned int x = 0; x < resultWidth; x++)
+		{
+			float color[3] = { 0.0f, 0.0f, 0.0f };
+			float weightedColor[3] = { 0.0f, 0.0f, 0.0f };
+			float alpha = 0.0f;
+			for (unsigned int dy = 0; dy < 2; dy++)
+			{
+				for (unsigned int dx = 0; dx < 2; dx++)
+				{
+					const unsigned int sourceX = std::min(x * 2 + dx, width - 1);
+					const unsigned int sourceY = std::min(y * 2 + dy, height - 1);
+					const float* texel = &texels[(sourceY * width + sourceX) * 4];
+					for (int c = 0; c < 3; c++)
+					{
+						color[c] += texel[c];
+						weightedColor[c] += texel[c] * texel[3];
+					}
+					alpha += texel[3];
+				}
+			}
+
+			float* resultTexel = &result[(y * resultWidth + x) * 4];
+			for (int c = 0; c < 3; c++)
+			{
+				resultTexel[c] = isSRGB && alpha > 0.0f ? weightedColor[c] / alpha : color[c] / 4.0f;
+			}
+			resultTexel[3] = alpha / 4.0f;
+		}
+	}
+}
+
+static void FetchBlock(const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int blockX, unsigned int blockY, unsigned char block[16][4])
+{
+	for (unsigned int y = 0; y < 4; y++)
+	{
+		for (unsigned int x = 0; x < 4; x++)
+		{
+			// Blocks of mips smaller than 4 texels repeat the edge texels
+			const unsigned int sourceX = std::min(blockX * 4 + x, width - 1);
+			const unsigned int sourceY = std::min(blockY * 4 + y, height - 1);
+			std::memcpy(block[y * 4 + x], &pixels[(sourceY * width + sourceX) * 4], 4);
+		}
+	}
+}
+
+/// Fits a line through the points along their principal axis, ending at the outermost projections
+static void FitLine(const float (*points)[4], int count, int channels, float start[4], float end[4])
+{
+	float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < count; i++)
+	{
+		for (int c = 0; c < channels; c++)
+		{
+			mean[c] += points[i][c] / count;
+		}
+	}
+
+	float covariance[4][4] = {};
+	for (int i = 0; i < count; i++)
+	{
+		for (int a = 0; a < channels; a++)
+		{
+			for (int b = 0; b < channels; b++)
+			{
+				covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+			}
+		}
+	}
+
+	// Starting from the channel that varies the most keeps the iteration off axes orthogonal to the answer
+	int widestChannel = 0;
+	for (int c = 1; c < channels; c++)
+	{
+		if (covariance[c][c] > covariance[widestChannel][widestChannel])
+		{
+			widestChannel = c;
+		}
+	}
+	float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	axis[widestChannel] = 1.0f;
+	for (int iteration = 0; iteration < 8; iteration++)
+	{
+		float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float length = 0.0f;
+		for (int a = 0; a < channels; a++)
+		{
+			for (int b = 0; b < channels; b++)
+			{
+				next[a] += covariance[a][b] * axis[b];
+			}
+			length = std::max(length, std::abs(next[a]));
+		}
+		if (length < 1e-6f)
+		{
+			break;
+		}
+		for (int c = 0; c < channels; c++)
+		{
+			axis[c] = next[c] / length;
+		}
+	}
+
+	float lengthSquared = 0.0f;
+	for (int c = 0; c < channels; c++)
+	{
+		lengthSquared += axis[c] * axis[c];
+	}
+	for (int c = 0; c < channels; c++)
+	{
+		axis[c] /= std::sqrt(lengthSquared);
+	}
+
+	float minT = 0.0f;
+	float maxT = 0.0f;
+	for (int i = 0; i < count; i++)
+	{
+		float t = 0.0f;
+		for (int c = 0; c < channels; c++)
+		{
+			t += (points[i][c] - mean[c]) * axis[c];
+		}
+		minT = std::min(minT, t);
+		maxT = std::max(maxT, t);
+	}
+
+	for (int c = 0; c < channels; c++)
+	{
+		start[c] = mean[c] + axis[c] * minT;
+		end[c] = mean[c] + axis[c] * maxT;
+	}
+}
+
+/// Least squares endpoints for the points given the palette entry each one uses. Returns false if the entries do not pin down both endpoints.
+static bool RefineEndpoints(const float (*points)[4], const int* indices, int count, int channels, const float* weights, float start[4], float end[4])
+{
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float ax[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float bx[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < count; i++)
+	{
+		const float b = weights[indices[i]];
+		const float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < channels; c++)
+		{
+			ax[c] += a * points[i][c];
+			bx[c] += b * points[i][c];
+		}
+	}
+
+	const float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f)
+	{
+		return false;
+	}
+	for (int c = 0; c < channels; c++)
+	{
+		start[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+		end[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+static uint16_t Quantize565(const float color[4])
+{
+	const int r = std::clamp((int)(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+	const int g = std::clamp((int)(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+	const int b = std::clamp((int)(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void Expand565(uint16_t color, int result[3])
+{
+	const int r = (color >> 11) & 31;
+	const int g = (color >> 5) & 63;
+	const int b = color & 31;
+	result[0] = (r << 3) | (r >> 2);
+	result[1] = (g << 2) | (g >> 4);
+	result[2] = (b << 3) | (b >> 2);
+}
+
+/// Picks the closest palette entry for each opaque point. Returns the total squared error.
+static int AssignColorIndices(const float (*points)[4], int count, uint16_t color0, uint16_t color1, bool isPunchThrough, int* indices)
+{
+	int endpoints[2][3];
+	Expand565(color0, endpoints[0]);
+	Expand565(color1, endpoints[1]);
+
+	const int paletteSize = isPunchThrough ? 3 : 4;
+	int palette[4][3];
+	for (int c = 0; c < 3; c++)
+	{
+		palette[0][c] = endpoints[0][c];
+		palette[1][c] = endpoints[1][c];
+		if (isPunchThrough)
+		{
+			palette[2][c] = (endpoints[0][c] + endpoints[1][c]) / 2;
+		}
+		else
+		{
+			palette[2][c] = (2 * endpoints[0][c] + endpoints[1][c]) / 3;
+			palette[3][c] = (endpoints[0][c] + 2 * endpoints[1][c]) / 3;
+		}
+	}
+
+	int totalError = 0;
+	for (int i = 0; i < count; i++)
+	{
+		int bestError = INT32_MAX;
+		for (int entry = 0; entry < paletteSize; entry++)
+		{
+			int error = 0;
+			for (int c = 0; c < 3; c++)
+			{
+				const int difference = (int)(points[i][c] + 0.5f) - palette[entry][c];
+				error += difference * difference;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				indices[i] = entry;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+/// BC1 colour block. Punch through alpha is only allowed for BC1 itself, BC3 always decodes its colour block with 4 colours.
+static void EncodeColorBlock(const unsigned char block[16][4], bool isPunchThroughAllowed, unsigned char* out)
+{
+	float points[16][4];
+	int pointTexels[16];
+	int count = 0;
+	bool hasTransparent = false;
+	for (int i = 0; i < 16; i++)
+	{
+		if (isPunchThroughAllowed && block[i][3] < 128)
+		{
+			hasTransparent = true;
+			continue;
+		}
+		for (int c = 0; c < 4; c++)
+		{
+			points[count][c] = block[i][c];
+		}
+		pointTexels[count++] = i;
+	}
+
+	uint32_t packedIndices = 0;
+	uint16_t color0 = 0;
+	uint16_t color1 = 0;
+	if (count == 0)
+	{
+		// Equal endpoints select 3 colour mode, where index 3 is transparent
+		packedIndices = 0xFFFFFFFF;
+	}
+	else
+	{
+		const float* weights = hasTransparent ? BC1_PUNCH_THROUGH_WEIGHTS : BC1_OPAQUE_WEIGHTS;
+		float start[4];
+		float end[4];
+		FitLine(points, count, 3, start, end);
+		color0 = Quantize565(start);
+		color1 = Quantize565(end);
+
+		int indices[16];
+		int error = AssignColorIndices(points, count, color0, color1, hasTransparent, indices);
+		for (int iteration = 0; iteration < 2 && error > 0; iteration++)
+		{
+			if (!RefineEndpoints(points, indices, count, 3, weights, start, end))
+			{
+				break;
+			}
+			const uint16_t refined0 = Quantize565(start);
+			const uint16_t refined1 = Quantize565(end);
+			int refinedIndices[16];
+			const int refinedError = AssignColorIndices(points, count, refined0, refined1, hasTransparent, refinedIndices);
+			if (refinedError >= error)
+			{
+				break;
+			}
+			color0 = refined0;
+			color1 = refined1;
+			error = refinedError;
+			std::copy(refinedIndices, refinedIndices + 16, indices);
+		}
+
+		// The decoder tells the modes apart by endpoint order, 4 colours need color0 > color1
+		const bool isSwapped = hasTransparent ? color0 > color1 : color0 < color1;
+		if (isSwapped)
+		{
+			std::swap(color0, color1);
+			for (int i = 0; i < count; i++)
+			{
+				indices[i] = indices[i] < 2 ? indices[i] ^ 1 : (hasTransparent ? 2 : indices[i] ^ 1);
+			}
+		}
+
+		if (hasTransparent)
+		{
+			packedIndices = 0xFFFFFFFF;
+		}
+		for (int i = 0; i < count; i++)
+		{
+			packedIndices &= ~(3u << (pointTexels[i] * 2));
+			packedIndices |= (uint32_t)indices[i] << (pointTexels[i] * 2);
+		}
+	}
+
+	std::memcpy(out, &color0, 2);
+	std::memcpy(out + 2, &color1, 2);
+	std::memcpy(out + 4, &packedIndices, 4);
+}
+
+/// BC4 block, used for the alpha of BC3 and each channel of BC5
+static void EncodeSingleChannelBlock(const unsigned char values[16], unsigned char* out)
+{
+	const int maxValue = *std::max_element(values, values + 16);
+	const int minValue = *std::min_element(values, values + 16);
+	out[0] = (unsigned char)maxValue;
+	out[1] = (unsigned char)minValue;
+
+	uint64_t packedIndices = 0;
+	if (maxValue != minValue)
+	{
+		// Palette in 8 value mode goes max, min, then 6 steps from max towards min
+		static const int PALETTE_ORDER[8] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+		for (int i = 0; i < 16; i++)
+		{
+			const int step = (int)((values[i] - minValue) * 7.0f / (maxValue - minValue) + 0.5f);
+			packedIndices |= (uint64_t)PALETTE_ORDER[step] << (i * 3);
+		}
+	}
+	for (int i = 0; i < 6; i++)
+	{
+		out[2 + i] = (unsigned char)(packedIndices >> (i * 8));
+	}
+}
+
+static void WriteBits(unsigned char* out, unsigned int& bit, unsigned int value, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++, bit++)
+	{
+		out[bit / 8] |= ((value >> i) & 1) << (bit % 8);
+	}
+}
+
+/// BC7 mode 6 block, a single RGBA line with 7 bit endpoints, a p-bit each and 16 palette entries
+static void EncodeBC7Block(const unsigned char block[16][4], unsigned char* out)
+{
+	float points[16][4];
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			points[i][c] = block[i][c];
+		}
+	}
+
+	float start[4];
+	float end[4];
+	FitLine(points, 16, 4, start, end);
+
+	int bestError = INT32_MAX;
+	int bestEndpoints[2][4];
+	int bestPBits[2];
+	int bestIndices[16];
+	for (int iteration = 0; iteration < 2; iteration++)
+	{
+		for (int pBit0 = 0; pBit0 < 2; pBit0++)
+		{
+			for (int pBit1 = 0; pBit1 < 2; pBit1++)
+			{
+				int endpoints[2][4];
+				for (int c = 0; c < 4; c++)
+				{
+					endpoints[0][c] = std::clamp((int)((start[c] - pBit0) / 2.0f + 0.5f), 0, 127);
+					endpoints[1][c] = std::clamp((int)((end[c] - pBit1) / 2.0f + 0.5f), 0, 127);
+				}
+
+				int palette[16][4];
+				for (int entry = 0; entry < 16; entry++)
+				{
+					for (int c = 0; c < 4; c++)
+					{
+						const int value0 = (endpoints[0][c] << 1) | pBit0;
+						const int value1 = (endpoints[1][c] << 1) | pBit1;
+						palette[entry][c] = ((64 - BC7_WEIGHTS[entry]) * value0 + BC7_WEIGHTS[entry] * value1 + 32) >> 6;
+					}
+				}
+
+				int indices[16];
+				int error = 0;
+				for (int i = 0; i < 16; i++)
+				{
+					int texelError = INT32_MAX;
+					for (int entry = 0; entry < 16; entry++)
+					{
+						int entryError = 0;
+						for (int c = 0; c < 4; c++)
+						{
+							const int difference = block[i][c] - palette[entry][c];
+							entryError += difference * difference;
+						}
+						if (entryError < texelError)
+						{
+							texelError = entryError;
+							indices[i] = entry;
+						}
+					}
+					error += texelError;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					std::memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+					bestPBits[0] = pBit0;
+					bestPBits[1] = pBit1;
+					std::copy(indices, indices + 16, bestIndices);
+				}
+			}
+		}
+
+		float weights[16];
+		for (int entry = 0; entry < 16; entry++)
+		{
+			weights[entry] = BC7_WEIGHTS[entry] / 64.0f;
+		}
+		if (bestError == 0 || !RefineEndpoints(points, bestIndices, 16, 4, weights, start, end))
+		{
+			break;
+		}
+	}
+
+	// The first index is stored with its top bit implied to be 0
+	if (bestIndices[0] & 8)
+	{
+		std::swap(bestEndpoints[0], bestEndpoints[1]);
+		std::swap(bestPBits[0], bestPBits[1]);
+		for (int i = 0; i < 16; i++)
+		{
+			bestIndices[i] = 15 - bestIndices[i];
+		}
+	}
+
+	std::memset(out, 0, 16);
+	unsigned int bit = 0;
+	WriteBits(out, bit, 1 << 6, 7);
+	for (int c = 0; c < 4; c++)
+	{
+		WriteBits(out, bit, bestEndpoints[0][c], 7);
+		WriteBits(out, bit, bestEndpoints[1][c], 7);
+	}
+	WriteBits(out, bit, bestPBits[0], 1);
+	WriteBits(out, bit, bestPBits[1], 1);
+	WriteBits(out, bit, bestIndices[0], 3);
+	for (int i = 1; i < 16; i++)
+	{
+		WriteBits(out, bit, bestIndices[i], 4);
+	}
+}
+
+static void EncodeLevel(const unsigned char* pixels, unsigned int width, unsigned int height, TextureCookFormat format, std::vector<char>& dds)
+{
+	if (format == TextureCookFormat::RGBA8)
+	{
+		dds.insert(dds.end(), (const char*)pixels, (const char*)pixels + width * height * 4);
+		return;
+	}
+
+	const unsigned int blockBytes = format == TextureCookFormat::BC1 ? 8 : 16;
+	const unsigned int blocksX = (width + 3) / 4;
+	const unsigned int blocksY = (height + 3) / 4;
+	size_t offset = dds.size();
+	dds.resize(offset + blocksX * blocksY * blockBytes);
+
+	unsigned char block[16][4];
+	unsigned char channel[16];
+	for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (unsigned int blockX = 0; blockX < blocksX; blockX++, offset += blockBytes)
+		{
+			FetchBlock(pixels, width, height, blockX, blockY, block);
+			unsigned char* out = (unsigned char*)&dds[offset];
+			switch (format)
+			{
+			case TextureCookFormat::BC1:
+				EncodeColorBlock(block, true, out);
+				break;
+			case TextureCookFormat::BC3:
+				for (int i = 0; i < 16; i++)
+				{
+					channel[i] = block[i][3];
+				}
+				EncodeSingleChannelBlock(channel, out);
+				EncodeColorBlock(block, false, out + 8);
+				break;
+			case TextureCookFormat::BC5:
+				for (int c = 0; c < 2; c++)
+				{
+					for (int i = 0; i < 16; i++)
+					{
+						channel[i] = block[i][c];
+					}
+					EncodeSingleChannelBlock(channel, out + c * 8);
+				}
+				break;
+			case TextureCookFormat::BC7:
+				EncodeBC7Block(block, out);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+uint64_t TextureCooker::HashContents(const char* data, size_t size)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::string TextureCooker::GetCookedPath(const std::string& sourcePath)
+{
+	// Not std::hash, the cooker and the engine may be built by different compilers
+	std::stringstream name;
+	name << std::hex << HashContents(sourcePath.data(), sourcePath.size());
+	return TEXTURE_COOKED_DIRECTORY + name.str() + ".dds";
+}
+
+TextureCookFormat TextureCooker::Cook(const unsigned char* pixels, unsigned int width, unsigned int height, const Settings& settings, uint64_t sourceHash, std::vector<char>& dds)
+{
+	TextureCookFormat format = settings.format;
+	if (format == TextureCookFormat::Auto)
+	{
+		format = TextureCookFormat::BC1;
+		for (unsigned int i = 0; i < width * height; i++)
+		{
+			if (pixels[i * 4 + 3] != 255)
+			{
+				format = TextureCookFormat::BC3;
+				break;
+			}
+		}
+	}
+	// D3D11 needs the top level of block compressed textures to be made of whole blocks
+	if (width % 4 != 0 || height % 4 != 0)
+	{
+		format = TextureCookFormat::RGBA8;
+	}
+	const bool isSRGB = settings.isSRGB && format != TextureCookFormat::BC5;
+
+	unsigned int mipCount = 1;
+	if (settings.isGeneratingMips)
+	{
+		while ((std::max(width, height) >> mipCount) > 0)
+		{
+			mipCount++;
+		}
+	}
+
+	const bool isCompressed = format != TextureCookFormat::RGBA8;
+	DDSHeader header = {};
+	header.size = sizeof(DDSHeader);
+	header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | (isCompressed ? DDSD_LINEARSIZE : DDSD_PITCH);
+	header.height = height;
+	header.width = width;
+	header.pitchOrLinearSize = isCompressed ? ((width + 3) / 4) * ((height + 3) / 4) * (format == TextureCookFormat::BC1 ? 8 : 16) : width * 4;
+	header.depth = 1;
+	header.mipMapCount = mipCount;
+	header.reserved1[6] = (uint32_t)settings.format | (settings.isSRGB ? 0x100 : 0) | (settings.isGeneratingMips ? 0x200 : 0);
+	header.reserved1[7] = COOKED_TEXTURE_TAG;
+	header.reserved1[8] = COOKED_TEXTURE_VERSION;
+	header.reserved1[9] = (uint32_t)sourceHash;
+	header.reserved1[10] = (uint32_t)(sourceHash >> 32);
+	header.pixelFormat.size = sizeof(DDSPixelFormat);
+	header.pixelFormat.flags = DDPF_FOURCC;
+	header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+	header.caps = DDSCAPS_TEXTURE | (mipCount > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+	DDSHeaderDX10 headerDX10 = {};
+	switch (format)
+	{
+	case TextureCookFormat::BC1:
+		headerDX10.dxgiFormat = DXGI_FORMAT_VALUE_BC1;
+		break;
+	case TextureCookFormat::BC3:
+		headerDX10.dxgiFormat = DXGI_FORMAT_VALUE_BC3;
+		break;
+	case TextureCookFormat::BC5:
+		headerDX10.dxgiFormat = DXGI_FORMAT_VALUE_BC5;
+		break;
+	case TextureCookFormat::BC7:
+		headerDX10.dxgiFormat = DXGI_FORMAT_VALUE_BC7;
+		break;
+	default:
+		headerDX10.dxgiFormat = DXGI_FORMAT_VALUE_RGBA8;
+		break;
+	}
+	headerDX10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+	headerDX10.arraySize = 1;
+
+	dds.clear();
+	Append(dds, (uint32_t)DDS_MAGIC);
+	Append(dds, header);
+	Append(dds, headerDX10);
+
+	std::vector<float> texels(width * height * 4);
+	for (unsigned int i = 0; i < width * height * 4; i++)
+	{
+		const float value = pixels[i] / 255.0f;
+		texels[i] = isSRGB && i % 4 != 3 ? SRGBToLinear(value) : value;
+	}
+
+	std::vector<unsigned char> levelPixels(pixels, pixels + width * height * 4);
+	std::vector<float> nextTexels;
+	unsigned int levelWidth = width;
+	unsigned int levelHeight = height;
+	for (unsigned int mip = 0; mip < mipCount; mip++)
+	{
+		if (mip > 0)
+		{
+			Downsample(texels, levelWidth, levelHeight, isSRGB, nextTexels);
+			texels.swap(nextTexels);
+			levelWidth = std::max(1u, levelWidth / 2);
+			levelHeight = std::max(1u, levelHeight / 2);
+
+			levelPixels.resize(levelWidth * levelHeight * 4);
+			for (unsigned int i = 0; i < levelWidth * levelHeight * 4; i++)
+			{
+				levelPixels[i] = ToByte(isSRGB && i % 4 != 3 ? LinearToSRGB(texels[i]) : texels[i]);
+			}
+		}
+		EncodeLevel(levelPixels.data(), levelWidth, levelHeight, format, dds);
+	}
+
+	return format;
+}
+
+bool TextureCooker::ReadCookedInfo(const char* dds, size_t size, uint64_t& sourceHash, Settings& settings)
+{
+	uint32_t magic;
+	DDSHeader header;
+	if (size < sizeof(magic) + sizeof(DDSHeader))
+	{
+		return false;
+	}
+	std::memcpy(&magic, dds, sizeof(magic));
+	std::memcpy(&header, dds + sizeof(magic), sizeof(DDSHeader));
+	if (magic != DDS_MAGIC || header.size != sizeof(DDSHeader) || header.reserved1[7] != COOKED_TEXTURE_TAG || header.reserved1[8] != COOKED_TEXTURE_VERSION)
+	{
+		return false;
+	}
+
+	sourceHash = (uint64_t)header.reserved1[9] | ((uint64_t)header.reserved1[10] << 32);
+	settings.format = (TextureCookFormat)(header.reserved1[6] & 0xFF);
+	settings.isSRGB = header.reserved1[6] & 0x100;
+	settings.isGeneratingMips = header.reserved1[6] & 0x200;
+	return true;
+}
+
+unsigned int TextureCooker::ReadCookedLevels(const char* dds, size_t size, std::vector<Level>& levels)
+{
+	uint64_t sourceHash;
+	Settings settings;
+	DDSHeader header;
+	DDSHeaderDX10 headerDX10;
+	const size_t headersSize = sizeof(uint32_t) + sizeof(DDSHeader) + sizeof(DDSHeaderDX10);
+	if (!ReadCookedInfo(dds, size, sourceHash, settings) || size < headersSize)
+	{
+		return 0;
+	}
+	std::memcpy(&header, dds + sizeof(uint32_t), sizeof(DDSHeader));
+	std::memcpy(&headerDX10, dds + sizeof(uint32_t) + sizeof(DDSHeader), sizeof(DDSHeaderDX10));
+
+	unsigned int blockBytes = 0;
+	switch (headerDX10.dxgiFormat)
+	{
+	case DXGI_FORMAT_VALUE_RGBA8:
+		break;
+	case DXGI_FORMAT_VALUE_BC1:
+		blockBytes = 8;
+		break;
+	case DXGI_FORMAT_VALUE_BC3:
+	case DXGI_FORMAT_VALUE_BC5:
+	case DXGI_FORMAT_VALUE_BC7:
+		blockBytes = 16;
+		break;
+	default:
+		return 0;
+	}
+
+	levels.clear();
+	size_t offset = headersSize;
+	unsigned int width = header.width;
+	unsigned int height = header.height;
+	for (unsigned int mip = 0; mip < header.mipMapCount; mip++)
+	{
+		Level level;
+		level.width = width;
+		level.height = height;
+		level.rowPitch = blockBytes ? ((width + 3) / 4) * blockBytes : width * 4;
+		level.offset = offset;
+		level.size = (size_t)level.rowPitch * (blockBytes ? (height + 3) / 4 : height);
+		if (offset + level.size > size)
+		{
+			return 0;
+		}
+		levels.push_back(level);
+
+		offset += level.size;
+		width = std::max(1u, width / 2);
+		height = std::max(1u, height / 2);
+	}
+	return headerDX10.dxgiFormat;
+}
+
+const char* TextureCooker::GetFormatName(TextureCookFormat format)
+{
+	switch (format)
+	{
+	case TextureCookFormat::Auto:
+		return "auto";
+	case TextureCookFormat::BC1:
+		return "bc1";
+	case TextureCookFormat::BC3:
+		return "bc3";
+	case TextureCookFormat::BC5:
+		return "bc5";
+	case TextureCookFormat::BC7:
+		return "bc7";
+	case TextureCookFormat::RGBA8:
+		return "rgba8";
+	}
+	return "unknown";
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Cooked textures are saved here relative to Rootex root, named by a hash of the source path
+#define TEXTURE_COOKED_DIRECTORY "cache/textures/"
+
+/// Encoding of a cooked texture
+enum class TextureCookFormat
+{
+	/// BC1 for opaque images, BC3 for images with alpha
+	Auto,
+	/// RGB with 1 bit alpha, 4 bits per pixel
+	BC1,
+	/// RGB with smooth alpha, 8 bits per pixel
+	BC3,
+	/// Red and green only, 8 bits per pixel. Meant for normal maps, shaders rebuild the blue channel
+	BC5,
+	/// RGBA, 8 bits per pixel, best quality
+	BC7,
+	/// Uncompressed. Used for images whose size is not a multiple of the 4x4 block size
+	RGBA8
+};
+
+/// Generates mip chains and block compresses RGBA8 images into DDS files that load through RenderingDevice::createDDSTexture.
+/// Uses nothing but the standard library so the command line cooker builds on any platform.
+class TextureCooker
+{
+public:
+	struct Settings
+	{
+		TextureCookFormat format = TextureCookFormat::Auto;
+		/// Texels are sRGB encoded colours, so mips are averaged in linear space. Turn off for data like normal maps.
+		/// Textures are stored as UNORM either way, like the ones loaded from image files.
+		bool isSRGB = true;
+		bool isGeneratingMips = true;
+	};
+
+	/// Where one mip of a cooked texture is stored in its DDS file
+	struct Level
+	{
+		unsigned int width;
+		unsigned int height;
+		/// Bytes per row of texels, or of 4x4 blocks for block compressed formats
+		unsigned int rowPitch;
+		size_t offset;
+		size_t size;
+	};
+
+	/// 64-bit FNV-1a, same as ResourceFile::HashContents
+	static uint64_t HashContents(const char* data, size_t size);
+	/// Path of the cooked texture for a source image path relative to Rootex root
+	static std::string GetCookedPath(const std::string& sourcePath);
+	/// Pixels are tightly packed RGBA8 rows. Returns the format used, which differs from the requested one for Auto and
+	/// for images that cannot be block compressed.
+	static TextureCookFormat Cook(const unsigned char* pixels, unsigned int width, unsigned int height, const Settings& settings, uint64_t sourceHash, std::vector<char>& dds);
+	/// Reads back the source hash and settings passed to Cook. Returns false if the data is not a texture written by Cook with the current cooker version.
+	static bool ReadCookedInfo(const char* dds, size_t size, uint64_t& sourceHash, Settings& settings);
+	/// Lists the mips of a texture written by Cook, finest first, and returns its DXGI_FORMAT. Returns 0 if the data is not a complete cooked texture.
+	static unsigned int ReadCookedLevels(const char* dds, size_t size, std::vector<Level>& levels);
+	static const char* GetFormatName(TextureCookFormat format);
+};
@@ -0,0 +1,207 @@
+#include "texture_residency.h"
+
+TextureResidency::TextureResidency(size_t budget, unsigned int maxLoads)
+    : m_Budget(budget)
+    , m_MaxLoads(maxLoads)
+{
+}
+
+size_t TextureResidency::getBytes(const Entry& entry, int mip) const
+{
+	size_t bytes = 0;
+	for (int i = mip; i < (int)entry.mipBytes.size(); i++)
+	{
+		bytes += entry.mipBytes[i];
+	}
+	return bytes;
+}
+
+int TextureResidency::getEvictionLimit(const Entry& entry, unsigned int frame) const
+{
+	// Textures in use this frame only give up the detail they were not asked for
+	return entry.lastRequestFrame == frame ? std::max(entry.wantedMip, entry.residentMip) : entry.baseMip;
+}
+
+size_t TextureResidency::getEvictableBytes(unsigned int frame, int excludedSlot) const
+{
+	size_t bytes = 0;
+	for (int slot = 0; slot < (int)m_Entries.size(); slot++)
+	{
+		const Entry& entry = m_Entries[slot];
+		if (slot == excludedSlot || entry.mipBytes.empty() || entry.loadingMip >= 0)
+		{
+			continue;
+		}
+		bytes += getBytes(entry, entry.residentMip) - getBytes(entry, getEvictionLimit(entry, frame));
+	}
+	return bytes;
+}
+
+size_t TextureResidency::evict(size_t bytes, unsigned int frame, int excludedSlot, std::vector<Change>& evictions)
+{
+	std::vector<int> candidates;
+	for (int slot = 0; slot < (int)m_Entries.size(); slot++)
+	{
+		const Entry& entry = m_Entries[slot];
+		if (slot != excludedSlot && !entry.mipBytes.empty() && entry.loadingMip < 0 && entry.residentMip < getEvictionLimit(entry, frame))
+		{
+			candidates.push_back(slot);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+		return m_Entries[a].lastRequestFrame < m_Entries[b].lastRequestFrame;
+	});
+
+	size_t freed = 0;
+	for (int slot : candidates)
+	{
+		if (freed >= bytes)
+		{
+			break;
+		}
+
+		Entry& entry = m_Entries[slot];
+		const int limit = getEvictionLimit(entry, frame);
+		while (entry.residentMip < limit && freed < bytes)
+		{
+			freed += entry.mipBytes[entry.residentMip];
+			m_ResidentBytes -= entry.mipBytes[entry.residentMip];
+			entry.residentMip++;
+		}
+
+		auto findIt = std::find_if(evictions.begin(), evictions.end(), [slot](const Change& change) { return change.slot == slot; });
+		if (findIt != evictions.end())
+		{
+			findIt->mip = entry.residentMip;
+		}
+		else
+		{
+			evictions.push_back({ slot, entry.residentMip });
+		}
+	}
+	return freed;
+}
+
+int TextureResidency::add(const std::vector<size_t>& mipBytes, int baseMip)
+{
+	int slot = 0;
+	while (slot < (int)m_Entries.size() && !m_Entries[slot].mipBytes.empty())
+	{
+		slot++;
+	}
+	if (slot == (int)m_Entries.size())
+	{
+		m_Entries.emplace_back();
+	}
+
+	Entry& entry = m_Entries[slot];
+	entry = Entry();
+	entry.mipBytes = mipBytes;
+	entry.baseMip = baseMip;
+	entry.residentMip = baseMip;
+	entry.wantedMip = baseMip;
+	m_ResidentBytes += getBytes(entry, baseMip);
+	m_TextureCount++;
+	return slot;
+}
+
+void TextureResidency::remove(int slot)
+{
+	Entry& entry = m_Entries[slot];
+	if (entry.loadingMip >= 0)
+	{
+		m_LoadingCount--;
+	}
+	m_ResidentBytes -= getBytes(entry, entry.loadingMip >= 0 ? entry.loadingMip : entry.residentMip);
+	entry = Entry();
+	m_TextureCount--;
+}
+
+void TextureResidency::request(int slot, int mip, unsigned int frame)
+{
+	Entry& entry = m_Entries[slot];
+	mip = std::clamp(mip, 0, entry.baseMip);
+	if (entry.lastRequestFrame != frame)
+	{
+		entry.lastRequestFrame = frame;
+		entry.wantedMip = mip;
+	}
+	else
+	{
+		entry.wantedMip = std::min(entry.wantedMip, mip);
+	}
+}
+
+void TextureResidency::update(unsigned int frame, std::vector<Change>& loads, std::vector<Change>& evictions)
+{
+	if (m_ResidentBytes > m_Budget)
+	{
+		evict(m_ResidentBytes - m_Budget, frame, -1, evictions);
+	}
+
+	std::vector<int> candidates;
+	for (int slot = 0; slot < (int)m_Entries.size(); slot++)
+	{
+		const Entry& entry = m_Entries[slot];
+		if (!entry.mipBytes.empty() && entry.lastRequestFrame == frame && entry.loadingMip < 0 && !entry.isLoadFailed && entry.wantedMip < entry.residentMip)
+		{
+			candidates.push_back(slot);
+		}
+	}
+	// Textures furthest from what they need go first
+	std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+		return m_Entries[a].residentMip - m_Entries[a].wantedMip > m_Entries[b].residentMip - m_Entries[b].wantedMip;
+	});
+
+	for (int slot : candidates)
+	{
+		if (m_LoadingCount >= m_MaxLoads)
+		{
+			break;
+		}
+
+		Entry& entry = m_Entries[slot];
+		const size_t residentBytes = getBytes(entry, entry.residentMip);
+		// Settle for less detail than wanted if that is all the budget has room for
+		for (int mip = entry.wantedMip; mip < entry.residentMip; mip++)
+		{
+			const size_t loadBytes = getBytes(entry, mip) - residentBytes;
+			if (m_ResidentBytes + loadBytes > m_Budget)
+			{
+				const size_t missingBytes = m_ResidentBytes + loadBytes - m_Budget;
+				if (getEvictableBytes(frame, slot) < missingBytes)
+				{
+					continue;
+				}
+				evict(missingBytes, frame, slot, evictions);
+			}
+
+			entry.loadingMip = mip;
+			m_ResidentBytes += loadBytes;
+			m_LoadingCount++;
+			loads.push_back({ slot, mip });
+			break;
+		}
+	}
+}
+
+void TextureResidency::finishLoad(int slot, bool isLoaded)
+{
+	Entry& entry = m_Entries[slot];
+	if (entry.loadingMip < 0)
+	{
+		return;
+	}
+
+	if (isLoaded)
+	{
+		entry.residentMip = entry.loadingMip;
+	}
+	else
+	{
+		m_ResidentBytes -= getBytes(entry, entry.loadingMip) - getBytes(entry, entry.residentMip);
+		entry.isLoadFailed = true;
+	}
+	entry.loadingMip = -1;
+	m_LoadingCount--;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/// Decides which mips of streamed textures should be resident under a memory budget. Only does the bookkeeping, so the policy can be exercised without a GPU.
+/// Uses nothing but the standard library, so tools/texture_residency_check builds it anywhere.
+/// Textures always keep their base mips. Finer mips are loaded as far as requests ask for them while the budget allows,
+/// making room by dropping mips of the least recently requested textures first.
+class TextureResidency
+{
+public:
+	/// Mip that becomes the finest resident one of a texture
+	struct Change
+	{
+		int slot;
+		int mip;
+	};
+
+private:
+	struct Entry
+	{
+		/// Bytes of each mip, finest first. Empty for free slots, which are reused by later textures
+		std::vector<size_t> mipBytes;
+		int baseMip = 0;
+		int residentMip = 0;
+		/// -1 while no load is in flight
+		int loadingMip = -1;
+		/// Set when a load fails, so it is not retried every frame. Cleared when the slot is reused by a new texture.
+		bool isLoadFailed = false;
+		/// Finest mip asked for in the last frame the texture was requested
+		int wantedMip = 0;
+		/// 0 if never requested
+		unsigned int lastRequestFrame = 0;
+	};
+
+	std::vector<Entry> m_Entries;
+	size_t m_Budget;
+	/// Includes the mips being loaded
+	size_t m_ResidentBytes = 0;
+	unsigned int m_MaxLoads;
+	unsigned int m_LoadingCount = 0;
+	unsigned int m_TextureCount = 0;
+
+	size_t getBytes(const Entry& entry, int mip) const;
+	/// Drops mips of the least recently requested textures until bytes are freed or nothing else may go. Returns the bytes freed.
+	size_t evict(size_t bytes, unsigned int frame, int excludedSlot, std::vector<Change>& evictions);
+	size_t getEvictableBytes(unsigned int frame, int excludedSlot) const;
+	/// Mip a texture may be dropped to
+	int getEvictionLimit(const Entry& entry, unsigned int frame) const;
+
+public:
+	TextureResidency(size_t budget, unsigned int maxLoads);
+	TextureResidency(const TextureResidency&) = delete;
+	~TextureResidency() = default;
+
+	/// mipBytes lists the size of each mip, finest first. Mips from baseMip on start out resident and are never dropped.
+	int add(const std::vector<size_t>& mipBytes, int baseMip);
+	void remove(int slot);
+	/// Ask for mips down to mip to be resident. Frames start at 1 and the finest request of a frame wins.
+	void request(int slot, int mip, unsigned int frame);
+	/// Decide the loads to start and mips to drop this frame. Dropped mips are gone right away, loads count against the budget
+	/// from now but only become resident through finishLoad.
+	void update(unsigned int frame, std::vector<Change>& loads, std::vector<Change>& evictions);
+	/// A failed load gives its bytes back to the budget and no more loads are started for the texture
+	void finishLoad(int slot, bool isLoaded);
+
+	void setBudget(size_t budget) { m_Budget = budget; }
+	size_t getBudget() const { return m_Budget; }
+	size_t getResidentBytes() const { return m_ResidentBytes; }
+	int getResidentMip(int slot) const { return m_Entries[slot].residentMip; }
+	int getLoadingMip(int slot) const { return m_Entries[slot].loadingMip; }
+	unsigned int getTextureCount() const { return m_TextureCount; }
+	unsigned int getLoadingCount() const { return m_LoadingCount; }
+};
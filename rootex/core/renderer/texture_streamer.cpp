@@ -0,0 +1,285 @@
+#include "texture_streamer.h"
+
+#include "rendering_device.h"
+#include "texture.h"
+#include "os/mapped_file.h"
+
+#include "Tracy/Tracy.hpp"
+
+TextureStreamer::TextureStreamer()
+    : m_Residency((size_t)TEXTURE_STREAMING_DEFAULT_BUDGET_MB * 1024 * 1024, TEXTURE_STREAMING_MAX_LOADS)
+{
+	m_IsRunning = true;
+	for (int i = 0; i < TEXTURE_STREAMING_THREADS; i++)
+	{
+		m_Workers.emplace_back(&TextureStreamer::runWorker, this);
+	}
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	shutDown();
+}
+
+TextureStreamer* TextureStreamer::GetSingleton()
+{
+	static TextureStreamer singleton;
+	return &singleton;
+}
+
+void TextureStreamer::runWorker()
+{
+	tracy::SetThreadName("Texture Streaming");
+	while (true)
+	{
+		LoadJob job;
+		{
+			std::unique_lock<Mutex> lock(m_JobsMutex);
+			m_JobsVariable.wait(lock, [this]() { return !m_IsRunning || !m_Jobs.empty(); });
+			if (!m_IsRunning)
+			{
+				return;
+			}
+			job = std::move(m_Jobs.front());
+			m_Jobs.erase(m_Jobs.begin());
+		}
+
+		ZoneNamedN(textureLoad, "Texture Mip Load", true);
+		LoadResult result = { job.slot, job.generation, job.mip, {} };
+
+		// The cooker may have rewritten the file since the texture was created
+		Ptr<MappedFile> cookedFile = MappedFile::Open(job.cookedPath);
+		uint64_t sourceHash = 0;
+		TextureCooker::Settings settings;
+		if (cookedFile && TextureCooker::ReadCookedInfo(cookedFile->getData(), cookedFile->getSize(), sourceHash, settings) && sourceHash == job.sourceHash)
+		{
+			// Finer mips come first in the file, so the ones missing are contiguous
+			const TextureCooker::Level& finest = job.levels[job.mip];
+			const TextureCooker::Level& coarsest = job.levels[job.residentMip - 1];
+			const size_t end = coarsest.offset + coarsest.size;
+			if (end <= cookedFile->getSize())
+			{
+				result.data.assign(cookedFile->getData() + finest.offset, cookedFile->getData() + end);
+			}
+		}
+
+		while (!m_Results.push(std::move(result)))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+Ref<Texture> TextureStreamer::createTexture(const String& cookedPath, const char* dds, size_t size)
+{
+	Vector<TextureCooker::Level> levels;
+	uint64_t sourceHash = 0;
+	TextureCooker::Settings settings;
+	const DXGI_FORMAT format = (DXGI_FORMAT)TextureCooker::ReadCookedLevels(dds, size, levels);
+	if (format == DXGI_FORMAT_UNKNOWN || !TextureCooker::ReadCookedInfo(dds, size, sourceHash, settings))
+	{
+		return Ref<Texture>(new Texture(dds, size));
+	}
+
+	int baseMip = 0;
+	while (baseMip + 1 < levels.size() && std::max(levels[baseMip].width, levels[baseMip].height) > TEXTURE_STREAMING_BASE_SIZE)
+	{
+		// The finest mip of a block compressed texture must be made of whole blocks
+		const TextureCooker::Level& next = levels[baseMip + 1];
+		if (format != DXGI_FORMAT_R8G8B8A8_UNORM && (next.width % 4 != 0 || next.height % 4 != 0))
+		{
+			break;
+		}
+		baseMip++;
+	}
+
+	Vector<D3D11_SUBRESOURCE_DATA> levelData;
+	for (int mip = baseMip; mip < levels.size(); mip++)
+	{
+		levelData.push_back({ dds + levels[mip].offset, levels[mip].rowPitch, 0 });
+	}
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> residentMips = RenderingDevice::GetSingleton()->createTexture2D(format, levels[baseMip].width, levels[baseMip].height, levels.size() - baseMip, levelData.data());
+	Ref<Texture> texture(new Texture(residentMips, levels[0].width, levels[0].height, levels.size(), baseMip));
+	if (baseMip == 0)
+	{
+		return texture;
+	}
+
+	Vector<size_t> mipBytes;
+	for (auto& level : levels)
+	{
+		mipBytes.push_back(level.size);
+	}
+
+	std::lock_guard<Mutex> lock(m_Mutex);
+	const int slot = m_Residency.add(mipBytes, baseMip);
+	if (slot >= m_Textures.size())
+	{
+		m_Textures.resize(slot + 1);
+	}
+	StreamedTexture& streamed = m_Textures[slot];
+	streamed.texture = texture;
+	streamed.cookedPath = cookedPath;
+	streamed.sourceHash = sourceHash;
+	streamed.format = format;
+	streamed.levels = levels;
+	texture->m_StreamingSlot = slot;
+	return texture;
+}
+
+void TextureStreamer::request(Texture* texture, float screenPixels)
+{
+	if (texture->getStreamingSlot() < 0)
+	{
+		return;
+	}
+
+	const float texels = (float)std::max(texture->getWidth(), texture->getHeight());
+	const int mip = (int)std::floor(std::log2(texels / std::max(screenPixels, 1.0f)));
+
+	std::lock_guard<Mutex> lock(m_Mutex);
+	m_Residency.request(texture->getStreamingSlot(), mip, m_Frame);
+}
+
+Microsoft::WRL::ComPtr<ID3D11Texture2D> TextureStreamer::createResidentMips(const StreamedTexture& streamed, const Texture* texture, int mip)
+{
+	const TextureCooker::Level& finest = streamed.levels[mip];
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> residentMips = RenderingDevice::GetSingleton()->createTexture2D(streamed.format, finest.width, finest.height, streamed.levels.size() - mip, nullptr);
+
+	const int oldMip = texture->getResidentMip();
+	for (int level = std::max(mip, oldMip); level < streamed.levels.size(); level++)
+	{
+		RenderingDevice::GetSingleton()->copyTexture(residentMips.Get(), level - mip, texture->getD3D11Texture2D(), level - oldMip);
+	}
+	return residentMips;
+}
+
+void TextureStreamer::applyLoad(const LoadResult& result)
+{
+	StreamedTexture& streamed = m_Textures[result.slot];
+	if (streamed.generation != result.generation)
+	{
+		return;
+	}
+
+	Ref<Texture> texture = streamed.texture.lock();
+	if (!texture || result.data.empty())
+	{
+		m_Residency.finishLoad(result.slot, false);
+		return;
+	}
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> residentMips = createResidentMips(streamed, texture.get(), result.mip);
+	const size_t dataOffset = streamed.levels[result.mip].offset;
+	for (int level = result.mip; level < texture->getResidentMip(); level++)
+	{
+		const TextureCooker::Level& loaded = streamed.levels[level];
+		RenderingDevice::GetSingleton()->updateTexture(residentMips.Get(), level - result.mip, result.data.data() + loaded.offset - dataOffset, loaded.rowPitch);
+	}
+
+	texture->setResidentMips(residentMips, result.mip);
+	m_Residency.finishLoad(result.slot, true);
+}
+
+void TextureStreamer::applyEviction(int slot, int mip)
+{
+	StreamedTexture& streamed = m_Textures[slot];
+	Ref<Texture> texture = streamed.texture.lock();
+	if (!texture || texture->getResidentMip() == mip)
+	{
+		return;
+	}
+	texture->setResidentMips(createResidentMips(streamed, texture.get(), mip), mip);
+}
+
+void TextureStreamer::freeDeadTextures()
+{
+	for (int slot = 0; slot < m_Textures.size(); slot++)
+	{
+		StreamedTexture& streamed = m_Textures[slot];
+		if (!streamed.cookedPath.empty() && streamed.texture.expired())
+		{
+			m_Residency.remove(slot);
+			const unsigned int generation = streamed.generation + 1;
+			streamed = StreamedTexture();
+			streamed.generation = generation;
+		}
+	}
+}
+
+void TextureStreamer::update()
+{
+	ZoneScoped;
+	std::lock_guard<Mutex> lock(m_Mutex);
+
+	LoadResult result;
+	while (m_Results.pop(result))
+	{
+		applyLoad(result);
+	}
+	freeDeadTextures();
+
+	Vector<TextureResidency::Change> loads;
+	Vector<TextureResidency::Change> evictions;
+	m_Residency.update(m_Frame, loads, evictions);
+	for (auto& [slot, mip] : evictions)
+	{
+		applyEviction(slot, mip);
+	}
+
+	if (!loads.empty())
+	{
+		std::lock_guard<Mutex> jobsLock(m_JobsMutex);
+		for (auto& [slot, mip] : loads)
+		{
+			const StreamedTexture& streamed = m_Textures[slot];
+			m_Jobs.push_back({ slot, streamed.generation, mip, m_Residency.getResidentMip(slot), streamed.cookedPath, streamed.sourceHash, streamed.levels });
+		}
+		m_JobsVariable.notify_all();
+	}
+
+	m_Frame++;
+}
+
+void TextureStreamer::shutDown()
+{
+	{
+		// Set under the lock so a worker cannot miss the wake up between checking and waiting
+		std::lock_guard<Mutex> lock(m_JobsMutex);
+		m_IsRunning = false;
+	}
+	m_JobsVariable.notify_all();
+	for (auto& worker : m_Workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+	m_Workers.clear();
+}
+
+void TextureStreamer::setBudget(size_t bytes)
+{
+	std::lock_guard<Mutex> lock(m_Mutex);
+	m_Residency.setBudget(bytes);
+}
+
+size_t TextureStreamer::getBudget()
+{
+	std::lock_guard<Mutex> lock(m_Mutex);
+	return m_Residency.getBudget();
+}
+
+void TextureStreamer::draw()
+{
+	std::lock_guard<Mutex> lock(m_Mutex);
+	ImGui::Text("Streamed Textures: %u, %u loading", m_Residency.getTextureCount(), m_Residency.getLoadingCount());
+	ImGui::Text("Resident Texture Mips: %.2f / %.2f MB", m_Residency.getResidentBytes() / 1048576.0f, m_Residency.getBudget() / 1048576.0f);
+
+	int budgetMB = m_Residency.getBudget() / (1024 * 1024);
+	if (ImGui::DragInt("Texture Budget (MB)", &budgetMB, 1.0f, 16, 16384))
+	{
+		m_Residency.setBudget((size_t)budgetMB * 1024 * 1024);
+	}
+}
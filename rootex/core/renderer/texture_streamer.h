@@ -0,0 +1,104 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include "common/common.h"
+#include "os/mpsc_queue.h"
+#include "renderer/texture_cooker.h"
+#include "renderer/texture_residency.h"
+
+#include <condition_variable>
+#include <thread>
+
+/// Mips at most this many texels wide and tall are loaded with the texture and never dropped
+#define TEXTURE_STREAMING_BASE_SIZE 64
+#define TEXTURE_STREAMING_DEFAULT_BUDGET_MB 512
+#define TEXTURE_STREAMING_THREADS 2
+/// Loads in flight at once, so a camera cut does not queue up IO for every texture in view
+#define TEXTURE_STREAMING_MAX_LOADS 8
+#define TEXTURE_STREAMING_RESULT_QUEUE_CAPACITY 16
+
+class Texture;
+
+/// Streams the mips of cooked textures in and out under a memory budget.
+/// Textures start out with their coarsest mips. Renderables request detail by the size they cover on screen, worker threads read
+/// the missing mips from the cooked files and the render thread swaps them in, copying the mips already resident on the GPU.
+/// Which mips stay resident is decided by TextureResidency.
+class TextureStreamer
+{
+	struct StreamedTexture
+	{
+		Weak<Texture> texture;
+		/// Empty for free slots
+		String cookedPath;
+		uint64_t sourceHash = 0;
+		DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+		Vector<TextureCooker::Level> levels;
+		/// Bumped when the slot is freed, so loads finishing after their texture died are dropped
+		unsigned int generation = 0;
+	};
+
+	struct LoadJob
+	{
+		int slot;
+		unsigned int generation;
+		/// Mips from mip up to residentMip are read
+		int mip;
+		int residentMip;
+		String cookedPath;
+		uint64_t sourceHash;
+		Vector<TextureCooker::Level> levels;
+	};
+
+	struct LoadResult
+	{
+		int slot;
+		unsigned int generation;
+		int mip;
+		/// Empty if the mips could not be read
+		Vector<char> data;
+	};
+
+	/// Guards the streamed textures and their residency, which loader threads add to
+	Mutex m_Mutex;
+	TextureResidency m_Residency;
+	/// By residency slot
+	Vector<StreamedTexture> m_Textures;
+	unsigned int m_Frame = 1;
+
+	Mutex m_JobsMutex;
+	/// Wakes the workers when jobs are queued or streaming shuts down
+	std::condition_variable m_JobsVariable;
+	Vector<LoadJob> m_Jobs;
+	MPSCQueue<LoadResult, TEXTURE_STREAMING_RESULT_QUEUE_CAPACITY> m_Results;
+	Vector<std::thread> m_Workers;
+	Atomic<bool> m_IsRunning = false;
+
+	void runWorker();
+	void freeDeadTextures();
+	void applyLoad(const LoadResult& result);
+	void applyEviction(int slot, int mip);
+	/// New GPU texture holding the mips from mip on, with the mips already resident copied over
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> createResidentMips(const StreamedTexture& streamed, const Texture* texture, int mip);
+
+	TextureStreamer();
+	TextureStreamer(TextureStreamer&) = delete;
+	~TextureStreamer();
+
+public:
+	static TextureStreamer* GetSingleton();
+
+	/// Texture from a DDS file written by TextureCooker. Only the mips up to TEXTURE_STREAMING_BASE_SIZE are loaded if there are finer ones.
+	/// Safe to call from any thread.
+	Ref<Texture> createTexture(const String& cookedPath, const char* dds, size_t size);
+	/// Ask for the mips needed to draw the texture across screenPixels pixels. Call every frame the texture is drawn.
+	void request(Texture* texture, float screenPixels);
+	/// Swap in loaded mips, then start loads and drop mips for the requests made since the last update. Must be called on the thread that renders.
+	void update();
+	void shutDown();
+
+	void setBudget(size_t bytes);
+	size_t getBudget();
+
+	void draw();
+};
@@ -1,115 +1,67 @@
 #include "vertex_buffer.h"
 
 #include "rendering_device.h"
+#include "geometry_heap.h"
 
 #include "Tracy/Tracy.hpp"
 
-VertexBuffer::VertexBuffer(const Vector<VertexData>& buffer)
-    : m_Stride(sizeof(VertexData))
-    , m_Count(buffer.size())
+void VertexBuffer::create(const void* vertices, unsigned int count, BufferUsage usage)
 {
-	D3D11_BUFFER_DESC vbd = { 0 };
-	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vbd.Usage = D3D11_USAGE_DEFAULT;
-	vbd.CPUAccessFlags = 0;
-	vbd.MiscFlags = 0u;
-	vbd.ByteWidth = sizeof(VertexData) * buffer.size();
-	vbd.StructureByteStride = 0;
-	D3D11_SUBRESOURCE_DATA vsd = { 0 };
-	vsd.pSysMem = buffer.data();
+	m_Count = count;
+	m_VertexBuffer = RenderingDevice::GetSingleton()->createBuffer(vertices, m_Stride * count, D3D11_BIND_VERTEX_BUFFER, usage);
+}
 
-	const UINT offset = 0u;
-	m_VertexBuffer = RenderingDevice::GetSingleton()->createBuffer(&vbd, &vsd);
+VertexBuffer::VertexBuffer(const Vector<VertexData>& buffer, BufferUsage usage)
+    : m_Stride(sizeof(VertexData))
+{
+	create(buffer.data(), buffer.size(), usage);
 }
 
-VertexBuffer::VertexBuffer(const Vector<InstanceData>& buffer)
+VertexBuffer::VertexBuffer(const Vector<InstanceData>& buffer, BufferUsage usage)
     : m_Stride(sizeof(InstanceData))
-    , m_Count(buffer.size())
 {
-	D3D11_BUFFER_DESC vbd = { 0 };
-	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vbd.Usage = D3D11_USAGE_DYNAMIC;
-	vbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	vbd.MiscFlags = 0u;
-	vbd.ByteWidth = sizeof(InstanceData) * buffer.size();
-	vbd.StructureByteStride = 0;
-	D3D11_SUBRESOURCE_DATA vsd = { 0 };
-	vsd.pSysMem = buffer.data();
-
-	const UINT offset = 0u;
-	m_VertexBuffer = RenderingDevice::GetSingleton()->createBuffer(&vbd, &vsd);
+	create(buffer.data(), buffer.size(), usage);
 }
 
-VertexBuffer::VertexBuffer(const Vector<UIVertexData>& buffer)
+VertexBuffer::VertexBuffer(const Vector<UIVertexData>& buffer, BufferUsage usage)
     : m_Stride(sizeof(UIVertexData))
-    , m_Count(buffer.size())
 {
-	D3D11_BUFFER_DESC vbd = { 0 };
-	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vbd.Usage = D3D11_USAGE_DEFAULT;
-	vbd.CPUAccessFlags = 0;
-	vbd.MiscFlags = 0u;
-	vbd.ByteWidth = sizeof(UIVertexData) * buffer.size();
-	vbd.StructureByteStride = 0;
-	D3D11_SUBRESOURCE_DATA vsd = { 0 };
-	vsd.pSysMem = buffer.data();
-
-	const UINT offset = 0u;
-	m_VertexBuffer = RenderingDevice::GetSingleton()->createBuffer(&vbd, &vsd);
+	create(buffer.data(), buffer.size(), usage);
 }
 
-VertexBuffer::VertexBuffer(const Vector<AnimatedVertexData>& buffer)
+VertexBuffer::VertexBuffer(const Vector<AnimatedVertexData>& buffer, BufferUsage usage)
     : m_Stride(sizeof(AnimatedVertexData))
-    , m_Count(buffer.size())
 {
-	D3D11_BUFFER_DESC vbd = { 0 };
-	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vbd.Usage = D3D11_USAGE_DYNAMIC;
-	vbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	vbd.MiscFlags = 0u;
-	vbd.ByteWidth = sizeof(AnimatedVertexData) * buffer.size();
-	vbd.StructureByteStride = 0;
-	D3D11_SUBRESOURCE_DATA vsd = { 0 };
-	vsd.pSysMem = buffer.data();
-
-	const UINT offset = 0u;
-	m_VertexBuffer = RenderingDevice::GetSingleton()->createBuffer(&vbd, &vsd);
+	create(buffer.data(), buffer.size(), usage);
 }
 
-VertexBuffer::VertexBuffer(const Vector<FXAAData>& buffer)
+VertexBuffer::VertexBuffer(const Vector<FXAAData>& buffer, BufferUsage usage)
     : m_Stride(sizeof(FXAAData))
-    , m_Count(buffer.size())
 {
-	D3D11_BUFFER_DESC vbd = { 0 };
-	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vbd.Usage = D3D11_USAGE_DEFAULT;
-	vbd.CPUAccessFlags = 0;
-	vbd.MiscFlags = 0u;
-	vbd.ByteWidth = sizeof(FXAAData) * buffer.size();
-	vbd.StructureByteStride = 0;
-	D3D11_SUBRESOURCE_DATA vsd = { 0 };
-	vsd.pSysMem = buffer.data();
-
-	const UINT offset = 0u;
-	m_VertexBuffer = RenderingDevice::GetSingleton()->createBuffer(&vbd, &vsd);
+	create(buffer.data(), buffer.size(), usage);
 }
 
-VertexBuffer::VertexBuffer(const Vector<float>& buffer)
+VertexBuffer::VertexBuffer(const Vector<float>& buffer, BufferUsage usage)
     : m_Stride(3 * sizeof(float))
-    , m_Count(buffer.size() / 3)
 {
-	D3D11_BUFFER_DESC vbd = { 0 };
-	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vbd.Usage = D3D11_USAGE_DEFAULT;
-	vbd.CPUAccessFlags = 0;
-	vbd.MiscFlags = 0u;
-	vbd.ByteWidth = sizeof(float) * buffer.size();
-	vbd.StructureByteStride = 0;
-	D3D11_SUBRESOURCE_DATA vsd = { 0 };
-	vsd.pSysMem = buffer.data();
+	create(buffer.data(), buffer.size() / 3, usage);
+}
 
-	const UINT offset = 0u;
-	m_VertexBuffer = RenderingDevice::GetSingleton()->createBuffer(&vbd, &vsd);
+VertexBuffer::VertexBuffer(Ref<GeometryPool> pool, const void* vertices, unsigned int count, unsigned int stride, bool isPacked)
+    : m_Stride(stride)
+    , m_Count(count)
+    , m_Pool(pool)
+    , m_IsPacked(isPacked)
+{
+	m_VertexBuffer = m_Pool->allocate(vertices, count, m_Range);
+}
+
+VertexBuffer::~VertexBuffer()
+{
+	if (m_Pool)
+	{
+		m_Pool->free(m_Range);
+	}
 }
 
 void VertexBuffer::bind() const
@@ -120,10 +72,15 @@ void VertexBuffer::bind() const
 }
 
 void VertexBuffer::setData(const Vector<InstanceData>& buffer)
+{
+	setData(buffer.data(), buffer.size());
+}
+
+void VertexBuffer::setData(const InstanceData* buffer, unsigned int count)
 {
 	D3D11_MAPPED_SUBRESOURCE subresource = { 0 };
 	RenderingDevice::GetSingleton()->mapBuffer(m_VertexBuffer.Get(), subresource);
-	memcpy(subresource.pData, buffer.data(), buffer.size() * sizeof(InstanceData));
+	memcpy(subresource.pData, buffer, count * sizeof(InstanceData));
 	RenderingDevice::GetSingleton()->unmapBuffer(m_VertexBuffer.Get());
-	m_Count = buffer.size();
+	m_Count = count;
 }
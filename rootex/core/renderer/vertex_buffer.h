@@ -4,6 +4,10 @@
 
 #include "common/common.h"
 #include "renderer/vertex_data.h"
+#include "renderer/buffer_usage.h"
+#include "renderer/geometry_arena.h"
+
+class GeometryPool;
 
 /// Encapsulates a vector of vertices to be used as Vertex Buffer
 class VertexBuffer
@@ -12,21 +16,37 @@ class VertexBuffer
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_VertexBuffer;
 	unsigned int m_Stride;
 	unsigned int m_Count;
+	/// Set when the vertices are a range of a page shared with other meshes
+	Ref<GeometryPool> m_Pool;
+	GeometryRange m_Range;
+	/// Holds PackedVertexData or PackedAnimatedVertexData
+	bool m_IsPacked = false;
+
+	void create(const void* vertices, unsigned int count, BufferUsage usage);
 
 public:
-	VertexBuffer(const Vector<VertexData>& buffer);
-	VertexBuffer(const Vector<InstanceData>& buffer);
-	VertexBuffer(const Vector<UIVertexData>& buffer);
-	VertexBuffer(const Vector<AnimatedVertexData>& buffer);
-	VertexBuffer(const Vector<float>& buffer);
-	VertexBuffer(const Vector<FXAAData>& buffer);
-	~VertexBuffer() = default;
+	VertexBuffer(const Vector<VertexData>& buffer, BufferUsage usage = BufferUsage::Immutable);
+	VertexBuffer(const Vector<InstanceData>& buffer, BufferUsage usage = BufferUsage::Dynamic);
+	VertexBuffer(const Vector<UIVertexData>& buffer, BufferUsage usage = BufferUsage::Immutable);
+	VertexBuffer(const Vector<AnimatedVertexData>& buffer, BufferUsage usage = BufferUsage::Immutable);
+	VertexBuffer(const Vector<float>& buffer, BufferUsage usage = BufferUsage::Immutable);
+	VertexBuffer(const Vector<FXAAData>& buffer, BufferUsage usage = BufferUsage::Immutable);
+	/// Vertices in a range of a shared page. Use GeometryHeap to create these.
+	VertexBuffer(Ref<GeometryPool> pool, const void* vertices, unsigned int count, unsigned int stride, bool isPacked = false);
+	VertexBuffer(const VertexBuffer&) = delete;
+	~VertexBuffer();
 
 	void bind() const;
 
+	/// Only for dynamic buffers
 	void setData(const Vector<InstanceData>& buffer);
+	/// Upload only the first count instances
+	void setData(const InstanceData* buffer, unsigned int count);
 
 	unsigned int getCount() const { return m_Count; }
 	unsigned int getStride() const { return m_Stride; }
+	bool isPacked() const { return m_IsPacked; }
+	/// Offset of the first vertex in the buffer, for indices to be relative to
+	int getBaseVertex() const { return m_Range.offset; }
 	ID3D11Buffer* getBuffer() const { return m_VertexBuffer.Get(); };
 };
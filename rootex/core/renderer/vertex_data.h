@@ -39,6 +39,24 @@ struct AnimatedVertexData : public VertexData
 	Vector4 m_BoneWeights;
 };
 
+/// VertexData quantized for the GPU. Normals, texture coordinates and tangents are half floats.
+/// Position stays a full float at the start, so layouts only reading positions work on either.
+struct PackedVertexData
+{
+	Vector3 m_Position;
+	/// W is 1 like the full layout's default
+	unsigned short m_Normal[4];
+	unsigned short m_TextureCoord[2];
+	unsigned short m_Tangent[4];
+};
+
+/// AnimatedVertexData quantized for the GPU. Weights are unorm8.
+struct PackedAnimatedVertexData : public PackedVertexData
+{
+	unsigned char m_BoneIndices[4];
+	unsigned char m_BoneWeights[4];
+};
+
 struct FXAAData
 {
 	Vector3 m_Position;
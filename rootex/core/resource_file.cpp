@@ -1,5 +1,7 @@
 #include "resource_file.h"
 
+#include "resource_loader.h"
+
 ResourceFile::ResourceFile(const Type& type, const FilePath& path)
     : m_Type(type)
     , m_Path(path.generic_string())
@@ -8,6 +10,25 @@ ResourceFile::ResourceFile(const Type& type, const FilePath& path)
 	m_LastChangedTime = OS::GetFileLastChangedTime(getPath().string());
 }
 
+uint64_t ResourceFile::HashContents(const FileBuffer& buffer)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : buffer)
+	{
+		hash ^= (unsigned char)c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+void ResourceFile::addDependency(const String& path)
+{
+	if (std::find(m_Dependencies.begin(), m_Dependencies.end(), path) == m_Dependencies.end())
+	{
+		m_Dependencies.push_back(path);
+	}
+}
+
 FilePath ResourceFile::getPath() const
 {
 	return m_Path;
@@ -26,6 +47,8 @@ const FileTimePoint& ResourceFile::getLastChangedTime()
 
 void ResourceFile::reimport()
 {
+	m_IsDirty = false;
+	m_Dependencies.clear();
 	m_LastReadTime = OS::s_FileSystemClock.now();
 	m_LastChangedTime = OS::GetFileLastChangedTime(getPath().string());
 }
@@ -37,6 +60,10 @@ bool ResourceFile::save()
 
 bool ResourceFile::isDirty()
 {
+	if (ResourceLoader::IsWatched(getPath()))
+	{
+		return m_IsDirty;
+	}
 	return getLastReadTime() < getLastChangedTime();
 }
 
@@ -43,9 +43,19 @@ protected:
 	FilePath m_Path;
 	FileTimePoint m_LastReadTime;
 	FileTimePoint m_LastChangedTime;
+	/// Set by the file watcher when hot reload is watching this file, so that dirtiness does not need to be polled from disk.
+	bool m_IsDirty = false;
+	/// Other files read by the last import. ResourceLoader reimports this resource when any of them changes.
+	Vector<String> m_Dependencies;
 
 	explicit ResourceFile(const Type& type, const FilePath& path);
 
+	/// Mark a file read while importing. Call from reimport().
+	void addDependency(const String& path);
+
+	/// 64 bit FNV-1a of file contents, used to tell if a cooked copy is stale
+	static uint64_t HashContents(const FileBuffer& buffer);
+
 	friend class ResourceLoader;
 
 public:
@@ -57,7 +67,9 @@ public:
 	virtual void reimport();
 	virtual bool save();
 
-	/// If the file has been changed on disk.
+	const Vector<String>& getDependencies() const { return m_Dependencies; }
+
+	/// If the file has been changed on disk. Only polls the file system if hot reload is not watching the file.
 	bool isDirty();
 
 	FilePath getPath() const;
@@ -6,6 +6,7 @@
 #include "renderer/vertex_data.h"
 #include "renderer/vertex_buffer.h"
 #include "renderer/index_buffer.h"
+#include "renderer/geometry_heap.h"
 #include "utility/maths.h"
 
 #include "assimp/Importer.hpp"
@@ -168,6 +169,54 @@ void AnimatedModelResourceFile::reimport()
 			vertices.push_back(vertex);
 		}
 
+		HashMap<int, Vector<unsigned int>> verticesIndex;
+		HashMap<int, Vector<float>> verticesWeights;
+
+		for (int j = 0; j < mesh->mNumBones; j++)
+		{
+			unsigned int boneIndex = 0;
+			const aiBone* bone = mesh->mBones[j];
+
+			if (m_BoneMapping.find(bone->mName.C_Str()) == m_BoneMapping.end())
+			{
+				boneIndex = boneCount;
+				boneCount++;
+
+				m_BoneMapping[bone->mName.C_Str()] = boneIndex;
+
+				Matrix offsetMatrix = AiMatrixToMatrix(bone->mOffsetMatrix);
+				m_BoneOffsets.push_back(offsetMatrix);
+			}
+			else
+			{
+				boneIndex = m_BoneMapping[bone->mName.C_Str()];
+			}
+
+			for (int weightIndex = 0; weightIndex < bone->mNumWeights; weightIndex++)
+			{
+				verticesIndex[bone->mWeights[weightIndex].mVertexId].push_back(boneIndex);
+				verticesWeights[bone->mWeights[weightIndex].mVertexId].push_back(bone->mWeights[weightIndex].mWeight);
+			}
+		}
+
+		for (auto& [vertexID, boneIndices] : verticesIndex)
+		{
+			boneIndices.resize(4);
+			vertices[vertexID].m_BoneIndices[0] = boneIndices[0];
+			vertices[vertexID].m_BoneIndices[1] = boneIndices[1];
+			vertices[vertexID].m_BoneIndices[2] = boneIndices[2];
+			vertices[vertexID].m_BoneIndices[3] = boneIndices[3];
+		}
+
+		for (auto& [vertexID, boneWeights] : verticesWeights)
+		{
+			boneWeights.resize(4);
+			vertices[vertexID].m_BoneWeights.x = boneWeights[0];
+			vertices[vertexID].m_BoneWeights.y = boneWeights[1];
+			vertices[vertexID].m_BoneWeights.z = boneWeights[2];
+			vertices[vertexID].m_BoneWeights.w = boneWeights[3];
+		}
+
 		std::vector<unsigned int> indices;
 
 		aiFace* face = nullptr;
@@ -180,31 +229,20 @@ void AnimatedModelResourceFile::reimport()
 			indices.push_back(face->mIndices[2]);
 		}
 
-		meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
-
-		Vector<Vector<unsigned int>> lods;
-		float lodLevels[MAX_LOD_COUNT - 1] = { 0.8f, 0.50f, 0.3f, 0.10f };
-
-		for (int i = 0; i < MAX_LOD_COUNT - 1; i++)
+		if (indices.empty())
 		{
-			float threshold = lodLevels[i];
-			size_t targetIndexCount = indices.size() * threshold;
-
-			Vector<unsigned int> lod(indices.size());
-			float lodError = 0.0f;
-			size_t finalLODIndexCount = meshopt_simplifySloppy(
-			    &lod[0],
-			    indices.data(),
-			    indices.size(),
-			    &vertices[0].m_Position.x,
-			    vertices.size(),
-			    sizeof(AnimatedVertexData),
-			    targetIndexCount);
-			lod.resize(finalLODIndexCount);
-
-			lods.push_back(lod);
+			WARN("Skipped mesh without triangles: " + String(mesh->mName.C_Str()));
+			continue;
 		}
 
+		meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+		// Reorder triangles to draw outer ones first as long as that costs at most 5% more vertex cache misses
+		meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), &vertices[0].m_Position.x, vertices.size(), sizeof(AnimatedVertexData), 1.05f);
+		// Bone weights are already in the vertices, since this renumbers them
+		vertices.resize(meshopt_optimizeVertexFetch(vertices.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(AnimatedVertexData)));
+
+		const Vector<Pair<Vector<unsigned int>, float>> lods = Mesh::SimplifyLODs(indices, &vertices[0].m_Position.x, vertices.size(), sizeof(AnimatedVertexData));
+
 		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 
 		aiColor3D color(0.0f, 0.0f, 0.0f);
@@ -230,6 +268,7 @@ void AnimatedModelResourceFile::reimport()
 		{
 			materialPath = "game/assets/materials/" + String(material->GetName().C_Str()) + ".rmat";
 		}
+		addDependency(materialPath);
 
 		if (OS::IsExists(materialPath))
 		{
@@ -324,63 +363,12 @@ void AnimatedModelResourceFile::reimport()
 			}
 		}
 
-		HashMap<int, Vector<unsigned int>> verticesIndex;
-		HashMap<int, Vector<float>> verticesWeights;
-
-		for (int j = 0; j < mesh->mNumBones; j++)
-		{
-			unsigned int boneIndex = 0;
-			const aiBone* bone = mesh->mBones[j];
-
-			if (m_BoneMapping.find(bone->mName.C_Str()) == m_BoneMapping.end())
-			{
-				boneIndex = boneCount;
-				boneCount++;
-
-				m_BoneMapping[bone->mName.C_Str()] = boneIndex;
-
-				Matrix offsetMatrix = AiMatrixToMatrix(bone->mOffsetMatrix);
-				m_BoneOffsets.push_back(offsetMatrix);
-			}
-			else
-			{
-				boneIndex = m_BoneMapping[bone->mName.C_Str()];
-			}
-
-			for (int weightIndex = 0; weightIndex < bone->mNumWeights; weightIndex++)
-			{
-				verticesIndex[bone->mWeights[weightIndex].mVertexId].push_back(boneIndex);
-				verticesWeights[bone->mWeights[weightIndex].mVertexId].push_back(bone->mWeights[weightIndex].mWeight);
-			}
-		}
-
-		for (auto& [vertexID, boneIndices] : verticesIndex)
-		{
-			boneIndices.resize(4);
-			vertices[vertexID].m_BoneIndices[0] = boneIndices[0];
-			vertices[vertexID].m_BoneIndices[1] = boneIndices[1];
-			vertices[vertexID].m_BoneIndices[2] = boneIndices[2];
-			vertices[vertexID].m_BoneIndices[3] = boneIndices[3];
-		}
-
-		for (auto& [vertexID, boneWeights] : verticesWeights)
-		{
-			boneWeights.resize(4);
-			vertices[vertexID].m_BoneWeights.x = boneWeights[0];
-			vertices[vertexID].m_BoneWeights.y = boneWeights[1];
-			vertices[vertexID].m_BoneWeights.z = boneWeights[2];
-			vertices[vertexID].m_BoneWeights.w = boneWeights[3];
-		}
-
 		Mesh extractedMesh;
-		extractedMesh.m_VertexBuffer.reset(new VertexBuffer(vertices));
-		extractedMesh.addLOD(std::make_shared<IndexBuffer>(indices), 1.0f);
-		for (int i = 0; i < MAX_LOD_COUNT - 1; i++)
+		extractedMesh.m_VertexBuffer = GeometryHeap::GetSingleton()->createVertexBuffer(vertices);
+		extractedMesh.addLOD(GeometryHeap::GetSingleton()->createIndexBuffer(indices), 0.0f);
+		for (auto& [lod, error] : lods)
 		{
-			if (!lods[i].empty())
-			{
-				extractedMesh.addLOD(std::make_shared<IndexBuffer>(lods[i]), lodLevels[i]);
-			}
+			extractedMesh.addLOD(GeometryHeap::GetSingleton()->createIndexBuffer(lod), error);
 		}
 		Vector3 max = { mesh->mAABB.mMax.x, mesh->mAABB.mMax.y, mesh->mAABB.mMax.z };
 		Vector3 min = { mesh->mAABB.mMin.x, mesh->mAABB.mMin.y, mesh->mAABB.mMin.z };
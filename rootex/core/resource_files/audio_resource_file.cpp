@@ -7,76 +7,44 @@ AudioResourceFile::AudioResourceFile(const FilePath& path)
     , m_AudioDataSize(0)
     , m_BitDepth(0)
     , m_Channels(0)
-    , m_DecompressedAudioBuffer(nullptr)
+    , m_Duration(0.0f)
     , m_Format(0)
     , m_Frequency(0)
 {
 	reimport();
 }
 
-AudioResourceFile::~AudioResourceFile()
+void AudioResourceFile::reimport()
 {
-	resetBuffer();
-}
+	ResourceFile::reimport();
 
-void AudioResourceFile::resetBuffer()
-{
-	if (m_DecompressedAudioBuffer)
+	Ptr<AudioDecoder> decoder = createDecoder();
+	if (!decoder)
 	{
-		ALUT_CHECK(alutUnloadWAV(m_Format, (void*)m_DecompressedAudioBuffer, m_AudioDataSize, m_Frequency));
-		m_DecompressedAudioBuffer = nullptr;
+		ERR("Could not import audio file: " + m_Path.generic_string());
+		return;
 	}
+
+	m_Format = decoder->getFormat();
+	m_Frequency = decoder->getFrequency();
+	m_Channels = decoder->getChannels();
+	m_BitDepth = decoder->getBitDepth();
+	m_AudioDataSize = decoder->getDecodedSize();
+	m_Duration = decoder->getDuration();
 }
 
-void AudioResourceFile::reimport()
+Ptr<AudioDecoder> AudioResourceFile::createDecoder() const
 {
-	ResourceFile::reimport();
-
-	resetBuffer();
-
-	const char* audioBuffer;
-	int format;
-	int size;
-	float frequency;
-
-	// We need to manually destruct this buffer on destruction.
-	ALUT_CHECK(audioBuffer = (const char*)alutLoadMemoryFromFile(
-	               OS::GetAbsolutePath(m_Path.generic_string()).generic_string().c_str(),
-	               &format,
-	               &size,
-	               &frequency));
-
-	m_DecompressedAudioBuffer = audioBuffer;
-	m_Format = format;
-	m_AudioDataSize = size;
-	m_Frequency = frequency;
+	return AudioDecoder::Open(m_Path.generic_string());
+}
 
-	switch (m_Format)
+Vector<char> AudioResourceFile::decodeAll() const
+{
+	Vector<char> audioData;
+	if (Ptr<AudioDecoder> decoder = createDecoder())
 	{
-	case AL_FORMAT_MONO8:
-		m_Channels = 1;
-		m_BitDepth = 8;
-		break;
-
-	case AL_FORMAT_MONO16:
-		m_Channels = 1;
-		m_BitDepth = 16;
-		break;
-
-	case AL_FORMAT_STEREO8:
-		m_Channels = 2;
-		m_BitDepth = 8;
-		break;
-
-	case AL_FORMAT_STEREO16:
-		m_Channels = 2;
-		m_BitDepth = 16;
-		break;
-
-	default:
-		ERR("Unknown channels and bit depth in WAV data");
+		audioData.resize(decoder->getDecodedSize());
+		audioData.resize(decoder->decode(audioData.data(), audioData.size()));
 	}
-
-	m_Duration = size * 8 / (m_Channels * m_BitDepth);
-	m_Duration /= frequency;
+	return audioData;
 }
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "resource_file.h"
+#include "core/audio/audio_decoder.h"
 
 #include "al.h"
-#include "AL/alut.h"
 
-/// Representation of an audio file. Only .wav files are supported.
+/// Representation of an audio file. WAV files holding PCM or IMA ADPCM data are supported.
+/// Only the format is read on import. Audio data is decoded by whoever plays it, all at once for short sounds
+/// or a chunk at a time for streamed music.
 class AudioResourceFile : public ResourceFile
 {
 	ALenum m_Format;
@@ -13,24 +15,24 @@ class AudioResourceFile : public ResourceFile
 	int m_BitDepth;
 	int m_Channels;
 	float m_Duration;
-
-	const char* m_DecompressedAudioBuffer;
 	ALsizei m_AudioDataSize;
 
 	explicit AudioResourceFile(const FilePath& path);
 
 	friend class ResourceLoader;
 
-	void resetBuffer();
-
 public:
 	explicit AudioResourceFile(AudioResourceFile&) = delete;
 	explicit AudioResourceFile(AudioResourceFile&&) = delete;
-	~AudioResourceFile();
+	~AudioResourceFile() = default;
 
 	void reimport() override;
 
-	const char* getAudioData() const { return m_DecompressedAudioBuffer; }
+	/// Open a new decoder positioned at the start of the audio. Returns nullptr if the file cannot be decoded.
+	Ptr<AudioDecoder> createDecoder() const;
+	/// Decode the whole file into memory.
+	Vector<char> decodeAll() const;
+
 	/// Get size of decompressed audio data.
 	ALsizei getAudioDataSize() const { return m_AudioDataSize; }
 	/// Returns the same enum value that OpenAL uses.
@@ -4,16 +4,126 @@
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 
+#include "Tracy/Tracy.hpp"
+
+#define COOKED_COLLISION_MAGIC 0x4c4f4358 // "XCOL"
+#define COOKED_COLLISION_VERSION 1
+#define COOKED_COLLISION_ALIGNMENT 16
+
+/// Layout of a cooked collision model. Submeshes, vertices, indices and the serialized BVH follow at the given offsets.
+struct CookedCollisionHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+	uint32_t submeshCount;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t submeshOffset;
+	uint32_t vertexOffset;
+	uint32_t indexOffset;
+	uint32_t bvhOffset;
+	uint32_t bvhSize;
+};
+
+struct CookedSubmesh
+{
+	uint32_t firstVertex;
+	uint32_t vertexCount;
+	uint32_t firstIndex;
+	uint32_t triangleCount;
+};
+
+static uint32_t AlignCooked(uint32_t offset)
+{
+	return (offset + COOKED_COLLISION_ALIGNMENT - 1) & ~(COOKED_COLLISION_ALIGNMENT - 1);
+}
+
+static void AddSubmesh(btTriangleIndexVertexArray& triangleMesh, const Vector3* vertices, const unsigned int* indices, const CookedSubmesh& submesh)
+{
+	btIndexedMesh indexedMesh;
+	indexedMesh.m_numTriangles = submesh.triangleCount;
+	indexedMesh.m_numVertices = submesh.vertexCount;
+	indexedMesh.m_triangleIndexBase = (const unsigned char*)(indices + submesh.firstIndex);
+	indexedMesh.m_triangleIndexStride = 3 * sizeof(unsigned int);
+	indexedMesh.m_vertexBase = (const unsigned char*)(vertices + submesh.firstVertex);
+	indexedMesh.m_vertexStride = 3 * sizeof(float);
+	triangleMesh.addIndexedMesh(indexedMesh, PHY_INTEGER);
+}
+
 CollisionModelResourceFile::CollisionModelResourceFile(const FilePath& path)
     : ResourceFile(Type::CollisionModel, path)
 {
 	reimport();
 }
 
+String CollisionModelResourceFile::getCookedPath() const
+{
+	std::stringstream name;
+	name << std::hex << std::hash<String>()(getPath().generic_string());
+	return COLLISION_MODEL_COOKED_DIRECTORY + name.str() + ".bvh";
+}
+
 void CollisionModelResourceFile::reimport()
 {
+	ZoneScoped;
 	ResourceFile::reimport();
 
+	const uint64_t sourceHash = HashContents(OS::LoadFileContents(getPath().generic_string()));
+
+	Ref<CollisionMesh> mesh = loadCooked(sourceHash);
+	if (!mesh)
+	{
+		mesh = importModel();
+		if (mesh)
+		{
+			cook(*mesh, sourceHash);
+		}
+	}
+	m_Mesh = mesh;
+}
+
+Ref<CollisionModelResourceFile::CollisionMesh> CollisionModelResourceFile::loadCooked(uint64_t sourceHash) const
+{
+	ZoneScoped;
+	Ptr<MappedFile> cookedFile = MappedFile::Open(getCookedPath());
+	if (!cookedFile || cookedFile->getSize() < sizeof(CookedCollisionHeader))
+	{
+		return nullptr;
+	}
+
+	char* data = cookedFile->getData();
+	const CookedCollisionHeader& header = *(const CookedCollisionHeader*)data;
+	if (header.magic != COOKED_COLLISION_MAGIC || header.version != COOKED_COLLISION_VERSION || header.sourceHash != sourceHash || (size_t)header.bvhOffset + header.bvhSize > cookedFile->getSize())
+	{
+		return nullptr;
+	}
+
+	// The BVH is fixed up in place inside the copy-on-write mapping
+	btOptimizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(data + header.bvhOffset, header.bvhSize, false);
+	if (!bvh)
+	{
+		WARN("Cooked collision BVH is corrupt, reimporting: " + getPath().generic_string());
+		return nullptr;
+	}
+
+	Ref<CollisionMesh> mesh(new CollisionMesh());
+	const CookedSubmesh* submeshes = (const CookedSubmesh*)(data + header.submeshOffset);
+	const Vector3* vertices = (const Vector3*)(data + header.vertexOffset);
+	const unsigned int* indices = (const unsigned int*)(data + header.indexOffset);
+	for (uint32_t i = 0; i < header.submeshCount; i++)
+	{
+		AddSubmesh(mesh->triangleMesh, vertices, indices, submeshes[i]);
+	}
+	mesh->cookedFile = std::move(cookedFile);
+	mesh->shape.reset(new btBvhTriangleMeshShape(&mesh->triangleMesh, true, false));
+	mesh->shape->setOptimizedBvh(bvh);
+	return mesh;
+}
+
+Ref<CollisionModelResourceFile::CollisionMesh> CollisionModelResourceFile::importModel() const
+{
+	ZoneScoped;
 	Assimp::Importer modelLoader;
 	const aiScene* scene = modelLoader.ReadFile(
 	    getPath().generic_string(),
@@ -23,13 +133,10 @@ void CollisionModelResourceFile::reimport()
 	{
 		ERR("Collision Model could not be loaded: " + getPath().generic_string());
 		ERR("Assimp: " + modelLoader.GetErrorString());
-		return;
+		return nullptr;
 	}
 
-	btTriangleIndexVertexArray meshes;
-	m_Meshes.clear();
-	m_Vertices.clear();
-	m_Indices.clear();
+	Ref<CollisionMesh> collisionMesh(new CollisionMesh());
 
 	// Stop the arrays from changing memory locations
 	unsigned int totalVertices = 0;
@@ -39,46 +146,114 @@ void CollisionModelResourceFile::reimport()
 		totalVertices += scene->mMeshes[i]->mNumVertices;
 		totalIndices += scene->mMeshes[i]->mNumFaces * 3;
 	}
-	m_Vertices.reserve(totalVertices);
-	m_Indices.reserve(totalIndices);
+	if (totalIndices == 0)
+	{
+		ERR("Collision Model has no triangles: " + getPath().generic_string());
+		return nullptr;
+	}
+	collisionMesh->vertices.reserve(totalVertices);
+	collisionMesh->indices.reserve(totalIndices);
 
-	unsigned int indicesSeen = 0;
-	unsigned int verticesSeen = 0;
+	Vector<CookedSubmesh> submeshes;
 	for (int i = 0; i < scene->mNumMeshes; i++)
 	{
 		const aiMesh* mesh = scene->mMeshes[i];
 
-		btIndexedMesh indexedMesh;
+		CookedSubmesh submesh;
+		submesh.firstVertex = collisionMesh->vertices.size();
+		submesh.vertexCount = mesh->mNumVertices;
+		submesh.firstIndex = collisionMesh->indices.size();
+		submesh.triangleCount = mesh->mNumFaces;
+
+		for (unsigned int f = 0; f < mesh->mNumFaces; f++)
 		{
-			indexedMesh.m_numTriangles = mesh->mNumFaces;
-			indexedMesh.m_numVertices = mesh->mNumVertices;
-			aiFace* face = nullptr;
-			for (unsigned int f = 0; f < mesh->mNumFaces; f++)
-			{
-				face = &mesh->mFaces[f];
-				//Model already triangulated by aiProcess_Triangulate so no need to check
-				m_Indices.push_back(face->mIndices[0]);
-				m_Indices.push_back(face->mIndices[1]);
-				m_Indices.push_back(face->mIndices[2]);
-			}
-			indexedMesh.m_triangleIndexBase = (const unsigned char*)(m_Indices.data() + indicesSeen);
-			indexedMesh.m_triangleIndexStride = 3 * sizeof(short);
-			for (unsigned int v = 0; v < mesh->mNumVertices; v++)
-			{
-				Vector3 vertex;
-				vertex.x = mesh->mVertices[v].x;
-				vertex.y = mesh->mVertices[v].y;
-				vertex.z = mesh->mVertices[v].z;
-				m_Vertices.push_back(vertex);
-			}
-			indexedMesh.m_vertexBase = (const unsigned char*)(m_Vertices.data() + verticesSeen);
-			indexedMesh.m_vertexStride = 3 * sizeof(float);
+			//Model already triangulated by aiProcess_Triangulate so no need to check
+			const aiFace& face = mesh->mFaces[f];
+			collisionMesh->indices.push_back(face.mIndices[0]);
+			collisionMesh->indices.push_back(face.mIndices[1]);
+			collisionMesh->indices.push_back(face.mIndices[2]);
 		}
-		indicesSeen += mesh->mNumFaces * 3;
-		verticesSeen += mesh->mNumVertices;
-		m_Meshes.push_back(indexedMesh);
-		meshes.addIndexedMesh(m_Meshes.back(), PHY_SHORT);
+		for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+		{
+			collisionMesh->vertices.push_back({ mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z });
+		}
+		submeshes.push_back(submesh);
+	}
+
+	for (auto& submesh : submeshes)
+	{
+		AddSubmesh(collisionMesh->triangleMesh, collisionMesh->vertices.data(), collisionMesh->indices.data(), submesh);
+	}
+	collisionMesh->shape.reset(new btBvhTriangleMeshShape(&collisionMesh->triangleMesh, true));
+	return collisionMesh;
+}
+
+void CollisionModelResourceFile::cook(CollisionMesh& mesh, uint64_t sourceHash) const
+{
+	ZoneScoped;
+	btOptimizedBvh* bvh = mesh.shape->getOptimizedBvh();
+	if (!bvh)
+	{
+		return;
+	}
+
+	const int submeshCount = mesh.triangleMesh.getNumSubParts();
+
+	CookedCollisionHeader header;
+	header.magic = COOKED_COLLISION_MAGIC;
+	header.version = COOKED_COLLISION_VERSION;
+	header.sourceHash = sourceHash;
+	header.submeshCount = submeshCount;
+	header.vertexCount = mesh.vertices.size();
+	header.indexCount = mesh.indices.size();
+	header.submeshOffset = AlignCooked(sizeof(CookedCollisionHeader));
+	header.vertexOffset = AlignCooked(header.submeshOffset + sizeof(CookedSubmesh) * submeshCount);
+	header.indexOffset = AlignCooked(header.vertexOffset + sizeof(Vector3) * header.vertexCount);
+	header.bvhOffset = AlignCooked(header.indexOffset + sizeof(unsigned int) * header.indexCount);
+	header.bvhSize = bvh->calculateSerializeBufferSize();
+
+	Vector<char> buffer(header.bvhOffset + header.bvhSize, 0);
+	memcpy(buffer.data(), &header, sizeof(header));
+
+	const IndexedMeshArray& indexedMeshes = mesh.triangleMesh.getIndexedMeshArray();
+	CookedSubmesh* submeshes = (CookedSubmesh*)(buffer.data() + header.submeshOffset);
+	for (int i = 0; i < submeshCount; i++)
+	{
+		submeshes[i].firstVertex = (const Vector3*)indexedMeshes[i].m_vertexBase - mesh.vertices.data();
+		submeshes[i].vertexCount = indexedMeshes[i].m_numVertices;
+		submeshes[i].firstIndex = (const unsigned int*)indexedMeshes[i].m_triangleIndexBase - mesh.indices.data();
+		submeshes[i].triangleCount = indexedMeshes[i].m_numTriangles;
+	}
+	memcpy(buffer.data() + header.vertexOffset, mesh.vertices.data(), sizeof(Vector3) * header.vertexCount);
+	memcpy(buffer.data() + header.indexOffset, mesh.indices.data(), sizeof(unsigned int) * header.indexCount);
+
+	void* bvhBuffer = btAlignedAlloc(header.bvhSize, COOKED_COLLISION_ALIGNMENT);
+	bool isSerialized = bvh->serializeInPlace(bvhBuffer, header.bvhSize, false);
+	memcpy(buffer.data() + header.bvhOffset, bvhBuffer, header.bvhSize);
+	btAlignedFree(bvhBuffer);
+
+	if (!isSerialized)
+	{
+		WARN("Could not serialize collision BVH: " + getPath().generic_string());
+		return;
 	}
 
-	m_TriangleMesh = meshes;
+	if (!OS::IsExists(COLLISION_MODEL_COOKED_DIRECTORY))
+	{
+		OS::CreateDirectoryName(COLLISION_MODEL_COOKED_DIRECTORY);
+	}
+	if (!OS::SaveFile(getCookedPath(), buffer.data(), buffer.size()))
+	{
+		WARN("Could not save cooked collision model: " + getCookedPath());
+	}
+}
+
+Ref<btBvhTriangleMeshShape> CollisionModelResourceFile::getCollisionShape() const
+{
+	if (!m_Mesh)
+	{
+		return nullptr;
+	}
+	// Aliases the mesh so the triangle data outlives every collider using the shape
+	return Ref<btBvhTriangleMeshShape>(m_Mesh, m_Mesh->shape.get());
 }
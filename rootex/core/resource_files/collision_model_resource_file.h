@@ -2,20 +2,36 @@
 
 #include "renderer/mesh.h"
 #include "resource_file.h"
+#include "os/mapped_file.h"
 
 #include "btBulletCollisionCommon.h"
 
+#define COLLISION_MODEL_COOKED_DIRECTORY "cache/collision/"
+
 class Material;
 
 /// Representation of a 3D model file used to initialise a mesh collider.
+/// The triangle mesh and its BVH are cooked to COLLISION_MODEL_COOKED_DIRECTORY on first import and memory mapped on later loads.
 class CollisionModelResourceFile : public ResourceFile
 {
+	/// Triangle data and the BVH shape built over it. Stays alive as long as any collider holds the shape.
+	struct CollisionMesh
+	{
+		Ptr<MappedFile> cookedFile;
+		Vector<Vector3> vertices;
+		Vector<unsigned int> indices;
+		btTriangleIndexVertexArray triangleMesh;
+		Ptr<btBvhTriangleMeshShape> shape;
+	};
+
 	explicit CollisionModelResourceFile(const FilePath& path);
 
-	btTriangleIndexVertexArray m_TriangleMesh;
-	Vector<btIndexedMesh> m_Meshes;
-	Vector<Vector3> m_Vertices;
-	Vector<short> m_Indices;
+	Ref<CollisionMesh> m_Mesh;
+
+	String getCookedPath() const;
+	Ref<CollisionMesh> loadCooked(uint64_t sourceHash) const;
+	Ref<CollisionMesh> importModel() const;
+	void cook(CollisionMesh& mesh, uint64_t sourceHash) const;
 
 	friend class ResourceLoader;
 
@@ -26,5 +42,7 @@ public:
 
 	void reimport() override;
 
-	btTriangleIndexVertexArray* getCollisionMesh() { return &m_TriangleMesh; }
+	btTriangleIndexVertexArray* getCollisionMesh() { return m_Mesh ? &m_Mesh->triangleMesh : nullptr; }
+	/// BVH shape shared by every collider using this model. Keeps the mesh data alive after a reimport.
+	Ref<btBvhTriangleMeshShape> getCollisionShape() const;
 };
@@ -1,5 +1,9 @@
 #include "image_resource_file.h"
 
+#include "renderer/texture_cooker.h"
+#include "renderer/texture_streamer.h"
+#include "os/mapped_file.h"
+
 ImageResourceFile::ImageResourceFile(const FilePath& path)
     : ResourceFile(Type::Image, path)
 {
@@ -11,5 +15,16 @@ void ImageResourceFile::reimport()
 	ResourceFile::reimport();
 
 	const FileBuffer& fileBuffer = OS::LoadFileContents(m_Path.generic_string());
+
+	const String cookedPath = TextureCooker::GetCookedPath(m_Path.generic_string());
+	Ptr<MappedFile> cookedFile = MappedFile::Open(cookedPath);
+	uint64_t cookedHash = 0;
+	TextureCooker::Settings cookedSettings;
+	if (cookedFile && TextureCooker::ReadCookedInfo(cookedFile->getData(), cookedFile->getSize(), cookedHash, cookedSettings) && cookedHash == TextureCooker::HashContents(fileBuffer.data(), fileBuffer.size()))
+	{
+		m_ImageTexture = TextureStreamer::GetSingleton()->createTexture(cookedPath, cookedFile->getData(), cookedFile->getSize());
+		return;
+	}
+
 	m_ImageTexture.reset(new Texture(fileBuffer.data(), fileBuffer.size()));
 }
@@ -3,7 +3,8 @@
 #include "resource_file.h"
 #include "renderer/texture.h"
 
-/// Representation of an image file. Supports BMP, JPEG, PNG, TIFF, GIF, HD Photo, or other WIC supported file containers
+/// Representation of an image file. Supports BMP, JPEG, PNG, TIFF, GIF, HD Photo, or other WIC supported file containers.
+/// Loads the texture cooked by the texture cooker instead, with mips and block compression, if it was cooked from the current file contents.
 class ImageResourceFile : public ResourceFile
 {
 	Ref<Texture> m_ImageTexture;
@@ -6,12 +6,97 @@
 #include "renderer/mesh.h"
 #include "renderer/vertex_buffer.h"
 #include "renderer/index_buffer.h"
+#include "renderer/geometry_heap.h"
+#include "os/mapped_file.h"
 
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 
 #include "meshoptimizer.h"
+#include "Tracy/Tracy.hpp"
+
+#define COOKED_MODEL_MAGIC 0x4c444d58 // "XMDL"
+#define COOKED_MODEL_VERSION 2
+
+/// Layout of a cooked model. Each mesh follows as a CookedMesh, its material path, its encoded vertices and indices, then its LODs.
+struct CookedModelHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+	uint32_t meshCount;
+};
+
+struct CookedMesh
+{
+	uint32_t materialPathSize;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t encodedVertexSize;
+	uint32_t encodedIndexSize;
+	uint32_t lodCount;
+	Vector3 center;
+	Vector3 extents;
+};
+
+/// Followed by the encoded LOD indices
+struct CookedLOD
+{
+	uint32_t indexCount;
+	uint32_t encodedIndexSize;
+	float error;
+};
+
+/// Reads the cooked sections in order, failing once anything would read past the end
+class CookedReader
+{
+	const char* m_Data;
+	size_t m_Size;
+	size_t m_Offset = 0;
+
+public:
+	CookedReader(const char* data, size_t size)
+	    : m_Data(data)
+	    , m_Size(size)
+	{
+	}
+
+	const char* readBytes(size_t size)
+	{
+		if (size > m_Size - m_Offset)
+		{
+			return nullptr;
+		}
+		const char* section = m_Data + m_Offset;
+		m_Offset += size;
+		return section;
+	}
+
+	template <class T>
+	bool read(T& value)
+	{
+		const char* section = readBytes(sizeof(T));
+		if (!section)
+		{
+			return false;
+		}
+		memcpy(&value, section, sizeof(T));
+		return true;
+	}
+};
+
+static void WriteCooked(Vector<char>& buffer, const void* data, size_t size)
+{
+	buffer.insert(buffer.end(), (const char*)data, (const char*)data + size);
+}
+
+static Vector<unsigned char> EncodeIndices(const Vector<unsigned int>& indices, size_t vertexCount)
+{
+	Vector<unsigned char> encoded(meshopt_encodeIndexBufferBound(indices.size(), vertexCount));
+	encoded.resize(meshopt_encodeIndexBuffer(encoded.data(), encoded.size(), indices.data(), indices.size()));
+	return encoded;
+}
 
 ModelResourceFile::ModelResourceFile(const FilePath& path)
     : ResourceFile(Type::Model, path)
@@ -19,10 +104,117 @@ ModelResourceFile::ModelResourceFile(const FilePath& path)
 	reimport();
 }
 
+String ModelResourceFile::getCookedPath() const
+{
+	std::stringstream name;
+	name << std::hex << std::hash<String>()(getPath().generic_string());
+	return MODEL_COOKED_DIRECTORY + name.str() + ".mesh";
+}
+
 void ModelResourceFile::reimport()
 {
+	ZoneScoped;
 	ResourceFile::reimport();
 
+	m_Meshes.clear();
+	const uint64_t sourceHash = HashContents(OS::LoadFileContents(getPath().generic_string()));
+	if (loadCooked(sourceHash))
+	{
+		return;
+	}
+
+	Vector<ImportedMesh> importedMeshes;
+	if (importModel(importedMeshes))
+	{
+		cook(importedMeshes, sourceHash);
+	}
+}
+
+bool ModelResourceFile::loadCooked(uint64_t sourceHash)
+{
+	ZoneScoped;
+	Ptr<MappedFile> cookedFile = MappedFile::Open(getCookedPath());
+	if (!cookedFile)
+	{
+		return false;
+	}
+
+	CookedReader reader(cookedFile->getData(), cookedFile->getSize());
+	CookedModelHeader header;
+	if (!reader.read(header) || header.magic != COOKED_MODEL_MAGIC || header.version != COOKED_MODEL_VERSION || header.sourceHash != sourceHash)
+	{
+		return false;
+	}
+
+	Vector<ImportedMesh> importedMeshes(header.meshCount);
+	for (auto& importedMesh : importedMeshes)
+	{
+		CookedMesh cookedMesh;
+		if (!reader.read(cookedMesh))
+		{
+			return false;
+		}
+		const char* materialPath = reader.readBytes(cookedMesh.materialPathSize);
+		const char* encodedVertices = reader.readBytes(cookedMesh.encodedVertexSize);
+		const char* encodedIndices = reader.readBytes(cookedMesh.encodedIndexSize);
+		if (!materialPath || !encodedVertices || !encodedIndices)
+		{
+			return false;
+		}
+
+		importedMesh.materialPath.assign(materialPath, cookedMesh.materialPathSize);
+		// Materials are created while importing, so a missing one needs the model imported again
+		if (!OS::IsExists(importedMesh.materialPath))
+		{
+			return false;
+		}
+
+		importedMesh.vertices.resize(cookedMesh.vertexCount);
+		importedMesh.indices.resize(cookedMesh.indexCount);
+		if (meshopt_decodeVertexBuffer(importedMesh.vertices.data(), cookedMesh.vertexCount, sizeof(VertexData), (const unsigned char*)encodedVertices, cookedMesh.encodedVertexSize) != 0
+		    || meshopt_decodeIndexBuffer(importedMesh.indices.data(), cookedMesh.indexCount, sizeof(unsigned int), (const unsigned char*)encodedIndices, cookedMesh.encodedIndexSize) != 0)
+		{
+			WARN("Cooked model is corrupt, reimporting: " + getPath().generic_string());
+			return false;
+		}
+		importedMesh.boundingBox.Center = cookedMesh.center;
+		importedMesh.boundingBox.Extents = cookedMesh.extents;
+
+		for (uint32_t i = 0; i < cookedMesh.lodCount; i++)
+		{
+			CookedLOD cookedLOD;
+			if (!reader.read(cookedLOD))
+			{
+				return false;
+			}
+			const char* encodedLOD = reader.readBytes(cookedLOD.encodedIndexSize);
+			if (!encodedLOD)
+			{
+				return false;
+			}
+
+			auto& [lod, error] = importedMesh.lods.emplace_back();
+			lod.resize(cookedLOD.indexCount);
+			error = cookedLOD.error;
+			if (meshopt_decodeIndexBuffer(lod.data(), cookedLOD.indexCount, sizeof(unsigned int), (const unsigned char*)encodedLOD, cookedLOD.encodedIndexSize) != 0)
+			{
+				WARN("Cooked model is corrupt, reimporting: " + getPath().generic_string());
+				return false;
+			}
+		}
+	}
+
+	for (auto& importedMesh : importedMeshes)
+	{
+		addDependency(importedMesh.materialPath);
+		addMesh(std::dynamic_pointer_cast<BasicMaterial>(MaterialLibrary::GetMaterial(importedMesh.materialPath)), importedMesh);
+	}
+	return true;
+}
+
+bool ModelResourceFile::importModel(Vector<ImportedMesh>& importedMeshes)
+{
+	ZoneScoped;
 	Assimp::Importer modelLoader;
 	const aiScene* scene = modelLoader.ReadFile(
 	    getPath().generic_string(),
@@ -32,17 +224,16 @@ void ModelResourceFile::reimport()
 	{
 		ERR("Model could not be loaded: " + getPath().generic_string());
 		ERR("Assimp: " + modelLoader.GetErrorString());
-		return;
+		return false;
 	}
 
-	m_Meshes.clear();
 	for (int i = 0; i < scene->mNumMeshes; i++)
 	{
 		const aiMesh* mesh = scene->mMeshes[i];
 
-		Vector<VertexData> vertices;
+		ImportedMesh importedMesh;
+		Vector<VertexData>& vertices = importedMesh.vertices;
 		vertices.reserve(mesh->mNumVertices);
-
 		VertexData vertex;
 		ZeroMemory(&vertex, sizeof(VertexData));
 		for (unsigned int v = 0; v < mesh->mNumVertices; v++)
@@ -78,8 +269,8 @@ void ModelResourceFile::reimport()
 			vertices.push_back(vertex);
 		}
 
-		Vector<unsigned int> indices;
-		indices.reserve(mesh->mNumFaces);
+		Vector<unsigned int>& indices = importedMesh.indices;
+		indices.reserve(mesh->mNumFaces * 3);
 
 		aiFace* face = nullptr;
 		for (unsigned int f = 0; f < mesh->mNumFaces; f++)
@@ -91,31 +282,19 @@ void ModelResourceFile::reimport()
 			indices.push_back(face->mIndices[2]);
 		}
 
-		meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
-
-		Vector<Vector<unsigned int>> lods;
-		float lodLevels[MAX_LOD_COUNT - 1] = { 0.8f, 0.50f, 0.3f, 0.10f };
-
-		for (int i = 0; i < MAX_LOD_COUNT - 1; i++)
+		if (indices.empty())
 		{
-			float threshold = lodLevels[i];
-			size_t targetIndexCount = indices.size() * threshold;
-
-			Vector<unsigned int> lod(indices.size());
-			float lodError = 0.0f;
-			size_t finalLODIndexCount = meshopt_simplifySloppy(
-			    &lod[0],
-			    indices.data(),
-			    indices.size(),
-			    &vertices[0].m_Position.x,
-			    vertices.size(),
-			    sizeof(VertexData),
-			    targetIndexCount);
-			lod.resize(finalLODIndexCount);
-
-			lods.push_back(lod);
+			WARN("Skipped mesh without triangles: " + String(mesh->mName.C_Str()));
+			continue;
 		}
 
+		meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+		// Reorder triangles to draw outer ones first as long as that costs at most 5% more vertex cache misses
+		meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), &vertices[0].m_Position.x, vertices.size(), sizeof(VertexData), 1.05f);
+		vertices.resize(meshopt_optimizeVertexFetch(vertices.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(VertexData)));
+
+		importedMesh.lods = Mesh::SimplifyLODs(indices, &vertices[0].m_Position.x, vertices.size(), sizeof(VertexData));
+
 		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 
 		aiColor3D color(0.0f, 0.0f, 0.0f);
@@ -254,39 +433,102 @@ void ModelResourceFile::reimport()
 			}
 		}
 
-		Mesh extractedMesh;
-		extractedMesh.m_VertexBuffer.reset(new VertexBuffer(vertices));
-		extractedMesh.addLOD(std::make_shared<IndexBuffer>(indices), 1.0f);
-		for (int i = 0; i < MAX_LOD_COUNT - 1; i++)
-		{
-			if (!lods[i].empty())
-			{
-				extractedMesh.addLOD(std::make_shared<IndexBuffer>(lods[i]), lodLevels[i]);
-			}
-		}
+
+		importedMesh.materialPath = materialPath;
+		addDependency(materialPath);
+
 		Vector3 max = { mesh->mAABB.mMax.x, mesh->mAABB.mMax.y, mesh->mAABB.mMax.z };
 		Vector3 min = { mesh->mAABB.mMin.x, mesh->mAABB.mMin.y, mesh->mAABB.mMin.z };
 		Vector3 center = (max + min) / 2.0f;
-		extractedMesh.m_BoundingBox.Center = center;
-		extractedMesh.m_BoundingBox.Extents = (max - min) / 2.0f;
-		extractedMesh.m_BoundingBox.Extents.x = abs(extractedMesh.m_BoundingBox.Extents.x);
-		extractedMesh.m_BoundingBox.Extents.y = abs(extractedMesh.m_BoundingBox.Extents.y);
-		extractedMesh.m_BoundingBox.Extents.z = abs(extractedMesh.m_BoundingBox.Extents.z);
-
-		bool found = false;
-		for (auto& materialModels : getMeshes())
+		importedMesh.boundingBox.Center = center;
+		importedMesh.boundingBox.Extents = (max - min) / 2.0f;
+		importedMesh.boundingBox.Extents.x = abs(importedMesh.boundingBox.Extents.x);
+		importedMesh.boundingBox.Extents.y = abs(importedMesh.boundingBox.Extents.y);
+		importedMesh.boundingBox.Extents.z = abs(importedMesh.boundingBox.Extents.z);
+
+		addMesh(extractedMaterial, importedMesh);
+		importedMeshes.push_back(std::move(importedMesh));
+	}
+	return true;
+}
+
+void ModelResourceFile::cook(const Vector<ImportedMesh>& importedMeshes, uint64_t sourceHash) const
+{
+	ZoneScoped;
+	CookedModelHeader header;
+	header.magic = COOKED_MODEL_MAGIC;
+	header.version = COOKED_MODEL_VERSION;
+	header.sourceHash = sourceHash;
+	header.meshCount = importedMeshes.size();
+
+	Vector<char> buffer;
+	WriteCooked(buffer, &header, sizeof(header));
+	for (auto& importedMesh : importedMeshes)
+	{
+		Vector<unsigned char> encodedVertices(meshopt_encodeVertexBufferBound(importedMesh.vertices.size(), sizeof(VertexData)));
+		encodedVertices.resize(meshopt_encodeVertexBuffer(encodedVertices.data(), encodedVertices.size(), importedMesh.vertices.data(), importedMesh.vertices.size(), sizeof(VertexData)));
+		const Vector<unsigned char> encodedIndices = EncodeIndices(importedMesh.indices, importedMesh.vertices.size());
+
+		CookedMesh cookedMesh;
+		cookedMesh.materialPathSize = importedMesh.materialPath.size();
+		cookedMesh.vertexCount = importedMesh.vertices.size();
+		cookedMesh.indexCount = importedMesh.indices.size();
+		cookedMesh.encodedVertexSize = encodedVertices.size();
+		cookedMesh.encodedIndexSize = encodedIndices.size();
+		cookedMesh.lodCount = importedMesh.lods.size();
+		cookedMesh.center = importedMesh.boundingBox.Center;
+		cookedMesh.extents = importedMesh.boundingBox.Extents;
+		WriteCooked(buffer, &cookedMesh, sizeof(cookedMesh));
+		WriteCooked(buffer, importedMesh.materialPath.data(), importedMesh.materialPath.size());
+		WriteCooked(buffer, encodedVertices.data(), encodedVertices.size());
+		WriteCooked(buffer, encodedIndices.data(), encodedIndices.size());
+
+		for (auto& [lod, error] : importedMesh.lods)
 		{
-			if (materialModels.first == extractedMaterial)
-			{
-				found = true;
-				materialModels.second.push_back(extractedMesh);
-				break;
-			}
+			const Vector<unsigned char> encodedLOD = EncodeIndices(lod, importedMesh.vertices.size());
+
+			CookedLOD cookedLOD;
+			cookedLOD.indexCount = lod.size();
+			cookedLOD.encodedIndexSize = encodedLOD.size();
+			cookedLOD.error = error;
+			WriteCooked(buffer, &cookedLOD, sizeof(cookedLOD));
+			WriteCooked(buffer, encodedLOD.data(), encodedLOD.size());
 		}
+	}
 
-		if (!found && extractedMaterial)
+	if (!OS::IsExists(MODEL_COOKED_DIRECTORY))
+	{
+		OS::CreateDirectoryName(MODEL_COOKED_DIRECTORY);
+	}
+	if (!OS::SaveFile(getCookedPath(), buffer.data(), buffer.size()))
+	{
+		WARN("Could not save cooked model: " + getCookedPath());
+	}
+}
+
+void ModelResourceFile::addMesh(Ref<Material> material, const ImportedMesh& importedMesh)
+{
+	if (!material || importedMesh.indices.empty())
+	{
+		return;
+	}
+
+	Mesh extractedMesh;
+	extractedMesh.m_VertexBuffer = GeometryHeap::GetSingleton()->createVertexBuffer(importedMesh.vertices);
+	extractedMesh.addLOD(GeometryHeap::GetSingleton()->createIndexBuffer(importedMesh.indices), 0.0f);
+	for (auto& [lod, error] : importedMesh.lods)
+	{
+		extractedMesh.addLOD(GeometryHeap::GetSingleton()->createIndexBuffer(lod), error);
+	}
+	extractedMesh.m_BoundingBox = importedMesh.boundingBox;
+
+	for (auto& materialModels : getMeshes())
+	{
+		if (materialModels.first == material)
 		{
-			getMeshes().push_back(Pair<Ref<Material>, Vector<Mesh>>(extractedMaterial, { extractedMesh }));
+			materialModels.second.push_back(extractedMesh);
+			return;
 		}
 	}
+	getMeshes().push_back(Pair<Ref<Material>, Vector<Mesh>>(material, { extractedMesh }));
 }
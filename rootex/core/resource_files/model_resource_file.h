@@ -1,18 +1,40 @@
 #pragma once
 
 #include "resource_file.h"
+#include "renderer/vertex_data.h"
+
+#define MODEL_COOKED_DIRECTORY "cache/models/"
 
 class Material;
 class ResourceFile;
 class Mesh;
 
 /// Representation of a 3D model file.
+/// Optimized mesh geometry is cooked to MODEL_COOKED_DIRECTORY, compressed with the meshoptimizer codecs, and loaded from there
+/// without importing the model again as long as the source file and the materials it refers to are unchanged.
 class ModelResourceFile : public ResourceFile
 {
+	/// Geometry of one mesh after import and optimization, as stored in the cooked model
+	struct ImportedMesh
+	{
+		String materialPath;
+		Vector<VertexData> vertices;
+		Vector<unsigned int> indices;
+		/// Simplified index lists with their error in model space units
+		Vector<Pair<Vector<unsigned int>, float>> lods;
+		BoundingBox boundingBox;
+	};
+
 	explicit ModelResourceFile(const FilePath& path);
 
 	Vector<Pair<Ref<Material>, Vector<Mesh>>> m_Meshes;
 
+	String getCookedPath() const;
+	bool loadCooked(uint64_t sourceHash);
+	bool importModel(Vector<ImportedMesh>& importedMeshes);
+	void cook(const Vector<ImportedMesh>& importedMeshes, uint64_t sourceHash) const;
+	void addMesh(Ref<Material> material, const ImportedMesh& importedMesh);
+
 	friend class ResourceLoader;
 
 public:
@@ -2,6 +2,7 @@
 
 #include "app/application.h"
 #include "os/thread.h"
+#include "event_manager.h"
 
 bool IsFileSupported(const String& extension, ResourceFile::Type supportedFileType)
 {
@@ -85,12 +86,9 @@ int ResourceLoader::Preload(ResourceCollection paths, Atomic<int>& progress)
 		}));
 	}
 
-	/// TODO: Fix the need for this dummy task (blocks the main thread if no resources are preloaded)
-	tasks.push_back(std::make_shared<Task>([]() {}));
-
 	Application::GetSingleton()->getThreadPool().submit(tasks);
 
-	return tasks.size() - 1; // One less for the dummy task
+	return tasks.size();
 }
 
 void ResourceLoader::Persist(Ref<ResourceFile> res)
@@ -184,3 +182,133 @@ Ref<ParticleEffectResourceFile> ResourceLoader::CreateParticleEffectResourceFile
 {
 	return GetCachedResource<ParticleEffectResourceFile>(ResourceFile::Type::ParticleEffect, FilePath(path));
 }
+
+bool ResourceLoader::StartWatching(const Vector<String>& directories)
+{
+	StopWatching();
+
+	s_FileWatcher = FileWatcher::Create();
+	if (!s_FileWatcher || !s_FileWatcher->start(directories))
+	{
+		WARN("Could not start watching files for hot reload");
+		s_FileWatcher.reset();
+		return false;
+	}
+
+	for (auto& directory : directories)
+	{
+		String root = FilePath(directory).generic_string();
+		while (!root.empty() && root.back() == '/')
+		{
+			root.pop_back();
+		}
+		s_WatchedDirectories.push_back(root);
+	}
+	PRINT("Hot reload is watching " + std::to_string(directories.size()) + " directories");
+	return true;
+}
+
+void ResourceLoader::StopWatching()
+{
+	if (s_FileWatcher)
+	{
+		s_FileWatcher->stop();
+		s_FileWatcher.reset();
+	}
+	s_WatchedDirectories.clear();
+}
+
+bool ResourceLoader::IsWatched(const FilePath& path)
+{
+	if (!s_FileWatcher)
+	{
+		return false;
+	}
+
+	const String filePath = path.generic_string();
+	for (auto& root : s_WatchedDirectories)
+	{
+		if (filePath.size() > root.size() && filePath.compare(0, root.size(), root) == 0 && filePath[root.size()] == '/')
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void ResourceLoader::AddDependency(const String& dependencyPath, Ref<ResourceFile> dependent)
+{
+	s_ResourceDataMutex.lock();
+	Vector<Weak<ResourceFile>>& dependents = s_Dependents[FilePath(dependencyPath).generic_string()];
+	auto findIt = std::find_if(dependents.begin(), dependents.end(), [&dependent](const Weak<ResourceFile>& item) { return item.lock() == dependent; });
+	if (findIt == dependents.end())
+	{
+		dependents.push_back(dependent);
+	}
+	s_ResourceDataMutex.unlock();
+}
+
+void ResourceLoader::AddDependencies(Ref<ResourceFile> dependent)
+{
+	for (auto& dependencyPath : dependent->getDependencies())
+	{
+		AddDependency(dependencyPath, dependent);
+	}
+}
+
+void ResourceLoader::ReloadChangedResources()
+{
+	if (!s_FileWatcher)
+	{
+		return;
+	}
+
+	Vector<String> changes = s_FileWatcher->takeChanges();
+	if (changes.empty())
+	{
+		return;
+	}
+
+	Vector<Ref<ResourceFile>> toReimport;
+	s_ResourceDataMutex.lock();
+	for (auto& path : changes)
+	{
+		auto findIt = s_Dependents.find(path);
+		if (findIt == s_Dependents.end())
+		{
+			continue;
+		}
+
+		Vector<Weak<ResourceFile>>& dependents = findIt->second;
+		for (int i = 0; i < dependents.size(); i++)
+		{
+			Ref<ResourceFile> dependent = dependents[i].lock();
+			if (!dependent)
+			{
+				dependents.erase(dependents.begin() + i);
+				i--;
+				continue;
+			}
+			if (std::find(toReimport.begin(), toReimport.end(), dependent) == toReimport.end())
+			{
+				dependent->m_IsDirty = true;
+				toReimport.push_back(dependent);
+			}
+		}
+
+		if (dependents.empty())
+		{
+			s_Dependents.erase(findIt);
+		}
+	}
+	s_ResourceDataMutex.unlock();
+
+	for (auto& resource : toReimport)
+	{
+		PRINT("Hot reloading: " + resource->getPath().generic_string());
+		resource->reimport();
+		AddDependencies(resource);
+	}
+
+	EventManager::GetSingleton()->call(RootexEvents::FilesChanged, changes);
+}
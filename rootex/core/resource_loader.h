@@ -3,6 +3,7 @@
 #include "common/common.h"
 
 #include "resource_file.h"
+#include "os/file_watcher.h"
 
 #include "resource_files/audio_resource_file.h"
 #include "resource_files/font_resource_file.h"
@@ -40,12 +41,22 @@ class ResourceLoader
 {
 	static inline HashMap<ResourceFile::Type, Vector<Weak<ResourceFile>>> s_ResourcesDataFiles;
 	static inline Vector<Ref<ResourceFile>> s_PersistentResources;
+	/// Files being imported right now. Other threads asking for them wait for the first import instead of importing again.
+	static inline HashMap<ResourceFile::Type, HashMap<String, SharedFuture<Ref<ResourceFile>>>> s_LoadingFiles;
+
+	/// Reverse dependency index from a file path to the loaded resources that need reimporting when that file changes.
+	static inline HashMap<String, Vector<Weak<ResourceFile>>> s_Dependents;
+	static inline Ptr<FileWatcher> s_FileWatcher;
+	/// Roots the file watcher reports changes under, without trailing slashes
+	static inline Vector<String> s_WatchedDirectories;
 
 	static inline RecursiveMutex s_PersistMutex;
 	static inline RecursiveMutex s_ResourceDataMutex;
 
 	template <class T>
 	static Ref<T> GetCachedResource(ResourceFile::Type type, const FilePath& path);
+	/// Index the files a resource read while importing, after it is loaded or reimported
+	static void AddDependencies(Ref<ResourceFile> dependent);
 
 public:
 	static const HashMap<ResourceFile::Type, Vector<Weak<ResourceFile>>>& GetResources();
@@ -71,6 +82,17 @@ public:
 	/// Add a resource to be kept alive till explicitly ordered to clear them. Internally synchronised.
 	static void Persist(Ref<ResourceFile> res);
 	static void ClearPersistentResources();
+
+	/// Watch directories in the background and hot reload resources whose files change.
+	static bool StartWatching(const Vector<String>& directories);
+	static void StopWatching();
+	static bool IsWatching() { return (bool)s_FileWatcher; }
+	/// If changes to a file are reported by the file watcher, so its dirtiness does not need to be polled from disk.
+	static bool IsWatched(const FilePath& path);
+	/// Register a resource to be reimported when another file changes. Internally synchronised.
+	static void AddDependency(const String& dependencyPath, Ref<ResourceFile> dependent);
+	/// Reimport only the resources affected by the batch of file changes seen since the last call. Call at a frame boundary.
+	static void ReloadChangedResources();
 };
 
 template <class T>
@@ -78,37 +100,53 @@ inline Ref<T> ResourceLoader::GetCachedResource(ResourceFile::Type type, const F
 {
 	s_ResourceDataMutex.lock();
 	String searchPath = path.generic_string();
-	Ref<T> ret;
 	for (auto& item : s_ResourcesDataFiles[type])
 	{
-		if (item.lock())
+		Ref<ResourceFile> itemRes = item.lock();
+		if (itemRes && itemRes->getPath() == searchPath)
 		{
-			Ref<ResourceFile> itemRes = item.lock();
-			if (itemRes && itemRes->getPath() == searchPath)
-			{
-				ret = std::dynamic_pointer_cast<T>(itemRes);
-				break;
-			}
+			s_ResourceDataMutex.unlock();
+			return std::dynamic_pointer_cast<T>(itemRes);
 		}
 	}
-	s_ResourceDataMutex.unlock();
 
-	if (ret)
+	auto& loading = s_LoadingFiles[type];
+	auto findIt = loading.find(searchPath);
+	if (findIt != loading.end())
 	{
-		return ret;
+		SharedFuture<Ref<ResourceFile>> loaded = findIt->second;
+		s_ResourceDataMutex.unlock();
+		return std::dynamic_pointer_cast<T>(loaded.get());
 	}
 
-	// File not found in cache, load it
-	if (!OS::IsExists(searchPath))
+	// File not found in cache, load it while holding a place for it
+	Promise<Ref<ResourceFile>> loadedPromise;
+	loading[searchPath] = loadedPromise.get_future().share();
+	s_ResourceDataMutex.unlock();
+
+	Ref<T> file;
+	if (OS::IsExists(searchPath))
+	{
+		file.reset(new T(searchPath));
+	}
+	else
 	{
 		ERR("File not found: " + searchPath);
-		return nullptr;
 	}
-	Ref<T> file(new T(searchPath));
 
 	s_ResourceDataMutex.lock();
-	s_ResourcesDataFiles[file->getType()].push_back(file);
+	if (file)
+	{
+		s_ResourcesDataFiles[file->getType()].push_back(file);
+	}
+	s_LoadingFiles[type].erase(searchPath);
 	s_ResourceDataMutex.unlock();
+	loadedPromise.set_value(file);
 
+	if (file)
+	{
+		AddDependency(searchPath, file);
+		AddDependencies(file);
+	}
 	return file;
 }
@@ -3,10 +3,9 @@
 #include "core/resource_loader.h"
 #include "core/resource_files/image_resource_file.h"
 #include "renderer/rendering_device.h"
+#include "renderer/texture_streamer.h"
 #include "renderer/shaders/register_locations_vertex_shader.h"
 #include "renderer/vertex_data.h"
-#include "renderer/vertex_buffer.h"
-#include "renderer/index_buffer.h"
 
 unsigned int CustomRenderInterface::s_TextureCount = 1; // 0 is reserved for white texture
 
@@ -21,6 +20,7 @@ Variant CustomRenderInterface::windowResized(const Event* event)
 CustomRenderInterface::CustomRenderInterface(int width, int height)
     : m_Width(width)
     , m_Height(height)
+    , m_GeometryBuffer(*this)
 {
 	BIND_EVENT_MEMBER_FUNCTION(RootexEvents::WindowResized, CustomRenderInterface::windowResized);
 
@@ -34,44 +34,105 @@ CustomRenderInterface::CustomRenderInterface(int width, int height)
 	m_Textures[0] = ResourceLoader::CreateImageResourceFile("rootex/assets/white.png")->getTexture();
 }
 
-void CustomRenderInterface::RenderGeometry(Rml::Vertex* vertices, int numVertices, int* indices, int numIndices, Rml::TextureHandle texture, const Rml::Vector2f& translation)
+static Microsoft::WRL::ComPtr<ID3D11Buffer> CreateUIBuffer(UINT bindFlags, const void* data, unsigned int byteWidth, bool isDynamic)
 {
-	Vector<UIVertexData> vertexData;
-	vertexData.assign((UIVertexData*)vertices, (UIVertexData*)vertices + numVertices);
-	for (auto& vertex : vertexData)
-	{
-		vertex.m_Position.x += translation.x;
-		vertex.m_Position.y += translation.y;
-	}
-	VertexBuffer vb(vertexData);
-	Vector<unsigned int> indicesBuffer;
-	indicesBuffer.assign(indices, indices + numIndices);
-	IndexBuffer ib(indicesBuffer);
+	D3D11_BUFFER_DESC bd = { 0 };
+	bd.BindFlags = bindFlags;
+	bd.Usage = isDynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_IMMUTABLE;
+	bd.CPUAccessFlags = isDynamic ? D3D11_CPU_ACCESS_WRITE : 0;
+	bd.MiscFlags = 0u;
+	bd.ByteWidth = byteWidth;
+	bd.StructureByteStride = 0;
+	D3D11_SUBRESOURCE_DATA sd = { 0 };
+	sd.pSysMem = data;
+
+	return RenderingDevice::GetSingleton()->createBuffer(&bd, data ? &sd : nullptr);
+}
 
-	vb.bind();
-	ib.bind();
+static void WriteUIBuffer(ID3D11Buffer* buffer, unsigned int byteOffset, const void* data, unsigned int byteCount, bool isDiscard)
+{
+	D3D11_MAPPED_SUBRESOURCE subresource;
+	RenderingDevice::GetSingleton()->mapBuffer(buffer, subresource, isDiscard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE);
+	memcpy((char*)subresource.pData + byteOffset, data, byteCount);
+	RenderingDevice::GetSingleton()->unmapBuffer(buffer);
+}
+
+UIGeometryDevice::BufferID CustomRenderInterface::createVertexBuffer(const UIVertexData* vertices, unsigned int count, bool isDynamic)
+{
+	BufferID id = m_NextBufferID++;
+	m_Buffers[id] = CreateUIBuffer(D3D11_BIND_VERTEX_BUFFER, vertices, sizeof(UIVertexData) * count, isDynamic);
+	return id;
+}
+
+UIGeometryDevice::BufferID CustomRenderInterface::createIndexBuffer(const unsigned int* indices, unsigned int count, bool isDynamic)
+{
+	BufferID id = m_NextBufferID++;
+	m_Buffers[id] = CreateUIBuffer(D3D11_BIND_INDEX_BUFFER, indices, sizeof(unsigned int) * count, isDynamic);
+	return id;
+}
+
+void CustomRenderInterface::releaseBuffer(BufferID buffer)
+{
+	m_Buffers.erase(buffer);
+}
+
+void CustomRenderInterface::writeVertices(BufferID buffer, unsigned int offset, const UIVertexData* vertices, unsigned int count, bool isDiscard)
+{
+	WriteUIBuffer(m_Buffers.at(buffer).Get(), sizeof(UIVertexData) * offset, vertices, sizeof(UIVertexData) * count, isDiscard);
+}
+
+void CustomRenderInterface::writeIndices(BufferID buffer, unsigned int offset, const unsigned int* indices, unsigned int count, bool isDiscard)
+{
+	WriteUIBuffer(m_Buffers.at(buffer).Get(), sizeof(unsigned int) * offset, indices, sizeof(unsigned int) * count, isDiscard);
+}
+
+void CustomRenderInterface::drawIndexed(BufferID vertexBuffer, BufferID indexBuffer, unsigned int indexCount, unsigned int startIndex, int baseVertex, UITextureID texture, const Vector2& translation)
+{
+	static const unsigned int stride = sizeof(UIVertexData);
+	static const unsigned int offset = 0;
+	RenderingDevice::GetSingleton()->bind(m_Buffers.at(vertexBuffer).GetAddressOf(), 1, &stride, &offset);
+	RenderingDevice::GetSingleton()->bind(m_Buffers.at(indexBuffer).Get(), DXGI_FORMAT_R32_UINT);
 	m_UIShader->bind();
 
 	Material::SetVSConstantBuffer(
-	    VSSolidConstantBuffer(m_UITransform * Matrix::CreateOrthographic(m_Width, m_Height, 0.0f, 10000.0f)),
+	    VSSolidConstantBuffer(Matrix::CreateTranslation(translation.x, translation.y, 0.0f) * m_UITransform * Matrix::CreateOrthographic(m_Width, m_Height, 0.0f, 10000.0f)),
 	    m_ModelMatrixBuffer,
 	    PER_OBJECT_VS_CPP);
 
+	// UI is drawn at its texture resolution
+	TextureStreamer::GetSingleton()->request(m_Textures[texture].get(), (float)std::max(m_Textures[texture]->getWidth(), m_Textures[texture]->getHeight()));
 	RenderingDevice::GetSingleton()->setInPixelShader(0, 1, m_Textures[texture]->getTextureResourceView());
-	RenderingDevice::GetSingleton()->drawIndexed(ib.getCount());
+	RenderingDevice::GetSingleton()->drawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void CustomRenderInterface::beginFrame()
+{
+	m_GeometryBuffer.beginFrame();
+}
+
+void CustomRenderInterface::endFrame()
+{
+	m_GeometryBuffer.flush();
+}
+
+void CustomRenderInterface::RenderGeometry(Rml::Vertex* vertices, int numVertices, int* indices, int numIndices, Rml::TextureHandle texture, const Rml::Vector2f& translation)
+{
+	m_GeometryBuffer.render((const UIVertexData*)vertices, numVertices, indices, numIndices, texture, { translation.x, translation.y });
 }
 
 Rml::CompiledGeometryHandle CustomRenderInterface::CompileGeometry(Rml::Vertex* vertices, int numVertices, int* indices, int numIndices, Rml::TextureHandle texture)
 {
-	return (Rml::CompiledGeometryHandle) nullptr;
+	return (Rml::CompiledGeometryHandle)m_GeometryBuffer.compile((const UIVertexData*)vertices, numVertices, indices, numIndices, texture);
 }
 
 void CustomRenderInterface::RenderCompiledGeometry(Rml::CompiledGeometryHandle geometry, const Rml::Vector2f& translation)
 {
+	m_GeometryBuffer.renderCompiled((UIGeometryBuffer::CompiledID)geometry, { translation.x, translation.y });
 }
 
 void CustomRenderInterface::ReleaseCompiledGeometry(Rml::CompiledGeometryHandle geometry)
 {
+	m_GeometryBuffer.release((UIGeometryBuffer::CompiledID)geometry);
 }
 
 bool CustomRenderInterface::LoadTexture(Rml::TextureHandle& textureHandle, Rml::Vector2i& textureDimensions, const String& source)
@@ -106,6 +167,7 @@ void CustomRenderInterface::ReleaseTexture(Rml::TextureHandle texture)
 
 void CustomRenderInterface::EnableScissorRegion(bool enable)
 {
+	m_GeometryBuffer.flush();
 	if (enable)
 	{
 		RenderingDevice::GetSingleton()->setTemporaryUIScissoredRS();
@@ -118,11 +180,13 @@ void CustomRenderInterface::EnableScissorRegion(bool enable)
 
 void CustomRenderInterface::SetScissorRegion(int x, int y, int width, int height)
 {
+	m_GeometryBuffer.flush();
 	RenderingDevice::GetSingleton()->setScissorRectangle(x, y, width, height);
 }
 
 void CustomRenderInterface::SetTransform(const Rml::Matrix4f* transform)
 {
+	m_GeometryBuffer.flush();
 	if (!transform)
 	{
 		m_UITransform = Matrix::Identity;
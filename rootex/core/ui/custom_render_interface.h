@@ -2,12 +2,14 @@
 
 #include "core/renderer/material_library.h"
 #include "event_manager.h"
+#include "ui_geometry_buffer.h"
 
 #undef interface
 #include "RmlUi/Core.h"
 #define interface __STRUCT__
 
-class CustomRenderInterface : public Rml::RenderInterface
+/// Renders RmlUi geometry through RenderingDevice, which also backs the UI geometry buffers
+class CustomRenderInterface : public Rml::RenderInterface, public UIGeometryDevice
 {
 	static unsigned int s_TextureCount;
 
@@ -18,6 +20,10 @@ class CustomRenderInterface : public Rml::RenderInterface
 	int m_Width;
 	int m_Height;
 
+	HashMap<BufferID, Microsoft::WRL::ComPtr<ID3D11Buffer>> m_Buffers;
+	BufferID m_NextBufferID = 1;
+	UIGeometryBuffer m_GeometryBuffer;
+
 	Variant windowResized(const Event* event);
 
 public:
@@ -25,6 +31,20 @@ public:
 	CustomRenderInterface(const CustomRenderInterface&) = delete;
 	virtual ~CustomRenderInterface() = default;
 
+	/// Starts a new UI frame. Called before the context is rendered
+	void beginFrame();
+	/// Draws any geometry still batched. Called after the context is rendered
+	void endFrame();
+
+	const UIGeometryBuffer::Statistics& getStatistics() const { return m_GeometryBuffer.getStatistics(); }
+
+	virtual BufferID createVertexBuffer(const UIVertexData* vertices, unsigned int count, bool isDynamic) override;
+	virtual BufferID createIndexBuffer(const unsigned int* indices, unsigned int count, bool isDynamic) override;
+	virtual void releaseBuffer(BufferID buffer) override;
+	virtual void writeVertices(BufferID buffer, unsigned int offset, const UIVertexData* vertices, unsigned int count, bool isDiscard) override;
+	virtual void writeIndices(BufferID buffer, unsigned int offset, const unsigned int* indices, unsigned int count, bool isDiscard) override;
+	virtual void drawIndexed(BufferID vertexBuffer, BufferID indexBuffer, unsigned int indexCount, unsigned int startIndex, int baseVertex, UITextureID texture, const Vector2& translation) override;
+
 	virtual void RenderGeometry(Rml::Vertex* vertices, int numVertices, int* indices, int numIndices, Rml::TextureHandle texture, const Rml::Vector2f& translation) override;
 
 	virtual Rml::CompiledGeometryHandle CompileGeometry(Rml::Vertex* vertices, int numVertices, int* indices, int numIndices, Rml::TextureHandle texture) override;
@@ -0,0 +1,170 @@
+#include "ui_geometry_buffer.h"
+
+#include "Tracy/Tracy.hpp"
+
+UIGeometryBuffer::UIGeometryBuffer(UIGeometryDevice& device, unsigned int ringVertexCapacity, unsigned int ringIndexCapacity)
+    : m_Device(device)
+    , m_RingVertexCapacity(ringVertexCapacity)
+    , m_RingIndexCapacity(ringIndexCapacity)
+{
+	m_BatchVertices.reserve(ringVertexCapacity);
+	m_BatchIndices.reserve(ringIndexCapacity);
+}
+
+UIGeometryBuffer::~UIGeometryBuffer()
+{
+	for (auto& [id, geometry] : m_CompiledGeometries)
+	{
+		m_Device.releaseBuffer(geometry.vertexBuffer);
+		m_Device.releaseBuffer(geometry.indexBuffer);
+	}
+	if (m_RingVertexBuffer)
+	{
+		m_Device.releaseBuffer(m_RingVertexBuffer);
+		m_Device.releaseBuffer(m_RingIndexBuffer);
+	}
+}
+
+void UIGeometryBuffer::growRing(unsigned int vertexCount, unsigned int indexCount)
+{
+	if (m_RingVertexBuffer)
+	{
+		m_Device.releaseBuffer(m_RingVertexBuffer);
+		m_Device.releaseBuffer(m_RingIndexBuffer);
+	}
+	while (m_RingVertexCapacity < vertexCount)
+	{
+		m_RingVertexCapacity *= 2;
+	}
+	while (m_RingIndexCapacity < indexCount)
+	{
+		m_RingIndexCapacity *= 2;
+	}
+	m_RingVertexBuffer = m_Device.createVertexBuffer(nullptr, m_RingVertexCapacity, true);
+	m_RingIndexBuffer = m_Device.createIndexBuffer(nullptr, m_RingIndexCapacity, true);
+	m_RingVertexCursor = 0;
+	m_RingIndexCursor = 0;
+}
+
+void UIGeometryBuffer::render(const UIVertexData* vertices, unsigned int vertexCount, const int* indices, unsigned int indexCount, UITextureID texture, const Vector2& translation)
+{
+	if (vertexCount == 0 || indexCount == 0)
+	{
+		return;
+	}
+
+	if (!m_BatchIndices.empty())
+	{
+		bool isSameTexture = texture == m_BatchTexture;
+		bool isFitting = m_BatchVertices.size() + vertexCount <= m_RingVertexCapacity && m_BatchIndices.size() + indexCount <= m_RingIndexCapacity;
+		if (!isSameTexture || !isFitting)
+		{
+			flush();
+		}
+	}
+	m_BatchTexture = texture;
+
+	unsigned int baseVertex = m_BatchVertices.size();
+	m_BatchVertices.insert(m_BatchVertices.end(), vertices, vertices + vertexCount);
+	for (unsigned int i = baseVertex; i < m_BatchVertices.size(); i++)
+	{
+		m_BatchVertices[i].m_Position += translation;
+	}
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		m_BatchIndices.push_back(baseVertex + indices[i]);
+	}
+
+	m_Statistics.immediateGeometries++;
+}
+
+void UIGeometryBuffer::flush()
+{
+	if (m_BatchIndices.empty())
+	{
+		return;
+	}
+	ZoneScoped;
+
+	unsigned int vertexCount = m_BatchVertices.size();
+	unsigned int indexCount = m_BatchIndices.size();
+
+	bool isDiscard = false;
+	if (!m_RingVertexBuffer || vertexCount > m_RingVertexCapacity || indexCount > m_RingIndexCapacity)
+	{
+		growRing(vertexCount, indexCount);
+		isDiscard = true;
+	}
+	else if (m_RingVertexCursor + vertexCount > m_RingVertexCapacity || m_RingIndexCursor + indexCount > m_RingIndexCapacity)
+	{
+		m_RingVertexCursor = 0;
+		m_RingIndexCursor = 0;
+		isDiscard = true;
+		m_Statistics.ringWraps++;
+	}
+
+	m_Device.writeVertices(m_RingVertexBuffer, m_RingVertexCursor, m_BatchVertices.data(), vertexCount, isDiscard);
+	m_Device.writeIndices(m_RingIndexBuffer, m_RingIndexCursor, m_BatchIndices.data(), indexCount, isDiscard);
+	m_Device.drawIndexed(m_RingVertexBuffer, m_RingIndexBuffer, indexCount, m_RingIndexCursor, m_RingVertexCursor, m_BatchTexture, Vector2::Zero);
+	m_Statistics.drawCalls++;
+
+	m_RingVertexCursor += vertexCount;
+	m_RingIndexCursor += indexCount;
+
+	m_BatchVertices.clear();
+	m_BatchIndices.clear();
+}
+
+UIGeometryBuffer::CompiledID UIGeometryBuffer::compile(const UIVertexData* vertices, unsigned int vertexCount, const int* indices, unsigned int indexCount, UITextureID texture)
+{
+	if (vertexCount == 0 || indexCount == 0)
+	{
+		return 0;
+	}
+
+	Vector<unsigned int> indexData(indices, indices + indexCount);
+
+	CompiledGeometry geometry;
+	geometry.vertexBuffer = m_Device.createVertexBuffer(vertices, vertexCount, false);
+	geometry.indexBuffer = m_Device.createIndexBuffer(indexData.data(), indexCount, false);
+	geometry.indexCount = indexCount;
+	geometry.texture = texture;
+
+	CompiledID id = m_NextCompiledID++;
+	m_CompiledGeometries[id] = geometry;
+	return id;
+}
+
+void UIGeometryBuffer::renderCompiled(CompiledID geometry, const Vector2& translation)
+{
+	auto findIt = m_CompiledGeometries.find(geometry);
+	if (findIt == m_CompiledGeometries.end())
+	{
+		return;
+	}
+
+	flush();
+
+	const CompiledGeometry& compiled = findIt->second;
+	m_Device.drawIndexed(compiled.vertexBuffer, compiled.indexBuffer, compiled.indexCount, 0, 0, compiled.texture, translation);
+	m_Statistics.drawCalls++;
+	m_Statistics.compiledGeometries++;
+}
+
+void UIGeometryBuffer::release(CompiledID geometry)
+{
+	auto findIt = m_CompiledGeometries.find(geometry);
+	if (findIt == m_CompiledGeometries.end())
+	{
+		return;
+	}
+
+	m_Device.releaseBuffer(findIt->second.vertexBuffer);
+	m_Device.releaseBuffer(findIt->second.indexBuffer);
+	m_CompiledGeometries.erase(findIt);
+}
+
+void UIGeometryBuffer::beginFrame()
+{
+	m_Statistics = Statistics();
+}
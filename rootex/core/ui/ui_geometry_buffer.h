@@ -0,0 +1,97 @@
+#pragma once
+
+#include "common/common.h"
+#include "renderer/vertex_data.h"
+
+#define UI_RING_VERTEX_CAPACITY 16384
+#define UI_RING_INDEX_CAPACITY 32768
+
+typedef uintptr_t UITextureID;
+
+/// GPU operations needed to manage UI geometry.
+/// Implemented over RenderingDevice for rendering, can be replaced to exercise the buffer management without a GPU.
+class UIGeometryDevice
+{
+public:
+	typedef unsigned int BufferID;
+
+	virtual ~UIGeometryDevice() = default;
+
+	/// Create a vertex buffer. Static buffers are filled with data once, dynamic buffers are left to be written into.
+	virtual BufferID createVertexBuffer(const UIVertexData* vertices, unsigned int count, bool isDynamic) = 0;
+	virtual BufferID createIndexBuffer(const unsigned int* indices, unsigned int count, bool isDynamic) = 0;
+	virtual void releaseBuffer(BufferID buffer) = 0;
+
+	/// Write into a dynamic buffer at an element offset. Discarding orphans the previous contents,
+	/// else the written range should not be in use by the GPU.
+	virtual void writeVertices(BufferID buffer, unsigned int offset, const UIVertexData* vertices, unsigned int count, bool isDiscard) = 0;
+	virtual void writeIndices(BufferID buffer, unsigned int offset, const unsigned int* indices, unsigned int count, bool isDiscard) = 0;
+
+	virtual void drawIndexed(BufferID vertexBuffer, BufferID indexBuffer, unsigned int indexCount, unsigned int startIndex, int baseVertex, UITextureID texture, const Vector2& translation) = 0;
+};
+
+/// Owns the GPU buffers used for UI geometry.
+/// Compiled geometry lives in its own static buffers. Immediate geometry is collected into batches of
+/// consecutive draws sharing a texture and streamed through a dynamic ring buffer shared by the whole frame.
+class UIGeometryBuffer
+{
+public:
+	typedef unsigned int CompiledID;
+
+	struct Statistics
+	{
+		unsigned int drawCalls = 0;
+		unsigned int immediateGeometries = 0;
+		unsigned int compiledGeometries = 0;
+		unsigned int ringWraps = 0;
+	};
+
+private:
+	struct CompiledGeometry
+	{
+		UIGeometryDevice::BufferID vertexBuffer;
+		UIGeometryDevice::BufferID indexBuffer;
+		unsigned int indexCount;
+		UITextureID texture;
+	};
+
+	UIGeometryDevice& m_Device;
+
+	HashMap<CompiledID, CompiledGeometry> m_CompiledGeometries;
+	CompiledID m_NextCompiledID = 1;
+
+	UIGeometryDevice::BufferID m_RingVertexBuffer = 0;
+	UIGeometryDevice::BufferID m_RingIndexBuffer = 0;
+	unsigned int m_RingVertexCapacity;
+	unsigned int m_RingIndexCapacity;
+	unsigned int m_RingVertexCursor = 0;
+	unsigned int m_RingIndexCursor = 0;
+
+	Vector<UIVertexData> m_BatchVertices;
+	Vector<unsigned int> m_BatchIndices;
+	UITextureID m_BatchTexture = 0;
+
+	Statistics m_Statistics;
+
+	void growRing(unsigned int vertexCount, unsigned int indexCount);
+
+public:
+	UIGeometryBuffer(UIGeometryDevice& device, unsigned int ringVertexCapacity = UI_RING_VERTEX_CAPACITY, unsigned int ringIndexCapacity = UI_RING_INDEX_CAPACITY);
+	UIGeometryBuffer(const UIGeometryBuffer&) = delete;
+	~UIGeometryBuffer();
+
+	/// Queue geometry for drawing. Translation is baked into the vertices so it can share a batch with other geometry.
+	void render(const UIVertexData* vertices, unsigned int vertexCount, const int* indices, unsigned int indexCount, UITextureID texture, const Vector2& translation);
+
+	CompiledID compile(const UIVertexData* vertices, unsigned int vertexCount, const int* indices, unsigned int indexCount, UITextureID texture);
+	void renderCompiled(CompiledID geometry, const Vector2& translation);
+	void release(CompiledID geometry);
+
+	/// Draw the pending batch. Call before any render state the batch depends on changes.
+	void flush();
+	/// Reset per frame statistics. The ring keeps its cursor so data drawn last frame is not overwritten while in flight.
+	void beginFrame();
+
+	const Statistics& getStatistics() const { return m_Statistics; }
+	unsigned int getCompiledCount() const { return m_CompiledGeometries.size(); }
+};
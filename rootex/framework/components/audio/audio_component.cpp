@@ -9,7 +9,9 @@ AudioComponent::AudioComponent(
     AudioSource::AttenuationModel model,
     ALfloat rolloffFactor,
     ALfloat referenceDistance,
-    ALfloat maxDistance)
+    ALfloat maxDistance,
+    float volume,
+    float priority)
     : m_IsPlayOnStart(playOnStart)
     , m_IsAttenuated(attenuation)
     , m_IsLooping(isLooping)
@@ -17,6 +19,8 @@ AudioComponent::AudioComponent(
     , m_RolloffFactor(rolloffFactor)
     , m_ReferenceDistance(referenceDistance)
     , m_MaxDistance(maxDistance)
+    , m_Volume(volume)
+    , m_Priority(priority)
     , m_DependencyOnTransformComponent(this)
 {
 }
@@ -32,7 +36,10 @@ bool AudioComponent::setupData()
 		getAudioSource()->setMaxDistance(m_MaxDistance);
 	}
 
+	getAudioSource()->setAttenuated(m_IsAttenuated);
 	getAudioSource()->setLooping(m_IsLooping);
+	getAudioSource()->setVolume(m_Volume);
+	getAudioSource()->setPriority(m_Priority);
 	return true;
 }
 
@@ -46,6 +53,8 @@ JSON::json AudioComponent::getJSON() const
 	j["rollOffFactor"] = m_RolloffFactor;
 	j["referenceDistance"] = m_ReferenceDistance;
 	j["maxDistance"] = m_MaxDistance;
+	j["volume"] = m_Volume;
+	j["priority"] = m_Priority;
 
 	return j;
 }
@@ -101,7 +110,19 @@ void AudioComponent::draw()
 		setLooping(m_IsLooping);
 	}
 
-	ImGui::Checkbox("Attenuation", &m_IsAttenuated);
+	if (ImGui::SliderFloat("Volume", &m_Volume, 0.0f, 1.0f))
+	{
+		m_AudioSource->setVolume(m_Volume);
+	}
+	if (ImGui::DragFloat("Priority", &m_Priority, 0.1f, 0.0f, 100.0f))
+	{
+		m_AudioSource->setPriority(m_Priority);
+	}
+
+	if (ImGui::Checkbox("Attenuation", &m_IsAttenuated))
+	{
+		m_AudioSource->setAttenuated(m_IsAttenuated);
+	}
 
 	if (ImGui::BeginCombo("Attenutation Model", m_AttenuationModelName.c_str()))
 	{
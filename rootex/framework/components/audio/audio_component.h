@@ -14,6 +14,8 @@ class AudioComponent : public Component
 	ALfloat m_RolloffFactor;
 	ALfloat m_ReferenceDistance;
 	ALfloat m_MaxDistance;
+	float m_Volume;
+	float m_Priority;
 	AudioSource* m_AudioSource;
 
 protected:
@@ -30,7 +32,9 @@ public:
 	    AudioSource::AttenuationModel model,
 	    ALfloat rolloffFactor,
 	    ALfloat referenceDistance,
-	    ALfloat maxDistance);
+	    ALfloat maxDistance,
+	    float volume,
+	    float priority);
 	virtual ~AudioComponent() = default;
 
 	void update();
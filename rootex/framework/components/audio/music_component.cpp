@@ -10,7 +10,9 @@ Ptr<Component> MusicComponent::Create(const JSON::json& componentData)
 	    (AudioSource::AttenuationModel)componentData.value("attenuationModel", (int)AudioSource::AttenuationModel::Linear),
 	    (ALfloat)componentData.value("rollOffFactor", 1.0f),
 	    (ALfloat)componentData.value("referenceDistance", 1.0f),
-	    (ALfloat)componentData.value("maxDistance", 100.0f));
+	    (ALfloat)componentData.value("maxDistance", 100.0f),
+	    componentData.value("volume", 1.0f),
+	    componentData.value("priority", 1.0f));
 }
 
 MusicComponent::MusicComponent(
@@ -21,8 +23,10 @@ MusicComponent::MusicComponent(
     AudioSource::AttenuationModel model,
     ALfloat rolloffFactor,
     ALfloat referenceDistance,
-    ALfloat maxDistance)
-    : AudioComponent(playOnStart, isLooping, attenuation, model, rolloffFactor, referenceDistance, maxDistance)
+    ALfloat maxDistance,
+    float volume,
+    float priority)
+    : AudioComponent(playOnStart, isLooping, attenuation, model, rolloffFactor, referenceDistance, maxDistance, volume, priority)
     , m_AudioFile(audioFile)
 {
 }
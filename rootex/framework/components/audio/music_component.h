@@ -24,7 +24,9 @@ public:
 	    AudioSource::AttenuationModel model,
 	    ALfloat rolloffFactor,
 	    ALfloat referenceDistance,
-	    ALfloat maxDistance);
+	    ALfloat maxDistance,
+	    float volume,
+	    float priority);
 	~MusicComponent();
 
 	AudioResourceFile* getAudioFile() const { return m_AudioFile.get(); }
@@ -28,5 +28,7 @@ enum class ComponentIDs : unsigned int
 	StaticPointLightComponent,
 	AnimatedModelComponent,
 	RenderableComponent,
-	ParticleEffectComponent
+	ParticleEffectComponent,
+	/// Not a component, keep last
+	Count
 };
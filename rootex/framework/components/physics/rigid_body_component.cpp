@@ -98,7 +98,7 @@ void RigidBodyComponent::handleHit(Hit* hit)
 {
 	if (m_IsGeneratesHitEvents)
 	{
-		m_Owner->call("hit", { hit });
+		m_Owner->invoke("hit", hit);
 	}
 }
 
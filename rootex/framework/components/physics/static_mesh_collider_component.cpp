@@ -29,16 +29,28 @@ StaticMeshColliderComponent::StaticMeshColliderComponent(
 
 bool StaticMeshColliderComponent::setupData()
 {
-	m_CollisionShape.reset(new btBvhTriangleMeshShape(m_CollisionModel->getCollisionMesh(), true));
+	// Shape is shared with every collider using the same collision model
+	m_CollisionShape = m_CollisionModel->getCollisionShape();
+	if (!m_CollisionShape)
+	{
+		WARN("Collision model has no collision mesh: " + m_CollisionModel->getPath().generic_string());
+		return false;
+	}
 	m_MeshShape = (btBvhTriangleMeshShape*)m_CollisionShape.get();
 	return RigidBodyComponent::setupData();
 }
 
 void StaticMeshColliderComponent::createStaticMesh()
 {
+	Ref<btBvhTriangleMeshShape> shape = m_CollisionModel->getCollisionShape();
+	if (!shape)
+	{
+		WARN("Collision model has no collision mesh: " + m_CollisionModel->getPath().generic_string());
+		return;
+	}
 	detachCollisionObject();
-	m_CollisionShape.reset(new btBvhTriangleMeshShape(m_CollisionModel->getCollisionMesh(), true));
-	m_MeshShape = (btBvhTriangleMeshShape*)m_CollisionShape.get();
+	m_CollisionShape = shape;
+	m_MeshShape = shape.get();
 	m_Body->setCollisionShape(m_MeshShape);
 	attachCollisionObject();
 }
@@ -74,7 +74,7 @@ void TriggerComponent::notifyEntry()
 		{
 			if (Entity* entity = scene->getEntity())
 			{
-				entity->call("enter", { entity, getOwner() });
+				entity->invoke("enter", entity, getOwner());
 			}
 		}
 		else
@@ -93,7 +93,7 @@ void TriggerComponent::notifyExit()
 		{
 			if (Entity* entity = scene->getEntity())
 			{
-				entity->call("exit", { entity, getOwner() });
+				entity->invoke("exit", entity, getOwner());
 			}
 		}
 		else
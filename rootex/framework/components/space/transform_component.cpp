@@ -5,6 +5,7 @@
 
 #include "entity.h"
 #include "systems/render_system.h"
+#include "systems/spatial_system.h"
 
 Ptr<Component> TransformComponent::Create(const JSON::json& componentData)
 {
@@ -44,11 +45,28 @@ TransformComponent::TransformComponent(const Vector3& position, const Quaternion
 	updateTransformFromPositionRotationScale();
 }
 
+bool TransformComponent::setupData()
+{
+	SpatialSystem::GetSingleton()->addTransform(this);
+	return true;
+}
+
+void TransformComponent::onRemove()
+{
+	SpatialSystem::GetSingleton()->removeTransform(this);
+}
+
+void TransformComponent::markDirty()
+{
+	m_IsAbsoluteTransformDirty = true;
+	m_IsSpatialDirty = true;
+}
+
 void TransformComponent::setPosition(const Vector3& position)
 {
 	m_TransformBuffer.m_Position = position;
 	updateTransformFromPositionRotationScale();
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::setAbsolutePosition(const Vector3& position)
@@ -60,72 +78,78 @@ void TransformComponent::setRotation(const float& yaw, const float& pitch, const
 {
 	m_TransformBuffer.m_Rotation = Quaternion::CreateFromYawPitchRoll(yaw, pitch, roll);
 	updateTransformFromPositionRotationScale();
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::setRotationQuaternion(const Quaternion& rotation)
 {
 	m_TransformBuffer.m_Rotation = rotation;
 	updateTransformFromPositionRotationScale();
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::setScale(const Vector3& scale)
 {
 	m_TransformBuffer.m_Scale = scale;
 	updateTransformFromPositionRotationScale();
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::setTransform(const Matrix& transform)
 {
 	m_TransformBuffer.m_Transform = transform;
 	updatePositionRotationScaleFromTransform(m_TransformBuffer.m_Transform);
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::setAbsoluteTransform(const Matrix& transform)
 {
 	setTransform(transform * m_ParentAbsoluteTransform.Invert());
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::setBounds(const BoundingBox& bounds)
 {
 	m_TransformBuffer.m_BoundingBox = bounds;
+	m_IsSpatialDirty = true;
 }
 
 void TransformComponent::setRotationPosition(const Matrix& transform)
 {
 	m_TransformBuffer.m_Transform = Matrix::CreateScale(m_TransformBuffer.m_Scale) * transform;
 	updatePositionRotationScaleFromTransform(m_TransformBuffer.m_Transform);
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::setAbsoluteRotationPosition(const Matrix& transform)
 {
 	setAbsoluteTransform(Matrix::CreateScale(m_TransformBuffer.m_Scale) * transform);
 	updatePositionRotationScaleFromTransform(m_TransformBuffer.m_Transform);
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::setParentAbsoluteTransform(const Matrix& parentTransform)
 {
+	// Called for every child on every frame, so only invalidate what depends on the parent when it actually moved
+	if (m_ParentAbsoluteTransform == parentTransform)
+	{
+		return;
+	}
 	m_ParentAbsoluteTransform = parentTransform;
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::addTransform(const Matrix& applyTransform)
 {
 	setTransform(getLocalTransform() * applyTransform);
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::addQuaternion(const Quaternion& applyQuaternion)
 {
 	m_TransformBuffer.m_Rotation = Quaternion::Concatenate(applyQuaternion, m_TransformBuffer.m_Rotation);
 	updateTransformFromPositionRotationScale();
-	m_IsAbsoluteTransformDirty = true;
+	markDirty();
 }
 
 void TransformComponent::addRotation(float yaw, float pitch, float roll)
@@ -273,6 +297,7 @@ void TransformComponent::draw()
 	}
 
 	updateTransformFromPositionRotationScale();
+	markDirty();
 }
 
 void TransformComponent::highlight()
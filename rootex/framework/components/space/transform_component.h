@@ -26,6 +26,13 @@ class TransformComponent : public Component
 	Vector3 m_AbsoluteScale;
 	bool m_IsAbsoluteTransformDirty = true;
 
+	/// Leaf of this entity in the SpatialSystem tree, -1 if it is not in the tree
+	int m_SpatialProxy = -1;
+	/// Position in the SpatialSystem transform list
+	unsigned int m_SpatialIndex = 0;
+	/// Set when the world space bounds may have changed since the last refit
+	bool m_IsSpatialDirty = true;
+
 	bool m_LockScale = false;
 
 	const TransformBuffer* getTransformBuffer() const { return &m_TransformBuffer; };
@@ -33,14 +40,19 @@ class TransformComponent : public Component
 	void updateAbsoluteTransformValues();
 	void updateTransformFromPositionRotationScale();
 	void updatePositionRotationScaleFromTransform(Matrix& transform);
+	void markDirty();
 
 	friend class ModelComponent;
 	friend class RenderSystem;
+	friend class SpatialSystem;
 
 public:
 	TransformComponent(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const BoundingBox& bounds);
 	~TransformComponent() = default;
 
+	bool setupData() override;
+	void onRemove() override;
+
 	void setPosition(const Vector3& position);
 	void setRotation(const float& yaw, const float& pitch, const float& roll);
 	void setRotationQuaternion(const Quaternion& rotation);
@@ -64,6 +76,8 @@ public:
 	Matrix getParentAbsoluteTransform() const { return m_ParentAbsoluteTransform; }
 
 	BoundingBox getWorldSpaceBounds();
+	/// Refit the spatial bounds on the next refit, for components that grow the bounds of their entity
+	void setSpatialDirty() { m_IsSpatialDirty = true; }
 
 	Matrix getAbsoluteTransform();
 	Vector3 getAbsolutePosition();
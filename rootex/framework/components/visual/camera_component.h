@@ -29,6 +29,12 @@ public:
 	Matrix& getViewMatrix();
 	Matrix& getProjectionMatrix();
 	Vector3 getAbsolutePosition() const { return m_TransformComponent->getAbsoluteTransform().Translation(); }
+	Matrix getAbsoluteTransform() const { return m_TransformComponent->getAbsoluteTransform(); }
+	/// Vertical field of view in radians
+	float getFoV() const { return m_FoV; }
+	float getNear() const { return m_Near; }
+	float getFar() const { return m_Far; }
+	const Vector2& getAspectRatio() const { return m_AspectRatio; }
 
 	PostProcessingDetails getPostProcessingDetails() const { return m_PostProcessingDetails; }
 
@@ -6,6 +6,7 @@
 #include "timer.h"
 
 #include "renderer/material_library.h"
+#include "app/application.h"
 
 void to_json(JSON::json& j, const ParticleTemplate p)
 {
@@ -46,7 +47,9 @@ Ptr<Component> CPUParticlesComponent::Create(const JSON::json& componentData)
 	    componentData.value("emitRate", 1),
 	    componentData.value("emitterDimensions", Vector3 { 1.0f, 1.0f, 1.0f }),
 	    componentData.value("isVisible", true),
-	    componentData.value("renderPass", (unsigned int)RenderPass::Basic));
+	    componentData.value("renderPass", (unsigned int)RenderPass::Basic),
+	    componentData.value("affectingStaticLights", Vector<SceneID>()),
+	    componentData.value("isStaticLightingAutomatic", true));
 }
 
 CPUParticlesComponent::CPUParticlesComponent(
@@ -58,7 +61,9 @@ CPUParticlesComponent::CPUParticlesComponent(
     int emitRate,
     const Vector3& emitterDimensions,
     bool visibility,
-    unsigned int renderPass)
+    unsigned int renderPass,
+    const Vector<SceneID>& affectingStaticLightIDs,
+    bool isStaticLightingAutomatic)
     : ModelComponent(
         renderPass,
         ResourceLoader::CreateModelResourceFile(particleModelPath),
@@ -66,16 +71,14 @@ CPUParticlesComponent::CPUParticlesComponent(
         visibility,
         false,
         0.0f,
-        0.0f,
-        {})
+        affectingStaticLightIDs,
+        isStaticLightingAutomatic)
     , m_ParticlesMaterial(std::dynamic_pointer_cast<ParticlesMaterial>(MaterialLibrary::GetMaterial(materialPath)))
     , m_ParticleTemplate(particleTemplate)
     , m_CurrentEmitMode(emitMode)
     , m_EmitterDimensions(emitterDimensions)
     , m_EmitRate(emitRate)
 {
-	m_InstanceBufferData.resize(MAX_PARTICLES);
-	m_InstanceBuffer.reset(new VertexBuffer(m_InstanceBufferData));
 	expandPool(poolSize);
 }
 
@@ -105,64 +108,93 @@ bool CPUParticlesComponent::preRender(float deltaMilliseconds)
 	}
 	{
 		ZoneNamedN(particleInterpolation, "Particle Interpolation", true);
+		m_LiveParticlesCount = Simulate(m_Particles, delta, m_LiveInstances);
+	}
+	return true;
+}
 
-		// Particle animation
-		for (int i = 0; i < m_ParticlePool.size(); i++)
-		{
-			Particle& particle = m_ParticlePool[i];
-
-			particle.lifeRemaining -= delta;
-
-			if (particle.lifeRemaining < 0.0f)
-			{
-				continue;
-			}
-
-			float life = particle.lifeRemaining / particle.lifeTime;
-			float size = particle.sizeBegin * (life) + particle.sizeEnd * (1.0f - life);
-
-			particle.position = particle.position + particle.velocity * delta;
-			particle.rotation = Quaternion::Concatenate(
-			    particle.rotation,
-			    Quaternion::CreateFromYawPitchRoll(
-			        particle.angularVelocity.x * delta,
-			        particle.angularVelocity.y * delta,
-			        particle.angularVelocity.z * delta));
-
-			InstanceData& instance = m_InstanceBufferData[i];
-			instance.transform = Matrix::CreateScale(size)
-			    * Matrix::CreateFromQuaternion(particle.rotation)
-			    * Matrix::CreateTranslation(particle.position);
-			instance.inverseTransposeTransform = instance.transform.Invert().Transpose();
-			instance.color = Color::Lerp(particle.colorEnd, particle.colorBegin, life);
-		}
+size_t CPUParticlesComponent::Simulate(ParticleStore& particles, float delta, Vector<InstanceData>& liveInstances)
+{
+	const size_t capacity = particles.getCapacity();
+	if (liveInstances.size() < capacity)
+	{
+		liveInstances.resize(capacity);
+	}
+
+	Application* application = Application::GetSingleton();
+	if (!application || capacity <= CPU_PARTICLES_INLINE_LIMIT)
+	{
+		return particles.simulate(0, capacity, delta, liveInstances.data());
+	}
+
+	// Each block packs its live instances at the start of its own part of the buffer
+	const size_t blockCount = (capacity + CPU_PARTICLES_PER_TASK - 1) / CPU_PARTICLES_PER_TASK;
+	Vector<size_t> blockLiveCounts(blockCount, 0);
+	Vector<Ref<Task>> tasks;
+	for (size_t block = 0; block < blockCount; block++)
+	{
+		tasks.push_back(std::make_shared<Task>([&particles, &liveInstances, &blockLiveCounts, delta, capacity, block]() {
+			const size_t first = block * CPU_PARTICLES_PER_TASK;
+			const size_t last = std::min(first + CPU_PARTICLES_PER_TASK, capacity);
+			blockLiveCounts[block] = particles.simulate(first, last, delta, liveInstances.data() + first);
+		}));
+	}
+	application->getThreadPool().execute(tasks);
 
-		// Count the size of the final live buffer
-		m_LiveParticlesCount = 0;
-		for (auto& particle : m_ParticlePool)
+	// Close the gaps dead particles left between blocks
+	size_t liveCount = blockLiveCounts[0];
+	for (size_t block = 1; block < blockCount; block++)
+	{
+		const InstanceData* blockStart = liveInstances.data() + block * CPU_PARTICLES_PER_TASK;
+		std::copy(blockStart, blockStart + blockLiveCounts[block], liveInstances.data() + liveCount);
+		liveCount += blockLiveCounts[block];
+	}
+	return liveCount;
+}
+
+void CPUParticlesComponent::Benchmark()
+{
+	ZoneScoped;
+
+	const float delta = 1.0f / 60.0f;
+	const int frames = 100;
+	for (size_t size : { (size_t)MAX_PARTICLES / 20, (size_t)MAX_PARTICLES / 4, (size_t)MAX_PARTICLES })
+	{
+		// Particles live through the whole benchmark so every frame does the full work
+		ParticleStore particles;
+		particles.resize(size);
+		for (size_t i = 0; i < size; i++)
 		{
-			if (particle.lifeRemaining > 0.0f)
-			{
-				m_LiveParticlesCount++;
-			}
+			ParticleSpawn spawn;
+			spawn.position = { Random::Float(), Random::Float(), Random::Float() };
+			spawn.rotation = Quaternion::CreateFromYawPitchRoll(Random::Float(), Random::Float(), Random::Float());
+			spawn.velocity = { Random::Float() - 0.5f, Random::Float() - 0.5f, Random::Float() - 0.5f };
+			spawn.angularVelocity = { Random::Float() - 0.5f, Random::Float() - 0.5f, Random::Float() - 0.5f };
+			spawn.colorBegin = ColorPresets::Red;
+			spawn.colorEnd = ColorPresets::Blue;
+			spawn.sizeBegin = 0.1f;
+			spawn.sizeEnd = 0.0f;
+			spawn.lifeTime = 4.0f * frames * delta;
+			particles.spawn(i, spawn);
 		}
+		Vector<InstanceData> liveInstances(particles.getCapacity());
 
-		// Copy live particles to the buffer which will be sent to the GPU
-		if (m_InstanceBufferLiveData.size() < m_LiveParticlesCount)
+		StopTimer timer;
+		for (int frame = 0; frame < frames; frame++)
 		{
-			m_InstanceBufferLiveData.resize(m_LiveParticlesCount);
+			particles.simulate(0, particles.getCapacity(), delta, liveInstances.data());
 		}
-		int liveCount = 0;
-		for (int i = 0; i < m_ParticlePool.size(); i++)
+		const float singleThreadMs = timer.getTimeMs() / frames;
+
+		timer.reset();
+		for (int frame = 0; frame < frames; frame++)
 		{
-			if (m_ParticlePool[i].lifeRemaining > 0.0f)
-			{
-				m_InstanceBufferLiveData[liveCount] = m_InstanceBufferData[i];
-				liveCount++;
-			}
+			Simulate(particles, delta, liveInstances);
 		}
+		const float workersMs = timer.getTimeMs() / frames;
+
+		PRINT("CPU particles: " + std::to_string(size) + " particles take " + std::to_string(singleThreadMs) + " ms per frame on one thread, " + std::to_string(workersMs) + " ms split across workers");
 	}
-	return true;
 }
 
 void CPUParticlesComponent::render(float viewDistance)
@@ -170,14 +202,18 @@ void CPUParticlesComponent::render(float viewDistance)
 	ZoneScoped;
 
 	RenderSystem::GetSingleton()->getRenderer()->bind(m_ParticlesMaterial.get());
-	m_InstanceBuffer->setData(m_InstanceBufferLiveData);
+	m_InstanceBuffer->setData(m_LiveInstances.data(), m_LiveParticlesCount);
+	const float particleSize = std::max(m_ParticleTemplate.sizeBegin, m_ParticleTemplate.sizeEnd) + m_ParticleTemplate.sizeVariation;
+	float screenSize = 0.0f;
 	for (auto& [material, meshes] : m_ModelResourceFile->getMeshes())
 	{
 		for (auto& mesh : meshes)
 		{
-			RenderSystem::GetSingleton()->getRenderer()->drawInstanced(mesh.m_VertexBuffer.get(), mesh.getLOD(1.0f).get(), m_InstanceBuffer.get(), m_LiveParticlesCount);
+			RenderSystem::GetSingleton()->getRenderer()->drawInstanced(mesh.m_VertexBuffer.get(), mesh.getLOD(0).get(), m_InstanceBuffer.get(), m_LiveParticlesCount);
+			screenSize = std::max(screenSize, getScreenSize(mesh.m_BoundingBox, viewDistance) * particleSize);
 		}
 	}
+	m_ParticlesMaterial->requestTextures(screenSize);
 }
 
 void CPUParticlesComponent::setMaterial(Ref<ParticlesMaterial> particlesMaterial)
@@ -195,8 +231,7 @@ void CPUParticlesComponent::emit(const ParticleTemplate& particleTemplate)
 {
 	ZoneScoped;
 
-	Particle& particle = m_ParticlePool[m_PoolIndex];
-
+	ParticleSpawn particle;
 	particle.velocity = particleTemplate.velocity + particleTemplate.velocityVariation * 2.0f * Vector3 { Random::Float() - 0.5f, Random::Float() - 0.5f, Random::Float() - 0.5f };
 	particle.angularVelocity = 2.0f * Vector3(Random::Float() - 0.5f, Random::Float() - 0.5f, Random::Float() - 0.5f) * particleTemplate.angularVelocityVariation;
 	particle.angularVelocity.Normalize();
@@ -205,11 +240,9 @@ void CPUParticlesComponent::emit(const ParticleTemplate& particleTemplate)
 	particle.colorEnd = particleTemplate.colorEnd;
 
 	particle.lifeTime = particleTemplate.lifeTime;
-	particle.lifeRemaining = particleTemplate.lifeTime;
 	particle.sizeBegin = particleTemplate.sizeBegin * (1.0f + particleTemplate.sizeVariation * 2.0f * (Random::Float() - 0.5f));
 	particle.sizeEnd = particleTemplate.sizeEnd;
 
-	Matrix initialTransform = Matrix::Identity;
 	Vector3 position;
 	switch (m_CurrentEmitMode)
 	{
@@ -240,20 +273,17 @@ void CPUParticlesComponent::emit(const ParticleTemplate& particleTemplate)
 	default:
 		break;
 	}
-	initialTransform = Matrix::CreateTranslation(position);
 
 	Quaternion rotation = Quaternion::CreateFromYawPitchRoll(
 	    particleTemplate.rotationVariation * Random::Float(),
 	    particleTemplate.rotationVariation * Random::Float(),
 	    particleTemplate.rotationVariation * Random::Float());
-	initialTransform = Matrix::CreateFromQuaternion(rotation) * initialTransform;
-	m_InstanceBufferData[m_PoolIndex].transform = initialTransform * m_TransformComponent->getAbsoluteTransform();
 
 	particle.position = position + m_TransformComponent->getAbsolutePosition();
 	particle.rotation = Quaternion::Concatenate(rotation, m_TransformComponent->getAbsoluteRotation());
-	particle.scale = m_TransformComponent->getAbsoluteScale();
+	m_Particles.spawn(m_PoolIndex, particle);
 
-	m_PoolIndex = --m_PoolIndex % m_ParticlePool.size();
+	m_PoolIndex = (m_PoolIndex == 0 ? m_Particles.getSize() : m_PoolIndex) - 1;
 }
 
 void CPUParticlesComponent::expandPool(const size_t& poolSize)
@@ -269,9 +299,11 @@ void CPUParticlesComponent::expandPool(const size_t& poolSize)
 		return;
 	}
 
-	m_ParticlePool.resize(poolSize);
-	m_InstanceBufferData.resize(poolSize);
+	m_Particles.resize(poolSize);
 	m_PoolIndex = poolSize - 1;
+	// Every particle of the pool can be alive at once
+	m_InstanceBuffer.reset(new VertexBuffer(Vector<InstanceData>(m_Particles.getCapacity())));
+	m_LiveParticlesCount = 0;
 }
 
 JSON::json CPUParticlesComponent::getJSON() const
@@ -279,7 +311,7 @@ JSON::json CPUParticlesComponent::getJSON() const
 	JSON::json& j = ModelComponent::getJSON();
 
 	j["materialPath"] = m_ParticlesMaterial->getFileName();
-	j["poolSize"] = m_ParticlePool.size();
+	j["poolSize"] = m_Particles.getSize();
 	j["particleTemplate"] = m_ParticleTemplate;
 	j["emitMode"] = (int)m_CurrentEmitMode;
 	j["emitterDimensions"]["x"] = m_EmitterDimensions.x;
@@ -338,11 +370,16 @@ void CPUParticlesComponent::draw()
 		ImGui::DragFloat("Dimensions", &m_EmitterDimensions.x, 0.01f, 0.0f);
 		break;
 	}
-	int poolSize = m_ParticlePool.size();
+	int poolSize = m_Particles.getSize();
 	if (ImGui::DragInt("Pool Size", &poolSize, 1.0f, 1, MAX_PARTICLES))
 	{
 		expandPool(poolSize);
 	}
+	ImGui::Text("Live Particles: %d", (int)m_LiveParticlesCount);
+	if (ImGui::Button("Benchmark"))
+	{
+		Benchmark();
+	}
 	ImGui::DragFloat("Emit Rate", &m_EmitRate, 0.1f, 0.0f, FLT_MAX);
 
 	ImGui::Separator();
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "renderer/vertex_data.h"
+#include "renderer/particle_store.h"
 #include "renderer/materials/particles_material.h"
 #include "components/visual/model/model_component.h"
 
-#define MAX_PARTICLES 5000
+/// Largest pool an emitter can have. Pools above CPU_PARTICLES_INLINE_LIMIT are split across worker threads.
+#define MAX_PARTICLES 100000
+/// Particles simulated by one worker thread task. Must be a multiple of PARTICLE_LANES.
+#define CPU_PARTICLES_PER_TASK 2048
+/// Pools up to this size are simulated on the calling thread, where handing them to workers costs more than it saves
+#define CPU_PARTICLES_INLINE_LIMIT 8192
 
 struct ParticleTemplate
 {
@@ -24,30 +30,13 @@ class CPUParticlesComponent : public ModelComponent
 {
 	DEFINE_COMPONENT(CPUParticlesComponent);
 
-	Vector<InstanceData> m_InstanceBufferData;
-	Vector<InstanceData> m_InstanceBufferLiveData;
-	int m_LiveParticlesCount;
+	/// Instances of live particles, packed from the start. Sized to the pool so simulation can pack them in place.
+	Vector<InstanceData> m_LiveInstances;
+	size_t m_LiveParticlesCount = 0;
 	Ptr<VertexBuffer> m_InstanceBuffer;
 
-	struct Particle
-	{
-		float sizeBegin;
-		float sizeEnd;
-		float lifeTime;
-		float lifeRemaining;
-		Color colorBegin;
-		Color colorEnd;
-		Vector3 velocity;
-		Vector3 angularVelocity;
-
-		// Not for use outside
-		Vector3 position;
-		Quaternion rotation;
-		Vector3 scale;
-	};
-
 	ParticleTemplate m_ParticleTemplate;
-	Vector<Particle> m_ParticlePool;
+	ParticleStore m_Particles;
 	Ref<ParticlesMaterial> m_ParticlesMaterial;
 	size_t m_PoolIndex;
 	float m_EmitRate;
@@ -66,7 +55,13 @@ class CPUParticlesComponent : public ModelComponent
 
 	float m_EmitCount = 0;
 
+	/// Simulate all particles, splitting large pools across worker threads. Returns the number of live instances.
+	static size_t Simulate(ParticleStore& particles, float delta, Vector<InstanceData>& liveInstances);
+
 public:
+	/// Print the time taken to simulate pools of up to MAX_PARTICLES, on one thread and split across workers
+	static void Benchmark();
+
 	CPUParticlesComponent(
 	    size_t poolSize,
 	    const String& particleModelPath,
@@ -76,7 +71,9 @@ public:
 	    int emitRate,
 	    const Vector3& emitterDimensions,
 	    bool visibility,
-	    unsigned int renderPass);
+	    unsigned int renderPass,
+	    const Vector<SceneID>& affectingStaticLightIDs,
+	    bool isStaticLightingAutomatic);
 	~CPUParticlesComponent() = default;
 
 	void setMaterial(Ref<ParticlesMaterial> particlesMaterial);
@@ -53,5 +53,9 @@ void PointLightComponent::draw()
 	ImGui::DragFloat("Constant Attenuation##Point", &m_PointLight.attConst, 0.01f);
 	ImGui::DragFloat("Linear Attenuation##Point", &m_PointLight.attLin, 0.01f);
 	ImGui::DragFloat("Quadratic Attenuation##Point", &m_PointLight.attQuad, 0.01f);
-	ImGui::DragFloat("Range##Point", &m_PointLight.range, 0.1f);
+	if (ImGui::DragFloat("Range##Point", &m_PointLight.range, 0.1f))
+	{
+		// The range grows the bounds of the entity in spatial queries
+		m_TransformComponent->setSpatialDirty();
+	}
 }
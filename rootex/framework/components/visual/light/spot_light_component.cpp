@@ -60,7 +60,10 @@ void SpotLightComponent::draw()
 	ImGui::DragFloat("Constant Attenuation##Spot", &m_SpotLight.attConst, 0.01f);
 	ImGui::DragFloat("Linear Attenuation##Spot", &m_SpotLight.attLin, 0.01f);
 	ImGui::DragFloat("Quadratic Attenuation##Spot", &m_SpotLight.attQuad, 0.01f);
-	ImGui::DragFloat("Range##Spot", &m_SpotLight.range, 1.0f);
+	if (ImGui::DragFloat("Range##Spot", &m_SpotLight.range, 1.0f))
+	{
+		m_TransformComponent->setSpatialDirty();
+	}
 	ImGui::DragFloat("Spot Factor##Spot", &m_SpotLight.spot, 0.1f);
 	ImGui::SliderAngle("Cone Sub-Angle##Spot", &m_SpotLight.angleRange, 0.0f, 90.0f);
 }
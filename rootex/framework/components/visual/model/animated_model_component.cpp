@@ -20,8 +20,8 @@ Ptr<Component> AnimatedModelComponent::Create(const JSON::json& componentData)
 	    componentData.value("isVisible", true),
 	    componentData.value("lodEnable", true),
 	    componentData.value("lodBias", 0.0f),
-	    componentData.value("lodDistance", 10.0f),
-	    componentData.value("affectingStaticLights", Vector<SceneID>()));
+	    componentData.value("affectingStaticLights", Vector<SceneID>()),
+	    componentData.value("isStaticLightingAutomatic", componentData.value("affectingStaticLights", Vector<SceneID>()).empty()));
 }
 
 AnimatedModelComponent::AnimatedModelComponent(
@@ -34,9 +34,9 @@ AnimatedModelComponent::AnimatedModelComponent(
     bool isVisible,
     bool lodEnable,
     float lodBias,
-    float lodDistance,
-    const Vector<SceneID>& affectingStaticLightIDs)
-    : RenderableComponent(renderPass, materialOverrides, isVisible, lodEnable, lodBias, lodDistance, affectingStaticLightIDs)
+    const Vector<SceneID>& affectingStaticLightIDs,
+    bool isStaticLightingAutomatic)
+    : RenderableComponent(renderPass, materialOverrides, isVisible, lodEnable, lodBias, affectingStaticLightIDs, isStaticLightingAutomatic)
     , m_CurrentTimePosition(0.0f)
     , m_IsPlaying(isPlayOnStart)
     , m_IsPlayOnStart(isPlayOnStart)
@@ -65,17 +65,23 @@ void AnimatedModelComponent::render(float viewDistance)
 	ZoneNamedN(componentRender, "Animated Model Render", true);
 	RenderableComponent::render(viewDistance);
 
-	std::sort(m_AnimatedModelResourceFile->getMeshes().begin(), m_AnimatedModelResourceFile->getMeshes().end(), CompareMaterials);
+	// Stable so every mesh keeps its LOD slot from frame to frame
+	std::stable_sort(m_AnimatedModelResourceFile->getMeshes().begin(), m_AnimatedModelResourceFile->getMeshes().end(), CompareMaterials);
 
+	int slot = 0;
 	for (auto& [material, meshes] : m_AnimatedModelResourceFile->getMeshes())
 	{
 		(std::dynamic_pointer_cast<AnimatedMaterial>(material))->setVSConstantBuffer(VSAnimationConstantBuffer(m_FinalTransforms));
-		RenderSystem::GetSingleton()->getRenderer()->bind(m_MaterialOverrides[material].get());
+		Material* boundMaterial = m_MaterialOverrides[material].get();
+		RenderSystem::GetSingleton()->getRenderer()->bind(boundMaterial);
 
+		float screenSize = 0.0f;
 		for (auto& mesh : meshes)
 		{
-			RenderSystem::GetSingleton()->getRenderer()->draw(mesh.m_VertexBuffer.get(), mesh.getLOD(getLODFactor(viewDistance)).get());
+			RenderSystem::GetSingleton()->getRenderer()->draw(mesh.m_VertexBuffer.get(), getLOD(mesh, slot++, viewDistance).get());
+			screenSize = std::max(screenSize, getScreenSize(mesh.m_BoundingBox, viewDistance));
 		}
+		boundMaterial->requestTextures(screenSize);
 	}
 }
 
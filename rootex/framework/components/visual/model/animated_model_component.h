@@ -44,8 +44,8 @@ public:
 	    bool isVisible,
 	    bool lodEnable,
 	    float lodBias,
-	    float lodDistance,
-	    const Vector<SceneID>& affectingStaticLightIDs);
+	    const Vector<SceneID>& affectingStaticLightIDs,
+	    bool isStaticLightingAutomatic);
 	~AnimatedModelComponent() = default;
 
 	bool preRender(float deltaMilliseconds) override;
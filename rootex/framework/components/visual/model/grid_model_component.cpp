@@ -12,7 +12,7 @@ Ptr<Component> GridModelComponent::Create(const JSON::json& componentData)
 }
 
 GridModelComponent::GridModelComponent(const Vector2& cellSize, const int& cellCount, const unsigned int& renderPass, bool isVisible)
-    : ModelComponent(renderPass, nullptr, {}, isVisible, false, 1.0f, 1.0f, {})
+    : ModelComponent(renderPass, nullptr, {}, isVisible, false, 0.0f, {}, false)
     , m_CellCount(cellCount)
     , m_CellSize(cellSize)
     , m_ColorMaterial(MaterialLibrary::GetMaterial("rootex/assets/materials/grid.rmat"))
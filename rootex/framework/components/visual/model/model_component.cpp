@@ -27,8 +27,8 @@ Ptr<Component> ModelComponent::Create(const JSON::json& componentData)
 	    componentData.value("isVisible", true),
 	    componentData.value("lodEnable", true),
 	    componentData.value("lodBias", 0.0f),
-	    componentData.value("lodDistance", 10.0f),
-	    componentData.value("affectingStaticLights", Vector<SceneID>()));
+	    componentData.value("affectingStaticLights", Vector<SceneID>()),
+	    componentData.value("isStaticLightingAutomatic", componentData.value("affectingStaticLights", Vector<SceneID>()).empty()));
 }
 
 ModelComponent::ModelComponent(
@@ -38,16 +38,16 @@ ModelComponent::ModelComponent(
     bool visibility,
     bool lodEnable,
     float lodBias,
-    float lodDistance,
-    const Vector<SceneID>& affectingStaticLightIDs)
+    const Vector<SceneID>& affectingStaticLightIDs,
+    bool isStaticLightingAutomatic)
     : RenderableComponent(
         renderPass,
         materialOverrides,
         visibility,
         lodEnable,
         lodBias,
-        lodDistance,
-        affectingStaticLightIDs)
+        affectingStaticLightIDs,
+        isStaticLightingAutomatic)
 {
 	assignOverrides(resFile, materialOverrides);
 }
@@ -70,20 +70,22 @@ void ModelComponent::render(float viewDistance)
 	ZoneNamedN(componentRender, "Model Render", true);
 	RenderableComponent::render(viewDistance);
 
-	std::sort(m_ModelResourceFile->getMeshes().begin(), m_ModelResourceFile->getMeshes().end(), CompareMaterials);
-	int i = 0;
-
-	RenderableComponent::render(viewDistance);
+	// Stable so every mesh keeps its LOD slot from frame to frame
+	std::stable_sort(m_ModelResourceFile->getMeshes().begin(), m_ModelResourceFile->getMeshes().end(), CompareMaterials);
+	int slot = 0;
 
 	for (auto& [material, meshes] : m_ModelResourceFile->getMeshes())
 	{
-		RenderSystem::GetSingleton()->getRenderer()->bind(m_MaterialOverrides.at(material).get());
-		i++;
+		Material* boundMaterial = m_MaterialOverrides.at(material).get();
+		RenderSystem::GetSingleton()->getRenderer()->bind(boundMaterial);
 
+		float screenSize = 0.0f;
 		for (auto& mesh : meshes)
 		{
-			RenderSystem::GetSingleton()->getRenderer()->draw(mesh.m_VertexBuffer.get(), mesh.getLOD(getLODFactor(viewDistance)).get());
+			RenderSystem::GetSingleton()->getRenderer()->draw(mesh.m_VertexBuffer.get(), getLOD(mesh, slot++, viewDistance).get());
+			screenSize = std::max(screenSize, getScreenSize(mesh.m_BoundingBox, viewDistance));
 		}
+		boundMaterial->requestTextures(screenSize);
 	}
 }
 
@@ -94,6 +96,7 @@ void ModelComponent::setModelResourceFile(Ref<ModelResourceFile> newModel, const
 		WARN("Tried to set a null model resource file.");
 		return;
 	}
+	m_MeshLODs.clear();
 	assignOverrides(newModel, materialOverrides);
 	assignBoundingBox();
 }
@@ -27,8 +27,8 @@ public:
 	    bool isVisible,
 	    bool lodEnable,
 	    float lodBias,
-	    float lodDistance,
-	    const Vector<SceneID>& affectingStaticLightIDs);
+	    const Vector<SceneID>& affectingStaticLightIDs,
+	    bool isStaticLightingAutomatic);
 	virtual ~ModelComponent() = default;
 
 	bool preRender(float deltaMilliseconds) override;
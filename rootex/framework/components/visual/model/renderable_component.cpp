@@ -3,6 +3,7 @@
 #include "components/visual/light/static_point_light_component.h"
 #include "system.h"
 #include "systems/render_system.h"
+#include "systems/light_system.h"
 #include "renderer/material_library.h"
 #include "scene_loader.h"
 
@@ -12,21 +13,43 @@ RenderableComponent::RenderableComponent(
     bool visibility,
     bool lodEnable,
     float lodBias,
-    float lodDistance,
-    const Vector<SceneID>& affectingStaticLightIDs)
+    const Vector<SceneID>& affectingStaticLightIDs,
+    bool isStaticLightingAutomatic)
     : m_RenderPass(renderPass)
     , m_IsVisible(visibility)
     , m_AffectingStaticLightIDs(affectingStaticLightIDs)
-    , m_LODDistance(lodDistance)
+    , m_IsStaticLightingAutomatic(isStaticLightingAutomatic)
     , m_LODBias(lodBias)
     , m_LODEnable(lodEnable)
     , m_DependencyOnTransformComponent(this)
 {
 }
 
-float RenderableComponent::getLODFactor(float viewDistance)
+Ref<IndexBuffer> RenderableComponent::getLOD(const Mesh& mesh, int slot, float viewDistance)
 {
-	return m_LODEnable ? m_LODBias + m_LODDistance / viewDistance : 1.0f;
+	if (slot >= m_MeshLODs.size())
+	{
+		m_MeshLODs.resize(slot + 1, 0);
+	}
+	if (!m_LODEnable)
+	{
+		m_MeshLODs[slot] = 0;
+		return mesh.getLOD(0);
+	}
+
+	const Vector3 scale = m_TransformComponent->getAbsoluteScale();
+	const float maxScale = std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+	const float errorScale = RenderSystem::GetSingleton()->getLODErrorScale() * maxScale / (std::max(viewDistance, 1e-3f) * std::exp2(m_LODBias));
+	m_MeshLODs[slot] = mesh.selectLOD(errorScale, RenderSystem::GetSingleton()->getLODErrorBudget(), m_MeshLODs[slot]);
+	return mesh.getLOD(m_MeshLODs[slot]);
+}
+
+float RenderableComponent::getScreenSize(const BoundingBox& box, float viewDistance)
+{
+	const Vector3 scale = m_TransformComponent->getAbsoluteScale();
+	const float maxScale = std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+	const float diameter = 2.0f * Vector3(box.Extents).Length() * maxScale;
+	return diameter * RenderSystem::GetSingleton()->getPixelsPerUnit() / std::max(viewDistance, 1e-3f);
 }
 
 bool RenderableComponent::setupData()
@@ -36,13 +59,7 @@ bool RenderableComponent::setupData()
 
 bool RenderableComponent::setupEntities()
 {
-	Vector<SceneID> affectingEntities = m_AffectingStaticLightIDs;
-	m_AffectingStaticLightIDs.clear();
-	m_AffectingStaticLights.clear();
-	for (auto& ID : affectingEntities)
-	{
-		addAffectingStaticLight(ID);
-	}
+	updateStaticLights();
 	return true;
 }
 
@@ -50,7 +67,12 @@ bool RenderableComponent::preRender(float deltaMilliseconds)
 {
 	if (m_TransformComponent)
 	{
-		RenderSystem::GetSingleton()->pushMatrixOverride(m_TransformComponent->getAbsoluteTransform());
+		const Matrix transform = m_TransformComponent->getAbsoluteTransform();
+		if (m_IsStaticLightingAutomatic && transform != m_StaticLightingTransform)
+		{
+			updateStaticLights();
+		}
+		RenderSystem::GetSingleton()->pushMatrixOverride(transform);
 	}
 	else
 	{
@@ -77,49 +99,78 @@ void RenderableComponent::postRender()
 
 bool RenderableComponent::addAffectingStaticLight(SceneID ID)
 {
+	if (m_AffectingStaticLightIDs.size() >= MAX_STATIC_POINT_LIGHTS_AFFECTING_1_OBJECT)
+	{
+		WARN("Static lights affecting 1 object are capped at " + std::to_string(MAX_STATIC_POINT_LIGHTS_AFFECTING_1_OBJECT));
+		return false;
+	}
+
 	Scene* light = SceneLoader::GetSingleton()->getCurrentScene()->findScene(ID);
-	if (!light->getEntity())
+	if (!light || !light->getEntity())
 	{
 		WARN("Static light entity referred to not found: " + std::to_string(ID));
-		{
-			return false;
-		};
+		return false;
 	}
-
-	int lightID = 0;
-	for (auto& component : ECSFactory::GetComponents<StaticPointLightComponent>())
+	if (!light->getEntity()->getComponent<StaticPointLightComponent>())
 	{
-		StaticPointLightComponent* staticLight = (StaticPointLightComponent*)component;
-		if (light->getEntity()->getComponent<StaticPointLightComponent>() == staticLight)
-		{
-			m_AffectingStaticLightIDs.push_back(ID);
-			m_AffectingStaticLights.push_back(lightID);
-			return true;
-		}
-		lightID++;
+		WARN("Provided static light scene does not have a static light: " + light->getFullName());
+		return false;
 	}
 
-	WARN("Provided static light scene does not have a static light: " + light->getFullName());
-	return false;
+	m_IsStaticLightingAutomatic = false;
+	m_AffectingStaticLightIDs.push_back(ID);
+	updateStaticLights();
+	return true;
 }
 
 void RenderableComponent::removeAffectingStaticLight(SceneID ID)
 {
-	for (int i = 0; i < m_AffectingStaticLightIDs.size(); i++)
+	auto eraseIt = std::find(m_AffectingStaticLightIDs.begin(), m_AffectingStaticLightIDs.end(), ID);
+	if (eraseIt != m_AffectingStaticLightIDs.end())
 	{
-		if (ID == m_AffectingStaticLightIDs[i])
+		m_IsStaticLightingAutomatic = false;
+		m_AffectingStaticLightIDs.erase(eraseIt);
+		updateStaticLights();
+	}
+}
+
+void RenderableComponent::updateStaticLights()
+{
+	LightSystem* lightSystem = LightSystem::GetSingleton();
+	if (m_IsStaticLightingAutomatic)
+	{
+		m_StaticLightingTransform = m_TransformComponent->getAbsoluteTransform();
+		const BoundingBox bounds = m_TransformComponent->getWorldSpaceBounds();
+		const Vector3 center = bounds.Center;
+		const Vector3 extents = bounds.Extents;
+		lightSystem->getStaticLightBVH().query(center - extents, center + extents, MAX_STATIC_POINT_LIGHTS_AFFECTING_1_OBJECT, m_AffectingStaticLights);
+
+		m_AffectingStaticLightIDs.clear();
+		for (int light : m_AffectingStaticLights)
 		{
-			auto& eraseIt = std::find(m_AffectingStaticLightIDs.begin(), m_AffectingStaticLightIDs.end(), ID);
-			m_AffectingStaticLightIDs.erase(eraseIt);
+			m_AffectingStaticLightIDs.push_back(lightSystem->getStaticLightID(light));
+		}
+		return;
+	}
 
-			int removeLightID = m_AffectingStaticLights[i];
-			auto& eraseLightIt = std::find(m_AffectingStaticLights.begin(), m_AffectingStaticLights.end(), removeLightID);
-			m_AffectingStaticLights.erase(eraseLightIt);
-			return;
+	// Lights that cannot be resolved yet are kept in the list so they are not lost when the scene is saved
+	m_AffectingStaticLights.clear();
+	for (auto& ID : m_AffectingStaticLightIDs)
+	{
+		int light = lightSystem->getStaticLightIndex(ID);
+		if (light != -1 && m_AffectingStaticLights.size() < MAX_STATIC_POINT_LIGHTS_AFFECTING_1_OBJECT)
+		{
+			m_AffectingStaticLights.push_back(light);
 		}
 	}
 }
 
+void RenderableComponent::setStaticLightingAutomatic(bool enabled)
+{
+	m_IsStaticLightingAutomatic = enabled;
+	updateStaticLights();
+}
+
 bool RenderableComponent::isVisible() const
 {
 	// TODO: Add culling
@@ -149,9 +200,9 @@ JSON::json RenderableComponent::getJSON() const
 		j["materialOverrides"][oldMaterial->getFileName()] = newMaterial->getFileName();
 	}
 	j["affectingStaticLights"] = m_AffectingStaticLightIDs;
+	j["isStaticLightingAutomatic"] = m_IsStaticLightingAutomatic;
 
 	j["lodBias"] = m_LODBias;
-	j["lodDistance"] = m_LODDistance;
 	j["lodEnable"] = m_LODEnable;
 
 	return j;
@@ -170,18 +221,31 @@ void RenderableComponent::draw()
 	{
 		ImGui::Indent();
 		ImGui::DragFloat("LOD Bias", &m_LODBias, 0.01f);
-		ImGui::DragFloat("LOD Distance", &m_LODDistance, 1.0f, 0.0f);
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::SetTooltip("Each step of 1 doubles the error allowed before switching to a coarser LOD");
+		}
 		ImGui::Unindent();
 	}
 
 	if (ImGui::TreeNodeEx("Static Lights"))
 	{
 		ImGui::Indent();
+		bool isAutomatic = m_IsStaticLightingAutomatic;
+		if (ImGui::Checkbox("Automatic", &isAutomatic))
+		{
+			setStaticLightingAutomatic(isAutomatic);
+		}
+
 		int slot = 0;
 		EntityID toRemove = -1;
 		for (auto& slotSceneID : m_AffectingStaticLightIDs)
 		{
 			Scene* staticLight = SceneLoader::GetSingleton()->getCurrentScene()->findScene(slotSceneID);
+			if (!staticLight || !staticLight->getEntity())
+			{
+				continue;
+			}
 			RenderSystem::GetSingleton()->submitLine(m_TransformComponent->getAbsoluteTransform().Translation(), staticLight->getEntity()->getComponent<TransformComponent>()->getAbsoluteTransform().Translation());
 
 			String displayName = staticLight->getFullName();
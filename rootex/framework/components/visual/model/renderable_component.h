@@ -3,6 +3,7 @@
 #include "component.h"
 #include "components/space/transform_component.h"
 #include "renderer/material.h"
+#include "renderer/mesh.h"
 #include "scene.h"
 
 class RenderableComponent : public Component
@@ -15,12 +16,20 @@ protected:
 	unsigned int m_RenderPass;
 
 	bool m_LODEnable;
+	/// Added to the global LOD bias. Every step of 1 doubles the error allowed for this renderable.
 	float m_LODBias;
-	float m_LODDistance;
+	/// LOD picked last frame for each mesh drawn, in drawing order
+	Vector<int> m_MeshLODs;
 
 	HashMap<Ref<Material>, Ref<Material>> m_MaterialOverrides;
+	/// Static light scenes lighting this renderable, picked by hand or assigned automatically
 	Vector<SceneID> m_AffectingStaticLightIDs;
+	/// Indices of m_AffectingStaticLightIDs in the static light buffer
 	Vector<int> m_AffectingStaticLights;
+	/// Assign the strongest static lights overlapping the bounds instead of using a hand picked list
+	bool m_IsStaticLightingAutomatic;
+	/// Transform the automatic static lights were assigned at. Moving away from it assigns them again.
+	Matrix m_StaticLightingTransform;
 
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_PerModelCB;
 
@@ -30,11 +39,14 @@ protected:
 	    bool visibility,
 	    bool lodEnable,
 	    float lodBias,
-	    float lodDistance,
-	    const Vector<SceneID>& affectingStaticLightIDs);
+	    const Vector<SceneID>& affectingStaticLightIDs,
+	    bool isStaticLightingAutomatic);
 	RenderableComponent(RenderableComponent&) = delete;
 
-	float getLODFactor(float viewDistance);
+	/// Index buffer for the slot-th mesh drawn, at the coarsest LOD whose error on screen fits the budget set in RenderSystem
+	Ref<IndexBuffer> getLOD(const Mesh& mesh, int slot, float viewDistance);
+	/// Pixels spanned on screen by a bounding box in model space, for requesting texture mips
+	float getScreenSize(const BoundingBox& box, float viewDistance);
 
 public:
 	virtual ~RenderableComponent() = default;
@@ -48,6 +60,11 @@ public:
 
 	virtual bool addAffectingStaticLight(SceneID id);
 	virtual void removeAffectingStaticLight(SceneID id);
+	/// Resolve the static lights reaching this renderable against the static lights currently set up in LightSystem
+	void updateStaticLights();
+
+	void setStaticLightingAutomatic(bool enabled);
+	bool isStaticLightingAutomatic() const { return m_IsStaticLightingAutomatic; }
 
 	void setMaterialOverride(Ref<Material> oldMaterial, Ref<Material> newMaterial);
 
@@ -71,23 +71,22 @@ bool ECSFactory::AddComponent(Entity* entity, Ptr<Component>& component)
 	return false;
 }
 
-Ptr<Component> ECSFactory::CreateComponent(const String& componentName, const JSON::json& componentData)
+Ptr<Component> ECSFactory::ConstructComponent(const String& componentName, const JSON::json& componentData)
 {
-	auto& findIt = s_ComponentCreators.end();
-	for (auto& componentClass = s_ComponentCreators.begin(); componentClass != s_ComponentCreators.end(); componentClass++)
+	auto findIt = s_ComponentCreatorTable.find(componentName);
+	if (findIt != s_ComponentCreatorTable.end())
 	{
-		if (std::get<String>(*componentClass) == componentName)
-		{
-			findIt = componentClass;
-		}
+		ComponentCreator create = findIt->second.first;
+		return create(componentData);
 	}
-	if (findIt != s_ComponentCreators.end())
-	{
-		ComponentCreator create = std::get<ComponentCreator>(*findIt);
-		Ptr<Component> component(std::move(create(componentData)));
+	return nullptr;
+}
 
+Ptr<Component> ECSFactory::CreateComponent(const String& componentName, const JSON::json& componentData)
+{
+	if (Ptr<Component> component = ConstructComponent(componentName, componentData))
+	{
 		RegisterComponentInstance(component.get());
-
 		return component;
 	}
 	ERR("Could not find component creator: " + componentName);
@@ -99,44 +98,88 @@ Ptr<Component> ECSFactory::CreateDefaultComponent(const String& componentName)
 	return CreateComponent(componentName, JSON::json::object());
 }
 
-Ptr<Entity> ECSFactory::CreateEntity(Scene* scene, const JSON::json& entityJSON)
+PreparedEntity ECSFactory::PrepareEntity(const JSON::json& entityJSON)
 {
+	PreparedEntity preparedEntity;
 	if (entityJSON.empty())
 	{
-		return std::make_unique<Entity>(scene);
+		return preparedEntity;
+	}
+	preparedEntity.isEmpty = false;
+
+	if (entityJSON.contains("Entity") && entityJSON.at("Entity").contains("script"))
+	{
+		preparedEntity.scriptJSON = entityJSON.at("Entity").at("script");
 	}
 
-	JSON::json componentJSON;
 	if (entityJSON.contains("components"))
 	{
-		componentJSON = entityJSON["components"];
+		for (auto&& [componentName, componentDescription] : entityJSON.at("components").items())
+		{
+			auto findIt = s_ComponentCreatorTable.find(componentName);
+			if (findIt == s_ComponentCreatorTable.end())
+			{
+				preparedEntity.unknownComponents.push_back(componentName);
+				continue;
+			}
+
+			auto& [create, isThreadSafe] = findIt->second;
+			if (isThreadSafe)
+			{
+				preparedEntity.components.push_back(create(componentDescription));
+			}
+			else
+			{
+				preparedEntity.deferredComponents.push_back({ componentName, &componentDescription });
+			}
+		}
+	}
+
+	return preparedEntity;
+}
+
+Ptr<Entity> ECSFactory::FinalizeEntity(Scene* scene, PreparedEntity& preparedEntity)
+{
+	if (preparedEntity.isEmpty)
+	{
+		return std::make_unique<Entity>(scene);
 	}
-	JSON::json scriptJSON = {};
-	if (entityJSON.contains("Entity") && entityJSON["Entity"].contains("script"))
+
+	Ptr<Entity> entity(std::make_unique<Entity>(scene, preparedEntity.scriptJSON));
+
+	for (auto& componentName : preparedEntity.unknownComponents)
+	{
+		ERR("Could not find component creator: " + componentName);
+	}
+	for (auto& [componentName, componentDescription] : preparedEntity.deferredComponents)
 	{
-		scriptJSON = entityJSON["Entity"]["script"];
+		preparedEntity.components.push_back(ConstructComponent(componentName, *componentDescription));
 	}
-	Ptr<Entity> entity(std::make_unique<Entity>(scene, scriptJSON));
+	preparedEntity.deferredComponents.clear();
 
-	for (auto&& [componentName, componentDescription] : componentJSON.items())
+	for (auto& component : preparedEntity.components)
 	{
-		Ptr<Component>& componentObject = CreateComponent(componentName, componentDescription);
-		if (componentObject)
-		{
-			componentObject->m_Owner = entity.get();
-			entity->m_Components[componentObject->getComponentID()] = std::move(componentObject);
-		}
+		RegisterComponentInstance(component.get());
+		component->m_Owner = entity.get();
+		entity->m_Components[component->getComponentID()] = std::move(component);
 	}
+	preparedEntity.components.clear();
 
 	if (!entity->onAllComponentsAdded())
 	{
 		ERR("Entity scene was not setup properly: " + std::to_string(scene->getID()));
 	}
 
-	PRINT("Created entity: " + entity->getFullName());
+	TRACE("Created entity: " + entity->getFullName());
 	return entity;
 }
 
+Ptr<Entity> ECSFactory::CreateEntity(Scene* scene, const JSON::json& entityJSON)
+{
+	PreparedEntity preparedEntity = PrepareEntity(entityJSON);
+	return FinalizeEntity(scene, preparedEntity);
+}
+
 Ptr<Entity> ECSFactory::CreateEmptyEntity(Scene* scene)
 {
 	return CreateEntity(scene, {});
@@ -174,9 +217,9 @@ void ECSFactory::Initialize()
 	REGISTER_COMPONENT(MusicComponent);
 	REGISTER_COMPONENT(ShortMusicComponent);
 	REGISTER_COMPONENT(CPUParticlesComponent);
-	REGISTER_COMPONENT(UIComponent);
+	REGISTER_MAIN_THREAD_COMPONENT(UIComponent);
 	REGISTER_COMPONENT(AnimatedModelComponent);
-	REGISTER_COMPONENT(ParticleEffectComponent);
+	REGISTER_MAIN_THREAD_COMPONENT(ParticleEffectComponent);
 	REGISTER_COMPONENT(TriggerComponent);
 }
 
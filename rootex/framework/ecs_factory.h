@@ -10,14 +10,30 @@
 typedef Ptr<Component> (*ComponentCreator)(const JSON::json& componentDescription);
 /// Collection of a component, its name, and a function that constructs that component.
 typedef Vector<Tuple<ComponentID, String, ComponentCreator>> ComponentDatabase;
+/// Component creators hashed by component name, along with whether they can be called from worker threads.
+typedef HashMap<String, Pair<ComponentCreator, bool>> ComponentCreatorTable;
 /// Collection of all components active inside the scene.
 typedef HashMap<ComponentID, Vector<Component*>> ComponentInstanceDatabase;
 
-#define REGISTER_COMPONENT(ComponentType) ECSFactory::RegisterComponent<ComponentType>(#ComponentType)
+#define REGISTER_COMPONENT(ComponentType) ECSFactory::RegisterComponent<ComponentType>(#ComponentType, true)
+/// Register a component whose creator touches state that is only safe to use on the main thread.
+#define REGISTER_MAIN_THREAD_COMPONENT(ComponentType) ECSFactory::RegisterComponent<ComponentType>(#ComponentType, false)
+
+/// Entity data constructed ahead of time that is yet to be attached to a scene on the main thread.
+struct PreparedEntity
+{
+	JSON::json scriptJSON;
+	Vector<Ptr<Component>> components;
+	/// Components whose creators need to be called on the main thread. Points into the source entity JSON.
+	Vector<Pair<String, const JSON::json*>> deferredComponents;
+	Vector<String> unknownComponents;
+	bool isEmpty = true;
+};
 
 class ECSFactory
 {
 	static inline ComponentDatabase s_ComponentCreators;
+	static inline ComponentCreatorTable s_ComponentCreatorTable;
 	static inline ComponentInstanceDatabase s_ComponentInstances;
 
 public:
@@ -29,6 +45,13 @@ public:
 	static bool AddComponent(Entity* entity, Ptr<Component>& component);
 	static Ptr<Component> CreateComponent(const String& componentName, const JSON::json& componentData);
 	static Ptr<Component> CreateDefaultComponent(const String& componentName);
+	/// Construct a component without registering it. Returns nullptr if the creator was not found.
+	static Ptr<Component> ConstructComponent(const String& componentName, const JSON::json& componentData);
+
+	/// Construct all components of an entity that are safe to construct off the main thread. Safe to call from worker threads.
+	static PreparedEntity PrepareEntity(const JSON::json& entityJSON);
+	/// Attach, register and set up the prepared components of an entity. Call only on the main thread.
+	static Ptr<Entity> FinalizeEntity(Scene* scene, PreparedEntity& preparedEntity);
 
 	static Ptr<Entity> CreateEntity(Scene* scene, const JSON::json& entityJSON);
 	static Ptr<Entity> CreateEntityFromFile(Scene* scene, TextResourceFile* textResourceFile);
@@ -38,7 +61,7 @@ public:
 
 	static const ComponentDatabase& GetComponentDatabase() { return s_ComponentCreators; }
 	template <class T>
-	static void RegisterComponent(const String& name);
+	static void RegisterComponent(const String& name, bool isThreadSafe);
 	static void RegisterComponentInstance(Component* component);
 	static void DeregisterComponentInstance(Component* component);
 };
@@ -50,7 +73,8 @@ inline Vector<Component*>& ECSFactory::GetComponents()
 }
 
 template <class T>
-inline void ECSFactory::RegisterComponent(const String& name)
+inline void ECSFactory::RegisterComponent(const String& name, bool isThreadSafe)
 {
 	s_ComponentCreators.push_back({ T::s_ID, name, T::Create });
+	s_ComponentCreatorTable[name] = { T::Create, isThreadSafe };
 }
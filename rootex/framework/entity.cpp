@@ -5,6 +5,8 @@
 #include "framework/component.h"
 #include "framework/system.h"
 #include "framework/systems/script_system.h"
+#include "framework/systems/spatial_system.h"
+#include "framework/components/space/transform_component.h"
 #include "script/script.h"
 #include "resource_loader.h"
 
@@ -85,7 +87,7 @@ bool Entity::onAllEntitiesAdded()
 
 void Entity::destroy()
 {
-	call("destroy", { this });
+	invoke("destroy", this);
 
 	for (auto& component : m_Components)
 	{
@@ -128,6 +130,12 @@ bool Entity::removeComponent(ComponentID toRemoveComponentID, bool hardRemove)
 	ECSFactory::DeregisterComponentInstance(toRemoveComponent);
 	m_Components.erase(toRemoveComponent->getComponentID());
 
+	// The entity no longer shows up in spatial queries for the removed component
+	if (TransformComponent* transform = getComponent<TransformComponent>())
+	{
+		SpatialSystem::GetSingleton()->addTransform(transform);
+	}
+
 	return true;
 }
 
@@ -2,11 +2,11 @@
 
 #include "common/common.h"
 #include "script/interpreter.h"
+#include "script/script.h"
 #include "event.h"
 
 class Component;
 class Scene;
-class Script;
 
 typedef unsigned int ComponentID;
 typedef int EntityID;
@@ -51,6 +51,9 @@ public:
 	const HashMap<ComponentID, Ptr<Component>>& getAllComponents() const;
 
 	bool call(const String& function, const Vector<Variant>& args);
+	/// Call a script function with the arguments passed straight to Lua.
+	template <typename... Args>
+	bool invoke(const String& function, Args&&... args);
 	void evaluateScriptOverrides();
 	bool setScript(const String& path);
 	Script* getScript() const { return m_Script.get(); }
@@ -58,6 +61,21 @@ public:
 	void draw();
 };
 
+template <typename... Args>
+inline bool Entity::invoke(const String& function, Args&&... args)
+{
+	bool status = false;
+	if (m_Script)
+	{
+		status = m_Script->invoke(function, std::forward<Args>(args)...);
+		if (!status)
+		{
+			WARN("Script error (" + getFullName() + ")");
+		}
+	}
+	return status;
+}
+
 template <class ComponentType>
 inline ComponentType* Entity::getComponent()
 {
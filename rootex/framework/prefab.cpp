@@ -0,0 +1,219 @@
+#include "prefab.h"
+
+#include "resource_loader.h"
+#include "scene.h"
+
+/// Smallest JSON merge patch that turns source into target
+static JSON::json CreateMergePatch(const JSON::json& source, const JSON::json& target)
+{
+	if (!source.is_object() || !target.is_object())
+	{
+		return target;
+	}
+
+	JSON::json patch = JSON::json::object();
+	for (auto&& [key, value] : source.items())
+	{
+		if (!target.contains(key))
+		{
+			patch[key] = nullptr;
+		}
+	}
+	for (auto&& [key, value] : target.items())
+	{
+		if (!source.contains(key))
+		{
+			patch[key] = value;
+		}
+		else if (source[key] != value)
+		{
+			patch[key] = CreateMergePatch(source[key], value);
+		}
+	}
+	return patch;
+}
+
+/// Removes what differs between instances of the same prefab even when nothing was edited, here and in every child scene
+static JSON::json StripInstanceKeys(JSON::json sceneJSON, bool isRoot = true)
+{
+	sceneJSON.erase("ID");
+	sceneJSON.erase("overrides");
+	if (isRoot)
+	{
+		sceneJSON.erase("importStyle");
+		sceneJSON.erase("sceneFile");
+	}
+	if (sceneJSON.contains("children"))
+	{
+		for (auto& child : sceneJSON["children"])
+		{
+			child = StripInstanceKeys(child, false);
+		}
+	}
+	return sceneJSON;
+}
+
+/// Merge patch of a scene, except that children are patched one by one by their index in the template.
+/// A null child removes the template child, a child past the end of the template is added.
+static JSON::json CreateSceneOverrides(const JSON::json& source, const JSON::json& target)
+{
+	JSON::json sourceScene = source;
+	JSON::json targetScene = target;
+	sourceScene.erase("children");
+	targetScene.erase("children");
+	JSON::json overrides = CreateMergePatch(sourceScene, targetScene);
+
+	const JSON::json& sourceChildren = source.value("children", JSON::json::array());
+	const JSON::json& targetChildren = target.value("children", JSON::json::array());
+	JSON::json childrenOverrides = JSON::json::object();
+	for (size_t i = 0; i < std::max(sourceChildren.size(), targetChildren.size()); i++)
+	{
+		if (i >= targetChildren.size())
+		{
+			childrenOverrides[std::to_string(i)] = nullptr;
+		}
+		else if (i >= sourceChildren.size())
+		{
+			childrenOverrides[std::to_string(i)] = targetChildren[i];
+		}
+		else
+		{
+			JSON::json childOverrides = CreateSceneOverrides(sourceChildren[i], targetChildren[i]);
+			if (!childOverrides.empty())
+			{
+				childrenOverrides[std::to_string(i)] = childOverrides;
+			}
+		}
+	}
+	if (!childrenOverrides.empty())
+	{
+		overrides["children"] = childrenOverrides;
+	}
+	return overrides;
+}
+
+static void ApplySceneOverrides(JSON::json& scene, const JSON::json& overrides)
+{
+	JSON::json sceneOverrides = overrides;
+	sceneOverrides.erase("children");
+	scene.merge_patch(sceneOverrides);
+	if (!overrides.contains("children"))
+	{
+		return;
+	}
+
+	JSON::json& children = scene["children"];
+	if (!children.is_array())
+	{
+		children = JSON::json::array();
+	}
+	const size_t templateCount = children.size();
+	Vector<size_t> removed;
+	Map<size_t, JSON::json> added;
+	for (auto&& [key, childOverrides] : overrides["children"].items())
+	{
+		const size_t index = std::stoul(key);
+		if (index >= templateCount)
+		{
+			if (!childOverrides.is_null())
+			{
+				added[index] = childOverrides;
+			}
+		}
+		else if (childOverrides.is_null())
+		{
+			removed.push_back(index);
+		}
+		else
+		{
+			ApplySceneOverrides(children[index], childOverrides);
+		}
+	}
+
+	for (auto& [index, child] : added)
+	{
+		children.push_back(child);
+	}
+	std::sort(removed.begin(), removed.end(), std::greater<size_t>());
+	for (auto& index : removed)
+	{
+		children.erase(children.begin() + index);
+	}
+}
+
+Ref<Prefab> Prefab::Load(const String& sceneFile)
+{
+	std::lock_guard<RecursiveMutex> lock(s_PrefabsMutex);
+
+	auto findIt = s_Prefabs.find(sceneFile);
+	if (findIt != s_Prefabs.end())
+	{
+		if (Ref<Prefab> prefab = findIt->second.lock())
+		{
+			if (!prefab->isStale())
+			{
+				return prefab;
+			}
+		}
+	}
+
+	Ref<TextResourceFile> t = ResourceLoader::CreateTextResourceFile(sceneFile);
+	if (!t)
+	{
+		return nullptr;
+	}
+	if (t->isDirty())
+	{
+		t->reimport();
+	}
+
+	Ref<Prefab> prefab = std::make_shared<Prefab>(t);
+	s_Prefabs[sceneFile] = prefab;
+	PRINT("Compiled prefab: " + sceneFile);
+	return prefab;
+}
+
+Prefab::Prefab(Ref<TextResourceFile> sceneFile)
+    : m_SceneFile(sceneFile)
+    , m_CompiledTime(sceneFile->getLastReadTime())
+    , m_SceneJSON(JSON::json::parse(sceneFile->getString()))
+{
+	m_SceneJSON["importStyle"] = (int)Scene::ImportStyle::External;
+	m_SceneJSON["sceneFile"] = getScenePath();
+	m_SceneJSON.erase("overrides");
+}
+
+Ptr<Scene> Prefab::instantiate(const JSON::json& overrides, bool isACopy)
+{
+	Ptr<Scene> scene;
+	if (overrides.empty())
+	{
+		scene = Scene::Create(m_SceneJSON, isACopy);
+	}
+	else
+	{
+		scene = Scene::Create(getPatchedJSON(overrides), isACopy);
+	}
+	scene->setPrefab(shared_from_this(), overrides);
+	return scene;
+}
+
+bool Prefab::isStale()
+{
+	return m_CompiledTime < m_SceneFile->getLastReadTime() || m_SceneFile->isDirty();
+}
+
+JSON::json Prefab::getOverrides(const JSON::json& instanceJSON) const
+{
+	return CreateSceneOverrides(StripInstanceKeys(m_SceneJSON), StripInstanceKeys(instanceJSON));
+}
+
+JSON::json Prefab::getPatchedJSON(const JSON::json& overrides) const
+{
+	JSON::json patchedJSON = m_SceneJSON;
+	if (overrides.is_object())
+	{
+		ApplySceneOverrides(patchedJSON, overrides);
+	}
+	return patchedJSON;
+}
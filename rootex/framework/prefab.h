@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common/common.h"
+#include "core/resource_files/text_resource_file.h"
+
+class Scene;
+
+/// Immutable scene template compiled once from a scene file.
+/// Instances share the compiled template and only store the overrides applied over it.
+class Prefab : public std::enable_shared_from_this<Prefab>
+{
+	static inline HashMap<String, Weak<Prefab>> s_Prefabs;
+	static inline RecursiveMutex s_PrefabsMutex;
+
+	Ref<TextResourceFile> m_SceneFile;
+	FileTimePoint m_CompiledTime;
+	JSON::json m_SceneJSON;
+
+public:
+	/// Get the prefab compiled from a scene file. Recompiles only if the scene file has changed on disk since the last compile.
+	static Ref<Prefab> Load(const String& sceneFile);
+
+	Prefab(Ref<TextResourceFile> sceneFile);
+	Prefab(const Prefab&) = delete;
+	~Prefab() = default;
+
+	/// Stamp out a new scene from the template with overrides from getOverrides applied over the template scene data.
+	Ptr<Scene> instantiate(const JSON::json& overrides = {}, bool isACopy = true);
+
+	/// If the scene file has been changed or reimported since this prefab was compiled.
+	bool isStale();
+	/// Merge patch that turns the template into the scene data of an instance, leaving out what only identifies the instance and its child scenes.
+	JSON::json getOverrides(const JSON::json& instanceJSON) const;
+	/// The template scene data with overrides applied. Child scenes are patched by their index in the template.
+	JSON::json getPatchedJSON(const JSON::json& overrides) const;
+
+	const JSON::json& getJSON() const { return m_SceneJSON; }
+	String getScenePath() const { return m_SceneFile->getPath().generic_string(); }
+};
@@ -3,6 +3,13 @@
 #include "ecs_factory.h"
 #include "resource_loader.h"
 #include "scene_loader.h"
+#include "prefab.h"
+#include "app/application.h"
+
+#include "Tracy/Tracy.hpp"
+
+/// Entities prepared by one worker task when instantiating a scene subtree.
+#define ENTITIES_PER_PREPARE_TASK 16
 
 static SceneID NextSceneID = ROOT_SCENE_ID + 1;
 Vector<Scene*> Scene::s_Scenes;
@@ -47,7 +54,62 @@ void Scene::ResetNextID()
 	NextSceneID = ROOT_SCENE_ID + 1;
 }
 
+void CollectEntityJSONs(const JSON::json& sceneData, Vector<const JSON::json*>& entityJSONs)
+{
+	if (sceneData.contains("entity"))
+	{
+		entityJSONs.push_back(&sceneData.at("entity"));
+	}
+	if (sceneData.contains("children"))
+	{
+		for (auto& childScene : sceneData.at("children"))
+		{
+			CollectEntityJSONs(childScene, entityJSONs);
+		}
+	}
+}
+
+Vector<PreparedEntity> Scene::PrepareSubtree(const JSON::json& sceneData)
+{
+	ZoneScoped;
+
+	Vector<const JSON::json*> entityJSONs;
+	CollectEntityJSONs(sceneData, entityJSONs);
+
+	Vector<PreparedEntity> preparedEntities(entityJSONs.size());
+	Application* application = Application::GetSingleton();
+	if (!application || entityJSONs.size() <= ENTITIES_PER_PREPARE_TASK)
+	{
+		for (int i = 0; i < entityJSONs.size(); i++)
+		{
+			preparedEntities[i] = ECSFactory::PrepareEntity(*entityJSONs[i]);
+		}
+		return preparedEntities;
+	}
+
+	Vector<Ref<Task>> tasks;
+	for (int begin = 0; begin < entityJSONs.size(); begin += ENTITIES_PER_PREPARE_TASK)
+	{
+		int end = std::min(begin + ENTITIES_PER_PREPARE_TASK, (int)entityJSONs.size());
+		tasks.push_back(std::make_shared<Task>([&entityJSONs, &preparedEntities, begin, end]() {
+			for (int i = begin; i < end; i++)
+			{
+				preparedEntities[i] = ECSFactory::PrepareEntity(*entityJSONs[i]);
+			}
+		}));
+	}
+	application->getThreadPool().execute(tasks);
+	return preparedEntities;
+}
+
 Ptr<Scene> Scene::Create(const JSON::json& sceneData, bool isACopy)
+{
+	Vector<PreparedEntity> preparedEntities = PrepareSubtree(sceneData);
+	PreparedEntity* nextPreparedEntity = preparedEntities.data();
+	return CreateFromPrepared(sceneData, isACopy, nextPreparedEntity);
+}
+
+Ptr<Scene> Scene::CreateFromPrepared(const JSON::json& sceneData, bool isACopy, PreparedEntity*& nextPreparedEntity)
 {
 	// Decide ID
 	SceneID thisSceneID;
@@ -81,37 +143,45 @@ Ptr<Scene> Scene::Create(const JSON::json& sceneData, bool isACopy)
 	    sceneData.value("settings", SceneSettings()),
 	    sceneData.value("importStyle", ImportStyle::Local),
 	    sceneData.value("sceneFile", "")));
+	if (thisScene->m_ImportStyle == ImportStyle::External)
+	{
+		thisScene->m_PrefabOverrides = sceneData.value("overrides", JSON::json());
+		thisScene->m_Prefab = Prefab::Load(thisScene->m_SceneFile);
+	}
 
-	// Make entity and children scenes
+	// Attach the prepared entity and make children scenes
 	if (sceneData.contains("entity"))
 	{
-		thisScene->m_Entity = ECSFactory::CreateEntity(thisScene.get(), sceneData["entity"]);
+		thisScene->m_Entity = ECSFactory::FinalizeEntity(thisScene.get(), *nextPreparedEntity++);
 	}
+	thisScene->addChildrenFromPrepared(sceneData, nextPreparedEntity);
+	return thisScene;
+}
+
+void Scene::addChildrenFromPrepared(const JSON::json& sceneData, PreparedEntity*& nextPreparedEntity)
+{
 	if (sceneData.contains("children"))
 	{
 		for (auto& childScene : sceneData["children"])
 		{
-			if (!thisScene->addChild(Create(childScene)))
+			if (!addChild(CreateFromPrepared(childScene, false, nextPreparedEntity)))
 			{
-				WARN("Could not add child scene to " + thisScene->getName() + " scene");
+				WARN("Could not add child scene to " + getName() + " scene");
 			}
 		}
 	}
-	return thisScene;
 }
 
 Ptr<Scene> Scene::CreateFromFile(const String& sceneFile)
 {
-	if (Ref<TextResourceFile> t = ResourceLoader::CreateTextResourceFile(sceneFile))
+	return CreateFromFileWithOverrides(sceneFile, {});
+}
+
+Ptr<Scene> Scene::CreateFromFileWithOverrides(const String& sceneFile, const JSON::json& overrides)
+{
+	if (Ref<Prefab> prefab = Prefab::Load(sceneFile))
 	{
-		if (t->isDirty())
-		{
-			t->reimport();
-		}
-		JSON::json importedScene = JSON::json::parse(t->getString());
-		importedScene["importStyle"] = ImportStyle::External;
-		importedScene["sceneFile"] = sceneFile;
-		return Create(importedScene);
+		return prefab->instantiate(overrides, false);
 	}
 	return nullptr;
 }
@@ -202,13 +272,25 @@ void Scene::reimport()
 		return;
 	}
 
-	Ref<TextResourceFile> t = ResourceLoader::CreateTextResourceFile(m_SceneFile);
-	t->reimport();
+	// Keep the edits made to this instance against the template it was stamped out from
+	if (m_Prefab)
+	{
+		m_PrefabOverrides = m_Prefab->getOverrides(getJSON());
+	}
+	m_Prefab = Prefab::Load(m_SceneFile);
+	if (!m_Prefab)
+	{
+		WARN("Could not reimport scene file: " + m_SceneFile);
+		return;
+	}
 
-	const JSON::json& sceneData = JSON::json::parse(t->getString());
+	// Reapply this instance's overrides over the fresh template
+	JSON::json sceneData = m_Prefab->getPatchedJSON(m_PrefabOverrides);
+	Vector<PreparedEntity> preparedEntities = PrepareSubtree(sceneData);
+	PreparedEntity* nextPreparedEntity = preparedEntities.data();
 	if (sceneData.contains("entity"))
 	{
-		setEntity(ECSFactory::CreateEntity(this, sceneData["entity"]));
+		setEntity(ECSFactory::FinalizeEntity(this, *nextPreparedEntity++));
 	}
 	else
 	{
@@ -216,16 +298,7 @@ void Scene::reimport()
 	}
 
 	m_ChildrenScenes.clear();
-	if (sceneData.contains("children"))
-	{
-		for (auto& childScene : sceneData["children"])
-		{
-			if (!addChild(Create(childScene)))
-			{
-				WARN("Could not add child scene to " + getName() + " scene");
-			}
-		}
-	}
+	addChildrenFromPrepared(sceneData, nextPreparedEntity);
 }
 
 void Scene::onLoad()
@@ -304,6 +377,12 @@ bool Scene::removeChild(Scene* toRemove)
 	return false;
 }
 
+void Scene::setPrefab(Ref<Prefab> prefab, const JSON::json& overrides)
+{
+	m_Prefab = prefab;
+	m_PrefabOverrides = overrides;
+}
+
 void Scene::setName(const String& name)
 {
 	m_Name = name;
@@ -331,6 +410,12 @@ JSON::json Scene::getJSON() const
 		j["children"].push_back(child->getJSON());
 	}
 
+	if (m_ImportStyle == ImportStyle::External)
+	{
+		// Edits made since instantiating become overrides of the template
+		j["overrides"] = m_Prefab ? m_Prefab->getOverrides(j) : m_PrefabOverrides;
+	}
+
 	return j;
 }
 
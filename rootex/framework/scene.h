@@ -8,6 +8,9 @@ typedef unsigned int SceneID;
 
 #define ROOT_SCENE_ID 1
 
+struct PreparedEntity;
+class Prefab;
+
 struct SceneSettings
 {
 	ResourceCollection preloads;
@@ -44,6 +47,10 @@ private:
 	ImportStyle m_ImportStyle;
 	/// Contains the current file name if local, else contains the linked scene file
 	String m_SceneFile;
+	/// Template this scene was stamped out from, if externally imported.
+	Ref<Prefab> m_Prefab;
+	/// Merge patch applied over the prefab template for this instance.
+	JSON::json m_PrefabOverrides;
 	Ptr<Entity> m_Entity;
 	SceneSettings m_Settings;
 
@@ -52,11 +59,17 @@ private:
 
 	bool checkCycle(Scene* child);
 
+	/// Prepare all entities of a scene subtree in parallel, in the order CreateFromPrepared consumes them.
+	static Vector<PreparedEntity> PrepareSubtree(const JSON::json& sceneData);
+	static Ptr<Scene> CreateFromPrepared(const JSON::json& sceneData, bool isACopy, PreparedEntity*& nextPreparedEntity);
+	void addChildrenFromPrepared(const JSON::json& sceneData, PreparedEntity*& nextPreparedEntity);
+
 public:
 	static void ResetNextID();
 
 	static Ptr<Scene> Create(const JSON::json& sceneData, bool isACopy = false);
 	static Ptr<Scene> CreateFromFile(const String& sceneFile);
+	static Ptr<Scene> CreateFromFileWithOverrides(const String& sceneFile, const JSON::json& overrides);
 	static Ptr<Scene> CreateEmpty();
 	static Ptr<Scene> CreateEmptyAtPath(const String& sceneFile);
 	static Ptr<Scene> CreateEmptyWithEntity();
@@ -78,6 +91,7 @@ public:
 	bool removeChild(Scene* toRemove);
 
 	void setEntity(Ptr<Entity>& entity) { m_Entity = std::move(entity); }
+	void setPrefab(Ref<Prefab> prefab, const JSON::json& overrides);
 	void setName(const String& name);
 
 	JSON::json getJSON() const;
@@ -85,6 +99,8 @@ public:
 	SceneID getID() const { return m_ID; }
 	ImportStyle getImportStyle() const { return m_ImportStyle; }
 	String getScenePath() const { return m_SceneFile; }
+	Prefab* getPrefab() const { return m_Prefab.get(); }
+	const JSON::json& getPrefabOverrides() const { return m_PrefabOverrides; }
 	Scene* getParent() const { return m_ParentScene; }
 	Entity* getEntity() const { return m_Entity.get(); }
 	const String& getName() const { return m_Name; }
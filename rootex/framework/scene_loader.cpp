@@ -9,6 +9,7 @@ SceneLoader::SceneLoader()
     : m_RootScene(Scene::CreateRootScene())
 {
 	BIND_EVENT_MEMBER_FUNCTION(RootexEvents::DeleteScene, deleteScene);
+	BIND_EVENT_MEMBER_FUNCTION(RootexEvents::FilesChanged, reimportChangedScenes);
 }
 
 SceneLoader* SceneLoader::GetSingleton()
@@ -50,6 +51,41 @@ Variant SceneLoader::deleteScene(const Event* event)
 	return true;
 }
 
+Variant SceneLoader::reimportChangedScenes(const Event* event)
+{
+	const Vector<String>& changedFiles = Extract<Vector<String>>(event->getData());
+
+	Vector<Scene*> changedScenes;
+	for (auto& scene : Scene::FindAllScenes())
+	{
+		if (scene->getImportStyle() == Scene::ImportStyle::External && std::find(changedFiles.begin(), changedFiles.end(), scene->getScenePath()) != changedFiles.end())
+		{
+			changedScenes.push_back(scene);
+		}
+	}
+
+	// Only reimport the topmost changed scenes because reimporting a scene recreates all of its children
+	for (auto& scene : changedScenes)
+	{
+		bool isUnderChangedScene = false;
+		for (Scene* parent = scene->getParent(); parent; parent = parent->getParent())
+		{
+			if (std::find(changedScenes.begin(), changedScenes.end(), parent) != changedScenes.end())
+			{
+				isUnderChangedScene = true;
+				break;
+			}
+		}
+		if (!isUnderChangedScene)
+		{
+			PRINT("Hot reloading scene: " + scene->getFullName());
+			scene->reimport();
+			scene->onLoad();
+		}
+	}
+	return true;
+}
+
 int SceneLoader::preloadScene(const String& sceneFile, Atomic<int>& progress)
 {
 	const SceneSettings& sceneJSON = JSON::json::parse(ResourceLoader::CreateTextResourceFile(sceneFile)->getString()).value("settings", SceneSettings());
@@ -21,6 +21,7 @@ class SceneLoader
 	Vector<String> findResourcePaths(const JSON::json& sceneJSON);
 
 	Variant deleteScene(const Event* event);
+	Variant reimportChangedScenes(const Event* event);
 
 public:
 	static SceneLoader* GetSingleton();
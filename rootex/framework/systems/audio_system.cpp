@@ -10,6 +10,7 @@
 #include "core/audio/static_audio_buffer.h"
 #include "core/audio/streaming_audio_buffer.h"
 #include "scene_loader.h"
+#include "os/timer.h"
 
 String AudioSystem::GetALErrorString(int errID)
 {
@@ -85,9 +86,167 @@ bool AudioSystem::initialize(const JSON::json& systemData)
 		ERR("AudioSystem: AL, ALC, ALUT failed to initialize");
 		return false;
 	}
+
+	for (int i = 0; i < AUDIO_MAX_VOICES; i++)
+	{
+		ALuint voice;
+		alGenSources(1, &voice);
+		if (alGetError() != AL_NO_ERROR)
+		{
+			WARN("AudioSystem: Device ran out of sources at " + std::to_string(i) + " voices");
+			break;
+		}
+		m_Voices.push_back(voice);
+	}
+	m_FreeVoices = m_Voices;
+
+	m_IsRunning = true;
+	m_AudioThread = std::thread(&AudioSystem::runAudio, this);
 	return true;
 }
 
+void AudioSystem::runAudio()
+{
+	tracy::SetThreadName("Audio");
+	StopTimer timer;
+	while (m_IsRunning)
+	{
+		{
+			ZoneNamedN(audio, "Audio Update", true);
+			std::lock_guard<Mutex> lock(m_AudioMutex);
+			processCommands();
+
+			updateVoices(timer.getTimeMs());
+			timer.reset();
+
+			for (auto& source : m_Sources)
+			{
+				source->queueNewBuffers();
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_THREAD_INTERVAL_MILLISECONDS));
+	}
+}
+
+void AudioSystem::processCommands()
+{
+	AudioCommand command;
+	while (m_Commands.pop(command))
+	{
+		switch (command.type)
+		{
+		case AudioCommand::Type::AddSource:
+			m_Sources.push_back(command.source);
+			break;
+		case AudioCommand::Type::SetListenerPosition:
+			m_ListenerPosition = command.vector;
+			AL_CHECK(alListener3f(AL_POSITION, m_ListenerPosition.x, m_ListenerPosition.y, m_ListenerPosition.z));
+			break;
+		default:
+			command.source->execute(command);
+			break;
+		}
+	}
+}
+
+void AudioSystem::postCommand(const AudioCommand& command)
+{
+	while (!m_Commands.push(command))
+	{
+		if (!m_IsRunning)
+		{
+			WARN("AudioSystem: Dropped audio command, the audio thread is not running");
+			return;
+		}
+		std::this_thread::yield();
+	}
+}
+
+void AudioSystem::removeSource(AudioSource* source)
+{
+	std::lock_guard<Mutex> lock(m_AudioMutex);
+	// Commands still queued may point at this source, so they are applied before it goes away
+	processCommands();
+
+	auto findIt = std::find(m_Sources.begin(), m_Sources.end(), source);
+	if (findIt != m_Sources.end())
+	{
+		*findIt = m_Sources.back();
+		m_Sources.pop_back();
+	}
+	if (source->hasVoice())
+	{
+		m_FreeVoices.push_back(source->releaseVoice());
+	}
+}
+
+void AudioSystem::requestVoice(AudioSource* source)
+{
+	if (!m_FreeVoices.empty())
+	{
+		source->bindVoice(m_FreeVoices.back());
+		m_FreeVoices.pop_back();
+	}
+}
+
+void AudioSystem::updateVoices(float deltaMilliseconds)
+{
+	ZoneScoped;
+
+	m_VoiceCandidates.clear();
+	for (auto& source : m_Sources)
+	{
+		source->updatePlayback(deltaMilliseconds * MS_TO_S);
+		if (!source->isPlaying())
+		{
+			if (source->hasVoice())
+			{
+				m_FreeVoices.push_back(source->releaseVoice());
+			}
+			continue;
+		}
+
+		float audibility = source->getAudibility(m_ListenerPosition);
+		if (audibility < AUDIO_AUDIBILITY_THRESHOLD)
+		{
+			if (source->hasVoice())
+			{
+				m_FreeVoices.push_back(source->releaseVoice());
+			}
+			continue;
+		}
+
+		float score = audibility * source->getPriority();
+		if (source->hasVoice())
+		{
+			score *= AUDIO_VOICE_HYSTERESIS;
+		}
+		m_VoiceCandidates.push_back({ score, source });
+	}
+
+	const int voiceCount = std::min(m_Voices.size(), m_VoiceCandidates.size());
+	std::partial_sort(m_VoiceCandidates.begin(), m_VoiceCandidates.begin() + voiceCount, m_VoiceCandidates.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+	// Losers give up their voices before winners take them
+	for (int i = voiceCount; i < m_VoiceCandidates.size(); i++)
+	{
+		AudioSource* source = m_VoiceCandidates[i].second;
+		if (source->hasVoice())
+		{
+			m_FreeVoices.push_back(source->releaseVoice());
+		}
+	}
+	for (int i = 0; i < voiceCount; i++)
+	{
+		AudioSource* source = m_VoiceCandidates[i].second;
+		if (!source->hasVoice())
+		{
+			requestVoice(source);
+		}
+	}
+	m_VirtualCount = m_VoiceCandidates.size() - voiceCount;
+}
+
 void AudioSystem::begin()
 {
 	for (auto& c : ECSFactory::GetComponents<MusicComponent>())
@@ -115,7 +274,6 @@ void AudioSystem::update(float deltaMilliseconds)
 	for (auto& c : ECSFactory::GetComponents<MusicComponent>())
 	{
 		MusicComponent* mc = (MusicComponent*)c;
-		mc->getAudioSource()->queueNewBuffers();
 		mc->update();
 	}
 	for (auto& c : ECSFactory::GetComponents<ShortMusicComponent>())
@@ -126,8 +284,7 @@ void AudioSystem::update(float deltaMilliseconds)
 
 	if (m_Listener)
 	{
-		const Vector3& listenerPosition = m_Listener->getPosition();
-		AL_CHECK(alListener3f(AL_POSITION, listenerPosition.x, listenerPosition.y, listenerPosition.z));
+		postCommand({ AudioCommand::Type::SetListenerPosition, nullptr, m_Listener->getPosition() });
 	}
 }
 
@@ -194,6 +351,17 @@ void AudioSystem::restoreListener()
 
 void AudioSystem::shutDown()
 {
+	m_IsRunning = false;
+	if (m_AudioThread.joinable())
+	{
+		m_AudioThread.join();
+	}
+	if (!m_Voices.empty())
+	{
+		AL_CHECK(alDeleteSources(m_Voices.size(), m_Voices.data()));
+		m_Voices.clear();
+		m_FreeVoices.clear();
+	}
 	alutExit();
 }
 
@@ -204,3 +372,13 @@ AudioSystem::AudioSystem()
     , m_Listener(nullptr)
 {
 }
+
+void AudioSystem::draw()
+{
+	System::draw();
+
+	std::lock_guard<Mutex> lock(m_AudioMutex);
+	ImGui::Text("Voices: %d / %d", (int)(m_Voices.size() - m_FreeVoices.size()), (int)m_Voices.size());
+	ImGui::Text("Virtual Sources: %u", m_VirtualCount);
+	ImGui::Text("Sources: %d", (int)m_Sources.size());
+}
@@ -10,6 +10,21 @@
 #include "alut.h"
 
 #include "system.h"
+#include "core/audio/audio_source.h"
+#include "os/spsc_queue.h"
+
+#include <thread>
+
+/// Time the audio thread sleeps between updates
+#define AUDIO_THREAD_INTERVAL_MILLISECONDS 5
+/// Commands gameplay can post before the audio thread picks them up. Must be a power of 2.
+#define AUDIO_COMMAND_QUEUE_CAPACITY 4096
+/// OpenAL sources shared by all audio sources. Devices with fewer sources get as many as they have.
+#define AUDIO_MAX_VOICES 32
+/// Audibility below which a playing source does not get a voice
+#define AUDIO_AUDIBILITY_THRESHOLD 0.001f
+/// Advantage given to sources that already have a voice, so close scores do not swap voices every frame
+#define AUDIO_VOICE_HYSTERESIS 1.2f
 
 #ifndef ALUT_CHECK
 #ifdef _DEBUG
@@ -46,7 +61,8 @@ class StreamingAudioSource;
 
 class ResourceFile;
 
-/// Audio System responsible for streaming and static audio
+/// Audio System responsible for streaming and static audio.
+/// OpenAL sources and the listener are only touched by the audio thread, which gameplay feeds through a lock-free command queue.
 class AudioSystem : public System
 {
 	ALCdevice* m_Device;
@@ -54,6 +70,27 @@ class AudioSystem : public System
 
 	AudioListenerComponent* m_Listener = nullptr;
 
+	/// Applies commands, hands out voices and refills stream buffers at its own pace, so a long frame does not starve playback
+	std::thread m_AudioThread;
+	Atomic<bool> m_IsRunning = false;
+	/// Held by the audio thread while it updates, and by gameplay while it removes a source
+	Mutex m_AudioMutex;
+	/// Produced by the main thread, consumed by whoever holds the audio mutex
+	SPSCQueue<AudioCommand, AUDIO_COMMAND_QUEUE_CAPACITY> m_Commands;
+	Vector3 m_ListenerPosition;
+
+	Vector<AudioSource*> m_Sources;
+	Vector<ALuint> m_Voices;
+	Vector<ALuint> m_FreeVoices;
+	/// Playing sources by audibility weighted by priority, rebuilt every frame
+	Vector<Pair<float, AudioSource*>> m_VoiceCandidates;
+	unsigned int m_VirtualCount = 0;
+
+	void runAudio();
+	void processCommands();
+	/// Give voices to the most audible playing sources, taking them from less audible ones
+	void updateVoices(float deltaMilliseconds);
+
 	AudioSystem();
 	AudioSystem(AudioSystem&) = delete;
 	virtual ~AudioSystem() = default;
@@ -77,6 +114,13 @@ public:
 
 	void restoreListener();
 
+	/// Queue a command for the audio thread. Only called from the main thread.
+	void postCommand(const AudioCommand& command);
+	/// Stop a source and forget it. Blocks until the audio thread is done with it.
+	void removeSource(AudioSource* source);
+	/// Bind a free voice to a source if there is one. Called on the audio thread.
+	void requestVoice(AudioSource* source);
+
 	bool initialize(const JSON::json& systemData) override;
 	void setConfig(const SceneSettings& sceneSettings) override;
 	void shutDown();
@@ -84,4 +128,6 @@ public:
 	void update(float deltaMilliseconds) override;
 	void begin() override;
 	void end() override;
+
+	void draw() override;
 };
@@ -6,7 +6,12 @@
 #include "components/visual/light/directional_light_component.h"
 #include "components/visual/light/spot_light_component.h"
 #include "components/space/transform_component.h"
+#include "components/visual/model/model_component.h"
+#include "components/visual/model/animated_model_component.h"
+#include "components/visual/effect/cpu_particles_component.h"
 #include "framework/systems/render_system.h"
+#include "framework/systems/spatial_system.h"
+#include "app/application.h"
 
 LightSystem::LightSystem()
     : System("LightSystem", UpdateOrder::Async, false)
@@ -43,39 +48,158 @@ StaticPointLightsInfo LightSystem::getStaticPointLights()
 	return staticLights;
 }
 
-LightsInfo LightSystem::getDynamicLights()
+void LightSystem::updateStaticLights()
 {
-	LightsInfo lights;
+	ZoneScoped;
+	Vector<StaticLightBounds> bounds;
+	m_StaticLightIDs.clear();
+	m_StaticLightIndices.clear();
+	const Vector<Component*>& staticPointLightComponents = ECSFactory::GetComponents<StaticPointLightComponent>();
+	for (int i = 0; i < staticPointLightComponents.size() && i < MAX_STATIC_POINT_LIGHTS; i++)
+	{
+		StaticPointLightComponent* staticLight = (StaticPointLightComponent*)staticPointLightComponents[i];
+		const PointLight& pointLight = staticLight->getPointLight();
+		bounds.push_back({ staticLight->getAbsoluteTransform().Translation(),
+		    pointLight.range,
+		    pointLight.attConst,
+		    pointLight.attLin,
+		    pointLight.attQuad,
+		    pointLight.diffuseIntensity });
+
+		const SceneID id = staticLight->getOwner()->getScene()->getID();
+		m_StaticLightIDs.push_back(id);
+		m_StaticLightIndices[id] = i;
+	}
+	m_StaticLightBVH.build(bounds);
 
-	Vector3 cameraPos = RenderSystem::GetSingleton()->getCamera()->getAbsolutePosition();
-	lights.cameraPos = cameraPos;
+	for (auto& component : ECSFactory::GetComponents<ModelComponent>())
+	{
+		((RenderableComponent*)component)->updateStaticLights();
+	}
+	for (auto& component : ECSFactory::GetComponents<AnimatedModelComponent>())
+	{
+		((RenderableComponent*)component)->updateStaticLights();
+	}
+	for (auto& component : ECSFactory::GetComponents<CPUParticlesComponent>())
+	{
+		((RenderableComponent*)component)->updateStaticLights();
+	}
+}
 
-	static auto sortingLambda = [&cameraPos](const Component* a, const Component* b) -> bool {
-		Vector3& aa = a->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Translation();
-		Vector3& bb = b->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Translation();
-		return Vector3::DistanceSquared(cameraPos, aa) < Vector3::DistanceSquared(cameraPos, bb);
-	};
+int LightSystem::getStaticLightIndex(SceneID id) const
+{
+	auto findIt = m_StaticLightIndices.find(id);
+	if (findIt == m_StaticLightIndices.end())
+	{
+		return -1;
+	}
+	return findIt->second;
+}
 
-	Vector<Component*>& pointLightComponents = ECSFactory::GetComponents<PointLightComponent>();
-	sort(pointLightComponents.begin(), pointLightComponents.end(), sortingLambda);
+void LightSystem::buildClusters(const ClusterView& view)
+{
+	ZoneScoped;
+	m_Clusters.begin(view, m_PointLightBounds, m_SpotLightBounds);
 
-	int i = 0;
-	for (; i < pointLightComponents.size() && i < MAX_DYNAMIC_POINT_LIGHTS; i++)
+	Application* application = Application::GetSingleton();
+	if (!application || m_PointLightBounds.size() + m_SpotLightBounds.size() == 0)
 	{
-		PointLightComponent* light = (PointLightComponent*)pointLightComponents[i];
-		Vector3 transformedPosition = light->getAbsoluteTransform().Translation();
-		const PointLight& pointLight = light->getPointLight();
-
-		lights.pointLightInfos[i].ambientColor = pointLight.ambientColor;
-		lights.pointLightInfos[i].diffuseColor = pointLight.diffuseColor;
-		lights.pointLightInfos[i].diffuseIntensity = pointLight.diffuseIntensity;
-		lights.pointLightInfos[i].attConst = pointLight.attConst;
-		lights.pointLightInfos[i].attLin = pointLight.attLin;
-		lights.pointLightInfos[i].attQuad = pointLight.attQuad;
-		lights.pointLightInfos[i].lightPos = transformedPosition;
-		lights.pointLightInfos[i].range = pointLight.range;
+		m_Clusters.binSlices(0, CLUSTER_COUNT_Z - 1);
 	}
-	lights.pointLightCount = i;
+	else
+	{
+		// Slices own disjoint clusters, so they can be binned at the same time
+		Vector<Ref<Task>> tasks;
+		for (int first = 0; first < CLUSTER_COUNT_Z; first += LIGHT_CLUSTER_SLICES_PER_TASK)
+		{
+			int last = std::min(first + LIGHT_CLUSTER_SLICES_PER_TASK, CLUSTER_COUNT_Z) - 1;
+			tasks.push_back(std::make_shared<Task>([this, first, last]() {
+				m_Clusters.binSlices(first, last);
+			}));
+		}
+		application->getThreadPool().execute(tasks);
+	}
+
+	m_Clusters.finish();
+}
+
+LightsInfo LightSystem::getDynamicLights()
+{
+	ZoneScoped;
+	LightsInfo lights;
+
+	CameraComponent* camera = RenderSystem::GetSingleton()->getCamera();
+	SpatialSystem::GetSingleton()->queryFrustum(
+	    camera->getViewMatrix() * camera->getProjectionMatrix(),
+	    SpatialSystem::GetTypeMask({ PointLightComponent::s_ID, SpotLightComponent::s_ID }),
+	    m_VisibleLightEntities);
+
+	m_PointLightInfos.clear();
+	m_PointLightBounds.clear();
+	m_SpotLightInfos.clear();
+	m_SpotLightBounds.clear();
+	for (auto& entity : m_VisibleLightEntities)
+	{
+		if (PointLightComponent* light = entity->getComponent<PointLightComponent>())
+		{
+			const Vector3 position = light->getAbsoluteTransform().Translation();
+			const PointLight& pointLight = light->getPointLight();
+
+			PointLightInfo info;
+			info.ambientColor = pointLight.ambientColor;
+			info.diffuseColor = pointLight.diffuseColor;
+			info.diffuseIntensity = pointLight.diffuseIntensity;
+			info.attConst = pointLight.attConst;
+			info.attLin = pointLight.attLin;
+			info.attQuad = pointLight.attQuad;
+			info.lightPos = position;
+			info.range = pointLight.range;
+			m_PointLightInfos.push_back(info);
+			m_PointLightBounds.push_back({ position, pointLight.range });
+		}
+
+		if (SpotLightComponent* light = entity->getComponent<SpotLightComponent>())
+		{
+			const Matrix transform = light->getAbsoluteTransform();
+			const SpotLight& spotLight = light->getSpotLight();
+
+			m_SpotLightInfos.push_back({ spotLight.ambientColor,
+			    spotLight.diffuseColor,
+			    spotLight.diffuseIntensity,
+			    spotLight.attConst,
+			    spotLight.attLin,
+			    spotLight.attQuad,
+			    transform.Translation(),
+			    spotLight.range,
+			    transform.Forward(),
+			    spotLight.spot,
+			    cos(spotLight.angleRange) });
+			// Spot lights still reach the whole half space in front of them, so they are bounded like point lights
+			m_SpotLightBounds.push_back({ transform.Translation(), spotLight.range });
+		}
+	}
+
+	const Matrix cameraTransform = camera->getAbsoluteTransform();
+	ClusterView view;
+	view.position = cameraTransform.Translation();
+	cameraTransform.Forward().Normalize(view.forward);
+	cameraTransform.Right().Normalize(view.right);
+	cameraTransform.Up().Normalize(view.up);
+	view.tanHalfFov.y = tan(camera->getFoV() * 0.5f);
+	view.tanHalfFov.x = view.tanHalfFov.y * camera->getAspectRatio().x / camera->getAspectRatio().y;
+	view.nearPlane = camera->getNear();
+	view.farPlane = camera->getFar();
+	buildClusters(view);
+
+	const ClusterView& builtView = m_Clusters.getView();
+	lights.cameraPos = builtView.position;
+	lights.cameraForward = builtView.forward;
+	lights.cameraRight = builtView.right;
+	lights.cameraUp = builtView.up;
+	lights.clusterDepthScale = m_Clusters.getDepthScale();
+	lights.clusterDepthBias = m_Clusters.getDepthBias();
+	lights.clusterNear = builtView.nearPlane;
+	lights.clusterTanHalfFov = builtView.tanHalfFov;
 
 	const Vector<Component*>& directionalLightComponents = ECSFactory::GetComponents<DirectionalLightComponent>();
 
@@ -99,31 +223,23 @@ LightsInfo LightSystem::getDynamicLights()
 		lights.directionalLightPresent = 1;
 	}
 
-	Vector<Component*>& spotLightComponents = ECSFactory::GetComponents<SpotLightComponent>();
-	sort(spotLightComponents.begin(), spotLightComponents.end(), sortingLambda);
+	return lights;
+}
 
-	i = 0;
-	for (; i < spotLightComponents.size() && i < MAX_DYNAMIC_SPOT_LIGHTS; i++)
+void LightSystem::draw()
+{
+	System::draw();
+
+	unsigned int busiestCluster = 0;
+	for (auto& cluster : m_Clusters.getClusters())
 	{
-		SpotLightComponent* light = (SpotLightComponent*)spotLightComponents[i];
-		Matrix transform = light->getAbsoluteTransform();
-		const SpotLight& spotLight = light->getSpotLight();
-
-		lights.spotLightInfos[i] = {
-			spotLight.ambientColor,
-			spotLight.diffuseColor,
-			spotLight.diffuseIntensity,
-			spotLight.attConst,
-			spotLight.attLin,
-			spotLight.attQuad,
-			transform.Translation(),
-			spotLight.range,
-			transform.Forward(),
-			spotLight.spot,
-			cos(spotLight.angleRange)
-		};
+		busiestCluster = std::max(busiestCluster, cluster.pointLightCount + cluster.spotLightCount);
 	}
-	lights.spotLightCount = i;
-
-	return lights;
+	ImGui::Text("Static Point Lights: %u", m_StaticLightBVH.getLightCount());
+	ImGui::Text("Static Light BVH Nodes: %u", m_StaticLightBVH.getNodeCount());
+	ImGui::Text("Visible Dynamic Point Lights: %d / %d", (int)m_PointLightInfos.size(), (int)ECSFactory::GetComponents<PointLightComponent>().size());
+	ImGui::Text("Visible Dynamic Spot Lights: %d / %d", (int)m_SpotLightInfos.size(), (int)ECSFactory::GetComponents<SpotLightComponent>().size());
+	ImGui::Text("Clusters: %d x %d x %d", CLUSTER_COUNT_X, CLUSTER_COUNT_Y, CLUSTER_COUNT_Z);
+	ImGui::Text("Light Indices: %d", (int)m_Clusters.getLightIndices().size());
+	ImGui::Text("Most Lights In A Cluster: %u", busiestCluster);
 }
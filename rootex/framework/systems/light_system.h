@@ -2,15 +2,50 @@
 
 #include "system.h"
 #include "renderer/constant_buffer.h"
+#include "renderer/light_clusters.h"
+#include "renderer/static_light_bvh.h"
+
+/// Depth slices of the light clusters binned by one task
+#define LIGHT_CLUSTER_SLICES_PER_TASK 4
 
 /// Interface for setting up point, directional and spot lights.
+/// Dynamic point and spot lights reaching into the camera frustum are found through the SpatialSystem
+/// and binned into view space clusters every frame, so each pixel only shades the lights near it.
+/// Static point lights are put in a BVH when they change, which renderables query for the strongest lights reaching them.
 class LightSystem : public System
 {
+	StaticLightBVH m_StaticLightBVH;
+	/// Static light scenes by their index in the static light buffer, and the other way around
+	Vector<SceneID> m_StaticLightIDs;
+	HashMap<SceneID, int> m_StaticLightIndices;
+
+	LightClusterGrid m_Clusters;
+	Vector<PointLightInfo> m_PointLightInfos;
+	Vector<SpotLightInfo> m_SpotLightInfos;
+	Vector<ClusterLightBounds> m_PointLightBounds;
+	Vector<ClusterLightBounds> m_SpotLightBounds;
+	Vector<Entity*> m_VisibleLightEntities;
+
 	LightSystem();
 
+	void buildClusters(const ClusterView& view);
+
 public:
 	static LightSystem* GetSingleton();
 
 	StaticPointLightsInfo getStaticPointLights();
+	/// Rebuild the static light BVH and reassign static lights to all renderables
+	void updateStaticLights();
+	/// Index of a static light scene in the static light buffer, or -1 if it is not a static light
+	int getStaticLightIndex(SceneID id) const;
+	SceneID getStaticLightID(int index) const { return m_StaticLightIDs[index]; }
+	const StaticLightBVH& getStaticLightBVH() const { return m_StaticLightBVH; }
+	/// Gather dynamic lights and bin them into clusters for the current camera
 	LightsInfo getDynamicLights();
+
+	const Vector<PointLightInfo>& getPointLightInfos() const { return m_PointLightInfos; }
+	const Vector<SpotLightInfo>& getSpotLightInfos() const { return m_SpotLightInfos; }
+	const LightClusterGrid& getClusters() const { return m_Clusters; }
+
+	void draw() override;
 };
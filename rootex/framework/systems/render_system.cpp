@@ -7,7 +7,10 @@
 #include "renderer/shaders/register_locations_vertex_shader.h"
 #include "renderer/shaders/register_locations_pixel_shader.h"
 #include "light_system.h"
+#include "spatial_system.h"
 #include "renderer/material_library.h"
+#include "renderer/geometry_heap.h"
+#include "renderer/texture_streamer.h"
 #include "application.h"
 #include "scene_loader.h"
 
@@ -32,6 +35,11 @@ RenderSystem::RenderSystem()
 	m_TransformationStack.push_back(Matrix::Identity);
 	setProjectionConstantBuffers();
 
+	m_PointLightBuffer.reset(new StructuredBuffer(sizeof(PointLightInfo)));
+	m_SpotLightBuffer.reset(new StructuredBuffer(sizeof(SpotLightInfo)));
+	m_LightClusterBuffer.reset(new StructuredBuffer(sizeof(LightCluster)));
+	m_LightIndexBuffer.reset(new StructuredBuffer(sizeof(unsigned int)));
+
 	m_LineMaterial = std::dynamic_pointer_cast<BasicMaterial>(MaterialLibrary::GetMaterial("rootex/assets/materials/line.rmat"));
 	m_CurrentFrameLines.m_Endpoints.reserve(LINE_INITIAL_RENDER_CACHE * 2 * 3);
 	m_CurrentFrameLines.m_Indices.reserve(LINE_INITIAL_RENDER_CACHE * 2);
@@ -101,10 +109,47 @@ void RenderSystem::calculateTransforms(Scene* scene)
 
 void RenderSystem::renderPassRender(float deltaMilliseconds, RenderPass renderPass)
 {
-	renderComponents<ModelComponent>(deltaMilliseconds, renderPass);
-	renderComponents<GridModelComponent>(deltaMilliseconds, renderPass);
-	renderComponents<CPUParticlesComponent>(deltaMilliseconds, renderPass);
-	renderComponents<AnimatedModelComponent>(deltaMilliseconds, renderPass);
+	renderComponents<ModelComponent>(m_VisibleModels, deltaMilliseconds, renderPass);
+	renderComponents<GridModelComponent>(ECSFactory::GetComponents<GridModelComponent>(), deltaMilliseconds, renderPass);
+	renderComponents<CPUParticlesComponent>(ECSFactory::GetComponents<CPUParticlesComponent>(), deltaMilliseconds, renderPass);
+	renderComponents<AnimatedModelComponent>(ECSFactory::GetComponents<AnimatedModelComponent>(), deltaMilliseconds, renderPass);
+}
+
+void RenderSystem::cullModels()
+{
+	ZoneScoped;
+	SpatialSystem* spatialSystem = SpatialSystem::GetSingleton();
+	// Parents moved by calculateTransforms have only now dirtied their children
+	spatialSystem->refit();
+	spatialSystem->queryFrustum(m_Camera->getViewMatrix() * m_Camera->getProjectionMatrix(), SpatialSystem::GetTypeMask({ ModelComponent::s_ID }), m_VisibleEntities);
+
+	m_VisibleModels.clear();
+	for (auto& entity : m_VisibleEntities)
+	{
+		m_VisibleModels.push_back(entity->getComponent<ModelComponent>());
+	}
+}
+
+void RenderSystem::updateLODScale(float deltaMilliseconds)
+{
+	m_AverageFrameTime += (deltaMilliseconds - m_AverageFrameTime) * 0.1f;
+	if (m_IsLODBiasAdaptive)
+	{
+		const float deltaSeconds = deltaMilliseconds / 1000.0f;
+		if (m_AverageFrameTime > m_LODTargetFrameTime * 1.1f)
+		{
+			m_LODBias += 0.5f * deltaSeconds;
+		}
+		else if (m_AverageFrameTime < m_LODTargetFrameTime * 0.9f)
+		{
+			m_LODBias -= 0.25f * deltaSeconds;
+		}
+		m_LODBias = std::clamp(m_LODBias, 0.0f, LOD_MAX_ADAPTIVE_BIAS);
+	}
+
+	const float screenHeight = Application::GetSingleton()->getWindow()->getHeight();
+	m_PixelsPerUnit = screenHeight / (2.0f * std::tan(m_Camera->getFoV() * 0.5f));
+	m_LODErrorScale = m_PixelsPerUnit / std::exp2(m_LODBias);
 }
 
 void RenderSystem::update(float deltaMilliseconds)
@@ -113,6 +158,9 @@ void RenderSystem::update(float deltaMilliseconds)
 	RenderingDevice::GetSingleton()->unbindSRVs();
 	RenderingDevice::GetSingleton()->setOffScreenRTVDSV();
 	m_Renderer->resetCurrentShader();
+	m_Renderer->resetCurrentGeometry();
+	GeometryHeap::GetSingleton()->upload();
+	TextureStreamer::GetSingleton()->update();
 
 	Color clearColor = { 0.15f, 0.15f, 0.15f, 1.0f };
 	float fogStart = 0.0f;
@@ -138,6 +186,8 @@ void RenderSystem::update(float deltaMilliseconds)
 		ZoneNamedN(absoluteTransform, "Absolute Transformations", true);
 		calculateTransforms(SceneLoader::GetSingleton()->getRootScene());
 	}
+	cullModels();
+	updateLODScale(deltaMilliseconds);
 	{
 		ZoneNamedN(stateSet, "Render State Reset", true);
 		// Render geometry
@@ -183,7 +233,7 @@ void RenderSystem::update(float deltaMilliseconds)
 				m_Renderer->bind(sky->getSkyMaterial());
 				for (auto& mesh : meshes)
 				{
-					m_Renderer->draw(mesh.m_VertexBuffer.get(), mesh.getLOD(1.0f).get());
+					m_Renderer->draw(mesh.m_VertexBuffer.get(), mesh.getLOD(0).get());
 				}
 			}
 		}
@@ -204,6 +254,8 @@ void RenderSystem::renderLines()
 		IndexBuffer ib(m_CurrentFrameLines.m_Indices);
 
 		m_Renderer->draw(&vb, &ib);
+		// These buffers are freed right after, so a later buffer could reuse their addresses
+		m_Renderer->resetCurrentGeometry();
 
 		m_CurrentFrameLines.m_Endpoints.clear();
 		m_CurrentFrameLines.m_Indices.clear();
@@ -361,10 +413,22 @@ void RenderSystem::perFrameVSCBBinds(float fogStart, float fogEnd)
 
 void RenderSystem::perFramePSCBBinds(const Color& fogColor)
 {
+	LightSystem* lightSystem = LightSystem::GetSingleton();
 	PerFramePSCB perFrame;
-	perFrame.lights = LightSystem::GetSingleton()->getDynamicLights();
+	perFrame.lights = lightSystem->getDynamicLights();
 	perFrame.fogColor = fogColor;
 	Material::SetPSConstantBuffer(perFrame, m_PSPerFrameConstantBuffer, PER_FRAME_PS_CPP);
+
+	m_PointLightBuffer->setData(lightSystem->getPointLightInfos());
+	m_SpotLightBuffer->setData(lightSystem->getSpotLightInfos());
+	m_LightClusterBuffer->setData(lightSystem->getClusters().getClusters());
+	m_LightIndexBuffer->setData(lightSystem->getClusters().getLightIndices());
+
+	RenderingDevice* device = RenderingDevice::GetSingleton();
+	device->setInPixelShader(POINT_LIGHTS_PS_CPP, 1, m_PointLightBuffer->getSRV());
+	device->setInPixelShader(SPOT_LIGHTS_PS_CPP, 1, m_SpotLightBuffer->getSRV());
+	device->setInPixelShader(LIGHT_CLUSTERS_PS_CPP, 1, m_LightClusterBuffer->getSRV());
+	device->setInPixelShader(LIGHT_INDICES_PS_CPP, 1, m_LightIndexBuffer->getSRV());
 }
 
 void RenderSystem::perScenePSCBBinds()
@@ -375,6 +439,8 @@ void RenderSystem::perScenePSCBBinds()
 
 void RenderSystem::updateStaticLights()
 {
+	LightSystem::GetSingleton()->updateStaticLights();
+
 	PerLevelPSCB perScene;
 	perScene.staticLights = LightSystem::GetSingleton()->getStaticPointLights();
 	Material::SetPSConstantBuffer(perScene, m_PSPerLevelConstantBuffer, PER_SCENE_PS_CPP);
@@ -447,6 +513,23 @@ void RenderSystem::draw()
 	ImGui::NextColumn();
 	ImGui::Columns(1);
 
+	ImGui::Text("Visible Models: %d / %d", (int)m_VisibleModels.size(), (int)ECSFactory::GetComponents<ModelComponent>().size());
+	GeometryHeap::GetSingleton()->draw();
+	TextureStreamer::GetSingleton()->draw();
+
+	if (ImGui::TreeNodeEx("LOD"))
+	{
+		ImGui::DragFloat("Error Budget (px)", &m_LODErrorBudget, 0.05f, 0.1f, 64.0f);
+		ImGui::Checkbox("Adapt Bias to Frame Time", &m_IsLODBiasAdaptive);
+		if (m_IsLODBiasAdaptive)
+		{
+			ImGui::DragFloat("Target Frame Time (ms)", &m_LODTargetFrameTime, 0.1f, 1.0f, 100.0f);
+		}
+		ImGui::SliderFloat("Bias", &m_LODBias, 0.0f, LOD_MAX_ADAPTIVE_BIAS);
+		ImGui::Text("Average Frame Time: %.2f ms", m_AverageFrameTime);
+		ImGui::TreePop();
+	}
+
 	if (ImGui::Button("Update Static Lights"))
 	{
 		updatePerSceneBinds();
@@ -2,6 +2,7 @@
 
 #include "core/renderer/renderer.h"
 #include "core/renderer/render_pass.h"
+#include "core/renderer/structured_buffer.h"
 #include "main/window.h"
 #include "framework/ecs_factory.h"
 #include "framework/scene.h"
@@ -13,6 +14,8 @@
 #include "ASSAO/ASSAO.h"
 
 #define LINE_INITIAL_RENDER_CACHE 1000
+/// Highest global LOD bias reached by adapting to frame time
+#define LOD_MAX_ADAPTIVE_BIAS 3.0f
 
 class BasicMaterial;
 
@@ -37,15 +40,41 @@ class RenderSystem : public System
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_PSPerFrameConstantBuffer;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_PSPerLevelConstantBuffer;
 
+	/// Dynamic lights and the clusters they are binned into, read by the pixel shaders
+	Ptr<StructuredBuffer> m_PointLightBuffer;
+	Ptr<StructuredBuffer> m_SpotLightBuffer;
+	Ptr<StructuredBuffer> m_LightClusterBuffer;
+	Ptr<StructuredBuffer> m_LightIndexBuffer;
+
 	bool m_IsEditorRenderPassEnabled;
 
+	/// Pixels covered by one unit at a distance of one unit
+	float m_PixelsPerUnit = 1.0f;
+	/// m_PixelsPerUnit scaled down by the global LOD bias
+	float m_LODErrorScale = 1.0f;
+	/// Error in pixels a LOD may show on screen
+	float m_LODErrorBudget = 1.0f;
+	/// Every step of 1 doubles the error allowed for all renderables
+	float m_LODBias = 0.0f;
+	/// Raise the LOD bias while frames take longer than the target and lower it back once they are within it
+	bool m_IsLODBiasAdaptive = true;
+	float m_LODTargetFrameTime = 1000.0f / 60.0f;
+	float m_AverageFrameTime = 1000.0f / 60.0f;
+
+	/// Models inside the camera frustum this frame, found through the SpatialSystem
+	Vector<Entity*> m_VisibleEntities;
+	Vector<Component*> m_VisibleModels;
+
 	RenderSystem();
 	RenderSystem(RenderSystem&) = delete;
 
 	void renderPassRender(float deltaMilliseconds, RenderPass renderPass);
+	/// Find the models the camera can see. Animated models, particles and grids are not culled since they can leave their bounds.
+	void cullModels();
+	void updateLODScale(float deltaMilliseconds);
 
 	template <class T>
-	void renderComponents(float deltaMilliseconds, RenderPass renderPass);
+	void renderComponents(const Vector<Component*>& components, float deltaMilliseconds, RenderPass renderPass);
 
 	Variant onOpenedScene(const Event* event);
 
@@ -89,14 +118,19 @@ public:
 	CameraComponent* getCamera() const { return m_Camera; }
 	const Matrix& getCurrentMatrix() const;
 	Renderer* getRenderer() const { return m_Renderer.get(); }
+	/// Turns a size at some distance into pixels when multiplied by pixels per unit / distance
+	float getPixelsPerUnit() const { return m_PixelsPerUnit; }
+	/// Turns a model space error at some distance into pixels when multiplied by scale / distance
+	float getLODErrorScale() const { return m_LODErrorScale; }
+	float getLODErrorBudget() const { return m_LODErrorBudget; }
 
 	void draw() override;
 };
 
 template <class T>
-inline void RenderSystem::renderComponents(float deltaMilliseconds, RenderPass renderPass)
+inline void RenderSystem::renderComponents(const Vector<Component*>& components, float deltaMilliseconds, RenderPass renderPass)
 {
-	for (auto& c : ECSFactory::GetComponents<T>())
+	for (auto& c : components)
 	{
 		T* tc = (T*)c;
 		if (tc->getRenderPass() & (unsigned int)renderPass)
@@ -19,16 +19,18 @@ void ScriptSystem::addInitScriptEntity(Entity* e)
 	m_ScriptEntitiesToInit.push_back(e);
 }
 
-void CallUpdateForScene(Scene* scene, float deltaMilliseconds)
+void ScriptSystem::addUpdateScript(Script* script)
 {
-	if (Entity* entity = scene->getEntity())
-	{
-		entity->call("update", { entity, deltaMilliseconds });
-	}
+	script->m_UpdateIndex = m_UpdateScripts.size();
+	m_UpdateScripts.push_back(script);
+}
 
-	for (auto& child : scene->getChildren())
+void ScriptSystem::removeUpdateScript(Script* script)
+{
+	if (script->m_UpdateIndex != -1)
 	{
-		CallUpdateForScene(child.get(), deltaMilliseconds);
+		m_UpdateScripts[script->m_UpdateIndex] = nullptr;
+		script->m_UpdateIndex = -1;
 	}
 }
 
@@ -41,20 +43,45 @@ void ScriptSystem::update(float deltaMilliseconds)
 		if (entity)
 		{
 			entity->evaluateScriptOverrides();
-			entity->call("begin", { entity });
+			entity->invoke("begin", entity);
 		}
 	}
 	m_ScriptEntitiesToInit.clear();
 
-	Scene* root = SceneLoader::GetSingleton()->getRootScene();
-	CallUpdateForScene(root, deltaMilliseconds);
+	m_Scheduler.update(deltaMilliseconds);
+
+	// Parallel scripts finish and their commands are applied before serial scripts run
+	m_ParallelRunner.update(deltaMilliseconds);
+
+	// Scripts added by an update are first updated next frame
+	const int updateCount = m_UpdateScripts.size();
+	int aliveCount = 0;
+	for (int i = 0; i < m_UpdateScripts.size(); i++)
+	{
+		if (Script* script = m_UpdateScripts[i])
+		{
+			Script::RunningScope runningScope(script);
+			if (i < updateCount && !script->isSuccessful(script->m_UpdateFunction(script->m_ScriptInstance, script->m_Entity, deltaMilliseconds)))
+			{
+				WARN("Script error (" + script->m_Entity->getFullName() + ")");
+			}
+		}
+
+		// The script may have been removed by an update
+		if (Script* script = m_UpdateScripts[i])
+		{
+			script->m_UpdateIndex = aliveCount;
+			m_UpdateScripts[aliveCount++] = script;
+		}
+	}
+	m_UpdateScripts.resize(aliveCount);
 }
 
 void CallDestroyForScene(Scene* scene)
 {
 	if (Entity* entity = scene->getEntity())
 	{
-		entity->call("destroy", { entity });
+		entity->invoke("destroy", entity);
 	}
 
 	for (auto& child : scene->getChildren())
@@ -63,6 +90,59 @@ void CallDestroyForScene(Scene* scene)
 	}
 }
 
+void ScriptSystem::draw()
+{
+	System::draw();
+
+	LuaInterpreter* interpreter = LuaInterpreter::GetSingleton();
+	const LuaInterpreter::GCStats& gcStats = interpreter->getGCStats();
+
+	ImGui::Text("Updating Scripts: %d", (int)m_UpdateScripts.size());
+	ImGui::Text("Coroutines: %u (%u sleeping, %u waiting frames)", m_Scheduler.getCount(), m_Scheduler.getTimeSleeperCount(), m_Scheduler.getFrameSleeperCount());
+	ImGui::Text("Parallel Scripts: %u on %d workers (%u commands)", m_ParallelRunner.getScriptCount(), (int)m_ParallelRunner.getWorkers().size(), m_ParallelRunner.getCommandsLastFrame());
+	for (int i = 0; i < m_ParallelRunner.getWorkers().size(); i++)
+	{
+		const Ptr<LuaWorker>& worker = m_ParallelRunner.getWorkers()[i];
+		ImGui::BulletText("Worker %d: %u scripts, %.3f ms", i, worker->getScriptCount(), worker->getLastUpdateMilliseconds());
+	}
+	ImGui::Separator();
+
+	float budget = interpreter->getGCBudget();
+	if (ImGui::DragFloat("GC Budget (ms)", &budget, 0.05f, 0.0f, 16.0f))
+	{
+		interpreter->setGCBudget(budget);
+	}
+	ImGui::Text("GC Step: %.3f ms (%u steps)", gcStats.lastStepMilliseconds, gcStats.lastSteps);
+	ImGui::Text("GC Cycles: %u (%u over budget)", gcStats.completedCycles, gcStats.emergencyCycles);
+	ImGui::Text("Lua Memory: %.1f KB", LuaMemory::GetTotalBytes() / 1024.0f);
+
+	if (ImGui::TreeNodeEx("Memory per Script", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		ImGui::Columns(4);
+		ImGui::Text("Script");
+		ImGui::NextColumn();
+		ImGui::Text("Live KB");
+		ImGui::NextColumn();
+		ImGui::Text("Frame KB");
+		ImGui::NextColumn();
+		ImGui::Text("Frame Allocations");
+		ImGui::NextColumn();
+		for (auto& stats : LuaMemory::GetStats())
+		{
+			ImGui::Text("%s", stats.name.c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%.1f", stats.liveBytes / 1024.0f);
+			ImGui::NextColumn();
+			ImGui::Text("%.1f", stats.lastFrameAllocatedBytes / 1024.0f);
+			ImGui::NextColumn();
+			ImGui::Text("%u", stats.lastFrameAllocations);
+			ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+		ImGui::TreePop();
+	}
+}
+
 void ScriptSystem::end()
 {
 	Scene* root = SceneLoader::GetSingleton()->getRootScene();
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "system.h"
+#include "script/coroutine_scheduler.h"
+#include "script/parallel_script_runner.h"
+
+class Script;
 
 /// Interface for initialisation, maintenance and deletion of script components.
 class ScriptSystem : public System
@@ -10,14 +14,25 @@ class ScriptSystem : public System
 	~ScriptSystem() = default;
 
 	Vector<Entity*> m_ScriptEntitiesToInit;
+	/// Scripts that define update(), in registration order. Removed scripts leave a nullptr that is compacted during update.
+	Vector<Script*> m_UpdateScripts;
+	CoroutineScheduler m_Scheduler;
+	ParallelScriptRunner m_ParallelRunner;
 
 public:
 	static ScriptSystem* GetSingleton();
 
 	void addInitScriptEntity(Entity* e);
+	void addUpdateScript(Script* script);
+	void removeUpdateScript(Script* script);
+
+	CoroutineScheduler& getScheduler() { return m_Scheduler; }
+	ParallelScriptRunner& getParallelRunner() { return m_ParallelRunner; }
 
 	/// Calls update() function of script components.
 	void update(float deltaMilliseconds) override;
 	/// Calls end() function of script components.
 	void end() override;
+
+	void draw() override;
 };
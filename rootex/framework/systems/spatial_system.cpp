@@ -0,0 +1,219 @@
+#include "spatial_system.h"
+
+#include "ecs_factory.h"
+#include "components/space/transform_component.h"
+#include "components/visual/light/point_light_component.h"
+#include "components/visual/light/static_point_light_component.h"
+#include "components/visual/light/spot_light_component.h"
+
+SpatialSystem::SpatialSystem()
+    : System("SpatialSystem", UpdateOrder::PostUpdate, true)
+{
+}
+
+SpatialSystem* SpatialSystem::GetSingleton()
+{
+	static SpatialSystem singleton;
+	return &singleton;
+}
+
+SpatialSystem::TypeMask SpatialSystem::GetTypeMask(const Vector<ComponentID>& componentIDs)
+{
+	TypeMask mask = 0;
+	for (auto& id : componentIDs)
+	{
+		mask |= 1ull << id;
+	}
+	return mask;
+}
+
+SpatialSystem::TypeMask SpatialSystem::GetTypeMaskFromNames(const Vector<String>& componentNames)
+{
+	TypeMask mask = 0;
+	for (auto& name : componentNames)
+	{
+		bool found = false;
+		for (auto& [id, componentName, creator] : ECSFactory::GetComponentDatabase())
+		{
+			if (componentName == name)
+			{
+				mask |= 1ull << id;
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			WARN("Component type not found for a spatial query: " + name);
+		}
+	}
+	return mask;
+}
+
+SpatialSystem::TypeMask SpatialSystem::GetEntityTypes(Entity* entity)
+{
+	TypeMask mask = 0;
+	for (auto& [id, component] : entity->getAllComponents())
+	{
+		mask |= 1ull << id;
+	}
+	return mask;
+}
+
+void SpatialSystem::GetFrustumPlanes(const Matrix& viewProjection, Vector4 planes[6])
+{
+	const Matrix& m = viewProjection;
+	const Vector4 column1 = { m._11, m._21, m._31, m._41 };
+	const Vector4 column2 = { m._12, m._22, m._32, m._42 };
+	const Vector4 column3 = { m._13, m._23, m._33, m._43 };
+	const Vector4 column4 = { m._14, m._24, m._34, m._44 };
+
+	// Clip space keeps -w <= x <= w, -w <= y <= w and 0 <= z <= w
+	planes[0] = column4 + column1;
+	planes[1] = column4 - column1;
+	planes[2] = column4 + column2;
+	planes[3] = column4 - column2;
+	planes[4] = column3;
+	planes[5] = column4 - column3;
+}
+
+void SpatialSystem::addTransform(TransformComponent* transform)
+{
+	const TypeMask types = GetEntityTypes(transform->getOwner());
+	if (transform->m_SpatialProxy != AABB_TREE_NULL_NODE)
+	{
+		m_Tree.setTypes(transform->m_SpatialProxy, types);
+		transform->m_IsSpatialDirty = true;
+		return;
+	}
+
+	// The absolute transform is not known until the hierarchy is walked, so the real bounds come in with the next refit
+	const Vector3 position = transform->getPosition();
+	transform->m_SpatialProxy = m_Tree.createProxy(position, position, transform, types);
+	transform->m_SpatialIndex = m_Transforms.size();
+	transform->m_IsSpatialDirty = true;
+	m_Transforms.push_back(transform);
+}
+
+void SpatialSystem::removeTransform(TransformComponent* transform)
+{
+	if (transform->m_SpatialProxy == AABB_TREE_NULL_NODE)
+	{
+		return;
+	}
+
+	m_Tree.destroyProxy(transform->m_SpatialProxy);
+	transform->m_SpatialProxy = AABB_TREE_NULL_NODE;
+
+	TransformComponent* last = m_Transforms.back();
+	m_Transforms[transform->m_SpatialIndex] = last;
+	last->m_SpatialIndex = transform->m_SpatialIndex;
+	m_Transforms.pop_back();
+}
+
+void SpatialSystem::getBounds(TransformComponent* transform, Vector3& min, Vector3& max)
+{
+	const BoundingBox bounds = transform->getWorldSpaceBounds();
+	min = Vector3(bounds.Center) - bounds.Extents;
+	max = Vector3(bounds.Center) + bounds.Extents;
+
+	auto growBySphere = [&min, &max](const Vector3& center, float radius) {
+		const Vector3 extents = { radius, radius, radius };
+		min = Vector3::Min(min, center - extents);
+		max = Vector3::Max(max, center + extents);
+	};
+	Entity* entity = transform->getOwner();
+	if (PointLightComponent* light = entity->getComponent<PointLightComponent>())
+	{
+		growBySphere(transform->getAbsolutePosition(), light->getPointLight().range);
+	}
+	if (StaticPointLightComponent* light = entity->getComponent<StaticPointLightComponent>())
+	{
+		growBySphere(transform->getAbsolutePosition(), light->getPointLight().range);
+	}
+	if (SpotLightComponent* light = entity->getComponent<SpotLightComponent>())
+	{
+		growBySphere(transform->getAbsolutePosition(), light->getSpotLight().range);
+	}
+}
+
+void SpatialSystem::refit()
+{
+	ZoneScoped;
+	m_LastRefitCount = 0;
+	m_LastReinsertCount = 0;
+	Vector3 min;
+	Vector3 max;
+	for (auto& transform : m_Transforms)
+	{
+		if (!transform->m_IsSpatialDirty)
+		{
+			continue;
+		}
+		transform->m_IsSpatialDirty = false;
+		getBounds(transform, min, max);
+		m_LastReinsertCount += m_Tree.moveProxy(transform->m_SpatialProxy, min, max);
+		m_LastRefitCount++;
+	}
+}
+
+void SpatialSystem::toEntities(Vector<Entity*>& entities) const
+{
+	entities.clear();
+	for (auto& proxy : m_Proxies)
+	{
+		entities.push_back(((TransformComponent*)m_Tree.getUserData(proxy))->getOwner());
+	}
+}
+
+void SpatialSystem::queryBox(const Vector3& min, const Vector3& max, TypeMask types, Vector<Entity*>& result)
+{
+	m_Tree.queryBox(min, max, types, m_Proxies);
+	toEntities(result);
+}
+
+void SpatialSystem::querySphere(const Vector3& center, float radius, TypeMask types, Vector<Entity*>& result)
+{
+	m_Tree.querySphere(center, radius, types, m_Proxies);
+	toEntities(result);
+}
+
+void SpatialSystem::queryFrustum(const Matrix& viewProjection, TypeMask types, Vector<Entity*>& result)
+{
+	Vector4 planes[6];
+	GetFrustumPlanes(viewProjection, planes);
+	m_Tree.queryFrustum(planes, types, m_Proxies);
+	toEntities(result);
+}
+
+Entity* SpatialSystem::raycast(const Vector3& origin, const Vector3& direction, float maxDistance, TypeMask types, float& hitDistance)
+{
+	const int proxy = m_Tree.raycast(origin, direction, maxDistance, types, hitDistance);
+	if (proxy == AABB_TREE_NULL_NODE)
+	{
+		return nullptr;
+	}
+	return ((TransformComponent*)m_Tree.getUserData(proxy))->getOwner();
+}
+
+void SpatialSystem::queryNearest(const Vector3& point, unsigned int count, TypeMask types, Vector<Entity*>& result)
+{
+	m_Tree.queryNearest(point, count, types, m_Proxies);
+	toEntities(result);
+}
+
+void SpatialSystem::update(float deltaMilliseconds)
+{
+	refit();
+}
+
+void SpatialSystem::draw()
+{
+	System::draw();
+
+	ImGui::Text("Entities: %u", m_Tree.getProxyCount());
+	ImGui::Text("Tree Nodes: %u", m_Tree.getNodeCount());
+	ImGui::Text("Tree Height: %d", m_Tree.getHeight());
+	ImGui::Text("Refit Last Frame: %u", m_LastRefitCount);
+	ImGui::Text("Reinserted Last Frame: %u", m_LastReinsertCount);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "system.h"
+#include "core/dynamic_aabb_tree.h"
+
+class TransformComponent;
+
+/// Type mask accepting entities with any components. Kept below 2^63 so it passes through Lua integers unchanged.
+#define SPATIAL_ALL_TYPES (~0ull >> 1)
+
+/// Keeps the world space bounds of every entity with a TransformComponent in a dynamic AABB tree for proximity queries.
+/// Leaves are tagged with the component types of their entity, so queries can ask only for entities with certain components.
+/// Bounds of entities with point or spot lights cover the light range.
+class SpatialSystem : public System
+{
+	DynamicAABBTree m_Tree;
+	Vector<TransformComponent*> m_Transforms;
+	/// Reused by queries to avoid allocating
+	Vector<int> m_Proxies;
+
+	unsigned int m_LastRefitCount = 0;
+	unsigned int m_LastReinsertCount = 0;
+
+	SpatialSystem();
+	SpatialSystem(SpatialSystem&) = delete;
+	~SpatialSystem() = default;
+
+	void getBounds(TransformComponent* transform, Vector3& min, Vector3& max);
+	void toEntities(Vector<Entity*>& entities) const;
+
+public:
+	typedef DynamicAABBTree::TypeMask TypeMask;
+	// Each component ID is a bit of the mask, and the top bit is left clear by SPATIAL_ALL_TYPES
+	static_assert((unsigned int)ComponentIDs::Count < sizeof(TypeMask) * 8, "Component IDs no longer fit in SpatialSystem::TypeMask");
+
+	static SpatialSystem* GetSingleton();
+
+	/// Mask accepting entities that have any of the components
+	static TypeMask GetTypeMask(const Vector<ComponentID>& componentIDs);
+	/// Mask accepting entities that have any of the components, by component name
+	static TypeMask GetTypeMaskFromNames(const Vector<String>& componentNames);
+	/// Mask of the components an entity has
+	static TypeMask GetEntityTypes(Entity* entity);
+	/// Planes of the frustum a view projection matrix sees, facing inwards
+	static void GetFrustumPlanes(const Matrix& viewProjection, Vector4 planes[6]);
+
+	/// Put an entity in the tree, or refresh its component types if it is already there
+	void addTransform(TransformComponent* transform);
+	void removeTransform(TransformComponent* transform);
+	/// Move the leaves of the transforms that changed since the last refit
+	void refit();
+
+	void queryBox(const Vector3& min, const Vector3& max, TypeMask types, Vector<Entity*>& result);
+	void querySphere(const Vector3& center, float radius, TypeMask types, Vector<Entity*>& result);
+	void queryFrustum(const Matrix& viewProjection, TypeMask types, Vector<Entity*>& result);
+	/// Closest entity whose bounds are hit by the ray within maxDistance, or nullptr
+	Entity* raycast(const Vector3& origin, const Vector3& direction, float maxDistance, TypeMask types, float& hitDistance);
+	/// Up to count entities whose bounds are closest to the point, closest first
+	void queryNearest(const Vector3& point, unsigned int count, TypeMask types, Vector<Entity*>& result);
+
+	void update(float deltaMilliseconds) override;
+	void draw() override;
+};
@@ -131,7 +131,9 @@ void UISystem::update(float deltaMilliseconds)
 	m_Context->Update();
 	RenderingDevice::GetSingleton()->setAlphaBS();
 	RenderingDevice::GetSingleton()->setTemporaryUIRS();
+	m_RmlRenderInterface->beginFrame();
 	m_Context->Render();
+	m_RmlRenderInterface->endFrame();
 }
 
 void UISystem::shutDown()
@@ -156,4 +158,10 @@ void UISystem::draw()
 	}
 
 	ImGui::Checkbox("Take Inputs", &InputInterface::s_IsEnabled);
+
+	const UIGeometryBuffer::Statistics& statistics = m_RmlRenderInterface->getStatistics();
+	ImGui::Text("Draw Calls: %u", statistics.drawCalls);
+	ImGui::Text("Immediate Geometries: %u", statistics.immediateGeometries);
+	ImGui::Text("Compiled Geometries: %u", statistics.compiledGeometries);
+	ImGui::Text("Ring Buffer Wraps: %u", statistics.ringWraps);
 }
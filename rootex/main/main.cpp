@@ -9,6 +9,8 @@ int main()
 	app->run();
 	app->end();
 	OS::Print(app->getAppTitle() + " is now safely exiting");
+	app.reset();
+	Logger::GetSingleton()->shutDown();
 
 	return 0;
 }
@@ -0,0 +1,349 @@
+#include "file_watcher.h"
+
+#include "common/common.h"
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+void FileWatcher::pushChange(const FilePath& path)
+{
+	m_ChangesMutex.lock();
+	m_PendingChanges[path.generic_string()] = std::chrono::steady_clock::now();
+	m_ChangesMutex.unlock();
+}
+
+Vector<String> FileWatcher::takeChanges()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	Vector<String> changes;
+
+	m_ChangesMutex.lock();
+	for (auto it = m_PendingChanges.begin(); it != m_PendingChanges.end();)
+	{
+		if (now - it->second >= std::chrono::milliseconds(SETTLE_MILLISECONDS))
+		{
+			changes.push_back(it->first);
+			it = m_PendingChanges.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+	m_ChangesMutex.unlock();
+
+	return changes;
+}
+
+#if defined(_WIN32)
+
+/// File watcher implemented over overlapped ReadDirectoryChangesW calls.
+class Win32FileWatcher : public FileWatcher
+{
+	struct WatchedDirectory
+	{
+		String path;
+		HANDLE handle = INVALID_HANDLE_VALUE;
+		OVERLAPPED overlapped = {};
+		/// Notifications are DWORD aligned
+		DWORD buffer[16 * 1024];
+	};
+
+	Vector<Ptr<WatchedDirectory>> m_Directories;
+	HANDLE m_StopEvent = nullptr;
+	std::thread m_Thread;
+
+	bool issueRead(WatchedDirectory& directory);
+	void run();
+
+public:
+	Win32FileWatcher() = default;
+	Win32FileWatcher(Win32FileWatcher&) = delete;
+	~Win32FileWatcher() { stop(); }
+
+	bool start(const Vector<String>& directories) override;
+	void stop() override;
+};
+
+bool Win32FileWatcher::issueRead(WatchedDirectory& directory)
+{
+	return ReadDirectoryChangesW(
+	    directory.handle,
+	    directory.buffer,
+	    sizeof(directory.buffer),
+	    TRUE,
+	    FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE,
+	    nullptr,
+	    &directory.overlapped,
+	    nullptr);
+}
+
+bool Win32FileWatcher::start(const Vector<String>& directories)
+{
+	if (m_Thread.joinable())
+	{
+		WARN("File watcher is already running");
+		return false;
+	}
+
+	m_StopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+	for (auto& directory : directories)
+	{
+		Ptr<WatchedDirectory> watched = std::make_unique<WatchedDirectory>();
+		watched->path = FilePath(directory).generic_string();
+		watched->handle = CreateFileW(
+		    OS::GetAbsolutePath(directory).wstring().c_str(),
+		    FILE_LIST_DIRECTORY,
+		    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		    nullptr,
+		    OPEN_EXISTING,
+		    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+		    nullptr);
+		if (watched->handle == INVALID_HANDLE_VALUE)
+		{
+			WARN("Could not open directory for watching: " + directory);
+			continue;
+		}
+
+		watched->overlapped.hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		if (!issueRead(*watched))
+		{
+			WARN("Could not start watching directory: " + directory);
+			CloseHandle(watched->overlapped.hEvent);
+			CloseHandle(watched->handle);
+			continue;
+		}
+
+		m_Directories.push_back(std::move(watched));
+	}
+
+	if (m_Directories.empty())
+	{
+		CloseHandle(m_StopEvent);
+		m_StopEvent = nullptr;
+		return false;
+	}
+
+	m_Thread = std::thread(&Win32FileWatcher::run, this);
+	return true;
+}
+
+void Win32FileWatcher::run()
+{
+	Vector<HANDLE> events = { m_StopEvent };
+	for (auto& directory : m_Directories)
+	{
+		events.push_back(directory->overlapped.hEvent);
+	}
+
+	while (true)
+	{
+		DWORD result = WaitForMultipleObjects(events.size(), events.data(), FALSE, INFINITE);
+		if (result == WAIT_OBJECT_0 || result < WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + events.size())
+		{
+			return;
+		}
+
+		WatchedDirectory& directory = *m_Directories[result - WAIT_OBJECT_0 - 1];
+		DWORD bytes = 0;
+		// Zero bytes means the notification buffer overflowed and this batch of changes was dropped by the OS
+		if (GetOverlappedResult(directory.handle, &directory.overlapped, &bytes, FALSE) && bytes > 0)
+		{
+			const char* cursor = (const char*)directory.buffer;
+			while (true)
+			{
+				const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)cursor;
+				std::wstring fileName(info->FileName, info->FileNameLength / sizeof(WCHAR));
+				pushChange(FilePath(directory.path) / fileName);
+
+				if (info->NextEntryOffset == 0)
+				{
+					break;
+				}
+				cursor += info->NextEntryOffset;
+			}
+		}
+
+		if (!issueRead(directory))
+		{
+			WARN("Stopped watching directory: " + directory.path);
+		}
+	}
+}
+
+void Win32FileWatcher::stop()
+{
+	if (m_StopEvent)
+	{
+		SetEvent(m_StopEvent);
+	}
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+
+	for (auto& directory : m_Directories)
+	{
+		DWORD bytes = 0;
+		CancelIoEx(directory->handle, &directory->overlapped);
+		GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+		CloseHandle(directory->overlapped.hEvent);
+		CloseHandle(directory->handle);
+	}
+	m_Directories.clear();
+
+	if (m_StopEvent)
+	{
+		CloseHandle(m_StopEvent);
+		m_StopEvent = nullptr;
+	}
+}
+
+#elif defined(__linux__)
+
+/// File watcher implemented over inotify. Inotify watches are not recursive so every subdirectory gets its own watch.
+class InotifyFileWatcher : public FileWatcher
+{
+	int m_Inotify = -1;
+	int m_StopPipe[2] = { -1, -1 };
+	/// Watch descriptors to watched directory paths relative to Rootex root
+	HashMap<int, String> m_WatchedPaths;
+	std::thread m_Thread;
+
+	void addWatch(const String& directory);
+	void run();
+
+public:
+	InotifyFileWatcher() = default;
+	InotifyFileWatcher(InotifyFileWatcher&) = delete;
+	~InotifyFileWatcher() { stop(); }
+
+	bool start(const Vector<String>& directories) override;
+	void stop() override;
+};
+
+void InotifyFileWatcher::addWatch(const String& directory)
+{
+	int watch = inotify_add_watch(m_Inotify, OS::GetAbsolutePath(directory).c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+	if (watch < 0)
+	{
+		WARN("Could not watch directory: " + directory);
+		return;
+	}
+	m_WatchedPaths[watch] = FilePath(directory).generic_string();
+
+	for (auto& subdirectory : OS::GetDirectoriesInDirectory(directory))
+	{
+		addWatch(subdirectory.generic_string());
+	}
+}
+
+bool InotifyFileWatcher::start(const Vector<String>& directories)
+{
+	if (m_Thread.joinable())
+	{
+		WARN("File watcher is already running");
+		return false;
+	}
+
+	m_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_Inotify < 0 || pipe(m_StopPipe) != 0)
+	{
+		WARN("Could not initialize inotify");
+		stop();
+		return false;
+	}
+
+	for (auto& directory : directories)
+	{
+		addWatch(directory);
+	}
+	if (m_WatchedPaths.empty())
+	{
+		stop();
+		return false;
+	}
+
+	m_Thread = std::thread(&InotifyFileWatcher::run, this);
+	return true;
+}
+
+void InotifyFileWatcher::run()
+{
+	alignas(inotify_event) char buffer[16 * 1024];
+	pollfd fds[2] = { { m_Inotify, POLLIN, 0 }, { m_StopPipe[0], POLLIN, 0 } };
+
+	while (true)
+	{
+		if (poll(fds, 2, -1) < 0 || (fds[1].revents & POLLIN))
+		{
+			return;
+		}
+
+		ssize_t length;
+		while ((length = read(m_Inotify, buffer, sizeof(buffer))) > 0)
+		{
+			for (char* cursor = buffer; cursor < buffer + length;)
+			{
+				const inotify_event* event = (const inotify_event*)cursor;
+				cursor += sizeof(inotify_event) + event->len;
+
+				auto findIt = m_WatchedPaths.find(event->wd);
+				if (event->len == 0 || findIt == m_WatchedPaths.end())
+				{
+					continue;
+				}
+
+				FilePath path = FilePath(findIt->second) / event->name;
+				if (event->mask & IN_ISDIR)
+				{
+					if (event->mask & IN_CREATE)
+					{
+						addWatch(path.generic_string());
+					}
+					continue;
+				}
+				pushChange(path);
+			}
+		}
+	}
+}
+
+void InotifyFileWatcher::stop()
+{
+	if (m_StopPipe[1] >= 0)
+	{
+		char stop = 1;
+		write(m_StopPipe[1], &stop, 1);
+	}
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+
+	for (int* fd : { &m_Inotify, &m_StopPipe[0], &m_StopPipe[1] })
+	{
+		if (*fd >= 0)
+		{
+			close(*fd);
+			*fd = -1;
+		}
+	}
+	m_WatchedPaths.clear();
+}
+
+#endif
+
+Ptr<FileWatcher> FileWatcher::Create()
+{
+#if defined(_WIN32)
+	return std::make_unique<Win32FileWatcher>();
+#elif defined(__linux__)
+	return std::make_unique<InotifyFileWatcher>();
+#else
+	return nullptr;
+#endif
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "common/types.h"
+
+#include <chrono>
+#include <thread>
+
+/// Watches directories for file changes on a background thread and batches the changed paths.
+/// Backed by the native change notification API of the platform: ReadDirectoryChangesW on Windows and inotify on Linux.
+class FileWatcher
+{
+	Mutex m_ChangesMutex;
+	/// Changed paths relative to Rootex root, with the time the last change was seen on each.
+	HashMap<String, std::chrono::steady_clock::time_point> m_PendingChanges;
+
+protected:
+	/// Record a change to a file. Path should be relative to Rootex root. Internally synchronised.
+	void pushChange(const FilePath& path);
+
+public:
+	/// Milliseconds a file has to stay unchanged before its change is reported. Coalesces editors that save in several writes.
+	static constexpr int SETTLE_MILLISECONDS = 100;
+
+	/// Create a watcher for the current platform. Returns nullptr if the platform is not supported.
+	static Ptr<FileWatcher> Create();
+
+	FileWatcher() = default;
+	FileWatcher(FileWatcher&) = delete;
+	virtual ~FileWatcher() = default;
+
+	/// Start watching the directories (relative to Rootex root) recursively on the watcher thread.
+	virtual bool start(const Vector<String>& directories) = 0;
+	/// Stop the watcher thread and release all watch handles.
+	virtual void stop() = 0;
+
+	/// Take the batch of changes that have settled since the last call.
+	Vector<String> takeChanges();
+};
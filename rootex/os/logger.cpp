@@ -0,0 +1,199 @@
+#include "logger.h"
+
+#include "os/timer.h"
+
+#include "Tracy/Tracy.hpp"
+
+#include <iostream>
+
+Logger::Logger()
+{
+	m_IsRunning = true;
+	m_SinkThread = std::thread(&Logger::runSink, this);
+}
+
+Logger::~Logger()
+{
+	shutDown();
+}
+
+Logger* Logger::GetSingleton()
+{
+	static Logger singleton;
+	return &singleton;
+}
+
+LogLevel Logger::GetLevelFromName(const String& name)
+{
+	if (name == "Trace")
+	{
+		return LogLevel::Trace;
+	}
+	if (name == "Warning")
+	{
+		return LogLevel::Warning;
+	}
+	if (name == "Error")
+	{
+		return LogLevel::Error;
+	}
+	return LogLevel::Print;
+}
+
+void Logger::log(LogLevel level, String message, bool isInline)
+{
+	if (!IsEnabled(level))
+	{
+		return;
+	}
+
+	LogEntry entry = { level, std::move(message), isInline };
+	if (!m_IsRunning)
+	{
+		write({ entry });
+		return;
+	}
+
+	// A full queue means the sink is behind, so wait for it rather than lose messages
+	while (!m_Queue.push(std::move(entry)))
+	{
+		std::this_thread::yield();
+	}
+	m_Logged++;
+}
+
+void Logger::runSink()
+{
+	tracy::SetThreadName("Logger");
+	StopTimer timer;
+	Vector<LogEntry> written;
+	LogEntry entry;
+	while (true)
+	{
+		const bool isRunning = m_IsRunning;
+
+		unsigned long long taken = 0;
+		const float now = timer.getTimeMs();
+		while (m_Queue.pop(entry))
+		{
+			taken++;
+			if (isAllowed(entry.message, now))
+			{
+				written.push_back(std::move(entry));
+			}
+		}
+		if (now - m_LastSweep > LOG_RATE_LIMIT_WINDOW_MILLISECONDS)
+		{
+			sweepRepeats(now, written);
+			m_LastSweep = now;
+		}
+
+		if (!written.empty())
+		{
+			ZoneNamedN(sink, "Log Sink", true);
+			write(written);
+			{
+				std::lock_guard<Mutex> lock(m_BatchMutex);
+				m_Batch.insert(m_Batch.end(), std::make_move_iterator(written.begin()), std::make_move_iterator(written.end()));
+				if (m_Batch.size() > LOG_BATCH_CAPACITY)
+				{
+					m_Batch.erase(m_Batch.begin(), m_Batch.end() - LOG_BATCH_CAPACITY);
+				}
+			}
+			written.clear();
+		}
+		m_Written += taken;
+
+		// Everything logged before shutDown was called has been drained by now
+		if (!isRunning)
+		{
+			break;
+		}
+		if (taken == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(LOG_SINK_INTERVAL_MILLISECONDS));
+		}
+	}
+}
+
+bool Logger::isAllowed(const String& message, float now)
+{
+	Repeat& repeat = m_Repeats[message];
+	if (now - repeat.windowStart > LOG_RATE_LIMIT_WINDOW_MILLISECONDS)
+	{
+		repeat.windowStart = now;
+		repeat.count = 0;
+	}
+	repeat.count++;
+	return repeat.count <= LOG_RATE_LIMIT_COUNT;
+}
+
+void Logger::sweepRepeats(float now, Vector<LogEntry>& written)
+{
+	for (auto it = m_Repeats.begin(); it != m_Repeats.end();)
+	{
+		const Repeat& repeat = it->second;
+		if (now - repeat.windowStart <= LOG_RATE_LIMIT_WINDOW_MILLISECONDS)
+		{
+			it++;
+			continue;
+		}
+		if (repeat.count > LOG_RATE_LIMIT_COUNT)
+		{
+			written.push_back({ LogLevel::Warning, "Suppressed " + std::to_string(repeat.count - LOG_RATE_LIMIT_COUNT) + " repeats of: " + it->first });
+		}
+		it = m_Repeats.erase(it);
+	}
+}
+
+void Logger::write(const Vector<LogEntry>& entries)
+{
+	String output;
+	for (auto& entry : entries)
+	{
+		switch (entry.level)
+		{
+		case LogLevel::Warning:
+			output += "\033[93m" + entry.message + "\033[0m";
+			break;
+		case LogLevel::Error:
+			output += "\033[91m" + entry.message + "\033[0m";
+			break;
+		default:
+			output += entry.message;
+			break;
+		}
+		if (!entry.isInline)
+		{
+			output += '\n';
+		}
+	}
+
+	std::cout.clear();
+	std::cout << output << std::flush;
+}
+
+void Logger::flush()
+{
+	const unsigned long long logged = m_Logged;
+	while (m_IsRunning && m_Written < logged)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void Logger::shutDown()
+{
+	m_IsRunning = false;
+	if (m_SinkThread.joinable())
+	{
+		m_SinkThread.join();
+	}
+}
+
+void Logger::takeBatch(Vector<LogEntry>& batch)
+{
+	std::lock_guard<Mutex> lock(m_BatchMutex);
+	batch.insert(batch.end(), std::make_move_iterator(m_Batch.begin()), std::make_move_iterator(m_Batch.end()));
+	m_Batch.clear();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "common/types.h"
+#include "os/mpsc_queue.h"
+
+#include <thread>
+
+/// Messages waiting for the sink thread. Must be a power of 2.
+#define LOG_QUEUE_CAPACITY 8192
+/// Time the sink thread sleeps when there is nothing to write
+#define LOG_SINK_INTERVAL_MILLISECONDS 5
+/// Times the same message may be written in one rate limit window before the rest are counted instead
+#define LOG_RATE_LIMIT_COUNT 10
+#define LOG_RATE_LIMIT_WINDOW_MILLISECONDS 1000
+/// Messages kept for takeBatch. The oldest are dropped first when nobody takes them.
+#define LOG_BATCH_CAPACITY 4096
+
+/// Severity of a log message. Messages below the minimum level are dropped before they are formatted.
+enum class LogLevel
+{
+	Trace,
+	Print,
+	Warning,
+	Error
+};
+
+struct LogEntry
+{
+	LogLevel level = LogLevel::Print;
+	String message;
+	/// Written without a line break
+	bool isInline = false;
+};
+
+/// Hands log messages to a background sink thread through a lock-free queue.
+/// The sink writes to the console once per batch and keeps batches for the editor output.
+class Logger
+{
+	struct Repeat
+	{
+		unsigned int count = 0;
+		float windowStart = 0.0f;
+	};
+
+	static inline Atomic<int> s_MinimumLevel = (int)LogLevel::Print;
+
+	MPSCQueue<LogEntry, LOG_QUEUE_CAPACITY> m_Queue;
+	std::thread m_SinkThread;
+	Atomic<bool> m_IsRunning = false;
+	/// Messages accepted and messages written, for flush to wait on
+	Atomic<unsigned long long> m_Logged = 0;
+	Atomic<unsigned long long> m_Written = 0;
+
+	/// Only touched by the sink thread
+	HashMap<String, Repeat> m_Repeats;
+	float m_LastSweep = 0.0f;
+
+	Mutex m_BatchMutex;
+	Vector<LogEntry> m_Batch;
+
+	Logger();
+	Logger(Logger&) = delete;
+	~Logger();
+
+	void runSink();
+	/// Returns false if the message was repeated too often recently
+	bool isAllowed(const String& message, float now);
+	/// Report messages whose rate limit window has ended
+	void sweepRepeats(float now, Vector<LogEntry>& written);
+	void write(const Vector<LogEntry>& entries);
+
+public:
+	static Logger* GetSingleton();
+
+	static bool IsEnabled(LogLevel level) { return (int)level >= s_MinimumLevel.load(std::memory_order_relaxed); }
+	static void SetMinimumLevel(LogLevel level) { s_MinimumLevel = (int)level; }
+	/// Accepts "Trace", "Print", "Warning" or "Error"
+	static LogLevel GetLevelFromName(const String& name);
+
+	/// Queue a message for the sink thread. Safe to call from any thread.
+	void log(LogLevel level, String message, bool isInline = false);
+	/// Block until everything logged so far has been written.
+	void flush();
+	/// Write what is left and stop the sink thread. Messages logged afterwards are written on the calling thread.
+	void shutDown();
+
+	/// Move the messages written since the last call into batch, up to the last LOG_BATCH_CAPACITY of them. Messages are collected from startup.
+	void takeBatch(Vector<LogEntry>& batch);
+};
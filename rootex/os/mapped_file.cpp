@@ -0,0 +1,122 @@
+#include "mapped_file.h"
+
+#include "common/common.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+Ptr<MappedFile> MappedFile::Open(const String& path)
+{
+	const String absolutePath = OS::GetAbsolutePath(path).string();
+
+	HANDLE file = CreateFileA(absolutePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return nullptr;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	Ptr<MappedFile> mappedFile(new MappedFile());
+	mappedFile->m_File = file;
+	mappedFile->m_Mapping = mapping;
+	mappedFile->m_Data = (char*)data;
+	mappedFile->m_Size = size.QuadPart;
+	return mappedFile;
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_Data)
+	{
+		UnmapViewOfFile(m_Data);
+	}
+	if (m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+	}
+	if (m_File)
+	{
+		CloseHandle(m_File);
+	}
+}
+
+#elif defined(__linux__)
+
+Ptr<MappedFile> MappedFile::Open(const String& path)
+{
+	const String absolutePath = OS::GetAbsolutePath(path).string();
+
+	int file = open(absolutePath.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return nullptr;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0)
+	{
+		close(file);
+		return nullptr;
+	}
+
+	void* data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	// The mapping holds its own reference to the file
+	close(file);
+	if (data == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	Ptr<MappedFile> mappedFile(new MappedFile());
+	mappedFile->m_Data = (char*)data;
+	mappedFile->m_Size = info.st_size;
+	return mappedFile;
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_Data)
+	{
+		munmap(m_Data, m_Size);
+	}
+}
+
+#else
+
+Ptr<MappedFile> MappedFile::Open(const String& path)
+{
+	return nullptr;
+}
+
+MappedFile::~MappedFile()
+{
+}
+
+#endif
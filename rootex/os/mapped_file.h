@@ -0,0 +1,27 @@
+#pragma once
+
+#include "common/types.h"
+
+/// File mapped into memory instead of being read into a buffer.
+/// Pages are mapped copy-on-write so the contents can be patched in place without touching the file on disk.
+class MappedFile
+{
+	char* m_Data = nullptr;
+	size_t m_Size = 0;
+#if defined(_WIN32)
+	void* m_File = nullptr;
+	void* m_Mapping = nullptr;
+#endif
+
+	MappedFile() = default;
+
+public:
+	/// Map a file relative to Rootex root. Returns nullptr if the file could not be mapped.
+	static Ptr<MappedFile> Open(const String& path);
+
+	MappedFile(MappedFile&) = delete;
+	~MappedFile();
+
+	char* getData() const { return m_Data; }
+	size_t getSize() const { return m_Size; }
+};
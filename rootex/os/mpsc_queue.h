@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/types.h"
+
+/// A fixed size ring buffer passing items from any number of producer threads to exactly one consumer thread without locks.
+/// Each slot carries a sequence number telling producers and the consumer whose turn it is. Capacity must be a power of 2.
+template <class T, size_t Capacity>
+class MPSCQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MPSCQueue capacity must be a power of 2");
+
+	struct Slot
+	{
+		Atomic<size_t> sequence;
+		T item;
+	};
+
+	Ptr<Slot[]> m_Slots;
+	/// Kept on separate cache lines so producers and the consumer do not fight over them
+	alignas(64) Atomic<size_t> m_Enqueue = 0;
+	alignas(64) Atomic<size_t> m_Dequeue = 0;
+
+public:
+	MPSCQueue()
+	    : m_Slots(new Slot[Capacity])
+	{
+		for (size_t i = 0; i < Capacity; i++)
+		{
+			m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	MPSCQueue(MPSCQueue&) = delete;
+	~MPSCQueue() = default;
+
+	/// Safe to call from any thread. Returns false if the queue is full.
+	bool push(T&& item)
+	{
+		size_t position = m_Enqueue.load(std::memory_order_relaxed);
+		Slot* slot;
+		while (true)
+		{
+			slot = &m_Slots[position & (Capacity - 1)];
+			const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+			if (difference == 0)
+			{
+				if (m_Enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_Enqueue.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->item = std::move(item);
+		slot->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Called only by the consumer. Returns false if the queue is empty.
+	bool pop(T& item)
+	{
+		const size_t position = m_Dequeue.load(std::memory_order_relaxed);
+		Slot& slot = m_Slots[position & (Capacity - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+		{
+			return false;
+		}
+
+		item = std::move(slot.item);
+		m_Dequeue.store(position + 1, std::memory_order_relaxed);
+		slot.sequence.store(position + Capacity, std::memory_order_release);
+		return true;
+	}
+};
@@ -10,7 +10,6 @@
 #include <commctrl.h>
 #include <shellapi.h>
 
-#include "event_manager.h"
 
 std::filesystem::file_time_type::clock OS::s_FileSystemClock;
 const std::chrono::time_point<std::chrono::system_clock> OS::s_ApplicationStartTime = std::chrono::system_clock::now();
@@ -480,15 +479,12 @@ bool OS::IsExists(String relativePath)
 
 void OS::Print(const String& msg, const String& type)
 {
-	PrintInline(msg, type);
-	std::cout << std::endl;
+	Logger::GetSingleton()->log(Logger::GetLevelFromName(type), msg);
 }
 
 void OS::PrintInline(const String& msg, const String& type)
 {
-	EventManager::GetSingleton()->call(RootexEvents::OSPrint, VariantVector { msg, type });
-	std::cout.clear();
-	std::cout << msg;
+	Logger::GetSingleton()->log(Logger::GetLevelFromName(type), msg, true);
 }
 
 void OS::Print(const float& real)
@@ -513,31 +509,26 @@ void OS::PrintLine(const String& msg)
 
 void OS::PrintWarning(const String& warning)
 {
-	std::cout << "\033[93m";
 	Print("WARNING: " + warning, "Warning");
-	std::cout << "\033[0m";
 }
 
 void OS::PrintWarningInline(const String& warning)
 {
-	std::cout << "\033[93m";
 	PrintInline("WARNING: " + warning, "Warning");
-	std::cout << "\033[0m";
 }
 
 void OS::PrintError(const String& error)
 {
-	std::cout << "\033[91m";
 	Print("ERROR: " + error, "Error");
-	std::cout << "\033[0m";
+	// Get everything before the error on screen before the message box blocks
+	Logger::GetSingleton()->flush();
 	PostError(error, "Error");
 }
 
 void OS::PrintErrorInline(const String& error)
 {
-	std::cout << "\033[91m";
 	PrintInline("ERROR: " + error, "Error");
-	std::cout << "\033[0m";
+	Logger::GetSingleton()->flush();
 	PostError(error, "Error");
 }
 
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "common/common.h"
+
+/// A fixed size ring buffer passing items from exactly one producer thread to exactly one consumer thread without locks.
+/// Capacity must be a power of 2. One slot is always left empty to tell a full ring from an empty one.
+template <class T, size_t Capacity>
+class SPSCQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of 2");
+
+	T m_Items[Capacity];
+	/// Kept on separate cache lines so the two threads do not fight over them
+	alignas(64) Atomic<size_t> m_Head = 0;
+	alignas(64) Atomic<size_t> m_Tail = 0;
+
+public:
+	SPSCQueue() = default;
+	SPSCQueue(SPSCQueue&) = delete;
+	~SPSCQueue() = default;
+
+	/// Called only by the producer. Returns false if the queue is full.
+	bool push(const T& item)
+	{
+		const size_t tail = m_Tail.load(std::memory_order_relaxed);
+		const size_t next = (tail + 1) & (Capacity - 1);
+		if (next == m_Head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		m_Items[tail] = item;
+		m_Tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	/// Called only by the consumer. Returns false if the queue is empty.
+	bool pop(T& item)
+	{
+		const size_t head = m_Head.load(std::memory_order_relaxed);
+		if (head == m_Tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		item = m_Items[head];
+		m_Head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+		return true;
+	}
+
+	/// Approximate when called while the other thread is active
+	bool isEmpty() const { return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire); }
+};
@@ -1,5 +1,6 @@
 #include "thread.h"
 #include <Windows.h>
+#include <thread>
 
 #include "Tracy/Tracy.hpp"
 
@@ -30,14 +31,6 @@ void ThreadPool::initialize()
 	m_DefaultWorkerParameter.m_Thread = 0;
 	m_DefaultWorkerParameter.m_ThreadPool = NULL;
 
-	{
-		m_TaskQueue.m_Read = 0;
-		m_TaskQueue.m_Write = 0;
-		m_TaskQueue.m_Jobs = 0;
-		m_TasksFinished = 0;
-		m_TasksComplete.m_Jobs = 0;
-	}
-
 	for (__int32 iThread = 0; iThread < m_Threads; iThread++)
 	{
 		m_WorkerParameters.push_back(m_DefaultWorkerParameter);
@@ -54,33 +47,13 @@ void ThreadPool::initialize()
 
 DWORD WINAPI MainLoop(LPVOID voidParameters)
 {
-	ZoneScoped;
 	const struct WorkerParameters* parameters = (struct WorkerParameters*)voidParameters;
-
-	const __int32 iThread = parameters->m_Thread;
 	ThreadPool& threadPool = *parameters->m_ThreadPool;
 
-	__int32 taskId = -1;
-	__int32 increment = 0;
-
 	while (true)
 	{
-		ZoneNamedN(process, "Main Threadpool loop", true);
-
 		EnterCriticalSection(&threadPool.m_CriticalSection);
-
-		/*if (m_ThreadPool.m_TasksComplete.m_Jobs > 0)
-		{
-			m_ThreadPool.m_TasksComplete.ids.push_back(taskId);
-			m_ThreadPool.m_TasksComplete.m_Jobs += increment;
-			m_ThreadPool.m_TasksFinished += increment;
-			increment++;
-			std::cout << increment;
-		}*/
-
-		WakeAllConditionVariable(&threadPool.m_ProducerVariable);
-
-		while ((threadPool.m_TaskQueue.m_Jobs == 0) && threadPool.m_IsRunning)
+		while (threadPool.m_TaskQueue.empty() && threadPool.m_IsRunning)
 		{
 			SleepConditionVariableCS(&threadPool.m_ConsumerVariable, &threadPool.m_CriticalSection, INFINITE);
 		}
@@ -91,132 +64,95 @@ DWORD WINAPI MainLoop(LPVOID voidParameters)
 			return 0;
 		}
 
-		taskId = threadPool.m_TaskQueue.m_QueueJobs[threadPool.m_TaskQueue.m_Read]->m_ID;
-		__int32 readTemp = threadPool.m_TaskQueue.m_Read;
-		threadPool.m_TaskQueue.m_Jobs--;
-		threadPool.m_TaskQueue.m_Read++;
-
+		Ref<Task> task = threadPool.m_TaskQueue.front();
+		threadPool.m_TaskQueue.pop_front();
 		LeaveCriticalSection(&threadPool.m_CriticalSection);
 
-		threadPool.m_TaskQueue.m_QueueJobs[readTemp]->execute();
-		threadPool.m_TasksComplete.m_Jobs++;
+		threadPool.run(task);
 	}
 	return 0;
 }
 
-void ThreadPool::submit(Vector<Ref<Task>>& tasks)
+void ThreadPool::run(const Ref<Task>& task)
 {
-	join();
-
-	MasterThread masterThread;
-	masterThread.m_TasksComplete.m_Jobs = 0;
-	masterThread.m_TasksReady.m_Jobs = 0;
-	masterThread.m_TasksReady.m_Read = 0;
-	masterThread.m_TasksReady.m_Write = 0;
-
-	bool isTasksRemaining = true;
-
-	m_TasksFinished = 0;
+	{
+		ZoneNamedN(process, "Thread Pool Task", true);
+		task->execute();
+	}
 
+	if (--task->m_Batch->m_Remaining == 0)
 	{
-		static __int32 idIndex = 0;
-		for (auto iJob : tasks)
-		{
-			iJob->m_Dependencies = 0;
-			m_TaskQueue.m_QueueJobs.push_back(iJob);
-			m_TaskQueue.m_QueueJobs[idIndex]->m_ID = idIndex;
-			idIndex++;
-		}
+		// Taking the lock orders the wake after a waiter's check of the batch, so the wake cannot be missed
+		EnterCriticalSection(&m_CriticalSection);
+		LeaveCriticalSection(&m_CriticalSection);
+		WakeAllConditionVariable(&m_ProducerVariable);
+	}
+	m_PendingTasks--;
+}
 
-		/*for (__int32 i_Job = 0; i_Job < tasks.size(); i_Job++)
-		{
-			for (__int32 i_Permission = 0; i_Permission < tasks[i_Job]->m_Permisions; i_Permission++)
-			{
-				tasks[tasks[i_Job]->i_Permissions[i_Permission]]->m_Dependencies++;
-			}
-		}*/
+Ref<TaskBatch> ThreadPool::submit(const Vector<Ref<Task>>& tasks)
+{
+	Ref<TaskBatch> batch(new TaskBatch());
+	batch->m_Remaining = tasks.size();
+	if (tasks.empty())
+	{
+		return batch;
 	}
 
-	while (isTasksRemaining)
+	EnterCriticalSection(&m_CriticalSection);
+	for (auto& task : tasks)
 	{
+		task->m_Batch = batch;
+		m_TaskQueue.push_back(task);
+	}
+	m_PendingTasks += tasks.size();
+	LeaveCriticalSection(&m_CriticalSection);
+	WakeAllConditionVariable(&m_ConsumerVariable);
 
-		/*{
-			const __int32 nJobs = master_thread.m_TasksComplete.m_Jobs;
-			for (__int32 i_job = 0; i_job < nJobs; i_job++)
-			{
-				__int32 taskId = master_thread.m_TasksComplete.ids[i_job];
-
-				for (__int32 i_Permission = 0; i_Permission < tasks[taskId]->m_Permisions; i_Permission++)
-				{
-					tasks[tasks[taskId]->i_Permissions[i_Permission]]->m_Dependencies--;
-				}
-				master_thread.m_TasksComplete.m_Jobs--;
-			}
-		}*/
-		{
-			__int32 iJob = 0;
-			while (iJob < tasks.size())
-			{
-				if (tasks[iJob]->m_Dependencies == 0)
-				{
-					masterThread.m_TasksReady.m_IDs.push_back(tasks[iJob]->m_ID);
-					masterThread.m_TasksReady.m_Write++;
-					masterThread.m_TasksReady.m_Jobs++;
-					tasks[iJob]->m_Dependencies--;
-				}
-				iJob++;
-			}
-		}
+	return batch;
+}
 
+void ThreadPool::wait(const Ref<TaskBatch>& batch)
+{
+	ZoneScoped;
+	while (true)
+	{
 		EnterCriticalSection(&m_CriticalSection);
-
-		{
-			__int32 nJobs = masterThread.m_TasksReady.m_Jobs;
-			for (__int32 i_Job = 0; i_Job < nJobs; i_Job++)
-			{
-				m_TaskQueue.m_QueueJobs[m_TaskQueue.m_Write]->m_ID = masterThread.m_TasksReady.m_IDs[masterThread.m_TasksReady.m_Read];
-				m_TaskQueue.m_Write++;
-				m_TaskQueue.m_Jobs++;
-				m_TasksFinished++;
-				masterThread.m_TasksReady.m_Read++;
-				masterThread.m_TasksReady.m_Jobs--;
-			}
-		}
-
-		WakeAllConditionVariable(&m_ConsumerVariable);
-
-		while ((m_TasksComplete.m_Jobs == 0) && m_IsRunning)
+		auto findIt = std::find_if(m_TaskQueue.begin(), m_TaskQueue.end(), [&batch](const Ref<Task>& task) { return task->m_Batch == batch; });
+		if (findIt == m_TaskQueue.end())
 		{
-			SleepConditionVariableCS(&m_ProducerVariable, &m_CriticalSection, INFINITE);
+			break;
 		}
+		Ref<Task> task = *findIt;
+		m_TaskQueue.erase(findIt);
+		LeaveCriticalSection(&m_CriticalSection);
 
-		/*{
-			const __int32 nJobs = m_TasksComplete.m_Jobs;
-			for (__int32 i_Job = 0; i_Job < nJobs; i_Job++)
-			{
-
-				master_thread.m_TasksComplete.ids[i_Job] = m_TasksComplete.ids[i_Job];
-				master_thread.m_TasksComplete.m_Jobs++;
-				m_TasksComplete.m_Jobs--;
-			}
-		}*/
-
-		isTasksRemaining = m_TasksFinished < tasks.size();
+		run(task);
+	}
 
-		LeaveCriticalSection(&m_CriticalSection);
+	// The rest of the batch is running on other threads
+	while (!batch->isCompleted())
+	{
+		SleepConditionVariableCS(&m_ProducerVariable, &m_CriticalSection, INFINITE);
 	}
+	LeaveCriticalSection(&m_CriticalSection);
+}
+
+void ThreadPool::execute(const Vector<Ref<Task>>& tasks)
+{
+	wait(submit(tasks));
 }
 
 bool ThreadPool::isCompleted() const
 {
-	return m_TaskQueue.m_QueueJobs.size() == m_TasksComplete.m_Jobs;
+	return m_PendingTasks.load() == 0;
 }
 
 void ThreadPool::join() const
 {
 	while (!isCompleted())
 	{
-		;
+		std::this_thread::yield();
 	}
 }
 
@@ -4,8 +4,11 @@
 
 #include <Windows.h>
 
+#include <deque>
+
 /// Interface for spawning and maintenance of threads.
 class ThreadPool;
+class TaskBatch;
 
 /// Defines jobs to be run on threads.
 class Task
@@ -15,6 +18,8 @@ public:
 	__int32 m_Dependencies;
 	Vector<__int32> m_Permissions;
 	Function<void()> m_ExecutionTask;
+	/// Batch the task was submitted with
+	Ref<TaskBatch> m_Batch;
 
 	Task(const Function<void()>& executionTask);
 	Task(const Task&) = default;
@@ -23,43 +28,22 @@ public:
 	void execute();
 };
 
-/// Worker thread parameters.
-struct WorkerParameters
+/// Tasks submitted together, so they can be waited on without waiting for the rest of the work in the pool.
+class TaskBatch
 {
-	__int32 m_Thread;
-	ThreadPool* m_ThreadPool;
-};
+	Atomic<int> m_Remaining = 0;
 
-/// A queue of jobs.
-struct TaskQueue
-{
-	__int32 m_Jobs;
-	unsigned __int32 m_Write;
-	unsigned __int32 m_Read;
-	Vector<Ref<Task>> m_QueueJobs;
-};
+	friend class ThreadPool;
 
-/// Contains the information of completed jobs.
-struct TaskComplete
-{
-	__int32 m_Jobs;
-	Vector<__int32> m_IDs;
-};
-
-/// Contains information of jobs ready for execution.
-struct TaskReady
-{
-	__int32 m_Jobs;
-	unsigned __int32 m_Write;
-	unsigned __int32 m_Read;
-	Vector<__int32> m_IDs;
+public:
+	bool isCompleted() const { return m_Remaining.load() == 0; }
 };
 
-/// Master thread to communicate with and maintain worker threads.
-struct MasterThread
+/// Worker thread parameters.
+struct WorkerParameters
 {
-	TaskComplete m_TasksComplete;
-	TaskReady m_TasksReady;
+	__int32 m_Thread;
+	ThreadPool* m_ThreadPool;
 };
 
 class ThreadPool
@@ -70,26 +54,36 @@ class ThreadPool
 	WorkerParameters m_DefaultWorkerParameter;
 	Vector<HANDLE> m_Handles;
 	HANDLE m_DefaultHandle = 0;
+	/// Signalled when tasks are queued
 	CONDITION_VARIABLE m_ConsumerVariable;
+	/// Signalled when a batch completes
 	CONDITION_VARIABLE m_ProducerVariable;
 	CRITICAL_SECTION m_CriticalSection;
 
-	__int32 m_TasksFinished;
-	TaskQueue m_TaskQueue;
-	TaskComplete m_TasksComplete;
+	/// Tasks not picked up by a thread yet. Tasks are dropped once picked up, so finished ones are freed.
+	std::deque<Ref<Task>> m_TaskQueue;
+	/// Tasks queued or running
+	Atomic<int> m_PendingTasks = 0;
 
 	friend DWORD WINAPI MainLoop(LPVOID voidParameters);
 
 	void initialize();
 	void shutDown();
+	/// Execute a task taken off the queue and wake the threads waiting on its batch if it was the last one
+	void run(const Ref<Task>& task);
 
 public:
 	ThreadPool();
 	ThreadPool(ThreadPool&) = delete;
 	~ThreadPool();
 
-	/// To submit a job to the jobs queue.
-	void submit(Vector<Ref<Task>>& tasks);
+	/// Queue tasks and return right away. Wait on the returned batch to know when they are done.
+	Ref<TaskBatch> submit(const Vector<Ref<Task>>& tasks);
+	/// Returns when every task of the batch has finished. Runs the tasks of the batch no thread has picked up yet on the calling thread,
+	/// so waiting never depends on unrelated work queued earlier.
+	void wait(const Ref<TaskBatch>& batch);
+	/// Submit tasks and wait for them
+	void execute(const Vector<Ref<Task>>& tasks);
 
 	/// Returns true if all tasks have been completed
 	bool isCompleted() const;
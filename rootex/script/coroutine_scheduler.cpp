@@ -0,0 +1,241 @@
+#include "coroutine_scheduler.h"
+
+#include "event_manager.h"
+#include "script/script.h"
+
+#include "Tracy/Tracy.hpp"
+
+#include <cmath>
+
+TimerWheel::TimerWheel(unsigned int slots)
+    : m_Slots(slots)
+{
+}
+
+void TimerWheel::schedule(unsigned long long wakeTick, CoroutineID id)
+{
+	wakeTick = std::max(wakeTick, m_CurrentTick + 1);
+	m_Slots[wakeTick % m_Slots.size()].push_back({ wakeTick, id });
+	m_Count++;
+}
+
+void TimerWheel::advance(unsigned long long toTick, Vector<CoroutineID>& woken)
+{
+	if (toTick <= m_CurrentTick)
+	{
+		return;
+	}
+
+	const unsigned long long steps = std::min<unsigned long long>(toTick - m_CurrentTick, m_Slots.size());
+	for (unsigned long long step = 1; step <= steps; step++)
+	{
+		Vector<Pair<unsigned long long, CoroutineID>>& slot = m_Slots[(m_CurrentTick + step) % m_Slots.size()];
+		for (int i = 0; i < slot.size();)
+		{
+			if (slot[i].first <= toTick)
+			{
+				woken.push_back(slot[i].second);
+				slot[i] = slot.back();
+				slot.pop_back();
+				m_Count--;
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+	m_CurrentTick = toTick;
+}
+
+CoroutineScheduler::CoroutineScheduler()
+    : m_TimeWheel(COROUTINE_WHEEL_SLOTS)
+    , m_FrameWheel(COROUTINE_WHEEL_SLOTS)
+{
+}
+
+template <typename... Args>
+void CoroutineScheduler::resume(CoroutineID id, Args&&... args)
+{
+	auto findIt = m_Coroutines.find(id);
+	if (findIt == m_Coroutines.end())
+	{
+		// Stopped while waiting
+		return;
+	}
+	// Keeps the coroutine alive if it stops itself
+	Ref<Coroutine> coroutine = findIt->second;
+
+	Script::RunningScope runningScope(coroutine->owner);
+	sol::protected_function_result result = coroutine->coroutine(std::forward<Args>(args)...);
+
+	if (m_Coroutines.find(id) == m_Coroutines.end())
+	{
+		return;
+	}
+	if (!result.valid())
+	{
+		sol::error e = result;
+		WARN(e.what());
+		remove(id);
+		return;
+	}
+	if (coroutine->coroutine.status() != sol::call_status::yielded)
+	{
+		remove(id);
+		return;
+	}
+	park(id, result);
+}
+
+void CoroutineScheduler::park(CoroutineID id, const sol::protected_function_result& result)
+{
+	// A bare coroutine.yield() waits for the next frame
+	Wait wait = Wait::Frames;
+	if (result.return_count() >= 2 && result.get_type(0) == sol::type::number)
+	{
+		wait = (Wait)result.get<int>(0);
+	}
+
+	switch (wait)
+	{
+	case Wait::Seconds:
+	{
+		double wakeMilliseconds = m_TimeMilliseconds + result.get<double>(1) * 1000.0;
+		m_TimeWheel.schedule((unsigned long long)std::ceil(wakeMilliseconds / COROUTINE_WHEEL_TICK_MILLISECONDS), id);
+		break;
+	}
+	case Wait::Frames:
+	{
+		int frames = result.return_count() >= 2 ? result.get<int>(1) : 1;
+		m_FrameWheel.schedule(m_Frame + std::max(frames, 1), id);
+		break;
+	}
+	case Wait::Event:
+		waitForEvent(id, result.get<String>(1));
+		break;
+	default:
+		WARN("Coroutine yielded an unknown wait type, waiting a frame instead");
+		m_FrameWheel.schedule(m_Frame + 1, id);
+	}
+}
+
+void CoroutineScheduler::waitForEvent(CoroutineID id, const String& eventName)
+{
+	EventWaiters& eventWaiters = m_EventWaiters[eventName];
+	bindEventListener(eventName, eventWaiters);
+	eventWaiters.waiters.push_back(id);
+}
+
+void CoroutineScheduler::bindEventListener(const String& eventName, EventWaiters& eventWaiters)
+{
+	if (!eventWaiters.listener.expired())
+	{
+		return;
+	}
+
+	// Listener stays bound, later waits on the same event reuse it until RTX.RemoveEvent or releaseAllEventListeners drops it
+	Ref<bool> listener(new bool(true));
+	eventWaiters.listener = listener;
+	EventManager::GetSingleton()->addListener(eventName, [this, eventName, listener](const Event* event) -> Variant {
+		Vector<CoroutineID>& waiters = m_EventWaiters[eventName].waiters;
+		for (auto& waiter : waiters)
+		{
+			m_EventWoken.push_back({ waiter, event->getData() });
+		}
+		waiters.clear();
+		return true;
+	});
+}
+
+void CoroutineScheduler::remove(CoroutineID id)
+{
+	auto findIt = m_Coroutines.find(id);
+	if (findIt == m_Coroutines.end())
+	{
+		return;
+	}
+
+	if (Script* owner = findIt->second->owner)
+	{
+		Vector<CoroutineID>& owned = m_OwnedCoroutines[owner];
+		owned.erase(std::find(owned.begin(), owned.end(), id));
+		if (owned.empty())
+		{
+			m_OwnedCoroutines.erase(owner);
+		}
+	}
+	m_Coroutines.erase(findIt);
+}
+
+CoroutineID CoroutineScheduler::start(sol::function function, sol::variadic_args args, Script* owner)
+{
+	Ref<Coroutine> coroutine(new Coroutine());
+	coroutine->thread = sol::thread::create(function.lua_state());
+	coroutine->coroutine = sol::coroutine(coroutine->thread.state(), function);
+	coroutine->owner = owner;
+
+	CoroutineID id = m_NextID++;
+	m_Coroutines[id] = coroutine;
+	if (owner)
+	{
+		m_OwnedCoroutines[owner].push_back(id);
+	}
+
+	resume(id, args);
+	return id;
+}
+
+void CoroutineScheduler::stop(CoroutineID id)
+{
+	// Waits on the wheels and events are dropped lazily when they come due
+	remove(id);
+}
+
+void CoroutineScheduler::stopAll(Script* owner)
+{
+	auto findIt = m_OwnedCoroutines.find(owner);
+	if (findIt == m_OwnedCoroutines.end())
+	{
+		return;
+	}
+
+	for (auto& id : findIt->second)
+	{
+		m_Coroutines.erase(id);
+	}
+	m_OwnedCoroutines.erase(findIt);
+}
+
+void CoroutineScheduler::update(float deltaMilliseconds)
+{
+	ZoneScoped;
+
+	m_Frame++;
+	m_TimeMilliseconds += deltaMilliseconds;
+
+	Vector<CoroutineID> woken;
+	m_FrameWheel.advance(m_Frame, woken);
+	m_TimeWheel.advance((unsigned long long)(m_TimeMilliseconds / COROUTINE_WHEEL_TICK_MILLISECONDS), woken);
+	for (auto& id : woken)
+	{
+		resume(id);
+	}
+
+	// Waiters of events whose listener was dropped would otherwise never wake
+	for (auto& [eventName, eventWaiters] : m_EventWaiters)
+	{
+		if (!eventWaiters.waiters.empty())
+		{
+			bindEventListener(eventName, eventWaiters);
+		}
+	}
+
+	// Events fired by the coroutines resumed below wake their waiters next frame
+	Vector<Pair<CoroutineID, Variant>> eventWoken;
+	eventWoken.swap(m_EventWoken);
+	for (auto& [id, data] : eventWoken)
+	{
+		resume(id, data);
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "common/common.h"
+#include "script/interpreter.h"
+
+class Script;
+
+typedef unsigned int CoroutineID;
+
+/// Milliseconds covered by one slot of the time wheel
+#define COROUTINE_WHEEL_TICK_MILLISECONDS 4
+#define COROUTINE_WHEEL_SLOTS 1024
+
+/// Hashed timer wheel. Sleepers are bucketed by wake tick so advancing the wheel only visits
+/// the slots passed over, and a long sleeper is looked at once per revolution.
+class TimerWheel
+{
+	Vector<Vector<Pair<unsigned long long, CoroutineID>>> m_Slots;
+	unsigned long long m_CurrentTick = 0;
+	unsigned int m_Count = 0;
+
+public:
+	TimerWheel(unsigned int slots);
+	TimerWheel(const TimerWheel&) = delete;
+	~TimerWheel() = default;
+
+	/// Wake ticks that are not in the future are woken on the next advance.
+	void schedule(unsigned long long wakeTick, CoroutineID id);
+	/// Move the wheel to a tick, collecting everything due by then.
+	void advance(unsigned long long toTick, Vector<CoroutineID>& woken);
+
+	unsigned long long getCurrentTick() const { return m_CurrentTick; }
+	unsigned int getCount() const { return m_Count; }
+};
+
+/// Runs Lua functions as coroutines that park on RTX.Wait(seconds), RTX.WaitFrames(frames) or RTX.WaitForEvent(name).
+/// Parked coroutines cost nothing per frame until they are due.
+class CoroutineScheduler
+{
+public:
+	/// What a coroutine yielded to wait for
+	enum class Wait : int
+	{
+		Seconds = 0,
+		Frames = 1,
+		Event = 2
+	};
+
+private:
+	struct Coroutine
+	{
+		sol::thread thread;
+		sol::coroutine coroutine;
+		Script* owner;
+	};
+
+	HashMap<CoroutineID, Ref<Coroutine>> m_Coroutines;
+	HashMap<Script*, Vector<CoroutineID>> m_OwnedCoroutines;
+	CoroutineID m_NextID = 1;
+
+	double m_TimeMilliseconds = 0.0;
+	unsigned long long m_Frame = 0;
+	TimerWheel m_TimeWheel;
+	TimerWheel m_FrameWheel;
+	struct EventWaiters
+	{
+		Vector<CoroutineID> waiters;
+		/// Only held by the bound listener, so it expires when EventManager drops the listener
+		Weak<bool> listener;
+	};
+
+	HashMap<String, EventWaiters> m_EventWaiters;
+	Vector<Pair<CoroutineID, Variant>> m_EventWoken;
+
+	template <typename... Args>
+	void resume(CoroutineID id, Args&&... args);
+	void park(CoroutineID id, const sol::protected_function_result& result);
+	void waitForEvent(CoroutineID id, const String& eventName);
+	/// Bind the listener that wakes the waiters of an event, unless it is still bound
+	void bindEventListener(const String& eventName, EventWaiters& eventWaiters);
+	void remove(CoroutineID id);
+
+public:
+	CoroutineScheduler();
+	CoroutineScheduler(const CoroutineScheduler&) = delete;
+	~CoroutineScheduler() = default;
+
+	/// Run a function as a coroutine until it first waits. Coroutines started by a script are stopped with it.
+	CoroutineID start(sol::function function, sol::variadic_args args, Script* owner);
+	void stop(CoroutineID id);
+	void stopAll(Script* owner);
+
+	/// Advance time and frame counts and resume every coroutine that is due.
+	void update(float deltaMilliseconds);
+
+	unsigned int getCount() const { return m_Coroutines.size(); }
+	unsigned int getTimeSleeperCount() const { return m_TimeWheel.getCount(); }
+	unsigned int getFrameSleeperCount() const { return m_FrameWheel.getCount(); }
+};
@@ -6,6 +6,7 @@
 #include "scene.h"
 #include "scene_loader.h"
 #include "ecs_factory.h"
+#include "prefab.h"
 #include "script.h"
 #include "components/audio/audio_component.h"
 #include "components/audio/short_music_component.h"
@@ -23,6 +24,8 @@
 #include "components/visual/ui/ui_component.h"
 #include "components/visual/effect/particle_effect_component.h"
 #include "systems/input_system.h"
+#include "systems/script_system.h"
+#include "systems/spatial_system.h"
 #include "core/resource_files/audio_resource_file.h"
 #include "core/resource_files/font_resource_file.h"
 #include "core/resource_files/image_resource_file.h"
@@ -33,6 +36,10 @@
 #include "core/resource_files/text_resource_file.h"
 #include "core/resource_files/particle_effect_resource_file.h"
 #include "event_manager.h"
+#include "lua_memory.h"
+#include "os/timer.h"
+
+#include "Tracy/Tracy.hpp"
 
 extern "C" int luaopen_lpeg(lua_State* L);
 
@@ -51,7 +58,54 @@ int HandleLuaException(lua_State* L, sol::optional<const std::exception&> maybeE
 	return sol::stack::push(L, description);
 }
 
+/// Convert a Lua value to JSON. Tables with only the keys 1 to n become arrays, other tables become objects.
+static JSON::json LuaToJSON(const sol::object& value)
+{
+	switch (value.get_type())
+	{
+	case sol::type::boolean:
+		return value.as<bool>();
+	case sol::type::number:
+	{
+		const double number = value.as<double>();
+		if (number == (double)(int64_t)number)
+		{
+			return (int64_t)number;
+		}
+		return number;
+	}
+	case sol::type::string:
+		return value.as<String>();
+	case sol::type::table:
+	{
+		const sol::table table = value.as<sol::table>();
+		const size_t arraySize = table.size();
+		size_t pairCount = 0;
+		table.for_each([&pairCount](const sol::object&, const sol::object&) { pairCount++; });
+
+		JSON::json j = arraySize > 0 && arraySize == pairCount ? JSON::json::array() : JSON::json::object();
+		if (j.is_array())
+		{
+			for (size_t i = 1; i <= arraySize; i++)
+			{
+				j.push_back(LuaToJSON(table.get<sol::object>(i)));
+			}
+		}
+		else
+		{
+			table.for_each([&j](const sol::object& key, const sol::object& item) {
+				j[key.get_type() == sol::type::string ? key.as<String>() : std::to_string(key.as<int64_t>())] = LuaToJSON(item);
+			});
+		}
+		return j;
+	}
+	default:
+		return nullptr;
+	}
+}
+
 LuaInterpreter::LuaInterpreter()
+    : m_Lua(sol::default_at_panic, &LuaMemory::Allocate)
 {
 	m_Lua.set_exception_handler(&HandleLuaException);
 	m_Lua.open_libraries(sol::lib::base);
@@ -69,6 +123,38 @@ LuaInterpreter::LuaInterpreter()
 
 	registerTypes();
 	runScripts();
+
+	lua_gc(m_Lua.lua_state(), LUA_GCSTOP, 0);
+	m_GCStats.bytesAfterLastCycle = LuaMemory::GetTotalBytes();
+}
+
+void LuaInterpreter::stepGarbageCollector()
+{
+	ZoneScoped;
+	lua_State* state = m_Lua.lua_state();
+
+	StopTimer timer;
+	bool isEmergency = LuaMemory::GetTotalBytes() > m_GCStats.bytesAfterLastCycle * LUA_GC_EMERGENCY_GROWTH;
+	bool isCycleComplete = false;
+	unsigned int steps = 0;
+	while (!isCycleComplete && (isEmergency || timer.getTimeMs() < m_GCBudgetMilliseconds))
+	{
+		isCycleComplete = lua_gc(state, LUA_GCSTEP, 0);
+		steps++;
+	}
+
+	if (isCycleComplete)
+	{
+		m_GCStats.completedCycles++;
+		m_GCStats.emergencyCycles += isEmergency;
+		m_GCStats.bytesAfterLastCycle = LuaMemory::GetTotalBytes();
+	}
+	m_GCStats.lastSteps = steps;
+	m_GCStats.lastStepMilliseconds = timer.getTimeMs();
+
+	TracyPlot("Lua Memory", (int64_t)LuaMemory::GetTotalBytes());
+	TracyPlot("Lua GC Milliseconds", m_GCStats.lastStepMilliseconds);
+	LuaMemory::ResetFrameStats();
 }
 
 LuaInterpreter* LuaInterpreter::GetSingleton()
@@ -93,9 +179,8 @@ void LuaInterpreter::runScripts()
 	m_Lua.do_string("package.path = package.path .. ';rootex/vendor/Narrator/?.lua'");
 }
 
-void LuaInterpreter::registerTypes()
+void LuaInterpreter::RegisterMathTypes(sol::table& rootex)
 {
-	sol::table& rootex = m_Lua.create_named_table("RTX");
 	{
 		sol::usertype<Vector2> vector2 = rootex.new_usertype<Vector2>(
 		    "Vector2",
@@ -106,6 +191,16 @@ void LuaInterpreter::registerTypes()
 		vector2["cross"] = [](const Vector2& l, const Vector2& r) { return l.Cross(r); };
 		vector2["x"] = &Vector2::x;
 		vector2["y"] = &Vector2::y;
+		vector2["length"] = &Vector2::Length;
+		vector2["lengthSquared"] = &Vector2::LengthSquared;
+		// In place operations write into an existing userdata instead of allocating a new one
+		vector2["set"] = [](Vector2& self, float x, float y) { self = { x, y }; };
+		vector2["assign"] = [](Vector2& self, const Vector2& other) { self = other; };
+		vector2["addInPlace"] = [](Vector2& self, const Vector2& other) { self += other; };
+		vector2["subtractInPlace"] = [](Vector2& self, const Vector2& other) { self -= other; };
+		vector2["scaleInPlace"] = [](Vector2& self, float scale) { self *= scale; };
+		vector2["lerpInPlace"] = [](Vector2& self, const Vector2& other, float t) { Vector2::Lerp(self, other, t, self); };
+		vector2["normalizeInPlace"] = [](Vector2& self) { self.Normalize(); };
 	}
 	{
 		sol::usertype<Vector3> vector3 = rootex.new_usertype<Vector3>(
@@ -113,12 +208,24 @@ void LuaInterpreter::registerTypes()
 		    sol::constructors<Vector3(), Vector3(float, float, float)>(),
 		    sol::meta_function::addition, [](Vector3& l, Vector3& r) { return l + r; },
 		    sol::meta_function::subtraction, [](Vector3& l, Vector3& r) { return l - r; },
-		    sol::meta_function::multiplication, [](float l, Vector3& r) { return l * r; });
+		    sol::meta_function::multiplication, sol::overload([](float l, Vector3& r) { return l * r; }, [](Vector3& l, float r) { return l * r; }));
 		vector3["dot"] = &Vector3::Dot;
 		vector3["cross"] = [](const Vector3& l, const Vector3& r) { return l.Cross(r); };
 		vector3["x"] = &Vector3::x;
 		vector3["y"] = &Vector3::y;
 		vector3["z"] = &Vector3::z;
+		vector3["length"] = &Vector3::Length;
+		vector3["lengthSquared"] = &Vector3::LengthSquared;
+		vector3["set"] = [](Vector3& self, float x, float y, float z) { self = { x, y, z }; };
+		vector3["assign"] = [](Vector3& self, const Vector3& other) { self = other; };
+		vector3["addInPlace"] = [](Vector3& self, const Vector3& other) { self += other; };
+		vector3["subtractInPlace"] = [](Vector3& self, const Vector3& other) { self -= other; };
+		vector3["scaleInPlace"] = [](Vector3& self, float scale) { self *= scale; };
+		vector3["lerpInPlace"] = [](Vector3& self, const Vector3& other, float t) { Vector3::Lerp(self, other, t, self); };
+		vector3["crossInPlace"] = [](Vector3& self, const Vector3& other) { self = self.Cross(other); };
+		vector3["normalizeInPlace"] = [](Vector3& self) { self.Normalize(); };
+		vector3["transformInPlace"] = [](Vector3& self, const Matrix& transform) { Vector3::Transform(self, transform, self); };
+		vector3["rotateInPlace"] = [](Vector3& self, const Quaternion& rotation) { Vector3::Transform(self, rotation, self); };
 	}
 	{
 		sol::usertype<Vector4> vector4 = rootex.new_usertype<Vector4>(
@@ -131,6 +238,15 @@ void LuaInterpreter::registerTypes()
 		vector4["y"] = &Vector4::y;
 		vector4["z"] = &Vector4::z;
 		vector4["w"] = &Vector4::w;
+		vector4["length"] = &Vector4::Length;
+		vector4["lengthSquared"] = &Vector4::LengthSquared;
+		vector4["set"] = [](Vector4& self, float x, float y, float z, float w) { self = { x, y, z, w }; };
+		vector4["assign"] = [](Vector4& self, const Vector4& other) { self = other; };
+		vector4["addInPlace"] = [](Vector4& self, const Vector4& other) { self += other; };
+		vector4["subtractInPlace"] = [](Vector4& self, const Vector4& other) { self -= other; };
+		vector4["scaleInPlace"] = [](Vector4& self, float scale) { self *= scale; };
+		vector4["lerpInPlace"] = [](Vector4& self, const Vector4& other, float t) { Vector4::Lerp(self, other, t, self); };
+		vector4["normalizeInPlace"] = [](Vector4& self) { self.Normalize(); };
 	}
 	{
 		sol::usertype<Color> color = rootex.new_usertype<Color>("Color", sol::constructors<Color(), Color(float, float, float, float)>());
@@ -145,6 +261,12 @@ void LuaInterpreter::registerTypes()
 		quaternion["y"] = &Quaternion::y;
 		quaternion["z"] = &Quaternion::z;
 		quaternion["w"] = &Quaternion::w;
+		quaternion["set"] = [](Quaternion& self, float x, float y, float z, float w) { self = { x, y, z, w }; };
+		quaternion["setYawPitchRoll"] = [](Quaternion& self, float yaw, float pitch, float roll) { self = Quaternion::CreateFromYawPitchRoll(yaw, pitch, roll); };
+		quaternion["assign"] = [](Quaternion& self, const Quaternion& other) { self = other; };
+		quaternion["multiplyInPlace"] = [](Quaternion& self, const Quaternion& other) { self *= other; };
+		quaternion["slerpInPlace"] = [](Quaternion& self, const Quaternion& other, float t) { Quaternion::Slerp(self, other, t, self); };
+		quaternion["normalizeInPlace"] = [](Quaternion& self) { self.Normalize(); };
 	}
 	{
 		sol::usertype<Matrix> matrix = rootex.new_usertype<Matrix>(
@@ -154,13 +276,23 @@ void LuaInterpreter::registerTypes()
 		    sol::meta_function::subtraction, [](Matrix& l, Matrix& r) { return l - r; },
 		    sol::meta_function::multiplication, [](Matrix& l, Matrix& r) { return l * r; });
 		matrix["Identity"] = sol::var(Matrix::Identity);
+		matrix["assign"] = [](Matrix& self, const Matrix& other) { self = other; };
+		matrix["multiplyInPlace"] = [](Matrix& self, const Matrix& other) { self *= other; };
 	}
+}
+
+void LuaInterpreter::registerTypes()
+{
+	sol::table& rootex = m_Lua.create_named_table("RTX");
+	RegisterMathTypes(rootex);
 	{
 		sol::usertype<Event> event = rootex.new_usertype<Event>("Event", sol::constructors<Event(const Event::Type, const Variant)>());
 		event["getType"] = &Event::getType;
 		event["getData"] = &Event::getData;
 	}
 	{
+		rootex["GetLuaAllocationCount"] = []() { return LuaMemory::GetTotalAllocations(); };
+		rootex["GetLuaMemoryBytes"] = []() { return LuaMemory::GetTotalBytes(); };
 		rootex["AddEvent"] = [](const String& eventType) { EventManager::GetSingleton()->addEvent(eventType); };
 		rootex["RemoveEvent"] = [](const String& eventType) { EventManager::GetSingleton()->removeEvent(eventType); };
 		rootex["CallEvent"] = [](const Event& event) { EventManager::GetSingleton()->call(event); };
@@ -181,6 +313,13 @@ void LuaInterpreter::registerTypes()
 		rootex["GetSceneArguments"] = []() { return SceneLoader::GetSingleton()->getArguments(); };
 		rootex["GetCurrentScene"] = []() { return SceneLoader::GetSingleton()->getCurrentScene(); };
 	}
+	{
+		rootex["StartCoroutine"] = [](sol::function function, sol::variadic_args args) { return ScriptSystem::GetSingleton()->getScheduler().start(function, args, Script::GetRunning()); };
+		rootex["StopCoroutine"] = [](CoroutineID id) { ScriptSystem::GetSingleton()->getScheduler().stop(id); };
+		rootex["Wait"] = sol::yielding([](float seconds) { return std::make_tuple((int)CoroutineScheduler::Wait::Seconds, seconds); });
+		rootex["WaitFrames"] = sol::yielding([](int frames) { return std::make_tuple((int)CoroutineScheduler::Wait::Frames, frames); });
+		rootex["WaitForEvent"] = sol::yielding([](const String& eventName) { return std::make_tuple((int)CoroutineScheduler::Wait::Event, eventName); });
+	}
 	{
 		sol::usertype<InputManager> inputManager = rootex.new_usertype<InputManager>("Input");
 		inputManager["SetEnabled"] = &InputManager::SetEnabled;
@@ -291,6 +430,15 @@ void LuaInterpreter::registerTypes()
 		scene["getName"] = &Scene::getName;
 		scene["getFullName"] = &Scene::getFullName;
 	}
+	{
+		sol::usertype<Prefab> prefab = rootex.new_usertype<Prefab>("Prefab");
+		prefab["Load"] = &Prefab::Load;
+		prefab["instantiate"] = sol::overload(
+		    [](Prefab* p) { return p->instantiate(); },
+		    [](Prefab* p, const sol::table& overrides) { return p->instantiate(LuaToJSON(overrides)); },
+		    [](Prefab* p, const String& overrides) { return p->instantiate(JSON::json::parse(overrides)); });
+		prefab["getScenePath"] = &Prefab::getScenePath;
+	}
 	{
 		sol::usertype<Entity> entity = rootex.new_usertype<Entity>("Entity");
 		entity["addComponent"] = &Entity::addComponent;
@@ -309,6 +457,36 @@ void LuaInterpreter::registerTypes()
 			return sol::nil;
 		};
 	}
+	{
+		sol::usertype<SpatialSystem> spatial = rootex.new_usertype<SpatialSystem>("Spatial");
+		spatial["AllTypes"] = sol::var(SPATIAL_ALL_TYPES);
+		spatial["GetTypeMask"] = [](const sol::nested<Vector<String>>& componentNames) { return SpatialSystem::GetTypeMaskFromNames(componentNames.value()); };
+		spatial["QueryBox"] = [](const Vector3& min, const Vector3& max, SpatialSystem::TypeMask types) {
+			Vector<Entity*> result;
+			SpatialSystem::GetSingleton()->queryBox(min, max, types, result);
+			return result;
+		};
+		spatial["QuerySphere"] = [](const Vector3& center, float radius, SpatialSystem::TypeMask types) {
+			Vector<Entity*> result;
+			SpatialSystem::GetSingleton()->querySphere(center, radius, types, result);
+			return result;
+		};
+		spatial["QueryFrustum"] = [](const Matrix& viewProjection, SpatialSystem::TypeMask types) {
+			Vector<Entity*> result;
+			SpatialSystem::GetSingleton()->queryFrustum(viewProjection, types, result);
+			return result;
+		};
+		spatial["QueryNearest"] = [](const Vector3& point, unsigned int count, SpatialSystem::TypeMask types) {
+			Vector<Entity*> result;
+			SpatialSystem::GetSingleton()->queryNearest(point, count, types, result);
+			return result;
+		};
+		spatial["Raycast"] = [](const Vector3& origin, const Vector3& direction, float maxDistance, SpatialSystem::TypeMask types) {
+			float hitDistance = 0.0f;
+			Entity* hit = SpatialSystem::GetSingleton()->raycast(origin, direction, maxDistance, types, hitDistance);
+			return std::make_tuple(hit, hitDistance);
+		};
+	}
 	{
 		sol::usertype<Component> component = rootex.new_usertype<Component>("Component");
 		component["getOwner"] = &Component::getOwner;
@@ -339,6 +517,13 @@ void LuaInterpreter::registerTypes()
 		transformComponent["getParentAbsoluteTransform"] = &TransformComponent::getParentAbsoluteTransform;
 		transformComponent["getComponentID"] = &TransformComponent::getComponentID;
 		transformComponent["getName"] = &TransformComponent::getName;
+		// Getters writing into a userdata owned by the script, so reading a transform every frame does not allocate
+		transformComponent["getPositionInto"] = [](TransformComponent* t, Vector3& out) { out = t->getPosition(); };
+		transformComponent["getAbsolutePositionInto"] = [](TransformComponent* t, Vector3& out) { out = t->getAbsolutePosition(); };
+		transformComponent["getRotationInto"] = [](TransformComponent* t, Quaternion& out) { out = t->getRotation(); };
+		transformComponent["getAbsoluteRotationInto"] = [](TransformComponent* t, Quaternion& out) { out = t->getAbsoluteRotation(); };
+		transformComponent["getScaleInto"] = [](TransformComponent* t, Vector3& out) { out = t->getScale(); };
+		transformComponent["getAbsoluteTransformInto"] = [](TransformComponent* t, Matrix& out) { out = t->getAbsoluteTransform(); };
 	}
 	{
 		sol::usertype<RenderableComponent> renderableComponent = rootex.new_usertype<RenderableComponent>(
@@ -27,10 +27,29 @@
 
 #include "sol/sol.hpp"
 
+/// Milliseconds per frame spent stepping the Lua garbage collector by default
+#define LUA_GC_BUDGET_MILLISECONDS 1.0f
+/// Heap growth over the size after the last full cycle at which collection ignores the frame budget
+#define LUA_GC_EMERGENCY_GROWTH 4
+
 /// Lua interpreter that runs all Lua scripts inside the same Lua state. This means that all Lua code-snippets that are run can cross-reference each other.
+/// Lua's automatic garbage collection is stopped, the engine steps the incremental collector within a per frame budget instead.
 class LuaInterpreter
 {
+public:
+	struct GCStats
+	{
+		float lastStepMilliseconds = 0.0f;
+		unsigned int lastSteps = 0;
+		unsigned int completedCycles = 0;
+		unsigned int emergencyCycles = 0;
+		size_t bytesAfterLastCycle = 0;
+	};
+
+private:
 	sol::state m_Lua;
+	float m_GCBudgetMilliseconds = LUA_GC_BUDGET_MILLISECONDS;
+	GCStats m_GCStats;
 
 	LuaInterpreter();
 	LuaInterpreter(LuaInterpreter&) = delete;
@@ -41,6 +60,16 @@ class LuaInterpreter
 
 public:
 	static LuaInterpreter* GetSingleton();
+	/// Math types shared by the interpreter and the parallel script workers
+	static void RegisterMathTypes(sol::table& rootex);
 
 	sol::state& getLuaState() { return m_Lua; }
+
+	/// Run incremental collection steps until the frame budget is used up or a cycle completes.
+	/// Finishes the cycle regardless of the budget if the heap has grown too far since the last one.
+	void stepGarbageCollector();
+
+	void setGCBudget(float milliseconds) { m_GCBudgetMilliseconds = milliseconds; }
+	float getGCBudget() const { return m_GCBudgetMilliseconds; }
+	const GCStats& getGCStats() const { return m_GCStats; }
 };
@@ -0,0 +1,90 @@
+#include "lua_memory.h"
+
+/// Keeps the block after it aligned the way malloc would
+struct alignas(16) LuaBlockHeader
+{
+	LuaMemoryOwner owner;
+};
+
+void* LuaMemory::Allocate(void* userData, void* block, size_t oldSize, size_t newSize)
+{
+	if (newSize == 0)
+	{
+		if (block)
+		{
+			LuaBlockHeader* header = (LuaBlockHeader*)block - 1;
+			s_Owners[header->owner].liveBytes -= oldSize;
+			s_TotalBytes -= oldSize;
+			free(header);
+		}
+		return nullptr;
+	}
+
+	if (!block)
+	{
+		// oldSize encodes the type of object being allocated when there is no block
+		LuaBlockHeader* header = (LuaBlockHeader*)malloc(sizeof(LuaBlockHeader) + newSize);
+		if (!header)
+		{
+			return nullptr;
+		}
+		header->owner = s_CurrentOwner;
+
+		LuaMemoryStats& stats = s_Owners[s_CurrentOwner];
+		stats.liveBytes += newSize;
+		stats.frameAllocatedBytes += newSize;
+		stats.frameAllocations++;
+		s_TotalBytes += newSize;
+		s_TotalAllocations++;
+		return header + 1;
+	}
+
+	LuaBlockHeader* header = (LuaBlockHeader*)realloc((LuaBlockHeader*)block - 1, sizeof(LuaBlockHeader) + newSize);
+	if (!header)
+	{
+		return nullptr;
+	}
+
+	LuaMemoryStats& stats = s_Owners[header->owner];
+	stats.liveBytes += newSize - oldSize;
+	s_TotalBytes += newSize - oldSize;
+	if (newSize > oldSize)
+	{
+		stats.frameAllocatedBytes += newSize - oldSize;
+		stats.frameAllocations++;
+		s_TotalAllocations++;
+	}
+	return header + 1;
+}
+
+LuaMemoryOwner LuaMemory::GetOwner(const String& scriptFile)
+{
+	auto findIt = s_OwnerIDs.find(scriptFile);
+	if (findIt != s_OwnerIDs.end())
+	{
+		return findIt->second;
+	}
+
+	LuaMemoryOwner owner = s_Owners.size();
+	s_Owners.push_back({ scriptFile });
+	s_OwnerIDs[scriptFile] = owner;
+	return owner;
+}
+
+LuaMemoryOwner LuaMemory::SetCurrentOwner(LuaMemoryOwner owner)
+{
+	LuaMemoryOwner previous = s_CurrentOwner;
+	s_CurrentOwner = owner;
+	return previous;
+}
+
+void LuaMemory::ResetFrameStats()
+{
+	for (auto& stats : s_Owners)
+	{
+		stats.lastFrameAllocatedBytes = stats.frameAllocatedBytes;
+		stats.lastFrameAllocations = stats.frameAllocations;
+		stats.frameAllocatedBytes = 0;
+		stats.frameAllocations = 0;
+	}
+}
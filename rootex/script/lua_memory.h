@@ -0,0 +1,58 @@
+#pragma once
+
+#include "common/types.h"
+
+/// Identifies who Lua memory is charged to. Owner 0 is the engine, every script file gets its own owner.
+typedef unsigned int LuaMemoryOwner;
+
+struct LuaMemoryStats
+{
+	String name;
+	size_t liveBytes = 0;
+	size_t frameAllocatedBytes = 0;
+	unsigned int frameAllocations = 0;
+	size_t lastFrameAllocatedBytes = 0;
+	unsigned int lastFrameAllocations = 0;
+};
+
+/// Allocator for the Lua state that attributes memory to scripts.
+/// Every block is prefixed with its owner so frees and reallocations are charged back to the script that allocated the block,
+/// no matter which script releases it.
+class LuaMemory
+{
+	static inline Vector<LuaMemoryStats> s_Owners = { { "Engine" } };
+	static inline HashMap<String, LuaMemoryOwner> s_OwnerIDs;
+	static inline LuaMemoryOwner s_CurrentOwner = 0;
+	static inline size_t s_TotalBytes = 0;
+	static inline unsigned long long s_TotalAllocations = 0;
+
+public:
+	/// lua_Alloc compatible allocation function.
+	static void* Allocate(void* userData, void* block, size_t oldSize, size_t newSize);
+
+	/// Find or create the owner for a script file.
+	static LuaMemoryOwner GetOwner(const String& scriptFile);
+	/// Charge following allocations to owner. Returns the previous owner.
+	static LuaMemoryOwner SetCurrentOwner(LuaMemoryOwner owner);
+
+	static const Vector<LuaMemoryStats>& GetStats() { return s_Owners; }
+	static size_t GetTotalBytes() { return s_TotalBytes; }
+	/// Number of allocations and growing reallocations since startup
+	static unsigned long long GetTotalAllocations() { return s_TotalAllocations; }
+	/// Move the per frame allocation counters to the last frame ones and clear them.
+	static void ResetFrameStats();
+};
+
+/// Charges Lua allocations made during its lifetime to a script.
+class LuaMemoryScope
+{
+	LuaMemoryOwner m_PreviousOwner;
+
+public:
+	LuaMemoryScope(LuaMemoryOwner owner)
+	    : m_PreviousOwner(LuaMemory::SetCurrentOwner(owner))
+	{
+	}
+	LuaMemoryScope(const LuaMemoryScope&) = delete;
+	~LuaMemoryScope() { LuaMemory::SetCurrentOwner(m_PreviousOwner); }
+};
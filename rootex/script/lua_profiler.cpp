@@ -0,0 +1,121 @@
+#include "lua_profiler.h"
+
+#include "common/common.h"
+#include "script/interpreter.h"
+#include "script/script.h"
+#include "entity.h"
+
+LuaProfiler* LuaProfiler::GetSingleton()
+{
+	static LuaProfiler singleton;
+	return &singleton;
+}
+
+void LuaProfiler::Hook(lua_State* state, lua_Debug* debug)
+{
+	LuaProfiler* profiler = GetSingleton();
+
+	TimePoint now = Timer::Now();
+	float gap = (now - profiler->m_LastHookTime).count() * NS_TO_MS;
+	profiler->m_LastHookTime = now;
+	profiler->m_PendingMilliseconds += std::min(gap, LUA_PROFILER_MAX_GAP_MILLISECONDS);
+
+	if (profiler->m_PendingMilliseconds >= LUA_PROFILER_SAMPLE_MILLISECONDS)
+	{
+		profiler->sample(state, profiler->m_PendingMilliseconds);
+		profiler->m_PendingMilliseconds = 0.0f;
+	}
+}
+
+static String GetFrameName(lua_Debug& debug)
+{
+	if (debug.what[0] == 'C')
+	{
+		return String("[C]:") + (debug.name ? debug.name : "?");
+	}
+	if (debug.what[0] == 'm')
+	{
+		return String(debug.short_src) + ":main";
+	}
+	return String(debug.short_src) + ":" + (debug.name ? debug.name : "anonymous") + ":" + std::to_string(debug.linedefined);
+}
+
+void LuaProfiler::sample(lua_State* state, float milliseconds)
+{
+	Vector<String> frames;
+	String leafFile;
+	lua_Debug debug;
+	for (int level = 0; level < LUA_PROFILER_MAX_DEPTH && lua_getstack(state, level, &debug); level++)
+	{
+		lua_getinfo(state, "Sn", &debug);
+		frames.push_back(GetFrameName(debug));
+		if (leafFile.empty() && debug.what[0] != 'C')
+		{
+			leafFile = debug.short_src;
+		}
+	}
+	if (frames.empty())
+	{
+		return;
+	}
+
+	String entityName = "Engine";
+	if (Script* script = Script::GetRunning())
+	{
+		entityName = script->getEntity() ? script->getEntity()->getFullName() : script->getFilePath();
+	}
+
+	String stack = entityName;
+	for (auto it = frames.rbegin(); it != frames.rend(); it++)
+	{
+		stack += ";" + *it;
+	}
+
+	for (Entry* entry : { &m_Stacks[stack], &m_Entities[entityName], &m_Files[leafFile.empty() ? "[C]" : leafFile], &m_Functions[frames.front()] })
+	{
+		entry->milliseconds += milliseconds;
+		entry->samples++;
+	}
+	m_TotalMilliseconds += milliseconds;
+	m_TotalSamples++;
+}
+
+void LuaProfiler::start()
+{
+	m_LastHookTime = Timer::Now();
+	m_PendingMilliseconds = 0.0f;
+	lua_sethook(LuaInterpreter::GetSingleton()->getLuaState().lua_state(), &LuaProfiler::Hook, LUA_MASKCOUNT, LUA_PROFILER_HOOK_INSTRUCTIONS);
+	s_IsRunning = true;
+}
+
+void LuaProfiler::stop()
+{
+	lua_sethook(LuaInterpreter::GetSingleton()->getLuaState().lua_state(), nullptr, 0, 0);
+	s_IsRunning = false;
+}
+
+void LuaProfiler::reset()
+{
+	m_Stacks.clear();
+	m_Entities.clear();
+	m_Files.clear();
+	m_Functions.clear();
+	m_TotalMilliseconds = 0.0f;
+	m_TotalSamples = 0;
+}
+
+String LuaProfiler::getFoldedStacks() const
+{
+	String folded;
+	for (auto& [stack, entry] : m_Stacks)
+	{
+		folded += stack + " " + std::to_string((long long)(entry.milliseconds * 1000.0f)) + "\n";
+	}
+	return folded;
+}
+
+bool LuaProfiler::saveFoldedStacks(const String& path) const
+{
+	String folded = getFoldedStacks();
+	return OS::SaveFile(path, folded.data(), folded.size());
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "common/types.h"
+#include "os/timer.h"
+
+struct lua_State;
+struct lua_Debug;
+
+/// Instructions run between two profiler hooks
+#define LUA_PROFILER_HOOK_INSTRUCTIONS 1000
+/// Time between two samples
+#define LUA_PROFILER_SAMPLE_MILLISECONDS 0.5f
+/// Longest gap between two hooks charged to a sample. Longer gaps are time spent outside Lua.
+#define LUA_PROFILER_MAX_GAP_MILLISECONDS 5.0f
+#define LUA_PROFILER_MAX_DEPTH 32
+
+/// Sampling profiler for the Lua state.
+/// A count hook fires every few instructions and takes a sample of the Lua stack once enough time has passed.
+/// Samples are attributed to the entity whose script is running, its script file and function,
+/// and are collected as folded stacks that flame graph tools read directly.
+class LuaProfiler
+{
+public:
+	/// Time spent in a frame or group of frames
+	struct Entry
+	{
+		float milliseconds = 0.0f;
+		unsigned int samples = 0;
+	};
+
+private:
+	static inline bool s_IsRunning = false;
+
+	TimePoint m_LastHookTime;
+	float m_PendingMilliseconds = 0.0f;
+	float m_TotalMilliseconds = 0.0f;
+	unsigned int m_TotalSamples = 0;
+
+	/// Folded stacks, root first and separated by ';'
+	HashMap<String, Entry> m_Stacks;
+	/// Self time per entity, script file and function
+	HashMap<String, Entry> m_Entities;
+	HashMap<String, Entry> m_Files;
+	HashMap<String, Entry> m_Functions;
+
+	static void Hook(lua_State* state, lua_Debug* debug);
+
+	LuaProfiler() = default;
+	LuaProfiler(LuaProfiler&) = delete;
+	~LuaProfiler() = default;
+
+	void sample(lua_State* state, float milliseconds);
+
+public:
+	static LuaProfiler* GetSingleton();
+
+	/// Called when the engine starts running Lua, so time spent outside Lua is not charged to the next sample.
+	static void OnLuaEntered()
+	{
+		if (s_IsRunning)
+		{
+			GetSingleton()->m_LastHookTime = Timer::Now();
+		}
+	}
+
+	/// Hooks the interpreter state. Coroutines inherit the hook from the state creating them.
+	void start();
+	void stop();
+	void reset();
+	bool isRunning() const { return s_IsRunning; }
+
+	/// Folded stacks with microseconds as weights, one stack per line
+	String getFoldedStacks() const;
+	bool saveFoldedStacks(const String& path) const;
+
+	float getTotalMilliseconds() const { return m_TotalMilliseconds; }
+	unsigned int getTotalSamples() const { return m_TotalSamples; }
+	const HashMap<String, Entry>& getEntities() const { return m_Entities; }
+	const HashMap<String, Entry>& getFiles() const { return m_Files; }
+	const HashMap<String, Entry>& getFunctions() const { return m_Functions; }
+};
@@ -0,0 +1,273 @@
+#include "parallel_script_runner.h"
+
+#include "app/application.h"
+#include "components/space/transform_component.h"
+#include "event_manager.h"
+#include "os/timer.h"
+#include "scene.h"
+#include "script/script.h"
+
+#include "Tracy/Tracy.hpp"
+
+#include <thread>
+
+LuaWorker::LuaWorker()
+{
+	m_Lua.open_libraries(sol::lib::base);
+	m_Lua.open_libraries(sol::lib::math);
+	m_Lua.open_libraries(sol::lib::string);
+	m_Lua.open_libraries(sol::lib::table);
+	m_Lua.open_libraries(sol::lib::package);
+
+	m_Lua.require_file("class", "rootex/vendor/Middleclass/middleclass.lua");
+	registerTypes();
+}
+
+void LuaWorker::registerTypes()
+{
+	sol::table& rootex = m_Lua.create_named_table("RTX");
+	LuaInterpreter::RegisterMathTypes(rootex);
+	{
+		sol::usertype<ParallelEntityView> entity = rootex.new_usertype<ParallelEntityView>("Entity", sol::no_constructor);
+		entity["getID"] = [](ParallelEntityView* e) { return e->id; };
+		entity["getName"] = [](ParallelEntityView* e) { return e->name; };
+		entity["hasTransform"] = [](ParallelEntityView* e) { return e->hasTransform; };
+		entity["getPosition"] = [](ParallelEntityView* e) { return e->position; };
+		entity["getPositionInto"] = [](ParallelEntityView* e, Vector3& out) { out = e->position; };
+		entity["setPosition"] = [](ParallelEntityView* e, const Vector3& position) {
+			e->position = position;
+			e->isTransformDirty = true;
+		};
+		entity["getRotation"] = [](ParallelEntityView* e) { return e->rotation; };
+		entity["getRotationInto"] = [](ParallelEntityView* e, Quaternion& out) { out = e->rotation; };
+		entity["setRotation"] = [](ParallelEntityView* e, float yaw, float pitch, float roll) {
+			e->rotation = Quaternion::CreateFromYawPitchRoll(yaw, pitch, roll);
+			e->isTransformDirty = true;
+		};
+		entity["setRotationQuaternion"] = [](ParallelEntityView* e, const Quaternion& rotation) {
+			e->rotation = rotation;
+			e->isTransformDirty = true;
+		};
+		entity["getScale"] = [](ParallelEntityView* e) { return e->scale; };
+		entity["getScaleInto"] = [](ParallelEntityView* e, Vector3& out) { out = e->scale; };
+		entity["setScale"] = [](ParallelEntityView* e, const Vector3& scale) {
+			e->scale = scale;
+			e->isTransformDirty = true;
+		};
+	}
+	{
+		// Everything reaching outside the script's own entity is deferred to the main thread
+		rootex["CallEvent"] = [this](const String& eventName, const Variant& data) {
+			m_Commands.push_back({ ParallelCommand::Type::CallEvent, 0, eventName, { data } });
+		};
+		rootex["Call"] = [this](unsigned int target, const String& function, sol::variadic_args args) {
+			ParallelCommand command = { ParallelCommand::Type::Call, target, function };
+			for (auto&& arg : args)
+			{
+				command.data.push_back(arg.as<Variant>());
+			}
+			m_Commands.push_back(command);
+		};
+		m_Lua["print"] = [this](const String& message) {
+			m_Commands.push_back({ ParallelCommand::Type::Print, 0, message });
+		};
+	}
+}
+
+void LuaWorker::CopyIn(Script* script)
+{
+	ParallelEntityView& view = script->m_View;
+	view.id = script->m_Entity->getScene()->getID();
+	view.isTransformDirty = false;
+
+	TransformComponent* transform = script->m_Entity->getComponent<TransformComponent>();
+	view.hasTransform = transform != nullptr;
+	if (transform)
+	{
+		view.position = transform->getPosition();
+		view.rotation = transform->getRotation();
+		view.scale = transform->getScale();
+	}
+}
+
+void LuaWorker::WriteBack(Script* script)
+{
+	ParallelEntityView& view = script->m_View;
+	if (!view.isTransformDirty)
+	{
+		return;
+	}
+
+	if (TransformComponent* transform = script->m_Entity->getComponent<TransformComponent>())
+	{
+		transform->setPosition(view.position);
+		transform->setRotationQuaternion(view.rotation);
+		transform->setScale(view.scale);
+	}
+	view.isTransformDirty = false;
+}
+
+void LuaWorker::addScript(Script* script)
+{
+	m_Scripts.push_back(script);
+}
+
+void LuaWorker::removeScript(Script* script)
+{
+	auto findIt = std::find(m_Scripts.begin(), m_Scripts.end(), script);
+	if (findIt != m_Scripts.end())
+	{
+		m_Scripts.erase(findIt);
+	}
+}
+
+void LuaWorker::copyIn()
+{
+	for (auto& script : m_Scripts)
+	{
+		CopyIn(script);
+	}
+}
+
+void LuaWorker::update(float deltaMilliseconds)
+{
+	ZoneScoped;
+	StopTimer timer;
+	for (auto& script : m_Scripts)
+	{
+		sol::protected_function_result result = script->m_UpdateFunction(script->m_ScriptInstance, &script->m_View, deltaMilliseconds);
+		if (!result.valid())
+		{
+			sol::error e = result;
+			m_Errors.push_back("Script error (" + script->m_View.name + "): " + e.what());
+		}
+	}
+	m_LastUpdateMilliseconds = timer.getTimeMs();
+}
+
+void LuaWorker::flush()
+{
+	for (auto& script : m_Scripts)
+	{
+		WriteBack(script);
+	}
+
+	for (auto& error : m_Errors)
+	{
+		WARN(error);
+	}
+	m_Errors.clear();
+
+	// Commands may destroy entities, which removes their scripts from this worker
+	Vector<ParallelCommand> commands;
+	commands.swap(m_Commands);
+	for (auto& command : commands)
+	{
+		switch (command.type)
+		{
+		case ParallelCommand::Type::CallEvent:
+			EventManager::GetSingleton()->call(command.name, command.data.front());
+			break;
+		case ParallelCommand::Type::Call:
+		{
+			Scene* scene = Scene::FindSceneByID(command.target);
+			if (!scene || !scene->getEntity())
+			{
+				WARN("Could not find scene to call " + command.name + ": " + std::to_string(command.target));
+				break;
+			}
+			scene->getEntity()->call(command.name, command.data);
+			break;
+		}
+		case ParallelCommand::Type::Print:
+			PRINT(command.name);
+			break;
+		}
+	}
+}
+
+void ParallelScriptRunner::createWorkers()
+{
+	unsigned int workerCount = std::clamp(std::thread::hardware_concurrency(), 1u, (unsigned int)LUA_PARALLEL_MAX_WORKERS);
+	for (unsigned int i = 0; i < workerCount; i++)
+	{
+		m_Workers.emplace_back(new LuaWorker());
+	}
+	PRINT("Created " + std::to_string(workerCount) + " Lua workers for parallel scripts");
+}
+
+LuaWorker* ParallelScriptRunner::assignWorker()
+{
+	if (m_Workers.empty())
+	{
+		createWorkers();
+	}
+
+	LuaWorker* leastLoaded = m_Workers.front().get();
+	for (auto& worker : m_Workers)
+	{
+		if (worker->getScriptCount() < leastLoaded->getScriptCount())
+		{
+			leastLoaded = worker.get();
+		}
+	}
+	return leastLoaded;
+}
+
+void ParallelScriptRunner::update(float deltaMilliseconds)
+{
+	ZoneScoped;
+
+	Vector<LuaWorker*> busyWorkers;
+	for (auto& worker : m_Workers)
+	{
+		if (worker->getScriptCount())
+		{
+			worker->copyIn();
+			busyWorkers.push_back(worker.get());
+		}
+	}
+	if (busyWorkers.empty())
+	{
+		m_CommandsLastFrame = 0;
+		return;
+	}
+
+	Application* application = Application::GetSingleton();
+	if (!application || busyWorkers.size() == 1)
+	{
+		for (auto& worker : busyWorkers)
+		{
+			worker->update(deltaMilliseconds);
+		}
+	}
+	else
+	{
+		Vector<Ref<Task>> tasks;
+		for (auto& worker : busyWorkers)
+		{
+			tasks.push_back(std::make_shared<Task>([worker, deltaMilliseconds]() {
+				worker->update(deltaMilliseconds);
+			}));
+		}
+		application->getThreadPool().execute(tasks);
+	}
+
+	// Flushed in worker order so the commands are applied in the same order every frame
+	m_CommandsLastFrame = 0;
+	for (auto& worker : busyWorkers)
+	{
+		m_CommandsLastFrame += worker->getCommandCount();
+		worker->flush();
+	}
+}
+
+unsigned int ParallelScriptRunner::getScriptCount() const
+{
+	unsigned int count = 0;
+	for (auto& worker : m_Workers)
+	{
+		count += worker->getScriptCount();
+	}
+	return count;
+}
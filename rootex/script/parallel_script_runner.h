@@ -0,0 +1,106 @@
+#pragma once
+
+#include "common/common.h"
+#include "script/interpreter.h"
+
+class Script;
+class Entity;
+
+/// Upper limit on Lua states updating parallel scripts
+#define LUA_PARALLEL_MAX_WORKERS 8
+
+/// Owning entity of a parallel script as seen from a worker.
+/// The transform is copied in before the update and written back after it if it was changed.
+struct ParallelEntityView
+{
+	unsigned int id = 0;
+	String name;
+	bool hasTransform = false;
+	bool isTransformDirty = false;
+	Vector3 position;
+	Quaternion rotation;
+	Vector3 scale;
+};
+
+/// Work queued by a parallel script, applied on the main thread once all workers are done.
+struct ParallelCommand
+{
+	enum class Type : int
+	{
+		/// Call an event with data
+		CallEvent,
+		/// Call a script function on another entity
+		Call,
+		Print
+	};
+
+	Type type;
+	unsigned int target = 0;
+	String name;
+	Vector<Variant> data;
+};
+
+/// Lua state owned by a single worker. Scripts loaded into it only see the restricted API:
+/// math types, their own entity view and commands that are deferred to the main thread.
+class LuaWorker
+{
+	sol::state m_Lua;
+	Vector<Script*> m_Scripts;
+	Vector<ParallelCommand> m_Commands;
+	/// Messages are built when the error happens, since the script may be gone by the time they are reported
+	Vector<String> m_Errors;
+	float m_LastUpdateMilliseconds = 0.0f;
+
+	void registerTypes();
+
+public:
+	LuaWorker();
+	LuaWorker(const LuaWorker&) = delete;
+	~LuaWorker() = default;
+
+	/// Copy the owning entity's state into the script's view
+	static void CopyIn(Script* script);
+	/// Apply changes made to the script's view to the owning entity
+	static void WriteBack(Script* script);
+
+	sol::state& getLuaState() { return m_Lua; }
+
+	void addScript(Script* script);
+	void removeScript(Script* script);
+
+	/// Runs on the main thread before the workers start.
+	void copyIn();
+	/// Runs update() of every script in this worker. Runs on a worker thread.
+	void update(float deltaMilliseconds);
+	/// Writes views back, reports errors and applies queued commands. Runs on the main thread.
+	void flush();
+
+	unsigned int getScriptCount() const { return m_Scripts.size(); }
+	unsigned int getCommandCount() const { return m_Commands.size(); }
+	float getLastUpdateMilliseconds() const { return m_LastUpdateMilliseconds; }
+};
+
+/// Updates scripts marked as parallel on a set of worker owned Lua states using the thread pool.
+/// Each worker's scripts are updated by one task, so a Lua state is never entered from two threads.
+class ParallelScriptRunner
+{
+	Vector<Ptr<LuaWorker>> m_Workers;
+	unsigned int m_CommandsLastFrame = 0;
+
+	void createWorkers();
+
+public:
+	ParallelScriptRunner() = default;
+	ParallelScriptRunner(const ParallelScriptRunner&) = delete;
+	~ParallelScriptRunner() = default;
+
+	/// Picks the worker with the fewest scripts for a script to be loaded into
+	LuaWorker* assignWorker();
+
+	/// Update all parallel scripts and apply what they queued before returning.
+	void update(float deltaMilliseconds);
+
+	unsigned int getScriptCount() const;
+	unsigned int getCommandsLastFrame() const { return m_CommandsLastFrame; }
+	const Vector<Ptr<LuaWorker>>& getWorkers() const { return m_Workers; }
+};
@@ -2,36 +2,160 @@
 #include "event_manager.h"
 #include "scene.h"
 #include "components/physics/hit.h"
+#include "systems/script_system.h"
 
 Script::Script(const JSON::json& script)
 {
 	String luaFilePath = script["path"];
 
 	m_ScriptFile = luaFilePath;
+	m_MemoryOwner = LuaMemory::GetOwner(m_ScriptFile);
+	m_IsParallel = script.value("isParallel", false);
+	m_IsParallelOnReload = m_IsParallel;
 	for (auto& element : JSON::json::iterator_wrapper(script["overrides"]))
 	{
 		m_Overrides[element.key()] = (String)element.value();
 	}
 }
 
+Script::~Script()
+{
+	ScriptSystem::GetSingleton()->removeUpdateScript(this);
+	ScriptSystem::GetSingleton()->getScheduler().stopAll(this);
+	if (m_Worker)
+	{
+		m_Worker->removeScript(this);
+	}
+}
+
+bool Script::IsLifecycleFunction(const String& function)
+{
+	return std::find(s_LifecycleFunctions.begin(), s_LifecycleFunctions.end(), function) != s_LifecycleFunctions.end();
+}
+
 bool Script::setup(Entity* entity)
 {
+	RunningScope runningScope(this);
+	m_Entity = entity;
+
+	sol::state_view lua = LuaInterpreter::GetSingleton()->getLuaState();
+	if (m_IsParallel)
+	{
+		if (!m_Worker)
+		{
+			m_Worker = ScriptSystem::GetSingleton()->getParallelRunner().assignWorker();
+		}
+		lua = m_Worker->getLuaState();
+		m_View.name = entity->getFullName();
+		LuaWorker::CopyIn(this);
+	}
+
 	bool status = true;
 	try
 	{
-		sol::table scriptClass = LuaInterpreter::GetSingleton()->getLuaState().script_file(m_ScriptFile);
-		m_ScriptInstance = scriptClass["new"](scriptClass, entity);
+		sol::table scriptClass = lua.script_file(m_ScriptFile);
+		if (m_IsParallel)
+		{
+			m_ScriptInstance = scriptClass["new"](scriptClass, &m_View);
+		}
+		else
+		{
+			m_ScriptInstance = scriptClass["new"](scriptClass, entity);
+		}
 	}
 	catch (std::exception e)
 	{
 		WARN(e.what());
-		m_ScriptInstance = LuaInterpreter::GetSingleton()->getLuaState().create_named_table("DefaultTable");
+		m_ScriptInstance = lua.create_named_table("DefaultTable");
 		status = false;
 	}
+	cacheFunctions();
 	return status;
 }
 
-bool Script::isSuccessful(const sol::function_result& result)
+void Script::cacheFunctions()
+{
+	m_Functions.clear();
+	for (auto& function : s_LifecycleFunctions)
+	{
+		sol::object luaFunction = m_ScriptInstance[function];
+		if (luaFunction.get_type() == sol::type::function)
+		{
+			m_Functions[function] = luaFunction.as<sol::protected_function>();
+		}
+	}
+
+	ScriptSystem::GetSingleton()->removeUpdateScript(this);
+	if (m_Worker)
+	{
+		m_Worker->removeScript(this);
+	}
+	m_UpdateFunction = sol::protected_function();
+	auto findIt = m_Functions.find("update");
+	if (findIt != m_Functions.end())
+	{
+		m_UpdateFunction = findIt->second;
+		if (m_Worker)
+		{
+			m_Worker->addScript(this);
+		}
+		else
+		{
+			ScriptSystem::GetSingleton()->addUpdateScript(this);
+		}
+	}
+}
+
+sol::protected_function Script::getFunction(const String& function)
+{
+	auto findIt = m_Functions.find(function);
+	if (findIt != m_Functions.end())
+	{
+		return findIt->second;
+	}
+	if (IsLifecycleFunction(function) || !m_ScriptInstance.valid())
+	{
+		return sol::protected_function();
+	}
+
+	sol::object luaFunction = m_ScriptInstance[function];
+	if (luaFunction.get_type() != sol::type::function)
+	{
+		return sol::protected_function();
+	}
+	return luaFunction.as<sol::protected_function>();
+}
+
+bool Script::invokeParallel(const String& function)
+{
+	// Engine objects do not exist in worker states, parallel scripts get their view instead
+	if (function != "begin" && function != "destroy")
+	{
+		if (!IsLifecycleFunction(function))
+		{
+			WARN("Parallel scripts can only be called by the engine: " + function);
+			return false;
+		}
+		return true;
+	}
+
+	sol::protected_function luaFunction = getFunction(function);
+	if (!luaFunction.valid())
+	{
+		return true;
+	}
+
+	LuaWorker::CopyIn(this);
+	bool status = isSuccessful(luaFunction(m_ScriptInstance, &m_View));
+	LuaWorker::WriteBack(this);
+	if (!status)
+	{
+		WARN("Could not call " + function);
+	}
+	return status;
+}
+
+bool Script::isSuccessful(const sol::protected_function_result& result)
 {
 	if (!result.valid())
 	{
@@ -44,7 +168,22 @@ bool Script::isSuccessful(const sol::function_result& result)
 
 bool Script::call(const String& function, const Vector<Variant>& args)
 {
-	bool status = isSuccessful(m_ScriptInstance[function](m_ScriptInstance, sol::as_args(args)));
+	if (m_IsParallel)
+	{
+		return invokeParallel(function);
+	}
+	RunningScope runningScope(this);
+	sol::protected_function luaFunction = getFunction(function);
+	if (!luaFunction.valid())
+	{
+		if (IsLifecycleFunction(function))
+		{
+			return true;
+		}
+		WARN("Could not find " + function);
+		return false;
+	}
+	bool status = isSuccessful(luaFunction(m_ScriptInstance, sol::as_args(args)));
 	if (!status)
 	{
 		WARN("Could not call " + function);
@@ -54,6 +193,9 @@ bool Script::call(const String& function, const Vector<Variant>& args)
 
 void Script::evaluateOverrides()
 {
+	RunningScope runningScope(this);
+	// Overrides are evaluated in the state the script instance lives in
+	sol::state_view state(m_ScriptInstance.lua_state());
 	for (auto&& [varName, lua] : m_Overrides)
 	{
 		if (!lua.empty())
@@ -61,7 +203,7 @@ void Script::evaluateOverrides()
 			sol::optional<sol::object> currVar = m_ScriptInstance["exports"][varName];
 			if (currVar)
 			{
-				m_ScriptInstance["exports"][varName] = LuaInterpreter::GetSingleton()->getLuaState().script("return " + lua);
+				m_ScriptInstance["exports"][varName] = state.script("return " + lua);
 			}
 		}
 	}
@@ -72,6 +214,7 @@ JSON::json Script::getJSON() const
 	JSON::json j;
 
 	j["path"] = m_ScriptFile;
+	j["isParallel"] = m_IsParallelOnReload;
 
 	j["overrides"] = {};
 
@@ -93,6 +236,12 @@ JSON::json Script::getJSON() const
 
 void Script::draw()
 {
+	ImGui::Checkbox("Parallel", &m_IsParallelOnReload);
+	if (m_IsParallelOnReload != m_IsParallel)
+	{
+		ImGui::SameLine();
+		ImGui::Text("(Reload to apply)");
+	}
 	ImGui::Text("Script Exports");
 
 	sol::optional<sol::table> currExports = m_ScriptInstance["exports"];
@@ -2,8 +2,12 @@
 
 #include "common.h"
 #include "script/interpreter.h"
+#include "script/lua_memory.h"
+#include "script/lua_profiler.h"
+#include "script/parallel_script_runner.h"
 
 class LuaTextResourceFile;
+class Entity;
 
 class Script
 {
@@ -11,22 +15,108 @@ private:
 	sol::table m_ScriptInstance;
 	String m_ScriptFile;
 	HashMap<String, String> m_Overrides;
+	/// Lua allocations made while running this script are charged to its file
+	LuaMemoryOwner m_MemoryOwner;
 
-	bool isSuccessful(const sol::function_result& result);
+	Entity* m_Entity = nullptr;
+	/// Lifecycle functions defined by the script, resolved once during setup.
+	HashMap<String, sol::protected_function> m_Functions;
+	sol::protected_function m_UpdateFunction;
+	/// Slot in the ScriptSystem update list, -1 if the script does not define update.
+	int m_UpdateIndex = -1;
+
+	/// Parallel scripts live in a worker's Lua state and only see their own entity through a view
+	bool m_IsParallel = false;
+	/// Parallel setting saved to the scene, applied when the script is next loaded
+	bool m_IsParallelOnReload = false;
+	LuaWorker* m_Worker = nullptr;
+	ParallelEntityView m_View;
+
+	static bool IsLifecycleFunction(const String& function);
+
+	bool isSuccessful(const sol::protected_function_result& result);
+	void cacheFunctions();
+	sol::protected_function getFunction(const String& function);
+	bool invokeParallel(const String& function);
+
+	static inline Script* s_Running = nullptr;
+
+	friend class ScriptSystem;
+	friend class LuaWorker;
 
 public:
+	/// Marks a script as running Lua code. Its allocations are charged to it and coroutines it starts are owned by it.
+	class RunningScope
+	{
+		Script* m_PreviousScript;
+		LuaMemoryScope m_MemoryScope;
+
+	public:
+		RunningScope(Script* script)
+		    : m_PreviousScript(s_Running)
+		    , m_MemoryScope(script ? script->m_MemoryOwner : 0)
+		{
+			if (!m_PreviousScript)
+			{
+				LuaProfiler::OnLuaEntered();
+			}
+			s_Running = script;
+		}
+		RunningScope(const RunningScope&) = delete;
+		~RunningScope() { s_Running = m_PreviousScript; }
+	};
+
+	/// Script whose Lua code is currently running, nullptr if none.
+	static Script* GetRunning() { return s_Running; }
+
+	/// Functions looked up once at setup instead of on every call.
+	static const inline Vector<String> s_LifecycleFunctions = { "begin", "update", "destroy", "hit", "enter", "exit" };
+
 	Script(const JSON::json& script);
 	Script(const Script&) = delete;
-	~Script() = default;
+	~Script();
 
 	bool setup(Entity* entity);
 
 	void evaluateOverrides();
 	bool call(const String& function, const Vector<Variant>& args);
+	/// Call a script function without packing the arguments into Variants.
+	/// Calling an undefined lifecycle function is not an error.
+	template <typename... Args>
+	bool invoke(const String& function, Args&&... args);
+	bool hasFunction(const String& function) const { return m_Functions.find(function) != m_Functions.end(); }
 
 	JSON::json getJSON() const;
 	const String& getFilePath() { return m_ScriptFile; }
+	bool isParallel() const { return m_IsParallel; }
+	Entity* getEntity() const { return m_Entity; }
 	sol::table& getScriptInstance() { return m_ScriptInstance; }
 
 	void draw();
 };
+
+template <typename... Args>
+inline bool Script::invoke(const String& function, Args&&... args)
+{
+	if (m_IsParallel)
+	{
+		return invokeParallel(function);
+	}
+	RunningScope runningScope(this);
+	sol::protected_function luaFunction = getFunction(function);
+	if (!luaFunction.valid())
+	{
+		if (IsLifecycleFunction(function))
+		{
+			return true;
+		}
+		WARN("Could not find " + function);
+		return false;
+	}
+	bool status = isSuccessful(luaFunction(m_ScriptInstance, std::forward<Args>(args)...));
+	if (!status)
+	{
+		WARN("Could not call " + function);
+	}
+	return status;
+}
@@ -0,0 +1,257 @@
+#include "renderer/rhi/command_buffer.h"
+#include "renderer/rhi/null_render_backend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Pixel shader texture slots every material binds, like the diffuse, normal and specular maps of BasicMaterial
+#define BENCHMARK_MATERIAL_TEXTURES 3
+
+struct Options
+{
+	unsigned int objects = 50000;
+	unsigned int materials = 200;
+	unsigned int shaders = 4;
+	/// Geometry pages meshes are spread over, like the ones GeometryHeap shares between meshes
+	unsigned int pages = 16;
+	unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+	unsigned int frames = 20;
+};
+
+struct Object
+{
+	unsigned int material;
+	unsigned int page;
+	unsigned int indices;
+	unsigned int startIndex;
+	int baseVertex;
+	float transform[16];
+};
+
+struct MaterialConstants
+{
+	float color[4];
+	float specular[4];
+	float reflection[4];
+	int flags[4];
+};
+
+static void PrintUsage()
+{
+	std::cout
+	    << "Usage: RenderBenchmark [options]\n"
+	    << "Records the draws of a generated scene into command buffers on several threads and replays them on the null backend.\n"
+	    << "Needs no GPU, so rendering CPU costs can be measured on any machine.\n\n"
+	    << "Options:\n"
+	    << "  --objects <count>    Meshes drawn per frame (default: 50000)\n"
+	    << "  --materials <count>  Materials the meshes use (default: 200)\n"
+	    << "  --shaders <count>    Shaders the materials use (default: 4)\n"
+	    << "  --pages <count>      Geometry pages the meshes are stored in (default: 16)\n"
+	    << "  --threads <count>    Threads recording in parallel (default: hardware threads)\n"
+	    << "  --frames <count>     Frames to average over (default: 20)\n";
+}
+
+static bool ParseOptions(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		unsigned int* value = nullptr;
+		if (argument == "--objects")
+		{
+			value = &options.objects;
+		}
+		else if (argument == "--materials")
+		{
+			value = &options.materials;
+		}
+		else if (argument == "--shaders")
+		{
+			value = &options.shaders;
+		}
+		else if (argument == "--pages")
+		{
+			value = &options.pages;
+		}
+		else if (argument == "--threads")
+		{
+			value = &options.threads;
+		}
+		else if (argument == "--frames")
+		{
+			value = &options.frames;
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << argument << "\n";
+			return false;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Missing value for " << argument << "\n";
+			return false;
+		}
+		*value = (unsigned int)std::stoul(argv[++i]);
+		if (*value == 0)
+		{
+			std::cerr << argument << " must be at least 1\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+/// The null backend never dereferences handles, so any distinct non null value will do
+template <class T>
+static T* FakeHandle(unsigned int kind, unsigned int index)
+{
+	return (T*)(uintptr_t)(((uint64_t)(kind + 1) << 32) | (index + 1));
+}
+
+static std::vector<Object> GenerateScene(const Options& options)
+{
+	std::mt19937 random(1234);
+	std::vector<Object> objects(options.objects);
+	for (Object& object : objects)
+	{
+		object.material = random() % options.materials;
+		object.page = random() % options.pages;
+		object.indices = 3 * (64 + random() % 4096);
+		object.startIndex = random() % 1000000;
+		object.baseVertex = random() % 100000;
+		for (int i = 0; i < 16; i++)
+		{
+			object.transform[i] = (float)(random() % 1000) / 1000.0f;
+		}
+	}
+
+	// Sorted the way renderables are drawn, so binds are shared by neighbouring draws
+	std::sort(objects.begin(), objects.end(), [&options](const Object& a, const Object& b) {
+		const unsigned int shaderA = a.material % options.shaders;
+		const unsigned int shaderB = b.material % options.shaders;
+		if (shaderA != shaderB)
+		{
+			return shaderA < shaderB;
+		}
+		if (a.material != b.material)
+		{
+			return a.material < b.material;
+		}
+		return a.page < b.page;
+	});
+	return objects;
+}
+
+static void Record(const Options& options, const Object* objects, size_t count, CommandBuffer& commands)
+{
+	RHIBuffer* modelConstants = FakeHandle<RHIBuffer>(0, 0);
+	RHIBuffer* materialConstants = FakeHandle<RHIBuffer>(0, 1);
+	RHISampler* sampler = FakeHandle<RHISampler>(1, 0);
+
+	commands.reset();
+	for (size_t i = 0; i < count; i++)
+	{
+		const Object& object = objects[i];
+		if (i == 0 || object.material != objects[i - 1].material)
+		{
+			const unsigned int shader = object.material % options.shaders;
+			commands.bindShaders(FakeHandle<RHIVertexShader>(2, shader), FakeHandle<RHIPixelShader>(3, shader), FakeHandle<RHIInputLayout>(4, shader));
+			for (unsigned int slot = 0; slot < BENCHMARK_MATERIAL_TEXTURES; slot++)
+			{
+				commands.bindTexture(slot, FakeHandle<RHITexture>(5, object.material * BENCHMARK_MATERIAL_TEXTURES + slot));
+			}
+			commands.bindSampler(sampler);
+
+			MaterialConstants material = {};
+			material.color[0] = (float)object.material;
+			commands.setConstants(RHIShaderStage::Pixel, 2, materialConstants, material);
+		}
+
+		commands.bindVertexBuffer(FakeHandle<RHIBuffer>(6, object.page), 32);
+		commands.bindIndexBuffer(FakeHandle<RHIBuffer>(7, object.page), RHIIndexFormat::UInt16);
+		commands.setConstants(RHIShaderStage::Vertex, 1, modelConstants, object.transform);
+		commands.drawIndexed(object.indices, object.startIndex, object.baseVertex);
+	}
+}
+
+static double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/// Records every frame over threads command buffers and replays them in order. Prints the average times of a frame.
+static void Run(const Options& options, const std::vector<Object>& objects, unsigned int threads)
+{
+	std::vector<CommandBuffer> commandBuffers(threads);
+	NullRenderBackend backend;
+	double recordMilliseconds = 0.0;
+	double replayMilliseconds = 0.0;
+
+	for (unsigned int frame = 0; frame < options.frames; frame++)
+	{
+		const auto recordStart = std::chrono::high_resolution_clock::now();
+		std::vector<std::thread> workers;
+		const size_t perThread = (objects.size() + threads - 1) / threads;
+		for (unsigned int t = 0; t < threads; t++)
+		{
+			const size_t begin = std::min(objects.size(), t * perThread);
+			const size_t end = std::min(objects.size(), begin + perThread);
+			workers.emplace_back(Record, std::cref(options), objects.data() + begin, end - begin, std::ref(commandBuffers[t]));
+		}
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+		const auto replayStart = std::chrono::high_resolution_clock::now();
+
+		backend.reset();
+		for (const CommandBuffer& commands : commandBuffers)
+		{
+			commands.replay(backend);
+		}
+		const auto replayEnd = std::chrono::high_resolution_clock::now();
+
+		recordMilliseconds += Milliseconds(replayStart - recordStart);
+		replayMilliseconds += Milliseconds(replayEnd - replayStart);
+	}
+
+	size_t commandCount = 0;
+	size_t constantBytes = 0;
+	for (const CommandBuffer& commands : commandBuffers)
+	{
+		commandCount += commands.getCommandCount();
+		constantBytes += commands.getConstantBytes();
+	}
+	const NullRenderBackend::Stats& stats = backend.getStats();
+	std::cout
+	    << threads << " thread(s): record " << recordMilliseconds / options.frames << " ms, replay " << replayMilliseconds / options.frames << " ms per frame\n"
+	    << "  " << commandCount << " commands, " << stats.draws << " draws, " << stats.triangles << " triangles\n"
+	    << "  " << stats.stateChanges << " state changes, " << stats.redundantBinds << " redundant binds, "
+	    << stats.constantUpdates << " constant updates (" << constantBytes / 1024 << " KB recorded)\n";
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const std::vector<Object> objects = GenerateScene(options);
+	std::cout << options.objects << " objects, " << options.materials << " materials, " << options.shaders << " shaders, " << options.pages << " geometry pages\n";
+	Run(options, objects, 1);
+	if (options.threads > 1)
+	{
+		Run(options, objects, options.threads);
+	}
+	return 0;
+}
@@ -0,0 +1,199 @@
+#include "renderer/texture_cooker.h"
+
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+/// Image files the engine loads as ImageResourceFile that the cooker can decode
+static const std::set<std::string> SOURCE_EXTENSIONS = { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif" };
+
+struct Options
+{
+	TextureCooker::Settings settings;
+	std::filesystem::path root = ".";
+	bool isForced = false;
+	std::vector<std::filesystem::path> inputs;
+};
+
+static void PrintUsage()
+{
+	std::cout
+	    << "Usage: TextureCooker [options] <image or directory>...\n"
+	    << "Cooks images into " TEXTURE_COOKED_DIRECTORY " under the Rootex root with a full mip chain and block compression.\n"
+	    << "Paths are relative to the Rootex root, like the ones the engine loads. Directories are searched recursively.\n\n"
+	    << "Options:\n"
+	    << "  --format <auto|bc1|bc3|bc5|bc7|rgba8>  Encoding, auto picks bc1 or bc3 depending on alpha (default: auto)\n"
+	    << "  --normal                               Same as --format bc5 --linear, for tangent space normal maps\n"
+	    << "  --linear                               Texels are data, not sRGB colours, when averaging mips\n"
+	    << "  --no-mips                              Only cook the full size level\n"
+	    << "  --root <directory>                     Rootex root (default: current directory)\n"
+	    << "  --force                                Cook even if the cooked texture is up to date\n";
+}
+
+static bool ParseFormat(const std::string& name, TextureCookFormat& format)
+{
+	for (TextureCookFormat candidate : { TextureCookFormat::Auto, TextureCookFormat::BC1, TextureCookFormat::BC3, TextureCookFormat::BC5, TextureCookFormat::BC7, TextureCookFormat::RGBA8 })
+	{
+		if (name == TextureCooker::GetFormatName(candidate))
+		{
+			format = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool ParseOptions(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (argument == "--format" && i + 1 < argc)
+		{
+			if (!ParseFormat(argv[++i], options.settings.format))
+			{
+				std::cerr << "Unknown format: " << argv[i] << "\n";
+				return false;
+			}
+		}
+		else if (argument == "--normal")
+		{
+			options.settings.format = TextureCookFormat::BC5;
+			options.settings.isSRGB = false;
+		}
+		else if (argument == "--linear")
+		{
+			options.settings.isSRGB = false;
+		}
+		else if (argument == "--no-mips")
+		{
+			options.settings.isGeneratingMips = false;
+		}
+		else if (argument == "--root" && i + 1 < argc)
+		{
+			options.root = argv[++i];
+		}
+		else if (argument == "--force")
+		{
+			options.isForced = true;
+		}
+		else if (argument.rfind("--", 0) == 0)
+		{
+			std::cerr << "Unknown option: " << argument << "\n";
+			return false;
+		}
+		else
+		{
+			options.inputs.push_back(argument);
+		}
+	}
+	return !options.inputs.empty();
+}
+
+static bool ReadFile(const std::filesystem::path& path, std::vector<char>& contents)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+/// Returns false if the image could not be cooked. Up to date textures count as cooked.
+static bool CookImage(const Options& options, const std::filesystem::path& sourcePath)
+{
+	std::vector<char> source;
+	if (!ReadFile(options.root / sourcePath, source))
+	{
+		std::cerr << "Could not read " << sourcePath.generic_string() << "\n";
+		return false;
+	}
+
+	const uint64_t sourceHash = TextureCooker::HashContents(source.data(), source.size());
+	const std::filesystem::path cookedPath = options.root / TextureCooker::GetCookedPath(sourcePath.generic_string());
+
+	std::vector<char> cooked;
+	uint64_t cookedHash = 0;
+	TextureCooker::Settings cookedSettings;
+	if (!options.isForced && ReadFile(cookedPath, cooked) && TextureCooker::ReadCookedInfo(cooked.data(), cooked.size(), cookedHash, cookedSettings)
+	    && cookedHash == sourceHash && cookedSettings.format == options.settings.format && cookedSettings.isSRGB == options.settings.isSRGB && cookedSettings.isGeneratingMips == options.settings.isGeneratingMips)
+	{
+		std::cout << "Up to date: " << sourcePath.generic_string() << "\n";
+		return true;
+	}
+
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	stbi_uc* pixels = stbi_load_from_memory((const stbi_uc*)source.data(), (int)source.size(), &width, &height, &channels, 4);
+	if (!pixels)
+	{
+		std::cerr << "Could not decode " << sourcePath.generic_string() << ": " << stbi_failure_reason() << "\n";
+		return false;
+	}
+
+	const TextureCookFormat format = TextureCooker::Cook(pixels, width, height, options.settings, sourceHash, cooked);
+	stbi_image_free(pixels);
+
+	std::filesystem::create_directories(cookedPath.parent_path());
+	std::ofstream cookedFile(cookedPath, std::ios::binary);
+	if (!cookedFile.write(cooked.data(), cooked.size()))
+	{
+		std::cerr << "Could not write " << cookedPath.generic_string() << "\n";
+		return false;
+	}
+
+	std::cout << "Cooked " << sourcePath.generic_string() << " (" << width << "x" << height << ", " << TextureCooker::GetFormatName(format) << ") to " << cookedPath.generic_string() << "\n";
+	return true;
+}
+
+static bool IsSourceImage(const std::filesystem::path& path)
+{
+	std::string extension = path.extension().string();
+	for (char& c : extension)
+	{
+		c = (char)std::tolower((unsigned char)c);
+	}
+	return SOURCE_EXTENSIONS.find(extension) != SOURCE_EXTENSIONS.end();
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	int failedCount = 0;
+	for (const std::filesystem::path& input : options.inputs)
+	{
+		const std::filesystem::path inputPath = options.root / input;
+		if (std::filesystem::is_directory(inputPath))
+		{
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(inputPath))
+			{
+				if (entry.is_regular_file() && IsSourceImage(entry.path()))
+				{
+					failedCount += !CookImage(options, std::filesystem::relative(entry.path(), options.root));
+				}
+			}
+		}
+		else
+		{
+			failedCount += !CookImage(options, input.lexically_normal());
+		}
+	}
+
+	return failedCount == 0 ? 0 : 1;
+}
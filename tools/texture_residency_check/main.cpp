@@ -0,0 +1,205 @@
+#include "renderer/texture_residency.h"
+
+#include <iostream>
+#include <vector>
+
+/// Mips of a 4 mip texture, finest first. Mips 2 and 3 are its base mips.
+static const std::vector<size_t> MipBytes = { 64, 16, 4, 1 };
+static const int BaseMip = 2;
+
+static int Failures = 0;
+
+#define CHECK(m_Condition)                                                                \
+	if (!(m_Condition))                                                                   \
+	{                                                                                     \
+		std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #m_Condition "\n"; \
+		Failures++;                                                                       \
+	}
+
+static bool HasChange(const std::vector<TextureResidency::Change>& changes, int slot, int mip)
+{
+	for (const TextureResidency::Change& change : changes)
+	{
+		if (change.slot == slot && change.mip == mip)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/// Loads the textures asked for this frame, finishing every load started
+static void RunFrame(TextureResidency& residency, unsigned int frame, std::vector<TextureResidency::Change>& loads, std::vector<TextureResidency::Change>& evictions)
+{
+	loads.clear();
+	evictions.clear();
+	residency.update(frame, loads, evictions);
+	for (const TextureResidency::Change& load : loads)
+	{
+		residency.finishLoad(load.slot, true);
+	}
+}
+
+/// The least recently requested textures lose their mips first, and only down to their base mips
+static void CheckLRUEviction()
+{
+	// Room for the base mips of three textures, the full mips of one and mip 1 of another
+	TextureResidency residency(3 * 5 + 80 + 20, 8);
+	const int a = residency.add(MipBytes, BaseMip);
+	const int b = residency.add(MipBytes, BaseMip);
+	const int c = residency.add(MipBytes, BaseMip);
+	std::vector<TextureResidency::Change> loads;
+	std::vector<TextureResidency::Change> evictions;
+
+	residency.request(a, 0, 1);
+	RunFrame(residency, 1, loads, evictions);
+	CHECK(residency.getResidentMip(a) == 0);
+
+	residency.request(b, 1, 2);
+	RunFrame(residency, 2, loads, evictions);
+	CHECK(residency.getResidentMip(b) == 1);
+	CHECK(residency.getResidentMip(a) == 0);
+
+	// c needs room, a was requested longest ago so it goes first
+	residency.request(c, 0, 3);
+	RunFrame(residency, 3, loads, evictions);
+	CHECK(residency.getResidentMip(c) == 0);
+	CHECK(HasChange(evictions, a, BaseMip));
+	CHECK(residency.getResidentMip(a) == BaseMip);
+	CHECK(residency.getResidentMip(b) == 1);
+	CHECK(residency.getResidentBytes() <= residency.getBudget());
+
+	// Base mips are never dropped, even far over budget
+	residency.setBudget(0);
+	RunFrame(residency, 4, loads, evictions);
+	CHECK(residency.getResidentMip(a) == BaseMip);
+	CHECK(residency.getResidentMip(b) == BaseMip);
+	CHECK(residency.getResidentMip(c) == BaseMip);
+	CHECK(residency.getResidentBytes() == 3 * 5);
+}
+
+/// Loads count against the budget while in flight, at most maxLoads run at once and failed loads give their bytes back
+static void CheckInFlightBudget()
+{
+	TextureResidency residency(1000, 2);
+	std::vector<int> slots;
+	for (int i = 0; i < 3; i++)
+	{
+		slots.push_back(residency.add(MipBytes, BaseMip));
+	}
+	const size_t baseBytes = residency.getResidentBytes();
+	std::vector<TextureResidency::Change> loads;
+	std::vector<TextureResidency::Change> evictions;
+
+	for (int slot : slots)
+	{
+		residency.request(slot, 0, 1);
+	}
+	residency.update(1, loads, evictions);
+	CHECK(loads.size() == 2);
+	CHECK(residency.getLoadingCount() == 2);
+	CHECK(residency.getResidentBytes() == baseBytes + 2 * 80);
+	CHECK(residency.getResidentMip(loads[0].slot) == BaseMip);
+
+	// Nothing new starts while the loads are in flight
+	std::vector<TextureResidency::Change> moreLoads;
+	for (int slot : slots)
+	{
+		residency.request(slot, 0, 2);
+	}
+	residency.update(2, moreLoads, evictions);
+	CHECK(moreLoads.empty());
+
+	residency.finishLoad(loads[0].slot, true);
+	residency.finishLoad(loads[1].slot, false);
+	CHECK(residency.getLoadingCount() == 0);
+	CHECK(residency.getResidentMip(loads[0].slot) == 0);
+	CHECK(residency.getResidentMip(loads[1].slot) == BaseMip);
+	CHECK(residency.getResidentBytes() == baseBytes + 80);
+	const int failedSlot = loads[1].slot;
+
+	// Removing a texture with a load in flight gives back what the load reserved
+	moreLoads.clear();
+	for (int slot : slots)
+	{
+		residency.request(slot, 0, 3);
+	}
+	residency.update(3, moreLoads, evictions);
+	CHECK(!moreLoads.empty());
+	CHECK(!HasChange(moreLoads, failedSlot, 0));
+	for (const TextureResidency::Change& load : moreLoads)
+	{
+		residency.remove(load.slot);
+	}
+	CHECK(residency.getLoadingCount() == 0);
+	CHECK(residency.getTextureCount() == 3 - moreLoads.size());
+}
+
+/// A failed load is not retried until the slot holds a new texture
+static void CheckFailedLoad()
+{
+	TextureResidency residency(1000, 8);
+	const int slot = residency.add(MipBytes, BaseMip);
+	std::vector<TextureResidency::Change> loads;
+	std::vector<TextureResidency::Change> evictions;
+
+	residency.request(slot, 0, 1);
+	residency.update(1, loads, evictions);
+	CHECK(HasChange(loads, slot, 0));
+	residency.finishLoad(slot, false);
+
+	for (unsigned int frame = 2; frame < 5; frame++)
+	{
+		residency.request(slot, 0, frame);
+		RunFrame(residency, frame, loads, evictions);
+		CHECK(loads.empty());
+		CHECK(residency.getResidentMip(slot) == BaseMip);
+	}
+
+	residency.remove(slot);
+	const int newSlot = residency.add(MipBytes, BaseMip);
+	CHECK(newSlot == slot);
+	residency.request(newSlot, 0, 5);
+	RunFrame(residency, 5, loads, evictions);
+	CHECK(HasChange(loads, newSlot, 0));
+	CHECK(residency.getResidentMip(newSlot) == 0);
+}
+
+/// A texture settles for coarser mips than wanted when the budget has no room for the finest
+static void CheckPartialMipFallback()
+{
+	// Room for the base mips and mip 1, but not mip 0
+	TextureResidency residency(5 + 16, 8);
+	const int slot = residency.add(MipBytes, BaseMip);
+	std::vector<TextureResidency::Change> loads;
+	std::vector<TextureResidency::Change> evictions;
+
+	residency.request(slot, 0, 1);
+	RunFrame(residency, 1, loads, evictions);
+	CHECK(HasChange(loads, slot, 1));
+	CHECK(residency.getResidentMip(slot) == 1);
+	CHECK(residency.getResidentBytes() == 5 + 16);
+
+	// Once the budget grows the finest mip follows
+	residency.setBudget(5 + 16 + 64);
+	residency.request(slot, 0, 2);
+	RunFrame(residency, 2, loads, evictions);
+	CHECK(HasChange(loads, slot, 0));
+	CHECK(residency.getResidentMip(slot) == 0);
+}
+
+int main()
+{
+	CheckLRUEviction();
+	CheckInFlightBudget();
+	CheckFailedLoad();
+	CheckPartialMipFallback();
+
+	if (Failures > 0)
+	{
+		std::cerr << Failures << " check(s) failed\n";
+		return 1;
+	}
+	std::cout << "All texture residency checks passed\n";
+	return 0;
+}